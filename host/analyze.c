@@ -0,0 +1,286 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  analyze.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Runs the firmware's post-game analysis (analysis.c) over logged
+//    games on the host.  Games are read from console captures of the
+//    board or of host/replay, which (with CHEAT_MODE on) show each
+//    secret and every guess:
+//        Today's secret number is: BYRW!
+//        --> You guessed: ORBG
+//    A game ends at its win or lose banner, or when the next one starts.
+//
+//    With -n, games are made up instead: a random secret, and a player
+//    who always guesses one of the codes still possible at random.  This
+//    is mainly for measuring throughput.
+//
+//  USAGE
+//    analyze [-q] [-n games] [-s seed] [capture ...]
+//      -q  print only the summary
+//      -n  analyze this many made-up games instead of captures
+//      -s  seed for the made-up games (default 1)
+//
+//  BUILDING
+//    gcc -O2 -Wall -DGAME_ANALYSIS -Ibsp -I../nios -o analyze analyze.c
+//        lfsr_model.c lfsr_soft_if.c ../nios/utilities.c ../nios/book.c
+//        ../nios/book_table.c ../nios/analysis.c ../nios/color_table.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for score_code, from_colorstr, code_from_index
+#include "analysis.h"
+
+// analysis.c compiles to nothing without the firmware's flag
+#ifndef GAME_ANALYSIS
+  #error "build analyze with -DGAME_ANALYSIS"
+#endif /* GAME_ANALYSIS */
+
+// Markers in the console output (see codebreaker.h)
+#define   ANALYZE_SECRET      "Today's secret number is: "
+#define   ANALYZE_GUESS       "--> You guessed: "
+#define   ANALYZE_WON         "THE DOOR UNLOCKS!"
+#define   ANALYZE_LOST        "YOU WERE TOO SLOW!"
+
+// One game
+typedef struct
+{
+  uint32  secret;
+  uint32  guesses[ANALYSIS_MAX_GUESSES];
+  uint32  count;
+} _game_t;
+
+static uint32   _quiet;
+static uint32   _games;
+static uint32   _guesses;
+static double   _busy;              // seconds spent analyzing
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _analyze
+//
+// DESCRIPTION: Analyzes one game and prints the report.
+//-------------------------------------------------------------------------
+static void _analyze(const _game_t* game)
+{
+  analysis_step_t steps[ANALYSIS_MAX_GUESSES];
+  uint8           line[ANALYSIS_LINE_LENGTH];
+  uint8           secret[CB_COLOR_LENGTH + 1];
+  double          start;
+  uint32          count;
+  uint32          i;
+
+  if (0 == game->count)
+  {
+    return;
+  } /* if */
+
+  start  = _now();
+  count  = analysis_game(game->secret, game->guesses, game->count, steps);
+  _busy += _now() - start;
+  _games++;
+  _guesses += count;
+
+  if (!_quiet)
+  {
+    to_colorstr(game->secret, secret);
+    printf("game %u, secret %s\n%s", _games, (char*)secret,
+           ANALYSIS_HEADING);
+    for (i = 0; i < count; i++)
+    {
+      analysis_format(&steps[i], i + 1, line);
+      fputs((char*)line, stdout);
+    } /* for i */
+    printf("\n");
+  } /* if */
+} /* _analyze */
+
+//-------------------------------------------------------------------------
+// NAME:        _read_capture
+//
+// DESCRIPTION: Finds the games in a console capture and analyzes them.
+// RETURNS:     int, 0 on success, -1 if the file can't be read
+//-------------------------------------------------------------------------
+static int _read_capture(const char* path)
+{
+  char    text[256];
+  char*   found;
+  char*   end;
+  _game_t game;
+  uint32  code;
+  uint32  playing = FALSE;
+  FILE*   in      = fopen(path, "r");
+
+  if (NULL == in)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+
+  while (NULL != fgets(text, sizeof(text), in))
+  {
+    if (NULL != (found = strstr(text, ANALYZE_SECRET)))
+    {
+      if (playing)
+      {
+        _analyze(&game);      // the last one never finished
+      } /* if */
+      found += strlen(ANALYZE_SECRET);
+      end    = strchr(found, '!');
+      if (NULL != end)
+      {
+        *end = 0;
+      } /* if */
+      playing    = from_colorstr((uint8*)found, &game.secret);
+      game.count = 0;
+    } /* if secret */
+    else if (playing && NULL != (found = strstr(text, ANALYZE_GUESS)))
+    {
+      found += strlen(ANALYZE_GUESS);
+      found[strcspn(found, "\r\n")] = 0;
+      // incomplete guesses count as guesses, but can't be analyzed
+      if (game.count < ANALYSIS_MAX_GUESSES &&
+          from_colorstr((uint8*)found, &code))
+      {
+        game.guesses[game.count++] = code;
+      } /* if */
+    } /* else if guess */
+    else if (playing && (NULL != strstr(text, ANALYZE_WON) ||
+                         NULL != strstr(text, ANALYZE_LOST)))
+    {
+      _analyze(&game);
+      playing = FALSE;
+    } /* else if over */
+  } /* while */
+
+  if (playing)
+  {
+    _analyze(&game);
+  } /* if */
+  fclose(in);
+  return 0;
+} /* _read_capture */
+
+//-------------------------------------------------------------------------
+// NAME:        _make_games
+//
+// DESCRIPTION: Makes up games with a random-but-consistent player and
+//              analyzes them.
+//-------------------------------------------------------------------------
+static void _make_games(uint32 count, uint32 seed)
+{
+  uint32  codes[ANALYSIS_CODES];
+  uint32  left[ANALYSIS_CODES];
+  uint32  n, kept, guess, score;
+  uint32  g, i;
+  _game_t game;
+
+  for (i = 0; i < ANALYSIS_CODES; i++)
+  {
+    codes[i] = code_from_index(i);
+  } /* for i */
+
+  srand(seed);
+  for (g = 0; g < count; g++)
+  {
+    game.secret = codes[rand() % ANALYSIS_CODES];
+    game.count  = 0;
+    memcpy(left, codes, sizeof(codes));
+    n = ANALYSIS_CODES;
+    do
+    {
+      guess = left[rand() % n];
+      score = score_code(game.secret, guess);
+      game.guesses[game.count++] = guess;
+      for (i = 0, kept = 0; i < n; i++)
+      {
+        if (score_code(left[i], guess) == score)
+        {
+          left[kept++] = left[i];
+        } /* if */
+      } /* for i */
+      n = kept;
+    } while (guess != game.secret && game.count < ANALYSIS_MAX_GUESSES);
+
+    _analyze(&game);
+  } /* for g */
+} /* _make_games */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, analyzes, and prints a summary.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  uint32  made   = 0;
+  uint32  seed   = 1;
+  int     status = 0;
+  int     opt;
+
+  while (-1 != (opt = getopt(argc, argv, "qn:s:")))
+  {
+    switch (opt)
+    {
+      case 'q':
+        _quiet = TRUE;
+        break;
+      case 'n':
+        made = (uint32)atoi(optarg);
+        break;
+      case 's':
+        seed = (uint32)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-q] [-n games] [-s seed] "
+                        "[capture ...]\n", argv[0]);
+        return 2;
+    } /* switch */
+  } /* while */
+
+  analysis_init();
+  if (0 != made)
+  {
+    _make_games(made, seed);
+  } /* if */
+  for (; optind < argc; optind++)
+  {
+    status |= _read_capture(argv[optind]);
+  } /* for */
+
+  fprintf(stderr, "%u games, %u guesses analyzed in %.3f s (%.0f games/s)\n",
+          _games, _guesses, _busy, (_busy > 0) ? _games / _busy : 0);
+  fprintf(stderr, "partition cache: %u hits, %u misses\n",
+          analysis_cache_hits, analysis_cache_misses);
+  return (0 == status) ? 0 : 1;
+} /* main */
@@ -0,0 +1,366 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  bench_score.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Throughput benchmark and cross-check for the batch scorer.  Every
+//    kernel the CPU supports is first checked against a direct port of
+//    check_guess's loops (and, for the firmware's code length and colors,
+//    against score_code itself), then timed on one core, both scoring a
+//    guess against the list (score_batch) and scoring pairs
+//    (score_pairs).
+//
+//  USAGE
+//    bench_score [-p pegs] [-c colors] [-r] [-n codes] [-t seconds]
+//                [-v]
+//      -p  positions per code (default CB_COLOR_LENGTH)
+//      -c  colors (default CB_POSSIBLE_COLORS)
+//      -r  allow repeated colors in the candidate list
+//      -n  candidate list length; the code set is repeated to fill it
+//      -t  seconds to time each kernel
+//      -v  verify only
+//
+//  BUILDING
+//    gcc -O2 -Wall -Ibsp -I../nios -o bench_score bench_score.c
+//        score_batch.c codeset.c lfsr_model.c lfsr_soft_if.c
+//        ../nios/utilities.c ../nios/color_table.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for score_code
+#include "codeset.h"
+#include "score_batch.h"
+
+// Guesses checked per kernel during verification
+#define   BENCH_VERIFY_GUESSES            4096
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _reference
+//
+// DESCRIPTION: check_guess's loops, applied to unpacked colors: P where
+//              the colors agree, then C for each other guess position
+//              whose color is at a secret position not yet answered for.
+// RETURNS:     uint32, feedback bucket
+//-------------------------------------------------------------------------
+static uint32 _reference(uint32 secret, uint32 guess, uint32 pegs)
+{
+  uint32 got_p = 0;
+  uint32 got_c = 0;
+  uint32 used  = 0;           // secret positions answered for
+  uint32 secret_idx;
+  uint32 guess_idx;
+
+  for (guess_idx = 0; guess_idx < pegs; guess_idx++)
+  {
+    if (((guess >> (guess_idx * 4)) & 0xF) ==
+        ((secret >> (guess_idx * 4)) & 0xF))
+    {
+      got_p++;
+      used |= 1 << guess_idx;
+    } /* if position */
+  } /* for guess_idx */
+
+  for (guess_idx = 0; guess_idx < pegs; guess_idx++)
+  {
+    if (((guess >> (guess_idx * 4)) & 0xF) ==
+        ((secret >> (guess_idx * 4)) & 0xF))
+    {
+      continue;               // already a P
+    } /* if */
+    for (secret_idx = 0; secret_idx < pegs; secret_idx++)
+    {
+      if (0 == (used & (1 << secret_idx)) &&
+          ((guess >> (guess_idx * 4)) & 0xF) ==
+          ((secret >> (secret_idx * 4)) & 0xF))
+      {
+        got_c++;
+        used |= 1 << secret_idx;
+        break;
+      } /* if match */
+    } /* for secret_idx */
+  } /* for guess_idx */
+
+  return SB_BUCKET(got_p, got_c, pegs);
+} /* _reference */
+
+//-------------------------------------------------------------------------
+// NAME:        _verify
+//
+// DESCRIPTION: Checks one kernel against the reference for a spread of
+//              guesses (including guesses with repeated colors).
+// RETURNS:     uint32, number of mismatches
+//-------------------------------------------------------------------------
+static uint32 _verify(uint32 impl, const uint32* codes, uint32 count,
+                      uint32 pegs, uint32 colors)
+{
+  uint32* buckets  = calloc(SB_BUCKETS(pegs), sizeof(uint32));
+  uint32* expected = calloc(SB_BUCKETS(pegs), sizeof(uint32));
+  uint16* feedback = calloc(count, sizeof(uint16));
+  uint16* paired   = calloc(count, sizeof(uint16));
+  uint32* partner  = calloc(count, sizeof(uint32));
+  uint64  guesses  = codeset_count(pegs, colors, TRUE);
+  uint64  step     = (guesses + BENCH_VERIFY_GUESSES - 1) /
+                     BENCH_VERIFY_GUESSES;
+  uint32  errors   = 0;
+  uint32  guess;
+  uint32  want;
+  uint64  g, rest;
+  uint32  i, b;
+
+  score_batch_select(impl);
+  for (g = 0; g < guesses; g += step)
+  {
+    // g-th code of the repeats-allowed set, by base-colors digits
+    guess = 0;
+    for (i = 0, rest = g; i < pegs; i++, rest /= colors)
+    {
+      guess |= (uint32)(rest % colors) << (i * 4);
+    } /* for i */
+
+    // pairs: half against this guess, half against other list codes
+    for (i = 0; i < count; i++)
+    {
+      partner[i] = (i & 1) ? guess : codes[(i + g) % count];
+    } /* for i */
+    score_pairs(codes, partner, count, pegs, colors, paired);
+    for (i = 0; i < count; i++)
+    {
+      errors += (paired[i] != _reference(codes[i], partner[i], pegs));
+    } /* for i */
+
+    memset(expected, 0, SB_BUCKETS(pegs) * sizeof(uint32));
+    score_batch(guess, codes, count, pegs, buckets, feedback);
+    for (i = 0; i < count; i++)
+    {
+      want = _reference(codes[i], guess, pegs);
+      expected[want]++;
+      if (feedback[i] != want)
+      {
+        errors++;
+      } /* if */
+      if (CB_COLOR_LENGTH == pegs && colors <= CB_POSSIBLE_COLORS &&
+          SB_BUCKET(SCORE_P(score_code(codes[i], guess)),
+                    SCORE_C(score_code(codes[i], guess)), pegs) != want)
+      {
+        errors++;
+      } /* if */
+    } /* for i */
+    for (b = 0; b < SB_BUCKETS(pegs); b++)
+    {
+      if (buckets[b] != expected[b])
+      {
+        errors++;
+      } /* if */
+    } /* for b */
+  } /* for g */
+
+  free(buckets);
+  free(expected);
+  free(feedback);
+  free(paired);
+  free(partner);
+  return errors;
+} /* _verify */
+
+//-------------------------------------------------------------------------
+// NAME:        _time
+//
+// DESCRIPTION: Times one kernel, scoring rotating guesses against the
+//              whole list.
+// RETURNS:     double, scores per second
+//-------------------------------------------------------------------------
+static double _time(uint32 impl, const uint32* codes, uint32 count,
+                    uint32 pegs, double seconds)
+{
+  uint32  buckets[SB_BUCKETS(SB_MAX_PEGS)];
+  uint64  scored = 0;
+  uint32  sink   = 0;
+  uint32  i      = 0;
+  double  start;
+  double  elapsed;
+
+  score_batch_select(impl);
+  start = _now();
+  do
+  {
+    score_batch(codes[i++ % count], codes, count, pegs, buckets, NULL);
+    sink  += buckets[0];
+    scored += count;
+    elapsed = _now() - start;
+  } while (elapsed < seconds);
+
+  if (0xFFFFFFFF == sink)
+  {
+    printf(" ");          // keep the result live
+  } /* if */
+  return scored / elapsed;
+} /* _time */
+
+//-------------------------------------------------------------------------
+// NAME:        _time_pairs
+//
+// DESCRIPTION: Times one pair kernel, scoring the list against itself at
+//              rotating offsets.
+// RETURNS:     double, pairs per second
+//-------------------------------------------------------------------------
+static double _time_pairs(uint32 impl, const uint32* codes, uint32 count,
+                          uint32 pegs, uint32 colors, double seconds)
+{
+  uint16* feedback = malloc(count * sizeof(uint16));
+  uint32  half     = count / 2;
+  uint64  scored   = 0;
+  uint32  sink     = 0;
+  uint32  i        = 0;
+  double  start;
+  double  elapsed;
+
+  score_batch_select(impl);
+  start = _now();
+  do
+  {
+    score_pairs(codes + (i++ % half), codes + half, half, pegs, colors,
+                feedback);
+    sink  += feedback[0];
+    scored += half;
+    elapsed = _now() - start;
+  } while (elapsed < seconds);
+
+  if (0xFFFFFFFF == sink)
+  {
+    printf(" ");          // keep the result live
+  } /* if */
+  free(feedback);
+  return scored / elapsed;
+} /* _time_pairs */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, verifies, then benchmarks.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  uint32  pegs    = CB_COLOR_LENGTH;
+  uint32  colors  = CB_POSSIBLE_COLORS;
+  uint32  repeats = FALSE;
+  uint32  length  = 0;
+  double  seconds = 1.0;
+  uint32  verify_only = FALSE;
+  uint32  failed  = FALSE;
+  uint32* codes;
+  uint32  count;
+  uint64  total;
+  uint32  impl;
+  uint32  errors;
+  uint32  i;
+  int     opt;
+
+  while (-1 != (opt = getopt(argc, argv, "p:c:rn:t:v")))
+  {
+    switch (opt)
+    {
+      case 'p':
+        pegs = (uint32)atoi(optarg);
+        break;
+      case 'c':
+        colors = (uint32)atoi(optarg);
+        break;
+      case 'r':
+        repeats = TRUE;
+        break;
+      case 'n':
+        length = (uint32)atoi(optarg);
+        break;
+      case 't':
+        seconds = atof(optarg);
+        break;
+      case 'v':
+        verify_only = TRUE;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-p pegs] [-c colors] [-r] [-n codes] "
+                        "[-t seconds] [-v]\n", argv[0]);
+        return 2;
+    } /* switch */
+  } /* while */
+
+  if (pegs < 1 || pegs > SB_MAX_PEGS || colors < 1 ||
+      colors > CODESET_MAX_COLORS)
+  {
+    fprintf(stderr, "unsupported configuration\n");
+    return 2;
+  } /* if */
+  total = codeset_count(pegs, colors, repeats);
+  if (0 == total || total > 0x10000000)
+  {
+    fprintf(stderr, "code set too large to enumerate\n");
+    return 2;
+  } /* if */
+
+  count = (length > total) ? length : (uint32)total;
+  codes = malloc(count * sizeof(uint32));
+  codeset_fill(codes, pegs, colors, repeats);
+  for (i = (uint32)total; i < count; i++)
+  {
+    codes[i] = codes[i % total];
+  } /* for i */
+
+  printf("pegs %u, colors %u, repeats %s, %u candidates\n",
+         pegs, colors, repeats ? "yes" : "no", count);
+  printf("%-8s %-8s %16s %16s\n", "kernel", "verify", "scores/sec/core",
+         "pairs/sec/core");
+
+  for (impl = SB_IMPL_SCALAR; impl < SB_IMPL_COUNT; impl++)
+  {
+    if (!score_batch_supported(impl))
+    {
+      printf("%-8s %-8s\n", score_batch_name(impl), "n/a");
+      continue;
+    } /* if */
+
+    errors = _verify(impl, codes, (uint32)total, pegs, colors);
+    failed |= (0 != errors);
+    printf("%-8s %-8s", score_batch_name(impl), errors ? "FAIL" : "ok");
+    if (!verify_only)
+    {
+      printf(" %16.4g", _time(impl, codes, count, pegs, seconds));
+      printf(" %16.4g", _time_pairs(impl, codes, count, pegs, colors,
+                                    seconds));
+    } /* if */
+    printf("\n");
+  } /* for impl */
+
+  free(codes);
+  return failed ? 1 : 0;
+} /* main */
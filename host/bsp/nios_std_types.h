@@ -0,0 +1,47 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  nios_std_types.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      Host stand-in for the BSP's standard embedded types, so that the
+//      firmware sources in ../nios can be compiled into host tools.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __NIOS_STD_TYPES__H
+#define __NIOS_STD_TYPES__H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t   uint8;
+typedef uint16_t  uint16;
+typedef uint32_t  uint32;
+typedef uint64_t  uint64;
+typedef int8_t    int8;
+typedef int16_t   int16;
+typedef int32_t   int32;
+typedef int64_t   int64;
+
+#ifndef TRUE
+#define TRUE    1
+#endif
+#ifndef FALSE
+#define FALSE   0
+#endif
+
+// The firmware treats NULL as the NUL character, as the BSP does.
+#undef  NULL
+#define NULL    0
+
+#endif /* __NIOS_STD_TYPES__H */
@@ -0,0 +1,45 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  alt_irq.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      Host stand-in for the HAL interrupt API.  ISRs are registered with
+//      the host register model, which calls them when the modelled
+//      peripherals raise their interrupts.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __ALT_IRQ_H__
+#define __ALT_IRQ_H__
+
+// The HAL includes this ahead of <string.h> and friends, so it declares
+// what it needs from regmodel.h itself rather than pulling in the
+// firmware's types (and its NULL) early.
+typedef void (*alt_isr_func)(void* isr_context);
+typedef unsigned int alt_irq_context;
+
+int rm_isr_register(unsigned int irq, void (*isr)(void*), void* context);
+int rm_irq_enable(unsigned int irq, unsigned int enable);
+int rm_irq_enabled(unsigned int irq);
+unsigned int rm_irq_disable_all();
+void rm_irq_enable_all(unsigned int context);
+
+#define alt_ic_isr_register(ic_id, irq, isr, context, flags) \
+          rm_isr_register((irq), (isr), (context))
+#define alt_ic_irq_enable(ic_id, irq)     rm_irq_enable((irq), 1)
+#define alt_ic_irq_disable(ic_id, irq)    rm_irq_enable((irq), 0)
+#define alt_ic_irq_enabled(ic_id, irq)    rm_irq_enabled(irq)
+#define alt_irq_disable_all()             rm_irq_disable_all()
+#define alt_irq_enable_all(context)       rm_irq_enable_all(context)
+
+#endif /* __ALT_IRQ_H__ */
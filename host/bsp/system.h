@@ -0,0 +1,60 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  system.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      Host stand-in for the BSP-generated system.h.  Base addresses and
+//      IRQ numbers match vhdl/nios_system.qsys; the host register model
+//      decodes these addresses rather than dereferencing them.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __SYSTEM_H_
+#define __SYSTEM_H_
+
+extern unsigned int rm_sysid_timestamp;   // set by the host model
+
+#define ALT_CPU_FREQ                                  50000000
+
+#define TIMER_GAME_1SEC_BASE                          0x11000
+#define TIMER_GAME_1SEC_IRQ                           0
+#define TIMER_GAME_1SEC_IRQ_INTERRUPT_CONTROLLER_ID   0
+#define TIMER_GAME_1SEC_LOAD_VALUE                    49999999
+
+#define TIMER_LED_TOGGLE_500MS_BASE                   0x11020
+#define TIMER_LED_TOGGLE_500MS_IRQ                    3
+#define TIMER_LED_TOGGLE_500MS_IRQ_INTERRUPT_CONTROLLER_ID 0
+#define TIMER_LED_TOGGLE_500MS_LOAD_VALUE             24999999
+
+#define DISPLAY_0_BASE                                0x11040
+#define PIO_LEDS_BASE                                 0x11050
+
+#define PIO_KEYS_BASE                                 0x11060
+#define PIO_KEYS_IRQ                                  2
+#define PIO_KEYS_IRQ_INTERRUPT_CONTROLLER_ID          0
+
+#define JTAG_UART_0_BASE                              0x11070
+#define JTAG_UART_0_IRQ                               1
+#define JTAG_UART_0_IRQ_INTERRUPT_CONTROLLER_ID       0
+
+#define LFSR_16_0_BASE                                0x110a0
+
+#define SYSID_QSYS_0_BASE                             0x11080
+#define SYSID_QSYS_0_ID                               5610703
+#define SYSID_QSYS_0_TIMESTAMP                        rm_sysid_timestamp
+
+#define COUNTDOWN_0_BASE                              0x11090
+#define COUNTDOWN_0_IRQ                               4
+#define COUNTDOWN_0_IRQ_INTERRUPT_CONTROLLER_ID       0
+
+#endif /* __SYSTEM_H_ */
@@ -0,0 +1,513 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  bustrace.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Tallies the firmware's bus traffic on the host register model.
+//    bt_access is hooked to rm_hooks.access, so every volatile access
+//    the drivers make through hw_access.h (the timers, the PIOs, the
+//    display, the JTAG UART data and control registers, the LFSR, ...)
+//    is counted against the function that made it and the register it
+//    hit, as a read or a write, with the bus cycles the model charged
+//    for it.  The cost of each access is the model's, and can be changed
+//    per peripheral with bt_set_cost (lfsr_16_0 is readWaitTime 1, so
+//    its reads cost one cycle more than the rest).
+//
+//    A profile can be saved as text and compared with a later run, so
+//    a driver change can be measured before it is ever synthesized:
+//        replay -q -a -p before.prof session.txt
+//        (change the driver)
+//        replay -q -a -b before.prof session.txt
+//
+//    Busy-wait polls the model skips over (a full TX FIFO, say) are
+//    counted as polls rather than reads, and their cycles are included.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "regmodel.h"         // for rm_*_cycles, rm_periph_name
+#include "bustrace.h"
+
+// Counts kept for each entry
+#define   _BT_READS                       0
+#define   _BT_WRITES                      1
+#define   _BT_POLLS                       2
+#define   _BT_CYCLES                      3
+#define   _BT_COUNTS                      4
+
+// Longest function or peripheral name in a saved profile
+#define   _BT_NAME_LENGTH                 64
+
+// Bus traffic of one function to one register
+typedef struct
+{
+  const char* func;
+  uint32      periph;
+  uint32      reg;
+  uint64      count[_BT_COUNTS];
+} _bt_entry_t;
+
+// Current run, and the saved one bt_diff compares it with
+static _bt_entry_t  _bt[BT_ENTRIES];
+static uint32       _bt_count;
+static uint32       _bt_dropped;
+static _bt_entry_t  _bt_base[BT_ENTRIES];
+static uint32       _bt_base_count;
+
+static const char*  _bt_headings[_BT_COUNTS] =
+{
+  "reads", "writes", "polls", "cycles"
+};
+
+//-------------------------------------------------------------------------
+// NAME:        _bt_find
+//
+// DESCRIPTION: Looks up the entry for a function and register.
+// ARGUMENTS:   _bt_entry_t* table, entries to search
+//              uint32* count, entries in use; bumped if one is added
+//              const char* func, uint32 periph, uint32 reg, the key
+//              uint32 add, TRUE to add the entry if it's missing
+// RETURNS:     _bt_entry_t*, the entry, or NULL if it's missing and
+//              wasn't (or couldn't be) added
+//-------------------------------------------------------------------------
+static _bt_entry_t* _bt_find(_bt_entry_t* table, uint32* count,
+                             const char* func, uint32 periph, uint32 reg,
+                             uint32 add)
+{
+  _bt_entry_t* entry;
+  uint32       i;
+
+  for (i = 0; i < *count; i++)
+  {
+    entry = &table[i];
+    if (entry->periph == periph && entry->reg == reg &&
+        (entry->func == func || 0 == strcmp(entry->func, func)))
+    {
+      return entry;
+    } /* if */
+  } /* for i */
+
+  if (!add || BT_ENTRIES == *count)
+  {
+    return NULL;
+  } /* if */
+  entry = &table[(*count)++];
+  memset(entry, 0, sizeof(*entry));
+  entry->func   = func;
+  entry->periph = periph;
+  entry->reg    = reg;
+  return entry;
+} /* _bt_find */
+
+//-------------------------------------------------------------------------
+// NAME:        bt_access
+//
+// DESCRIPTION: Register model hook (rm_hooks.access); tallies one access.
+// ARGUMENTS:   as rm_hooks_t.access
+// RETURNS:     None
+//-------------------------------------------------------------------------
+void bt_access(uint32 periph, uint32 reg, uint32 write, uint32 value,
+               const char* func, uint32 cycles, uint32 count)
+{
+  _bt_entry_t* entry = _bt_find(_bt, &_bt_count, func, periph, reg, TRUE);
+
+  if (NULL == entry)
+  {
+    _bt_dropped++;
+    return;
+  } /* if table full */
+
+  if (write)
+  {
+    entry->count[_BT_WRITES]++;
+  } /* if */
+  else
+  {
+    entry->count[_BT_READS]++;
+    entry->count[_BT_POLLS] += count - 1;
+  } /* else */
+  entry->count[_BT_CYCLES] += cycles;
+} /* bt_access */
+
+//-------------------------------------------------------------------------
+// NAME:        bt_set_cost
+//
+// DESCRIPTION: Sets the bus cycles charged for one peripheral's accesses.
+// ARGUMENTS:   const char* spec, "<peripheral>=<read>[/<write>]", with
+//                                the peripheral named as in Qsys (e.g.
+//                                "lfsr_16_0=3/2")
+// RETURNS:     int, 0 on success, -1 if the spec can't be parsed
+//-------------------------------------------------------------------------
+int bt_set_cost(const char* spec)
+{
+  const char* equals = strchr(spec, '=');
+  uint32      read;
+  uint32      write;
+  uint32      periph;
+  int         fields;
+
+  if (NULL == equals)
+  {
+    return -1;
+  } /* if */
+  for (periph = 0; periph < RM_PERIPHERALS; periph++)
+  {
+    if (strlen(rm_periph_name(periph)) == (size_t)(equals - spec) &&
+        0 == strncmp(rm_periph_name(periph), spec, equals - spec))
+    {
+      break;
+    } /* if */
+  } /* for periph */
+
+  fields = sscanf(equals + 1, "%u/%u", &read, &write);
+  if (RM_PERIPHERALS == periph || fields < 1)
+  {
+    return -1;
+  } /* if */
+  rm_read_cycles[periph] = read;
+  if (2 == fields)
+  {
+    rm_write_cycles[periph] = write;
+  } /* if */
+  return 0;
+} /* bt_set_cost */
+
+//-------------------------------------------------------------------------
+// NAME:        _bt_register
+//
+// DESCRIPTION: Formats an entry's register as "<peripheral>[<index>]".
+//-------------------------------------------------------------------------
+static const char* _bt_register(const _bt_entry_t* entry)
+{
+  static char text[_BT_NAME_LENGTH + 16];
+
+  snprintf(text, sizeof(text), "%s[%u]", rm_periph_name(entry->periph),
+           entry->reg);
+  return text;
+} /* _bt_register */
+
+//-------------------------------------------------------------------------
+// NAME:        _bt_func_cycles
+//
+// DESCRIPTION: Total bus cycles of one function in the current run.
+//-------------------------------------------------------------------------
+static uint64 _bt_func_cycles(const char* func)
+{
+  uint64 total = 0;
+  uint32 i;
+
+  for (i = 0; i < _bt_count; i++)
+  {
+    if (0 == strcmp(_bt[i].func, func))
+    {
+      total += _bt[i].count[_BT_CYCLES];
+    } /* if */
+  } /* for i */
+  return total;
+} /* _bt_func_cycles */
+
+//-------------------------------------------------------------------------
+// NAME:        _bt_order
+//
+// DESCRIPTION: qsort order for the report: busiest function first, and
+//              within a function, busiest register first.
+//-------------------------------------------------------------------------
+static int _bt_order(const void* a, const void* b)
+{
+  const _bt_entry_t* x = a;
+  const _bt_entry_t* y = b;
+  uint64             fx = _bt_func_cycles(x->func);
+  uint64             fy = _bt_func_cycles(y->func);
+  int                name;
+
+  if (fx != fy)
+  {
+    return (fx < fy) - (fx > fy);
+  } /* if */
+  name = strcmp(x->func, y->func);
+  if (0 != name)
+  {
+    return name;
+  } /* if */
+  return (x->count[_BT_CYCLES] < y->count[_BT_CYCLES]) -
+         (x->count[_BT_CYCLES] > y->count[_BT_CYCLES]);
+} /* _bt_order */
+
+//-------------------------------------------------------------------------
+// NAME:        _bt_row
+//
+// DESCRIPTION: Prints one line of a report.
+//-------------------------------------------------------------------------
+static void _bt_row(FILE* out, const char* indent, const char* name,
+                    const uint64* count)
+{
+  fprintf(out, "%s%-*s %9llu %9llu %11llu %13llu\n", indent,
+          (int)(30 - strlen(indent)), name,
+          (unsigned long long)count[_BT_READS],
+          (unsigned long long)count[_BT_WRITES],
+          (unsigned long long)count[_BT_POLLS],
+          (unsigned long long)count[_BT_CYCLES]);
+} /* _bt_row */
+
+//-------------------------------------------------------------------------
+// NAME:        bt_print
+//
+// DESCRIPTION: Prints the bus traffic of the run so far, by function and
+//              then by register, busiest first.
+// ARGUMENTS:   FILE* out, where to print
+// RETURNS:     None
+//-------------------------------------------------------------------------
+void bt_print(FILE* out)
+{
+  uint64 func[_BT_COUNTS];
+  uint64 total[_BT_COUNTS];
+  uint32 first;
+  uint32 i, j, k;
+
+  qsort(_bt, _bt_count, sizeof(_bt_entry_t), _bt_order);
+  memset(total, 0, sizeof(total));
+
+  fprintf(out, "%-30s %9s %9s %11s %13s\n", "bus accesses",
+          _bt_headings[_BT_READS], _bt_headings[_BT_WRITES],
+          _bt_headings[_BT_POLLS], _bt_headings[_BT_CYCLES]);
+  for (first = 0; first < _bt_count; first = i)
+  {
+    // entries of one function are together after the sort
+    memset(func, 0, sizeof(func));
+    for (i = first; i < _bt_count && 0 == strcmp(_bt[i].func,
+                                                 _bt[first].func); i++)
+    {
+      for (k = 0; k < _BT_COUNTS; k++)
+      {
+        func[k]  += _bt[i].count[k];
+        total[k] += _bt[i].count[k];
+      } /* for k */
+    } /* for i */
+
+    _bt_row(out, "", _bt[first].func, func);
+    for (j = first; j < i; j++)
+    {
+      _bt_row(out, "  ", _bt_register(&_bt[j]), _bt[j].count);
+    } /* for j */
+  } /* for first */
+  _bt_row(out, "", "total", total);
+
+  if (0 != _bt_dropped)
+  {
+    fprintf(out, "(%u accesses not tallied; more than %u entries)\n",
+            _bt_dropped, BT_ENTRIES);
+  } /* if */
+} /* bt_print */
+
+//-------------------------------------------------------------------------
+// NAME:        bt_save
+//
+// DESCRIPTION: Saves the run's profile for a later bt_diff.  Each line is
+//              "<function> <peripheral> <register> <reads> <writes>
+//              <polls> <cycles>".
+// ARGUMENTS:   const char* path, file to write
+// RETURNS:     int, 0 on success, -1 if the file can't be written
+//-------------------------------------------------------------------------
+int bt_save(const char* path)
+{
+  FILE*  out = fopen(path, "w");
+  uint32 i;
+
+  if (NULL == out)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+
+  fprintf(out, "%s\n", BT_MAGIC);
+  for (i = 0; i < _bt_count; i++)
+  {
+    fprintf(out, "%s %s %u %llu %llu %llu %llu\n", _bt[i].func,
+            rm_periph_name(_bt[i].periph), _bt[i].reg,
+            (unsigned long long)_bt[i].count[_BT_READS],
+            (unsigned long long)_bt[i].count[_BT_WRITES],
+            (unsigned long long)_bt[i].count[_BT_POLLS],
+            (unsigned long long)_bt[i].count[_BT_CYCLES]);
+  } /* for i */
+  fclose(out);
+  return 0;
+} /* bt_save */
+
+//-------------------------------------------------------------------------
+// NAME:        _bt_load
+//
+// DESCRIPTION: Reads a saved profile into _bt_base.
+// RETURNS:     int, 0 on success, -1 if it can't be read
+//-------------------------------------------------------------------------
+static int _bt_load(const char* path)
+{
+  char                line[256];
+  char                func[_BT_NAME_LENGTH];
+  char                name[_BT_NAME_LENGTH];
+  unsigned long long  count[_BT_COUNTS];
+  _bt_entry_t*        entry;
+  uint32              periph;
+  uint32              reg;
+  uint32              k;
+  FILE*               in = fopen(path, "r");
+
+  if (NULL == in)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+  if (NULL == fgets(line, sizeof(line), in) ||
+      0 != strncmp(line, BT_MAGIC, strlen(BT_MAGIC)))
+  {
+    fprintf(stderr, "%s: not a saved bus profile\n", path);
+    fclose(in);
+    return -1;
+  } /* if */
+
+  _bt_base_count = 0;
+  while (NULL != fgets(line, sizeof(line), in))
+  {
+    if (7 != sscanf(line, "%63s %63s %u %llu %llu %llu %llu", func, name,
+                    &reg, &count[_BT_READS], &count[_BT_WRITES],
+                    &count[_BT_POLLS], &count[_BT_CYCLES]))
+    {
+      continue;
+    } /* if */
+    for (periph = 0; periph < RM_PERIPHERALS &&
+                     0 != strcmp(rm_periph_name(periph), name); periph++)
+    {
+    } /* for periph */
+
+    entry = _bt_find(_bt_base, &_bt_base_count, func, periph, reg, TRUE);
+    if (NULL != entry)
+    {
+      if (entry->func == func)
+      {
+        entry->func = strdup(func);
+      } /* if new */
+      for (k = 0; k < _BT_COUNTS; k++)
+      {
+        entry->count[k] += count[k];
+      } /* for k */
+    } /* if */
+  } /* while */
+
+  fclose(in);
+  return 0;
+} /* _bt_load */
+
+//-------------------------------------------------------------------------
+// NAME:        _bt_diff_row
+//
+// DESCRIPTION: Prints one line of bt_diff, if anything changed.
+//-------------------------------------------------------------------------
+static void _bt_diff_row(FILE* out, const char* func, const char* reg,
+                         const uint64* before, const uint64* after)
+{
+  char   name[2 * _BT_NAME_LENGTH + 16];
+  int64  delta[_BT_COUNTS];
+  uint32 changed = FALSE;
+  uint32 k;
+
+  for (k = 0; k < _BT_COUNTS; k++)
+  {
+    delta[k] = (int64)(after[k] - before[k]);
+    changed |= (0 != delta[k]);
+  } /* for k */
+  if (!changed)
+  {
+    return;
+  } /* if */
+
+  snprintf(name, sizeof(name), "%s %s", func, reg);
+  fprintf(out, "%-40s %+9lld %+9lld %+11lld %+13lld\n", name,
+          (long long)delta[_BT_READS], (long long)delta[_BT_WRITES],
+          (long long)delta[_BT_POLLS], (long long)delta[_BT_CYCLES]);
+} /* _bt_diff_row */
+
+//-------------------------------------------------------------------------
+// NAME:        bt_diff
+//
+// DESCRIPTION: Prints how the run's bus traffic differs from a saved
+//              profile, register by register, then in total.  Registers
+//              a function no longer touches (or only now touches) show
+//              up with all of their traffic as the difference.
+// ARGUMENTS:   FILE* out, where to print
+//              const char* path, profile saved by bt_save
+// RETURNS:     int, 0 on success, -1 if the profile can't be read
+//-------------------------------------------------------------------------
+int bt_diff(FILE* out, const char* path)
+{
+  static const uint64 none[_BT_COUNTS];
+
+  uint64              before[_BT_COUNTS];
+  uint64              after[_BT_COUNTS];
+  _bt_entry_t*        match;
+  uint32              i, k;
+
+  if (0 != _bt_load(path))
+  {
+    return -1;
+  } /* if */
+
+  fprintf(out, "%-40s %9s %9s %11s %13s\n", "bus accesses, change",
+          _bt_headings[_BT_READS], _bt_headings[_BT_WRITES],
+          _bt_headings[_BT_POLLS], _bt_headings[_BT_CYCLES]);
+  memset(before, 0, sizeof(before));
+  memset(after, 0, sizeof(after));
+  for (i = 0; i < _bt_count; i++)
+  {
+    match = _bt_find(_bt_base, &_bt_base_count, _bt[i].func, _bt[i].periph,
+                     _bt[i].reg, FALSE);
+    _bt_diff_row(out, _bt[i].func, _bt_register(&_bt[i]),
+                 (NULL != match) ? match->count : none, _bt[i].count);
+    for (k = 0; k < _BT_COUNTS; k++)
+    {
+      after[k] += _bt[i].count[k];
+    } /* for k */
+  } /* for i */
+  for (i = 0; i < _bt_base_count; i++)
+  {
+    if (NULL == _bt_find(_bt, &_bt_count, _bt_base[i].func,
+                         _bt_base[i].periph, _bt_base[i].reg, FALSE))
+    {
+      _bt_diff_row(out, _bt_base[i].func, _bt_register(&_bt_base[i]),
+                   _bt_base[i].count, none);
+    } /* if gone */
+    for (k = 0; k < _BT_COUNTS; k++)
+    {
+      before[k] += _bt_base[i].count[k];
+    } /* for k */
+  } /* for i */
+  _bt_diff_row(out, "total", "", before, after);
+
+  for (k = 0; k < _BT_COUNTS; k++)
+  {
+    if (k != _BT_POLLS)
+    {
+      fprintf(out, "%-8s %llu -> %llu", _bt_headings[k],
+              (unsigned long long)before[k], (unsigned long long)after[k]);
+      if (0 != before[k])
+      {
+        fprintf(out, " (%+.1f%%)",
+                100.0 * ((double)after[k] - before[k]) / before[k]);
+      } /* if */
+      fprintf(out, "\n");
+    } /* if */
+  } /* for k */
+  return 0;
+} /* bt_diff */
@@ -0,0 +1,42 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  bustrace.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for bustrace.c, the bus
+//      traffic profiler for the host register model.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_BUSTRACE__H
+#define __LAB_7_BUSTRACE__H
+
+#include <stdio.h>
+
+#include "nios_std_types.h"   // standard data types
+
+// Most (function, register) pairs tallied
+#define   BT_ENTRIES                      256
+
+// First line of a saved profile
+#define   BT_MAGIC                        "# bustrace 1"
+
+// Prototypes for public functions
+void bt_access(uint32 periph, uint32 reg, uint32 write, uint32 value,
+               const char* func, uint32 cycles, uint32 count);
+int bt_set_cost(const char* spec);
+void bt_print(FILE* out);
+int bt_save(const char* path);
+int bt_diff(FILE* out, const char* path);
+
+#endif /* __LAB_7_BUSTRACE__H */
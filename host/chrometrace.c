@@ -0,0 +1,565 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  chrometrace.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Records a timeline of a run on the host register model and writes
+//    it in the Chrome trace event format, for chrome://tracing or
+//    ui.perfetto.dev.  Timestamps are the model's simulated clock, so a
+//    trace of a replayed session shows exactly when each interrupt was
+//    taken and how long it ran, not how long the host took to model it.
+//
+//    ct_attach hooks the model (chaining to any hooks already set, so
+//    bustrace and the console capture still see everything) and lays
+//    the run out on a few tracks:
+//        CPU           ISRs, firmware spans (CPU_TRACE_BEGIN/END),
+//                      idle time skipped by CPU_IDLE, and busy-waits
+//                      on a full JTAG UART TX FIFO
+//        game state    the state named by CPU_TRACE_STATE
+//        interrupts    each interrupt line rising (timer ticks, keys,
+//                      the UART, the countdown) and the countdown
+//                      expiring
+//        UART          each character received and sent
+//        keys          each key edge, with the PIO key mask
+//
+//    Nothing is recorded unless ct_attach is called; left unattached,
+//    each hook costs the model one NULL check, and on the board the
+//    trace points compile to nothing.  By default every event is kept;
+//    with a ring size, only the most recent events are, in fixed memory,
+//    and the number overwritten is given in the trace's otherData.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // for ALT_CPU_FREQ
+#include "regmodel.h"
+#include "chrometrace.h"
+
+// Tracks (the trace's thread ids)
+#define   _CT_CPU                         1
+#define   _CT_STATE                       2
+#define   _CT_IRQ                         3
+#define   _CT_UART                        4
+#define   _CT_KEYS                        5
+#define   _CT_TRACKS                      6
+
+// What an event's data is
+#define   _CT_ARG_NONE                    0
+#define   _CT_ARG_IRQ                     1   // data: interrupt line
+#define   _CT_ARG_CHAR                    2   // data: character
+#define   _CT_ARG_KEYS                    3   // data: PIO key mask
+#define   _CT_ARG_FUNC                    4   // detail: function name
+#define   _CT_ARG_POLLS                   5   // detail, data: polls skipped
+
+// Unbounded recording starts with room for this many events
+#define   _CT_INITIAL                     4096
+
+// One recorded event: a complete span ('X') or an instant ('i')
+typedef struct
+{
+  uint64      ts;         // cycles
+  uint64      dur;        // cycles, spans only
+  const char* name;       // string literals and __func__ only
+  const char* cat;
+  const char* detail;
+  uint32      data;
+  uint8       track;
+  uint8       phase;
+  uint8       arg;
+} _ct_event_t;
+
+// A span that has begun but not yet ended
+typedef struct
+{
+  uint64      ts;
+  const char* name;
+  const char* cat;
+  uint32      data;
+  uint8       arg;
+} _ct_open_t;
+
+uint64              ct_recorded;
+uint64              ct_dropped;
+
+static _ct_event_t* _ct;
+static uint32       _ct_size;       // events _ct has room for
+static uint32       _ct_ring;       // TRUE if it's a ring of _ct_size
+static uint32       _ct_next;       // where the next event goes
+
+static _ct_open_t   _ct_stack[CT_DEPTH];
+static uint32       _ct_depth;      // may exceed CT_DEPTH; those are lost
+static _ct_open_t   _ct_state;      // name NULL before the first state
+
+static rm_hooks_t   _ct_chain;      // hooks set before ct_attach
+
+static const char*  _ct_track_names[_CT_TRACKS] =
+{
+  NULL, "CPU", "game state", "interrupts", "UART", "keys"
+};
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_add
+//
+// DESCRIPTION: Makes room for one more event.
+// RETURNS:     _ct_event_t*, the event to fill in, or NULL if there's no
+//              memory left for it
+//-------------------------------------------------------------------------
+static _ct_event_t* _ct_add()
+{
+  _ct_event_t* grown;
+
+  if (_ct_next == _ct_size)
+  {
+    if (_ct_ring)
+    {
+      _ct_next = 0;
+    } /* if wrapping */
+    else
+    {
+      grown = realloc(_ct, 2 * _ct_size * sizeof(*_ct));
+      if (NULL == grown)
+      {
+        ct_dropped++;
+        return NULL;
+      } /* if */
+      _ct      = grown;
+      _ct_size = 2 * _ct_size;
+    } /* else growing */
+  } /* if full */
+
+  if (ct_recorded >= _ct_size)
+  {
+    ct_dropped++;               // overwriting the oldest
+  } /* if */
+  ct_recorded++;
+  return &_ct[_ct_next++];
+} /* _ct_add */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_event
+//
+// DESCRIPTION: Records one event.
+// ARGUMENTS:   uint32 track, one of _CT_* tracks
+//              uint32 phase, 'X' for a span or 'i' for an instant
+//              uint64 ts, uint64 dur, start and length in cycles
+//              const char* name, const char* cat, what it was
+//              uint32 arg, one of _CT_ARG_*, with its detail and data
+// RETURNS:     void
+//-------------------------------------------------------------------------
+static void _ct_event(uint32 track, uint32 phase, uint64 ts, uint64 dur,
+                      const char* name, const char* cat, uint32 arg,
+                      const char* detail, uint32 data)
+{
+  _ct_event_t* event = _ct_add();
+
+  if (NULL == event)
+  {
+    return;
+  } /* if */
+  event->ts     = ts;
+  event->dur    = dur;
+  event->name   = name;
+  event->cat    = cat;
+  event->detail = detail;
+  event->data   = data;
+  event->track  = (uint8)track;
+  event->phase  = (uint8)phase;
+  event->arg    = (uint8)arg;
+} /* _ct_event */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_begin, _ct_end
+//
+// DESCRIPTION: Open and close a span on the CPU track.  Spans nest; one
+//              that ends is recorded as a complete event.
+//-------------------------------------------------------------------------
+static void _ct_begin(const char* name, const char* cat, uint32 arg,
+                      uint32 data)
+{
+  _ct_open_t* open;
+
+  if (_ct_depth < CT_DEPTH)
+  {
+    open       = &_ct_stack[_ct_depth];
+    open->ts   = rm_cycles;
+    open->name = name;
+    open->cat  = cat;
+    open->arg  = (uint8)arg;
+    open->data = data;
+  } /* if */
+  else
+  {
+    ct_dropped++;
+  } /* else too deep */
+  _ct_depth++;
+} /* _ct_begin */
+
+static void _ct_end()
+{
+  _ct_open_t* open;
+
+  if (0 == _ct_depth)
+  {
+    return;                     // an end with no begin
+  } /* if */
+  _ct_depth--;
+  if (_ct_depth < CT_DEPTH)
+  {
+    open = &_ct_stack[_ct_depth];
+    _ct_event(_CT_CPU, 'X', open->ts, rm_cycles - open->ts, open->name,
+              open->cat, open->arg, NULL, open->data);
+  } /* if */
+} /* _ct_end */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_isr_enter, _ct_isr_exit
+//
+// DESCRIPTION: Register model hooks; bracket each ISR.
+//-------------------------------------------------------------------------
+static void _ct_isr_enter(uint32 irq)
+{
+  _ct_begin(rm_irq_name(irq), "isr", _CT_ARG_IRQ, irq);
+  if (NULL != _ct_chain.isr_enter)
+  {
+    _ct_chain.isr_enter(irq);
+  } /* if */
+} /* _ct_isr_enter */
+
+static void _ct_isr_exit(uint32 irq)
+{
+  _ct_end();
+  if (NULL != _ct_chain.isr_exit)
+  {
+    _ct_chain.isr_exit(irq);
+  } /* if */
+} /* _ct_isr_exit */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_access
+//
+// DESCRIPTION: Register model hook; records the polls of a busy-wait the
+//              model skipped over as a span ending now.  Single accesses
+//              aren't recorded.
+//-------------------------------------------------------------------------
+static void _ct_access(uint32 periph, uint32 reg, uint32 write,
+                       uint32 value, const char* func, uint32 cycles,
+                       uint32 count)
+{
+  uint64 dur;
+
+  if (count > 1)
+  {
+    dur = (uint64)cycles - cycles / count;
+    _ct_event(_CT_CPU, 'X', rm_cycles - dur, dur, "busy-wait",
+              "busy-wait", _CT_ARG_POLLS, func, count - 1);
+  } /* if */
+  if (NULL != _ct_chain.access)
+  {
+    _ct_chain.access(periph, reg, write, value, func, cycles, count);
+  } /* if */
+} /* _ct_access */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_idle
+//
+// DESCRIPTION: Register model hook; records the time CPU_IDLE skipped.
+//-------------------------------------------------------------------------
+static void _ct_idle(uint64 since, const char* func)
+{
+  _ct_event(_CT_CPU, 'X', since, rm_cycles - since, "idle", "idle",
+            _CT_ARG_FUNC, func, 0);
+  if (NULL != _ct_chain.idle)
+  {
+    _ct_chain.idle(since, func);
+  } /* if */
+} /* _ct_idle */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_irq_raise
+//
+// DESCRIPTION: Register model hook; marks an interrupt line rising.
+//-------------------------------------------------------------------------
+static void _ct_irq_raise(uint32 irq)
+{
+  _ct_event(_CT_IRQ, 'i', rm_cycles, 0, rm_irq_name(irq), "irq",
+            _CT_ARG_IRQ, NULL, irq);
+  if (NULL != _ct_chain.irq_raise)
+  {
+    _ct_chain.irq_raise(irq);
+  } /* if */
+} /* _ct_irq_raise */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_uart_tx
+//
+// DESCRIPTION: Register model hook; marks a character sent.
+//-------------------------------------------------------------------------
+static void _ct_uart_tx(uint8 byte)
+{
+  _ct_event(_CT_UART, 'i', rm_cycles, 0, "tx", "uart", _CT_ARG_CHAR,
+            NULL, byte);
+  if (NULL != _ct_chain.uart_tx)
+  {
+    _ct_chain.uart_tx(byte);
+  } /* if */
+} /* _ct_uart_tx */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_stimulus
+//
+// DESCRIPTION: Register model hook; marks what the outside world did.
+//-------------------------------------------------------------------------
+static void _ct_stimulus(uint32 type, uint32 data)
+{
+  switch (type)
+  {
+    case RM_EV_UART_RX:
+      _ct_event(_CT_UART, 'i', rm_cycles, 0, "rx", "uart", _CT_ARG_CHAR,
+                NULL, data);
+      break;
+    case RM_EV_KEY_DOWN:
+      _ct_event(_CT_KEYS, 'i', rm_cycles, 0, "down", "key", _CT_ARG_KEYS,
+                NULL, data);
+      break;
+    case RM_EV_KEY_UP:
+      _ct_event(_CT_KEYS, 'i', rm_cycles, 0, "up", "key", _CT_ARG_KEYS,
+                NULL, data);
+      break;
+    case RM_EV_TICK:
+      _ct_event(_CT_IRQ, 'i', rm_cycles, 0, "countdown expires", "irq",
+                _CT_ARG_NONE, NULL, 0);
+      break;
+  } /* switch */
+  if (NULL != _ct_chain.stimulus)
+  {
+    _ct_chain.stimulus(type, data);
+  } /* if */
+} /* _ct_stimulus */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_mark
+//
+// DESCRIPTION: Register model hook; takes the firmware's CPU_TRACE_*
+//              points.  A new state ends the one before it.
+//-------------------------------------------------------------------------
+static void _ct_mark(uint32 kind, const char* name)
+{
+  switch (kind)
+  {
+    case RM_TRACE_BEGIN:
+      _ct_begin(name, "firmware", _CT_ARG_NONE, 0);
+      break;
+    case RM_TRACE_END:
+      _ct_end();
+      break;
+    case RM_TRACE_STATE:
+      if (NULL != _ct_state.name)
+      {
+        _ct_event(_CT_STATE, 'X', _ct_state.ts, rm_cycles - _ct_state.ts,
+                  _ct_state.name, "state", _CT_ARG_NONE, NULL, 0);
+      } /* if */
+      _ct_state.ts   = rm_cycles;
+      _ct_state.name = name;
+      break;
+  } /* switch */
+  if (NULL != _ct_chain.mark)
+  {
+    _ct_chain.mark(kind, name);
+  } /* if */
+} /* _ct_mark */
+
+//-------------------------------------------------------------------------
+// NAME:        ct_attach
+//
+// DESCRIPTION: Starts recording.  Call after rm_reset and after setting
+//              any other hooks, which are kept and called in turn.
+// ARGUMENTS:   uint32 ring, events to keep (the most recent), or 0 to
+//              keep them all
+// RETURNS:     int, 0 on success, -1 if there's no memory for the events
+//-------------------------------------------------------------------------
+int ct_attach(uint32 ring)
+{
+  _ct_size = (0 != ring) ? ring : _CT_INITIAL;
+  _ct_ring = (0 != ring);
+  _ct      = malloc(_ct_size * sizeof(*_ct));
+  if (NULL == _ct)
+  {
+    return -1;
+  } /* if */
+  _ct_next       = 0;
+  _ct_depth      = 0;
+  _ct_state.name = NULL;
+  ct_recorded    = 0;
+  ct_dropped     = 0;
+
+  _ct_chain           = rm_hooks;
+  rm_hooks.access     = _ct_access;
+  rm_hooks.isr_enter  = _ct_isr_enter;
+  rm_hooks.isr_exit   = _ct_isr_exit;
+  rm_hooks.uart_tx    = _ct_uart_tx;
+  rm_hooks.stimulus   = _ct_stimulus;
+  rm_hooks.irq_raise  = _ct_irq_raise;
+  rm_hooks.idle       = _ct_idle;
+  rm_hooks.mark       = _ct_mark;
+  return 0;
+} /* ct_attach */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_string
+//
+// DESCRIPTION: Writes a JSON string.
+//-------------------------------------------------------------------------
+static void _ct_string(FILE* out, const char* text, uint32 length)
+{
+  uint8  c;
+  uint32 i;
+
+  fputc('"', out);
+  for (i = 0; i < length; i++)
+  {
+    c = (uint8)text[i];
+    if ('"' == c || '\\' == c)
+    {
+      fprintf(out, "\\%c", c);
+    } /* if */
+    else if (c < 0x20 || c >= 0x7F)
+    {
+      fprintf(out, "\\u%04x", c);
+    } /* else if */
+    else
+    {
+      fputc(c, out);
+    } /* else */
+  } /* for i */
+  fputc('"', out);
+} /* _ct_string */
+
+//-------------------------------------------------------------------------
+// NAME:        _ct_write_event
+//
+// DESCRIPTION: Writes one event as a JSON object.
+//-------------------------------------------------------------------------
+static void _ct_write_event(FILE* out, const _ct_event_t* event)
+{
+  double us = 1000000.0 / ALT_CPU_FREQ;   // per cycle
+  char   c;
+
+  fprintf(out, ",\n{\"name\":");
+  _ct_string(out, event->name, strlen(event->name));
+  fprintf(out, ",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,",
+          event->cat, event->phase, (double)event->ts * us);
+  if ('X' == event->phase)
+  {
+    fprintf(out, "\"dur\":%.3f,", (double)event->dur * us);
+  } /* if */
+  else
+  {
+    fprintf(out, "\"s\":\"t\",");
+  } /* else */
+  fprintf(out, "\"pid\":1,\"tid\":%u", event->track);
+
+  switch (event->arg)
+  {
+    case _CT_ARG_IRQ:
+      fprintf(out, ",\"args\":{\"irq\":%u}", event->data);
+      break;
+    case _CT_ARG_CHAR:
+      c = (char)event->data;
+      fprintf(out, ",\"args\":{\"char\":");
+      _ct_string(out, &c, 1);
+      fprintf(out, ",\"code\":%u}", event->data);
+      break;
+    case _CT_ARG_KEYS:
+      fprintf(out, ",\"args\":{\"mask\":%u}", event->data);
+      break;
+    case _CT_ARG_FUNC:
+      fprintf(out, ",\"args\":{\"func\":");
+      _ct_string(out, event->detail, strlen(event->detail));
+      fprintf(out, "}");
+      break;
+    case _CT_ARG_POLLS:
+      fprintf(out, ",\"args\":{\"func\":");
+      _ct_string(out, event->detail, strlen(event->detail));
+      fprintf(out, ",\"polls\":%u}", event->data);
+      break;
+  } /* switch */
+  fprintf(out, "}");
+} /* _ct_write_event */
+
+//-------------------------------------------------------------------------
+// NAME:        ct_write
+//
+// DESCRIPTION: Ends the spans still open at the end of the run and
+//              writes the trace.
+// ARGUMENTS:   const char* path, JSON file to write
+// RETURNS:     int, 0 on success, -1 if it can't be written
+//-------------------------------------------------------------------------
+int ct_write(const char* path)
+{
+  FILE*  out;
+  uint32 count;
+  uint32 first;
+  uint32 track;
+  uint32 i;
+
+  // The run stops wherever it is
+  while (_ct_depth > 0)
+  {
+    _ct_end();
+  } /* while */
+  if (NULL != _ct_state.name)
+  {
+    _ct_event(_CT_STATE, 'X', _ct_state.ts, rm_cycles - _ct_state.ts,
+              _ct_state.name, "state", _CT_ARG_NONE, NULL, 0);
+    _ct_state.name = NULL;
+  } /* if */
+
+  out = fopen(path, "w");
+  if (NULL == out)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+
+  fprintf(out, "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\","
+               "\"pid\":1,\"tid\":0,\"args\":{\"name\":\"codebreaker "
+               "(%.0f MHz simulated)\"}}", ALT_CPU_FREQ / 1e6);
+  for (track = 1; track < _CT_TRACKS; track++)
+  {
+    fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                 "\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            track, _ct_track_names[track]);
+    fprintf(out, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\","
+                 "\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}",
+            track, track);
+  } /* for track */
+
+  // Oldest first; a ring that has wrapped starts at _ct_next
+  count = (ct_recorded < _ct_size) ? (uint32)ct_recorded : _ct_size;
+  first = (count == _ct_size && _ct_ring) ? _ct_next % _ct_size : 0;
+  for (i = 0; i < count; i++)
+  {
+    _ct_write_event(out, &_ct[(first + i) % _ct_size]);
+  } /* for i */
+
+  fprintf(out, "\n],\n\"displayTimeUnit\":\"ns\",\n\"otherData\":{"
+               "\"clock\":\"simulated\",\"cycles\":%llu,\"recorded\":%llu,"
+               "\"dropped\":%llu}}\n", (unsigned long long)rm_cycles,
+          (unsigned long long)ct_recorded, (unsigned long long)ct_dropped);
+  fclose(out);
+  return 0;
+} /* ct_write */
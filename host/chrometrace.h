@@ -0,0 +1,38 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  chrometrace.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for chrometrace.c, the
+//      timeline recorder for the host register model.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_CHROMETRACE__H
+#define __LAB_7_CHROMETRACE__H
+
+#include "nios_std_types.h"   // standard data types
+
+// Deepest nesting of ISRs and firmware spans kept open at once
+#define   CT_DEPTH                        16
+
+// Statistics
+extern uint64 ct_recorded;            // events recorded
+extern uint64 ct_dropped;             // events lost: overwritten by a
+                                      // full ring, or nested too deep
+
+// Prototypes for public functions
+int ct_attach(uint32 ring);
+int ct_write(const char* path);
+
+#endif /* __LAB_7_CHROMETRACE__H */
@@ -0,0 +1,191 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  codeset.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Enumerates and converts packed codes for arbitrary game sizes, for
+//    the host-side tools.  Codes use the same layout as
+//    generate_secret_code: position i holds its color in bits 4i+3..4i.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "codeset.h"
+
+//-------------------------------------------------------------------------
+// NAME:        codeset_count
+//
+// DESCRIPTION: Counts the codes in a configuration.
+// ARGUMENTS:   uint32 pegs, positions per code
+//              uint32 colors, colors available
+//              uint32 repeats, TRUE if a color may appear more than once
+// RETURNS:     uint64, number of codes
+//-------------------------------------------------------------------------
+uint64 codeset_count(uint32 pegs, uint32 colors, uint32 repeats)
+{
+  uint64 count = 1;
+  uint32 i;
+
+  for (i = 0; i < pegs; i++)
+  {
+    count *= repeats ? colors : (colors > i ? colors - i : 0);
+  } /* for i */
+
+  return count;
+} /* codeset_count */
+
+//-------------------------------------------------------------------------
+// NAME:        codeset_valid
+//
+// DESCRIPTION: Checks that a packed code belongs to a configuration.
+// ARGUMENTS:   uint32 code, packed code
+//              uint32 pegs, uint32 colors, uint32 repeats, configuration
+// RETURNS:     uint32, TRUE if the code is valid
+//-------------------------------------------------------------------------
+uint32 codeset_valid(uint32 code, uint32 pegs, uint32 colors,
+                     uint32 repeats)
+{
+  uint32 seen = 0;
+  uint32 color;
+  uint32 i;
+
+  if (0 != (code & ~CODESET_MASK(pegs)))
+  {
+    return FALSE;
+  } /* if stray bits */
+
+  for (i = 0; i < pegs; i++)
+  {
+    color = (code >> (i * 4)) & 0xF;
+    if (color >= colors)
+    {
+      return FALSE;
+    } /* if */
+    if (!repeats && 0 != (seen & (1 << color)))
+    {
+      return FALSE;
+    } /* if */
+    seen |= 1 << color;
+  } /* for i */
+
+  return TRUE;
+} /* codeset_valid */
+
+//-------------------------------------------------------------------------
+// NAME:        codeset_fill
+//
+// DESCRIPTION: Writes every code of a configuration, in increasing
+//              base-colors order with position 0 least significant.
+// ARGUMENTS:   uint32* codes, destination with codeset_count() entries
+//              uint32 pegs, uint32 colors, uint32 repeats, configuration
+// RETURNS:     uint32, number of codes written
+//-------------------------------------------------------------------------
+uint32 codeset_fill(uint32* codes, uint32 pegs, uint32 colors,
+                    uint32 repeats)
+{
+  uint32 digits[CODESET_MAX_PEGS] = {0};
+  uint32 count = 0;
+  uint32 code;
+  uint32 i;
+
+  while (TRUE)
+  {
+    code = 0;
+    for (i = 0; i < pegs; i++)
+    {
+      code |= digits[i] << (i * 4);
+    } /* for i */
+    if (repeats || codeset_valid(code, pegs, colors, repeats))
+    {
+      codes[count++] = code;
+    } /* if */
+
+    // odometer increment
+    for (i = 0; i < pegs; i++)
+    {
+      if (++digits[i] < colors)
+      {
+        break;
+      } /* if no carry */
+      digits[i] = 0;
+    } /* for i */
+    if (i == pegs)
+    {
+      break;            // wrapped all the way around
+    } /* if */
+  } /* while */
+
+  return count;
+} /* codeset_fill */
+
+//-------------------------------------------------------------------------
+// NAME:        codeset_to_str
+//
+// DESCRIPTION: Converts a packed code to color letters, like to_colorstr.
+// ARGUMENTS:   uint32 code, packed code
+//              uint32 pegs, positions in the code
+//              char* str, receives pegs letters and a terminator
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void codeset_to_str(uint32 code, uint32 pegs, char* str)
+{
+  uint32 i;
+
+  for (i = 0; i < pegs; i++)
+  {
+    str[i] = CODESET_LETTERS[(code >> (i * 4)) & 0xF];
+  } /* for i */
+  str[pegs] = 0;
+} /* codeset_to_str */
+
+//-------------------------------------------------------------------------
+// NAME:        codeset_from_str
+//
+// DESCRIPTION: Parses color letters (either case) into a packed code.
+// ARGUMENTS:   const char* str, at least pegs letters
+//              uint32 pegs, uint32 colors, configuration
+//              uint32* code, receives the packed code
+// RETURNS:     int32, 0 on success, -1 on an invalid letter
+//-------------------------------------------------------------------------
+int32 codeset_from_str(const char* str, uint32 pegs, uint32 colors,
+                       uint32* code)
+{
+  uint32 result = 0;
+  uint32 color;
+  uint32 i;
+  char   letter;
+
+  for (i = 0; i < pegs; i++)
+  {
+    letter = str[i];
+    if (letter >= 'a' && letter <= 'z')
+    {
+      letter -= 0x20;
+    } /* if lower case */
+    for (color = 0; color < colors; color++)
+    {
+      if (CODESET_LETTERS[color] == letter)
+      {
+        break;
+      } /* if */
+    } /* for color */
+    if (color == colors)
+    {
+      return -1;
+    } /* if not found */
+    result |= color << (i * 4);
+  } /* for i */
+
+  *code = result;
+  return 0;
+} /* codeset_from_str */
@@ -0,0 +1,46 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  codeset.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for codeset.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_CODESET__H
+#define __LAB_7_CODESET__H
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_COLOR_LETTERS
+
+// Largest configuration a packed code can hold
+#define   CODESET_MAX_PEGS                8
+#define   CODESET_MAX_COLORS              16
+
+// Color letters; the game's come first
+#define   CODESET_LETTERS                 CB_COLOR_LETTERS "PKCMTVANSX"
+
+// Mask of the slots used by a code with the given number of pegs
+#define   CODESET_MASK(pegs)  (0xFFFFFFFF >> (32 - ((pegs) * 4)))
+
+// Prototypes for public functions
+uint64 codeset_count(uint32 pegs, uint32 colors, uint32 repeats);
+uint32 codeset_fill(uint32* codes, uint32 pegs, uint32 colors,
+                    uint32 repeats);
+uint32 codeset_valid(uint32 code, uint32 pegs, uint32 colors,
+                     uint32 repeats);
+void codeset_to_str(uint32 code, uint32 pegs, char* str);
+int32 codeset_from_str(const char* str, uint32 pegs, uint32 colors,
+                       uint32* code);
+
+#endif /* __LAB_7_CODESET__H */
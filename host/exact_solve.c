@@ -0,0 +1,1603 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  exact_solve.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Exact solver: finds the strategy with the fewest guesses summed over
+//    every code (the optimal average), and the fewest guesses for the
+//    worst code (the optimal worst case, and the fewest total guesses
+//    within it), by a full game-tree search.  gen_book only ranks a few
+//    guesses per node; this tries them all, and so proves its answers.
+//
+//    The search at a set of remaining codes tries every guess, plays it
+//    (its cost is the set's size, plus each feedback's subset solved in
+//    turn), and keeps the cheapest.  Most of that tree is redundant, and
+//    four things cut it down:
+//
+//    1. Symmetry.  Permuting the positions and renaming the colors of
+//       every code changes no feedback.  The symmetries that fix every
+//       guess made so far map the remaining set onto itself, so only one
+//       guess of each of their orbits needs trying.  Colors no guess has
+//       used yet are interchangeable, so the symmetries are kept as one
+//       position permutation and a map of the used colors each; there
+//       are never more than pegs! of them.
+//
+//    2. A transposition table.  A set's cost depends only on the guesses
+//       and feedback that led to it, in any order, and up to symmetry, so
+//       it is stored under the history's canonical form: the smallest,
+//       over position permutations and orders of the turns, of the turns
+//       sorted by feedback with the colors renamed in order of first
+//       appearance.  Keys are compared whole, so a hit is never wrong.
+//
+//    3. Branch and bound.  The cheapest any set of n codes can be solved
+//       in (below) bounds each guess before it is played and each subset
+//       before it is solved; a guess whose bound reaches the best so far
+//       is skipped, and a subset is searched only for a cost under what
+//       is left.  Guesses are tried best bound first.  A search that
+//       fails its bound stores that bound in the table as a lower bound.
+//
+//    4. Threads.  The subsets of the first guess, and every second guess
+//       in each, are split into tasks; each subset's best so far is the
+//       bound for the rest of its tasks.
+//
+//    The bound: a node of the strategy finds at most one code (the one it
+//    guesses), and has at most b children, b being the feedbacks other
+//    than a win that any pair gives.  So at most b^(d-1) codes are found
+//    by guess d, and filling each depth in turn gives the least possible
+//    total (and shows when a depth limit can't be met at all).
+//
+//    The worst case is found by searching again with a limit on the
+//    guesses, from the least the bound allows up to one under the
+//    average strategy's worst case, until one is met.
+//
+//    With -o the strategy is written as a tree, one node per line,
+//    indented two spaces per guess: the feedback that led to it as two
+//    digits (P then C, none for the first guess), then the guess.  Every
+//    strategy is checked by playing every code through it with
+//    score_one, and -V does the same for a strategy file, independently
+//    of the search.
+//
+//  USAGE
+//    exact_solve [-p pegs] [-c colors] [-r] [-j threads] [-m MiB] [-w]
+//                [-o file]
+//    exact_solve [-p pegs] [-c colors] [-r] -V file
+//      -p  positions per code (default CB_COLOR_LENGTH, at most 6)
+//      -c  colors (default CB_POSSIBLE_COLORS)
+//      -r  allow repeated colors
+//      -j  threads (default one per CPU)
+//      -m  transposition table size in MiB (default 256)
+//      -w  write the worst-case strategy (default the average one)
+//      -o  write the strategy here
+//      -V  check this strategy file
+//
+//  BUILDING
+//    gcc -O2 -Wall -pthread -Ibsp -I../nios -o exact_solve exact_solve.c
+//        score_batch.c codeset.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "codeset.h"
+#include "score_batch.h"
+
+// Limits
+#define   ES_MAX_PEGS                     6
+#define   ES_MAX_SYMS                     720   // ES_MAX_PEGS!
+#define   ES_MAX_CODES                    8192  // the feedback table is N^2
+#define   ES_MAX_DEPTH                    24    // guesses, and "no limit"
+#define   ES_MAX_BUCKETS                  SB_BUCKETS(ES_MAX_PEGS)
+#define   ES_MAX_THREADS                  64
+
+// No strategy (a depth limit can't be met)
+#define   ES_NONE                         0xFFFFFFFF
+
+// Transposition table: longest history kept, smallest set worth keeping,
+// entries per bucket, and locks
+#define   ES_KEY_TURNS                    8
+#define   ES_TT_MIN                       5
+#define   ES_TT_WAYS                      4
+#define   ES_LOCKS                        1024
+
+// Subsets of the first guess smaller than this aren't split into tasks
+#define   ES_TASK_MIN                     12
+
+// A symmetry that fixes every guess so far: position j moves to
+// perm[j], and each used color c becomes color[c] (0xFF if unused; the
+// unused colors may be renamed freely)
+typedef struct
+{
+  uint8   perm[ES_MAX_PEGS];
+  uint8   color[CODESET_MAX_COLORS];
+} _es_sym_t;
+
+// The symmetries left at one turn
+typedef struct
+{
+  uint32    count;
+  uint32    free_count;
+  uint8     free[CODESET_MAX_COLORS];   // unused colors, ascending
+  _es_sym_t sym[ES_MAX_SYMS];
+} _es_group_t;
+
+// A guess worth trying, and the least it can cost
+typedef struct
+{
+  uint32  lower;
+  uint16  guess;                      // code index
+  uint8   parts;
+  uint8   member;
+} _es_cand_t;
+
+// Transposition table entry; turns is 0 if it is empty
+typedef struct
+{
+  uint32  key[ES_KEY_TURNS];
+  uint32  value;
+  uint16  codes;                      // set size, to choose a victim
+  uint8   turns;
+  uint8   depth;                      // guesses allowed
+  uint8   exact;                      // else value is a lower bound
+  uint8   unused[3];
+} _es_entry_t;
+
+// Per-thread search state
+typedef struct
+{
+  pthread_t   thread;
+  uint16*     sets;                   // subsets, one level after another
+  uint32      sets_top;
+  _es_cand_t* cands;                  // candidate guesses, likewise
+  uint32      cands_top;
+  uint32      turns;
+  uint32      history[ES_MAX_DEPTH];  // feedback << 24 | guess
+  _es_group_t group[ES_MAX_DEPTH + 1];
+  uint64      nodes;
+  uint64      probes;
+  uint64      hits;
+  uint64      stores;
+} _es_ctx_t;
+
+// A subset of a first guess, solved by tasks
+typedef struct
+{
+  uint16*       set;
+  uint32        count;
+  uint32        history;
+  _es_group_t*  group;
+  uint32        best;
+} _es_child_t;
+
+// A second guess to play in one of those subsets
+typedef struct
+{
+  uint32  child;
+  uint32  guess;
+  uint32  lower;
+  uint32  rank;                       // among the subset's guesses
+} _es_task_t;
+
+// Strategy tree node; child[] holds node indices, or -1
+typedef struct
+{
+  uint32  guess;                      // packed
+  int32   child[ES_MAX_BUCKETS];
+} _es_node_t;
+
+// Configuration
+static uint32       _pegs;
+static uint32       _colors;
+static uint32       _repeats;
+static uint32       _threads;
+
+// Codes, their feedback, and the bounds
+static uint32*      _codes;
+static uint32       _count;
+static uint8*       _fb;              // _fb[guess * _count + code]
+static uint32       _win;             // the bucket of a right guess
+static uint32       _outcomes;        // other feedbacks any pair gives
+static uint32*      _lower;           // _lower[depth * (_count + 1) + n]
+static uint8        _perms[ES_MAX_SYMS][ES_MAX_PEGS];
+static uint32       _perm_count;
+
+// Transposition table
+static _es_entry_t* _table;
+static uint32       _table_mask;      // buckets - 1
+static pthread_mutex_t _locks[ES_LOCKS];
+
+// Threads and tasks
+static _es_ctx_t*   _ctx[ES_MAX_THREADS];
+static _es_child_t* _children;
+static uint32       _child_count;
+static _es_task_t*  _tasks;
+static uint32       _task_count;
+static uint32       _next_task;
+static uint32       _task_depth;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+// The strategy being emitted
+static _es_node_t*  _tree;
+static uint32       _tree_count;
+static uint32       _tree_size;
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _lower_bound
+//
+// DESCRIPTION: The least total guesses any strategy can solve n codes in
+//              with at most depth guesses each, or ES_NONE.
+//-------------------------------------------------------------------------
+static uint32 _lower_bound(uint32 n, uint32 depth)
+{
+  return _lower[depth * (_count + 1) + n];
+} /* _lower_bound */
+
+static void _lower_init()
+{
+  uint64 width;
+  uint32 left, take, total;
+  uint32 depth, n, d;
+
+  _lower = malloc((ES_MAX_DEPTH + 1) * (_count + 1) * sizeof(uint32));
+  for (depth = 0; depth <= ES_MAX_DEPTH; depth++)
+  {
+    for (n = 0; n <= _count; n++)
+    {
+      // fill each depth with as many codes as it can find
+      left  = n;
+      total = 0;
+      width = 1;
+      for (d = 1; d <= depth && 0 != left; d++)
+      {
+        take   = (width < left) ? (uint32)width : left;
+        total += d * take;
+        left  -= take;
+        width  = (width * _outcomes < _count) ? width * _outcomes : _count;
+      } /* for d */
+      _lower[depth * (_count + 1) + n] = (0 == left) ? total : ES_NONE;
+    } /* for n */
+  } /* for depth */
+} /* _lower_init */
+
+//-------------------------------------------------------------------------
+// NAME:        _group_*
+//
+// DESCRIPTION: The symmetries of the empty history, and those of a
+//              history that also fix its next guess.
+//-------------------------------------------------------------------------
+static void _group_free(_es_group_t* group, uint32 used)
+{
+  uint32 c;
+
+  group->free_count = 0;
+  for (c = 0; c < _colors; c++)
+  {
+    if (0 == (used & (1 << c)))
+    {
+      group->free[group->free_count++] = c;
+    } /* if */
+  } /* for c */
+} /* _group_free */
+
+static void _group_root(_es_group_t* group)
+{
+  uint32 s;
+
+  for (s = 0; s < _perm_count; s++)
+  {
+    memcpy(group->sym[s].perm, _perms[s], ES_MAX_PEGS);
+    memset(group->sym[s].color, 0xFF, CODESET_MAX_COLORS);
+  } /* for s */
+  group->count = _perm_count;
+  _group_free(group, 0);
+} /* _group_root */
+
+static void _group_fix(const _es_group_t* parent, uint32 guess,
+                       _es_group_t* group)
+{
+  const _es_sym_t* sym;
+  uint32           used = 0;
+  uint32           images;
+  uint32           c, target;
+  uint32           s, j, ok;
+
+  for (c = 0; c < _colors; c++)
+  {
+    used |= (0xFF != parent->sym[0].color[c]) << c;
+  } /* for c */
+
+  group->count = 0;
+  for (s = 0; s < parent->count; s++)
+  {
+    sym    = &parent->sym[s];
+    images = 0;
+    ok     = TRUE;
+    group->sym[group->count] = *sym;
+    for (j = 0; j < _pegs && ok; j++)
+    {
+      // the color at j must become the guess's color where j goes
+      c      = (guess >> (j * 4)) & 0xF;
+      target = (guess >> (sym->perm[j] * 4)) & 0xF;
+      if (0xFF == group->sym[group->count].color[c])
+      {
+        // a new color, renamed to another new one, one to one
+        ok = (0 == (used & (1 << target)) && 0 == (images & (1 << target)));
+        group->sym[group->count].color[c] = target;
+        images |= 1 << target;
+      } /* if */
+      else
+      {
+        ok = (group->sym[group->count].color[c] == target);
+      } /* else */
+    } /* for j */
+    group->count += ok;
+  } /* for s */
+
+  for (j = 0; j < _pegs; j++)
+  {
+    used |= 1 << ((guess >> (j * 4)) & 0xF);
+  } /* for j */
+  _group_free(group, used);
+} /* _group_fix */
+
+//-------------------------------------------------------------------------
+// NAME:        _orbit_min
+//
+// DESCRIPTION: The smallest code a group's symmetries map a code to.  A
+//              code that is its own is the one of its orbit to try.
+//-------------------------------------------------------------------------
+static uint32 _orbit_min(const _es_group_t* group, uint32 code)
+{
+  const _es_sym_t* sym;
+  uint8            moved[ES_MAX_PEGS];
+  uint8            name[CODESET_MAX_COLORS];
+  uint32           best = 0xFFFFFFFF;
+  uint32           mapped, next, c;
+  uint32           s, j;
+  int32            i;
+
+  for (s = 0; s < group->count; s++)
+  {
+    sym = &group->sym[s];
+    for (j = 0; j < _pegs; j++)
+    {
+      c = (code >> (j * 4)) & 0xF;
+      moved[sym->perm[j]] = c;
+    } /* for j */
+
+    // used colors as mapped; unused ones take the smallest unused names
+    // in order of appearance, most significant position first
+    memset(name, 0xFF, sizeof(name));
+    mapped = 0;
+    next   = 0;
+    for (i = _pegs - 1; i >= 0; i--)
+    {
+      c = moved[i];
+      if (0xFF != sym->color[c])
+      {
+        c = sym->color[c];
+      } /* if */
+      else
+      {
+        if (0xFF == name[c])
+        {
+          name[c] = group->free[next++];
+        } /* if */
+        c = name[c];
+      } /* else */
+      mapped |= c << (i * 4);
+    } /* for i */
+    best = (mapped < best) ? mapped : best;
+  } /* for s */
+
+  return best;
+} /* _orbit_min */
+
+//-------------------------------------------------------------------------
+// NAME:        _canon
+//
+// DESCRIPTION: The canonical form of a history: for each position
+//              permutation, the turns are taken smallest feedback first
+//              (trying each order of equal feedbacks), with the colors
+//              renamed in order of first appearance, and the smallest
+//              resulting sequence is kept.  A depth-first walk over the
+//              orders drops a branch as soon as it is larger.
+//-------------------------------------------------------------------------
+typedef struct
+{
+  const uint32* history;
+  uint32        turns;
+  const uint8*  perm;
+  uint32        best[ES_KEY_TURNS];
+  uint32        valid;                // turns of best that are set
+} _es_canon_t;
+
+static uint32 _canon_word(uint32 code, const uint8* perm, uint8* name,
+                          uint32* next)
+{
+  uint8  moved[ES_MAX_PEGS];
+  uint32 word = 0;
+  uint32 c, j;
+  int32  i;
+
+  for (j = 0; j < _pegs; j++)
+  {
+    moved[perm[j]] = (code >> (j * 4)) & 0xF;
+  } /* for j */
+  for (i = _pegs - 1; i >= 0; i--)
+  {
+    c = moved[i];
+    if (0xFF == name[c])
+    {
+      name[c] = (*next)++;
+    } /* if */
+    word |= name[c] << (i * 4);
+  } /* for i */
+
+  return word;
+} /* _canon_word */
+
+static void _canon_walk(_es_canon_t* canon, uint32 level, uint32 taken,
+                        const uint8* name, uint32 next)
+{
+  uint8  renamed[CODESET_MAX_COLORS];
+  uint32 low = 0xFF;
+  uint32 later, word, f, i;
+
+  if (level == canon->turns)
+  {
+    return;
+  } /* if */
+
+  for (i = 0; i < canon->turns; i++)
+  {
+    f = canon->history[i] >> 24;
+    if (0 == (taken & (1 << i)) && f < low)
+    {
+      low = f;
+    } /* if */
+  } /* for i */
+
+  for (i = 0; i < canon->turns; i++)
+  {
+    if (0 != (taken & (1 << i)) || (canon->history[i] >> 24) != low)
+    {
+      continue;
+    } /* if */
+    memcpy(renamed, name, sizeof(renamed));
+    later = next;
+    word  = (low << 24) | _canon_word(canon->history[i] & 0xFFFFFF,
+                                      canon->perm, renamed, &later);
+    if (level < canon->valid)
+    {
+      if (word > canon->best[level])
+      {
+        continue;             // larger already
+      } /* if */
+      if (word < canon->best[level])
+      {
+        canon->best[level] = word;
+        canon->valid       = level + 1;
+      } /* if */
+    } /* if */
+    else
+    {
+      canon->best[level] = word;
+      canon->valid       = level + 1;
+    } /* else */
+    _canon_walk(canon, level + 1, taken | (1 << i), renamed, later);
+  } /* for i */
+} /* _canon_walk */
+
+static void _canon(const uint32* history, uint32 turns, uint32* key)
+{
+  _es_canon_t canon;
+  uint8       name[CODESET_MAX_COLORS];
+  uint32      s;
+
+  canon.history = history;
+  canon.turns   = turns;
+  canon.valid   = 0;
+  memset(name, 0xFF, sizeof(name));
+  for (s = 0; s < _perm_count; s++)
+  {
+    canon.perm = _perms[s];
+    _canon_walk(&canon, 0, 0, name, 0);
+  } /* for s */
+  memcpy(key, canon.best, turns * sizeof(uint32));
+} /* _canon */
+
+//-------------------------------------------------------------------------
+// NAME:        _tt_*
+//
+// DESCRIPTION: Transposition table: a bucket of ES_TT_WAYS entries per
+//              hash, each under one of ES_LOCKS locks.  A full bucket
+//              gives up the entry for the smallest set.
+//-------------------------------------------------------------------------
+static void _tt_init(uint32 megabytes)
+{
+  uint64 buckets = ((uint64)megabytes << 20) /
+                   (ES_TT_WAYS * sizeof(_es_entry_t));
+  uint32 i;
+
+  while (0 != (buckets & (buckets - 1)))
+  {
+    buckets &= buckets - 1;   // down to a power of two
+  } /* while */
+  _table_mask = (uint32)buckets - 1;
+  _table = calloc(buckets * ES_TT_WAYS, sizeof(_es_entry_t));
+  for (i = 0; i < ES_LOCKS; i++)
+  {
+    pthread_mutex_init(&_locks[i], NULL);
+  } /* for i */
+} /* _tt_init */
+
+static uint32 _tt_bucket(const uint32* key, uint32 turns, uint32 depth)
+{
+  uint64 hash = (turns << 8) | depth;
+  uint32 i;
+
+  for (i = 0; i < turns; i++)
+  {
+    hash = (hash ^ key[i]) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+  } /* for i */
+  return (uint32)(hash >> 32) & _table_mask;
+} /* _tt_bucket */
+
+static uint32 _tt_probe(const uint32* key, uint32 turns, uint32 depth,
+                        uint32* value, uint32* exact)
+{
+  uint32       bucket = _tt_bucket(key, turns, depth);
+  _es_entry_t* entry  = &_table[bucket * ES_TT_WAYS];
+  uint32       found  = FALSE;
+  uint32       w;
+
+  pthread_mutex_lock(&_locks[bucket & (ES_LOCKS - 1)]);
+  for (w = 0; w < ES_TT_WAYS && !found; w++, entry++)
+  {
+    if (entry->turns == turns + 1 && entry->depth == depth &&
+        0 == memcmp(entry->key, key, turns * sizeof(uint32)))
+    {
+      *value = entry->value;
+      *exact = entry->exact;
+      found  = TRUE;
+    } /* if */
+  } /* for w */
+  pthread_mutex_unlock(&_locks[bucket & (ES_LOCKS - 1)]);
+
+  return found;
+} /* _tt_probe */
+
+static void _tt_store(const uint32* key, uint32 turns, uint32 depth,
+                      uint32 codes, uint32 value, uint32 exact)
+{
+  uint32       bucket = _tt_bucket(key, turns, depth);
+  _es_entry_t* entry  = &_table[bucket * ES_TT_WAYS];
+  _es_entry_t* victim = entry;
+  uint32       w;
+
+  pthread_mutex_lock(&_locks[bucket & (ES_LOCKS - 1)]);
+  for (w = 0; w < ES_TT_WAYS; w++, entry++)
+  {
+    if (entry->turns == turns + 1 && entry->depth == depth &&
+        0 == memcmp(entry->key, key, turns * sizeof(uint32)))
+    {
+      victim = entry;
+      break;                  // the same set, better known now
+    } /* if */
+    if (0 == entry->turns ||
+        (0 != victim->turns && entry->codes < victim->codes))
+    {
+      victim = entry;
+    } /* if */
+  } /* for w */
+  memcpy(victim->key, key, turns * sizeof(uint32));
+  victim->value = value;
+  victim->codes = (uint16)codes;
+  victim->turns = (uint8)(turns + 1);
+  victim->depth = (uint8)depth;
+  victim->exact = (uint8)exact;
+  pthread_mutex_unlock(&_locks[bucket & (ES_LOCKS - 1)]);
+} /* _tt_store */
+
+//-------------------------------------------------------------------------
+// NAME:        _split
+//
+// DESCRIPTION: Splits a set by its feedback to a guess, into space taken
+//              from the thread's arena (a counting sort, to keep the
+//              order), and sets up the symmetries of the next turn.
+// RETURNS:     uint16*, the subsets, start[f] apart
+//-------------------------------------------------------------------------
+static uint16* _split(_es_ctx_t* ctx, const uint16* set, uint32 n,
+                      uint32 guess, uint32* start)
+{
+  const uint8* row = _fb + (uint64)guess * _count;
+  uint16*      parts = ctx->sets + ctx->sets_top;
+  uint32       fill[ES_MAX_BUCKETS];
+  uint32       i, f;
+
+  memset(start, 0, (ES_MAX_BUCKETS + 1) * sizeof(uint32));
+  for (i = 0; i < n; i++)
+  {
+    start[row[set[i]] + 1]++;
+  } /* for i */
+  for (f = 0; f < ES_MAX_BUCKETS; f++)
+  {
+    start[f + 1] += start[f];
+    fill[f]       = start[f];
+  } /* for f */
+  for (i = 0; i < n; i++)
+  {
+    parts[fill[row[set[i]]]++] = set[i];
+  } /* for i */
+  ctx->sets_top += n;
+
+  _group_fix(&ctx->group[ctx->turns], _codes[guess],
+             &ctx->group[ctx->turns + 1]);
+  return parts;
+} /* _split */
+
+//-------------------------------------------------------------------------
+// NAME:        _candidates
+//
+// DESCRIPTION: Lists the guesses worth trying on a set, one per orbit of
+//              the turn's symmetries, with the least each can cost, best
+//              first, into space taken from the thread's arena.  Guesses
+//              that can't get under the bound, and guesses that don't
+//              split the set and can't be the code, are left out.
+// RETURNS:     uint32, guesses listed
+//-------------------------------------------------------------------------
+static int _cand_order(const void* a, const void* b)
+{
+  const _es_cand_t* x = a;
+  const _es_cand_t* y = b;
+
+  if (x->lower != y->lower)
+  {
+    return (x->lower < y->lower) ? -1 : 1;
+  } /* if */
+  if (x->parts != y->parts)
+  {
+    return (x->parts > y->parts) ? -1 : 1;
+  } /* if */
+  if (x->member != y->member)
+  {
+    return x->member ? -1 : 1;
+  } /* if */
+  return (int)x->guess - (int)y->guess;
+} /* _cand_order */
+
+static uint32 _candidates(_es_ctx_t* ctx, const uint16* set, uint32 n,
+                          uint32 depth, uint32 bound, _es_cand_t* cands)
+{
+  const _es_group_t* group = &ctx->group[ctx->turns];
+  const uint8*       row;
+  uint32             sizes[ES_MAX_BUCKETS];
+  uint32             count = 0;
+  uint32             lower, sub, parts;
+  uint32             g, i, f;
+
+  for (g = 0; g < _count; g++)
+  {
+    if (_orbit_min(group, _codes[g]) != _codes[g])
+    {
+      continue;               // another guess stands for it
+    } /* if */
+
+    memset(sizes, 0, sizeof(sizes));
+    row = _fb + (uint64)g * _count;
+    for (i = 0; i < n; i++)
+    {
+      sizes[row[set[i]]]++;
+    } /* for i */
+
+    parts = 0;
+    lower = n;
+    for (f = 0; f < ES_MAX_BUCKETS && lower < bound; f++)
+    {
+      if (0 == sizes[f])
+      {
+        continue;
+      } /* if */
+      parts++;
+      if (f != _win)
+      {
+        sub    = _lower_bound(sizes[f], depth - 1);
+        lower  = (ES_NONE == sub) ? ES_NONE : lower + sub;
+      } /* if */
+    } /* for f */
+    if (lower >= bound || (1 == parts && 0 == sizes[_win]))
+    {
+      continue;
+    } /* if */
+
+    cands[count].lower  = lower;
+    cands[count].guess  = (uint16)g;
+    cands[count].parts  = (uint8)parts;
+    cands[count].member = (0 != sizes[_win]);
+    count++;
+  } /* for g */
+
+  qsort(cands, count, sizeof(_es_cand_t), _cand_order);
+  return count;
+} /* _candidates */
+
+//-------------------------------------------------------------------------
+// NAME:        _solve, _search, _play
+//
+// DESCRIPTION: The search.  _solve finds the least total guesses that
+//              solve a set with at most depth guesses each, through the
+//              transposition table; _search does the work, trying each
+//              guess; _play finds one guess's cost.  Each is given a
+//              bound: a result under it is exact, and any other result is
+//              the bound itself, meaning the cost is at least that.
+//              ES_NONE means no strategy meets the depth.  The thread's
+//              history and symmetries describe the set.
+// ARGUMENTS:   _es_ctx_t* ctx, the thread
+//              const uint16* set, uint32 n, the remaining codes
+//              uint32 depth, guesses allowed
+//              uint32 bound, as above
+//              uint32* guess (_search), receives the best guess, if any
+//              uint32 guess (_play), the guess to play
+// RETURNS:     uint32, total guesses, as above
+//-------------------------------------------------------------------------
+static uint32 _solve(_es_ctx_t* ctx, const uint16* set, uint32 n,
+                     uint32 depth, uint32 bound);
+
+static uint32 _play(_es_ctx_t* ctx, const uint16* set, uint32 n,
+                    uint32 guess, uint32 depth, uint32 bound)
+{
+  uint16* parts;
+  uint32  start[ES_MAX_BUCKETS + 1];
+  uint32  lower[ES_MAX_BUCKETS];
+  uint32  order[ES_MAX_BUCKETS];
+  uint32  count = 0;
+  uint32  total = n;          // every code spends this guess
+  uint32  size, value, f, i;
+
+  parts = _split(ctx, set, n, guess, start);
+  for (f = 0; f < ES_MAX_BUCKETS && total < bound; f++)
+  {
+    size = start[f + 1] - start[f];
+    if (0 == size || f == _win)
+    {
+      continue;
+    } /* if */
+    lower[f] = _lower_bound(size, depth - 1);
+    total    = (ES_NONE == lower[f]) ? ES_NONE : total + lower[f];
+
+    // largest first: they are likeliest to break the bound
+    for (i = count; i > 0 && start[order[i - 1] + 1] - start[order[i - 1]] <
+                             size; i--)
+    {
+      order[i] = order[i - 1];
+    } /* for i */
+    order[i] = f;
+    count++;
+  } /* for f */
+
+  for (i = 0; i < count && total < bound; i++)
+  {
+    f = order[i];
+    ctx->history[ctx->turns++] = (f << 24) | _codes[guess];
+    total -= lower[f];
+    value  = _solve(ctx, parts + start[f], start[f + 1] - start[f],
+                    depth - 1, bound - total);
+    total  = (value >= bound - total) ? bound : total + value;
+    ctx->turns--;
+  } /* for i */
+
+  ctx->sets_top -= n;
+  return (total < bound) ? total : bound;
+} /* _play */
+
+static uint32 _search(_es_ctx_t* ctx, const uint16* set, uint32 n,
+                      uint32 depth, uint32 bound, uint32* guess)
+{
+  _es_cand_t* cands;
+  uint8       seen[ES_MAX_BUCKETS];
+  uint32      count, value, f;
+  uint32      best = bound;
+  uint32      i, j;
+
+  ctx->nodes++;
+  if (1 == n)
+  {
+    *guess = set[0];
+    return (1 < bound) ? 1 : bound;
+  } /* if */
+
+  // a code that tells all the others apart can't be beaten
+  if (2 * n - 1 == _lower_bound(n, depth))
+  {
+    for (i = 0; i < n; i++)
+    {
+      memset(seen, 0, sizeof(seen));
+      for (j = 0; j < n; j++)
+      {
+        f = _fb[(uint64)set[i] * _count + set[j]];
+        if (0 != seen[f])
+        {
+          break;
+        } /* if */
+        seen[f] = 1;
+      } /* for j */
+      if (j == n)
+      {
+        *guess = set[i];
+        return (2 * n - 1 < bound) ? 2 * n - 1 : bound;
+      } /* if */
+    } /* for i */
+  } /* if */
+
+  cands = ctx->cands + ctx->cands_top;
+  count = _candidates(ctx, set, n, depth, bound, cands);
+  ctx->cands_top += _count;
+  for (i = 0; i < count && cands[i].lower < best; i++)
+  {
+    value = _play(ctx, set, n, cands[i].guess, depth, best);
+    if (value < best)
+    {
+      best   = value;
+      *guess = cands[i].guess;
+    } /* if */
+  } /* for i */
+  ctx->cands_top -= _count;
+
+  return best;
+} /* _search */
+
+static uint32 _solve(_es_ctx_t* ctx, const uint16* set, uint32 n,
+                     uint32 depth, uint32 bound)
+{
+  uint32 key[ES_KEY_TURNS];
+  uint32 keep, value, exact;
+  uint32 guess;
+
+  if (_lower_bound(n, depth) >= bound)
+  {
+    return bound;
+  } /* if */
+  if (1 == n)
+  {
+    return 1;
+  } /* if */
+
+  keep = (n >= ES_TT_MIN && ctx->turns <= ES_KEY_TURNS);
+  if (keep)
+  {
+    _canon(ctx->history, ctx->turns, key);
+    ctx->probes++;
+    if (_tt_probe(key, ctx->turns, depth, &value, &exact))
+    {
+      if (exact || value >= bound)
+      {
+        ctx->hits++;
+        return (value < bound) ? value : bound;
+      } /* if */
+    } /* if */
+  } /* if */
+
+  value = _search(ctx, set, n, depth, bound, &guess);
+  if (keep)
+  {
+    ctx->stores++;
+    _tt_store(key, ctx->turns, depth, n, value, value < bound);
+  } /* if */
+
+  return value;
+} /* _solve */
+
+//-------------------------------------------------------------------------
+// NAME:        _worker
+//
+// DESCRIPTION: Thread body: plays second guesses until none are left.
+//-------------------------------------------------------------------------
+static void* _worker(void* arg)
+{
+  _es_ctx_t*    ctx = arg;
+  _es_task_t*   task;
+  _es_child_t*  child;
+  uint32        bound, value;
+
+  for (;;)
+  {
+    pthread_mutex_lock(&_lock);
+    task  = (_next_task < _task_count) ? &_tasks[_next_task++] : NULL;
+    child = (NULL != task) ? &_children[task->child] : NULL;
+    bound = (NULL != task) ? child->best : 0;
+    pthread_mutex_unlock(&_lock);
+    if (NULL == task)
+    {
+      break;
+    } /* if */
+    if (task->lower >= bound)
+    {
+      continue;
+    } /* if */
+
+    ctx->turns      = 1;
+    ctx->history[0] = child->history;
+    ctx->group[1].count      = child->group->count;
+    ctx->group[1].free_count = child->group->free_count;
+    memcpy(ctx->group[1].free, child->group->free, CODESET_MAX_COLORS);
+    memcpy(ctx->group[1].sym, child->group->sym,
+           child->group->count * sizeof(_es_sym_t));
+    value = _play(ctx, child->set, child->count, task->guess, _task_depth,
+                  bound);
+
+    pthread_mutex_lock(&_lock);
+    if (value < child->best)
+    {
+      child->best = value;
+    } /* if */
+    pthread_mutex_unlock(&_lock);
+  } /* for */
+
+  return NULL;
+} /* _worker */
+
+//-------------------------------------------------------------------------
+// NAME:        _solve_root
+//
+// DESCRIPTION: Solves the whole code set with at most depth guesses per
+//              code.  Every subset of every first guess is solved
+//              exactly, small ones here and the rest by the threads, and
+//              stored in the table; the first guess is then chosen by the
+//              ordinary search, which finds them there.
+// RETURNS:     uint32, total guesses, or ES_NONE
+//-------------------------------------------------------------------------
+static int _task_order(const void* a, const void* b)
+{
+  const _es_task_t* x = a;
+  const _es_task_t* y = b;
+
+  // each subset's likeliest guesses first, to set its bound early; then
+  // the biggest subsets
+  if (x->rank != y->rank)
+  {
+    return (x->rank < y->rank) ? -1 : 1;
+  } /* if */
+  if (_children[x->child].count != _children[y->child].count)
+  {
+    return (_children[x->child].count > _children[y->child].count) ? -1 : 1;
+  } /* if */
+  return (x->child < y->child) ? -1 : 1;
+} /* _task_order */
+
+static uint32 _solve_root(uint16* all, uint32 depth)
+{
+  _es_ctx_t*    ctx = _ctx[0];
+  _es_cand_t*   roots;
+  _es_cand_t*   cands;
+  _es_group_t*  groups;
+  _es_child_t*  child;
+  uint16*       parts;
+  uint32        start[ES_MAX_BUCKETS + 1];
+  uint32        key[ES_KEY_TURNS];
+  uint32        root_count, count, size;
+  uint32        value, guess;
+  uint32        r, f, i, t;
+
+  ctx->turns     = 0;
+  ctx->sets_top  = 0;
+  ctx->cands_top = 0;
+  _group_root(&ctx->group[0]);
+  roots = malloc(_count * sizeof(_es_cand_t));
+  root_count = _candidates(ctx, all, _count, depth, ES_NONE, roots);
+  groups = malloc(root_count * sizeof(_es_group_t));
+  _children    = malloc(root_count * ES_MAX_BUCKETS * sizeof(_es_child_t));
+  _child_count = 0;
+  _tasks       = NULL;
+  _task_count  = 0;
+
+  // the subsets of each first guess, and the second guesses to try
+  for (r = 0; r < root_count; r++)
+  {
+    parts = _split(ctx, all, _count, roots[r].guess, start);
+    groups[r] = ctx->group[1];
+    for (f = 0; f < ES_MAX_BUCKETS; f++)
+    {
+      size = start[f + 1] - start[f];
+      if (0 == size || f == _win)
+      {
+        continue;
+      } /* if */
+      child          = &_children[_child_count++];
+      child->set     = malloc(size * sizeof(uint16));
+      child->count   = size;
+      child->history = (f << 24) | _codes[roots[r].guess];
+      child->group   = &groups[r];
+      child->best    = ES_NONE;
+      memcpy(child->set, parts + start[f], size * sizeof(uint16));
+
+      ctx->history[ctx->turns++] = child->history;
+      if (size < ES_TASK_MIN || depth < 2)
+      {
+        child->best = _solve(ctx, child->set, size, depth - 1, ES_NONE);
+      } /* if small */
+      else
+      {
+        cands = ctx->cands + ctx->cands_top;
+        count = _candidates(ctx, child->set, size, depth - 1, ES_NONE,
+                            cands);
+        _tasks = realloc(_tasks, (_task_count + count) * sizeof(_es_task_t));
+        for (i = 0; i < count; i++)
+        {
+          _tasks[_task_count].child = _child_count - 1;
+          _tasks[_task_count].guess = cands[i].guess;
+          _tasks[_task_count].lower = cands[i].lower;
+          _tasks[_task_count].rank  = i;
+          _task_count++;
+        } /* for i */
+      } /* else */
+      ctx->turns--;
+    } /* for f */
+    ctx->sets_top -= _count;
+  } /* for r */
+
+  qsort(_tasks, _task_count, sizeof(_es_task_t), _task_order);
+  _next_task  = 0;
+  _task_depth = depth - 1;
+  for (t = 0; t < _threads; t++)
+  {
+    _ctx[t]->sets_top  = 0;
+    _ctx[t]->cands_top = 0;
+    pthread_create(&_ctx[t]->thread, NULL, _worker, _ctx[t]);
+  } /* for t */
+  for (t = 0; t < _threads; t++)
+  {
+    pthread_join(_ctx[t]->thread, NULL);
+  } /* for t */
+
+  // every subset is known exactly now; keep them where the search looks
+  for (i = 0; i < _child_count; i++)
+  {
+    child           = &_children[i];
+    ctx->history[0] = child->history;
+    if (child->count >= ES_TT_MIN)
+    {
+      _canon(ctx->history, 1, key);
+      _tt_store(key, 1, depth - 1, child->count, child->best, TRUE);
+    } /* if */
+    free(child->set);
+  } /* for i */
+
+  ctx->turns     = 0;
+  ctx->sets_top  = 0;
+  ctx->cands_top = 0;
+  value = _search(ctx, all, _count, depth, ES_NONE, &guess);
+
+  free(_tasks);
+  free(_children);
+  free(groups);
+  free(roots);
+  return value;
+} /* _solve_root */
+
+//-------------------------------------------------------------------------
+// NAME:        _emit
+//
+// DESCRIPTION: Builds the strategy tree for a set whose cost is known,
+//              choosing at each node a guess that meets it.
+// RETURNS:     int32, the node
+//-------------------------------------------------------------------------
+static int32 _emit(_es_ctx_t* ctx, const uint16* set, uint32 n,
+                   uint32 depth, uint32 value)
+{
+  uint16* parts;
+  uint32  start[ES_MAX_BUCKETS + 1];
+  uint32  guess = set[0];
+  uint32  node, size, sub, f;
+  int32   child;
+
+  if (_tree_count == _tree_size)
+  {
+    _tree_size = 2 * _tree_size + 64;
+    _tree = realloc(_tree, _tree_size * sizeof(_es_node_t));
+  } /* if */
+  node = _tree_count++;
+  memset(_tree[node].child, 0xFF, sizeof(_tree[node].child));
+
+  if (n > 1 && value != _search(ctx, set, n, depth, value + 1, &guess))
+  {
+    fprintf(stderr, "exact_solve: no guess meets the cost\n");
+    exit(1);
+  } /* if */
+  _tree[node].guess = _codes[guess];
+  if (1 == n)
+  {
+    return (int32)node;
+  } /* if */
+
+  parts = _split(ctx, set, n, guess, start);
+  for (f = 0; f < ES_MAX_BUCKETS; f++)
+  {
+    size = start[f + 1] - start[f];
+    if (0 == size || f == _win)
+    {
+      continue;
+    } /* if */
+    ctx->history[ctx->turns++] = (f << 24) | _codes[guess];
+    sub   = _solve(ctx, parts + start[f], size, depth - 1, ES_NONE);
+    child = _emit(ctx, parts + start[f], size, depth - 1, sub);
+    _tree[node].child[f] = child;
+    ctx->turns--;
+  } /* for f */
+  ctx->sets_top -= n;
+
+  return (int32)node;
+} /* _emit */
+
+//-------------------------------------------------------------------------
+// NAME:        _check
+//
+// DESCRIPTION: Plays every code through a strategy tree, scoring with
+//              score_one rather than the search's feedback table.
+// RETURNS:     uint32, codes the strategy doesn't solve
+//-------------------------------------------------------------------------
+static uint32 _check(const _es_node_t* tree, uint32 nodes, uint32* total,
+                     uint32* worst)
+{
+  uint32 failed = 0;
+  uint32 turn, b, i;
+  int32  node;
+
+  *total = 0;
+  *worst = 0;
+  for (i = 0; i < _count; i++)
+  {
+    node = (0 != nodes) ? 0 : -1;
+    for (turn = 1; turn <= ES_MAX_DEPTH && node >= 0; turn++)
+    {
+      b = score_one(_codes[i], tree[node].guess, _pegs);
+      if (b == _win)
+      {
+        break;
+      } /* if */
+      node = tree[node].child[b];
+    } /* for turn */
+    if (node < 0 || turn > ES_MAX_DEPTH)
+    {
+      failed++;
+      continue;
+    } /* if */
+    *total += turn;
+    *worst  = (turn > *worst) ? turn : *worst;
+  } /* for i */
+
+  return failed;
+} /* _check */
+
+//-------------------------------------------------------------------------
+// NAME:        _write_tree, _read_tree
+//
+// DESCRIPTION: A strategy tree as text, in the format described above.
+//-------------------------------------------------------------------------
+static void _write_node(FILE* out, uint32 node, uint32 level, uint32 f)
+{
+  char   str[CODESET_MAX_PEGS + 1];
+  uint32 i;
+
+  for (i = 0; i < level; i++)
+  {
+    fputs("  ", out);
+  } /* for i */
+  if (0 != level)
+  {
+    fprintf(out, "%u%u ", SB_BUCKET_P(f, _pegs), SB_BUCKET_C(f, _pegs));
+  } /* if */
+  codeset_to_str(_tree[node].guess, _pegs, str);
+  fprintf(out, "%s\n", str);
+
+  for (f = 0; f < ES_MAX_BUCKETS; f++)
+  {
+    if (_tree[node].child[f] >= 0)
+    {
+      _write_node(out, _tree[node].child[f], level + 1, f);
+    } /* if */
+  } /* for f */
+} /* _write_node */
+
+static int _write_tree(const char* path, const char* comment)
+{
+  FILE* out = fopen(path, "w");
+
+  if (NULL == out)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+  fprintf(out, "# %u pegs, %u colors, %s\n# %s\n", _pegs, _colors,
+          _repeats ? "repeats" : "no repeats", comment);
+  _write_node(out, 0, 0, 0);
+  if (0 != fclose(out))
+  {
+    fprintf(stderr, "%s: write failed\n", path);
+    return -1;
+  } /* if */
+  return 0;
+} /* _write_tree */
+
+static int _read_tree(const char* path)
+{
+  char   line[256];
+  int32  parent[ES_MAX_DEPTH + 2];
+  uint32 number = 0;
+  uint32 level, p, c, code;
+  char*  text;
+  FILE*  in = fopen(path, "r");
+
+  if (NULL == in)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+  _tree_count = 0;
+  parent[0]   = -1;
+  while (NULL != fgets(line, sizeof(line), in))
+  {
+    number++;
+    if ('#' == line[0] || '\n' == line[0])
+    {
+      continue;
+    } /* if */
+    for (text = line; ' ' == *text; text++)
+    {
+    } /* for */
+    level = (uint32)(text - line) / 2;
+    p = c = 0;
+    if ((0 == level) != (0 == _tree_count) || level > ES_MAX_DEPTH ||
+        (0 != level && (text[0] < '0' || text[0] > '0' + (char)_pegs ||
+                        text[1] < '0' || text[1] > '0' + (char)_pegs ||
+                        ' ' != text[2])))
+    {
+      break;
+    } /* if bad indent or feedback */
+    if (0 != level)
+    {
+      p     = text[0] - '0';
+      c     = text[1] - '0';
+      text += 3;
+    } /* if */
+    if (0 != codeset_from_str(text, _pegs, _colors, &code) ||
+        !codeset_valid(code, _pegs, _colors, _repeats) ||
+        (0 != level && (parent[level - 1] < 0 ||
+                        _tree[parent[level - 1]].child[SB_BUCKET(p, c,
+                        _pegs)] >= 0)))
+    {
+      break;
+    } /* if bad guess, or no parent */
+
+    if (_tree_count == _tree_size)
+    {
+      _tree_size = 2 * _tree_size + 64;
+      _tree = realloc(_tree, _tree_size * sizeof(_es_node_t));
+    } /* if */
+    _tree[_tree_count].guess = code;
+    memset(_tree[_tree_count].child, 0xFF, sizeof(_tree[0].child));
+    if (0 != level)
+    {
+      _tree[parent[level - 1]].child[SB_BUCKET(p, c, _pegs)] =
+        (int32)_tree_count;
+    } /* if */
+    parent[level]     = (int32)_tree_count;
+    parent[level + 1] = -1;
+    _tree_count++;
+  } /* while */
+
+  if (!feof(in))
+  {
+    fprintf(stderr, "%s:%u: bad line\n", path, number);
+    fclose(in);
+    return -1;
+  } /* if */
+  fclose(in);
+  return 0;
+} /* _read_tree */
+
+//-------------------------------------------------------------------------
+// NAME:        _strategy
+//
+// DESCRIPTION: Emits the strategy for a depth limit whose cost is known,
+//              checks it, and reports it.
+// RETURNS:     uint32, its worst case
+//-------------------------------------------------------------------------
+static uint32 _strategy(uint16* all, uint32 depth, uint32 value,
+                        const char* name)
+{
+  uint32 total, worst, failed;
+
+  _ctx[0]->turns     = 0;
+  _ctx[0]->sets_top  = 0;
+  _ctx[0]->cands_top = 0;
+  _group_root(&_ctx[0]->group[0]);
+  _tree_count = 0;
+  _emit(_ctx[0], all, _count, depth, value);
+  failed = _check(_tree, _tree_count, &total, &worst);
+  printf("%-9s %u nodes; checked: %u codes unsolved, %u guesses, "
+         "worst case %u\n", name, _tree_count, failed, total, worst);
+  if (0 != failed || total != value)
+  {
+    fprintf(stderr, "exact_solve: the strategy doesn't match the search\n");
+    exit(1);
+  } /* if */
+
+  return worst;
+} /* _strategy */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, then solves, or checks a strategy file.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  uint16*     all;
+  uint16*     feedback;
+  uint32*     buckets;
+  uint8       present[ES_MAX_BUCKETS];
+  uint32      megabytes  = 256;
+  uint32      worst_mode = FALSE;
+  const char* out_path   = NULL;
+  const char* in_path    = NULL;
+  uint32      average, avg_worst;
+  uint32      worst, worst_total, depth;
+  uint32      total, failed, seen;
+  uint64      nodes, probes, hits, stores, arena;
+  uint32      i, j, t;
+  char        comment[128];
+  double      start, elapsed;
+  int         opt;
+
+  _pegs    = CB_COLOR_LENGTH;
+  _colors  = CB_POSSIBLE_COLORS;
+  _repeats = FALSE;
+  _threads = (uint32)sysconf(_SC_NPROCESSORS_ONLN);
+  while (-1 != (opt = getopt(argc, argv, "p:c:rj:m:wo:V:")))
+  {
+    switch (opt)
+    {
+      case 'p':
+        _pegs = (uint32)atoi(optarg);
+        break;
+      case 'c':
+        _colors = (uint32)atoi(optarg);
+        break;
+      case 'r':
+        _repeats = TRUE;
+        break;
+      case 'j':
+        _threads = (uint32)atoi(optarg);
+        break;
+      case 'm':
+        megabytes = (uint32)atoi(optarg);
+        break;
+      case 'w':
+        worst_mode = TRUE;
+        break;
+      case 'o':
+        out_path = optarg;
+        break;
+      case 'V':
+        in_path = optarg;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-p pegs] [-c colors] [-r] [-j threads] "
+                        "[-m MiB] [-w] [-o file]\n"
+                        "       %s [-p pegs] [-c colors] [-r] -V file\n",
+                argv[0], argv[0]);
+        return 2;
+    } /* switch */
+  } /* while */
+
+  if (_pegs < 2 || _pegs > ES_MAX_PEGS || _colors < 2 ||
+      _colors > CODESET_MAX_COLORS || 0 == codeset_count(_pegs, _colors,
+      _repeats) || codeset_count(_pegs, _colors, _repeats) > ES_MAX_CODES)
+  {
+    fprintf(stderr, "unsupported configuration (at most %u pegs and %u "
+                    "codes)\n", ES_MAX_PEGS, ES_MAX_CODES);
+    return 2;
+  } /* if */
+  if (_threads < 1 || _threads > ES_MAX_THREADS)
+  {
+    fprintf(stderr, "threads must be 1 to %u\n", ES_MAX_THREADS);
+    return 2;
+  } /* if */
+
+  // every code, and every pair's feedback
+  _count = (uint32)codeset_count(_pegs, _colors, _repeats);
+  _codes = malloc(_count * sizeof(uint32));
+  codeset_fill(_codes, _pegs, _colors, _repeats);
+  _win = SB_BUCKET(_pegs, 0, _pegs);
+
+  if (NULL != in_path)
+  {
+    if (0 != _read_tree(in_path))
+    {
+      return 1;
+    } /* if */
+    failed = _check(_tree, _tree_count, &total, &worst);
+    printf("%s: %u nodes, %u of %u codes unsolved, %u guesses (%.4f per "
+           "code), worst case %u\n", in_path, _tree_count, failed, _count,
+           total, (double)total / _count, worst);
+    return (0 == failed) ? 0 : 1;
+  } /* if */
+
+  score_batch_select(SB_IMPL_AUTO);
+  _fb      = malloc((uint64)_count * _count);
+  feedback = malloc(_count * sizeof(uint16));
+  buckets  = malloc(SB_BUCKETS(_pegs) * sizeof(uint32));
+  memset(present, 0, sizeof(present));
+  for (i = 0; i < _count; i++)
+  {
+    // row i: guess i against each code
+    score_batch(_codes[i], _codes, _count, _pegs, buckets, feedback);
+    for (j = 0; j < _count; j++)
+    {
+      _fb[(uint64)i * _count + j] = (uint8)feedback[j];
+      present[feedback[j]] = TRUE;
+    } /* for j */
+  } /* for i */
+  _outcomes = 0;
+  for (i = 0; i < ES_MAX_BUCKETS; i++)
+  {
+    _outcomes += (i != _win && present[i]);
+  } /* for i */
+  free(feedback);
+  free(buckets);
+
+  _lower_init();
+  _perm_count = 0;
+  for (i = 0; i < _pegs; i++)
+  {
+    _perms[0][i] = i;
+  } /* for i */
+  do
+  {
+    // lexicographic successor of the last permutation
+    memcpy(_perms[_perm_count + 1], _perms[_perm_count], ES_MAX_PEGS);
+    _perm_count++;
+    for (i = _pegs - 1; i > 0 && _perms[_perm_count][i - 1] >
+                                 _perms[_perm_count][i]; i--)
+    {
+    } /* for i */
+    if (0 == i)
+    {
+      break;
+    } /* if last */
+    for (j = _pegs - 1; _perms[_perm_count][j] < _perms[_perm_count][i - 1];
+         j--)
+    {
+    } /* for j */
+    t = _perms[_perm_count][i - 1];
+    _perms[_perm_count][i - 1] = _perms[_perm_count][j];
+    _perms[_perm_count][j]     = t;
+    for (j = _pegs - 1; i < j; i++, j--)
+    {
+      t = _perms[_perm_count][i];
+      _perms[_perm_count][i] = _perms[_perm_count][j];
+      _perms[_perm_count][j] = t;
+    } /* for j */
+  } while (_perm_count < ES_MAX_SYMS);
+
+  _tt_init(megabytes);
+  arena = (uint64)_count * (ES_MAX_DEPTH + 1) *
+          (sizeof(uint16) + sizeof(_es_cand_t));
+  for (t = 0; t < _threads; t++)
+  {
+    _ctx[t] = calloc(1, sizeof(_es_ctx_t));
+    _ctx[t]->sets  = malloc((uint64)_count * (ES_MAX_DEPTH + 1) *
+                            sizeof(uint16));
+    _ctx[t]->cands = malloc((uint64)_count * (ES_MAX_DEPTH + 1) *
+                            sizeof(_es_cand_t));
+  } /* for t */
+  all = malloc(_count * sizeof(uint16));
+  for (i = 0; i < _count; i++)
+  {
+    all[i] = (uint16)i;
+  } /* for i */
+
+  printf("%u pegs, %u colors, %s: %u codes, %u other feedbacks, %u "
+         "position symmetries, %u threads\n", _pegs, _colors,
+         _repeats ? "repeats" : "no repeats", _count, _outcomes,
+         _perm_count, _threads);
+
+  // the average, then the worst case, below the average strategy's
+  start     = _now();
+  average   = _solve_root(all, ES_MAX_DEPTH);
+  printf("average   %u guesses (%.4f per code), optimal\n", average,
+         (double)average / _count);
+  avg_worst = _strategy(all, ES_MAX_DEPTH, average, "strategy");
+  worst       = avg_worst;
+  worst_total = average;
+  for (seen = 0; seen < _count; seen++)
+  {
+    if (ES_NONE != _lower_bound(_count, seen + 1))
+    {
+      break;
+    } /* if */
+  } /* for seen */
+  for (depth = seen + 1; depth < avg_worst; depth++)
+  {
+    total = _solve_root(all, depth);
+    if (ES_NONE != total)
+    {
+      worst       = depth;
+      worst_total = total;
+      break;
+    } /* if */
+  } /* for depth */
+  elapsed = _now() - start;
+  printf("worst     %u guesses, optimal (%u impossible); fewest total "
+         "within it %u (%.4f per code)\n", worst, worst - 1, worst_total,
+         (double)worst_total / _count);
+  if (worst_mode)
+  {
+    _strategy(all, worst, worst_total, "strategy");
+  } /* if */
+
+  nodes = probes = hits = stores = 0;
+  for (t = 0; t < _threads; t++)
+  {
+    nodes  += _ctx[t]->nodes;
+    probes += _ctx[t]->probes;
+    hits   += _ctx[t]->hits;
+    stores += _ctx[t]->stores;
+  } /* for t */
+  printf("search    %llu nodes in %.3f s, %.0f nodes/s\n",
+         (unsigned long long)nodes, elapsed, nodes / elapsed);
+  printf("table     %llu probes, %.1f%% hits, %llu stores\n",
+         (unsigned long long)probes, probes ? 100.0 * hits / probes : 0.0,
+         (unsigned long long)stores);
+  printf("memory    table %.1f MiB, feedback %.1f MiB, arenas %.1f MiB, "
+         "bounds %.1f MiB\n",
+         (_table_mask + 1.0) * ES_TT_WAYS * sizeof(_es_entry_t) / 1048576,
+         (double)_count * _count / 1048576,
+         (double)_threads * (arena + sizeof(_es_ctx_t)) / 1048576,
+         (ES_MAX_DEPTH + 1.0) * (_count + 1) * sizeof(uint32) / 1048576);
+
+  if (NULL != out_path)
+  {
+    sprintf(comment, "%s: %u guesses, worst case %u; optimal",
+            worst_mode ? "worst case" : "average",
+            worst_mode ? worst_total : average,
+            worst_mode ? worst : avg_worst);
+    if (0 != _write_tree(out_path, comment))
+    {
+      return 1;
+    } /* if */
+  } /* if */
+
+  return 0;
+} /* main */
@@ -0,0 +1,676 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  gen_book.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Build-time generator for the firmware's opening book (book_table.c):
+//    a complete strategy tree for the CB_COLOR_LENGTH-peg,
+//    CB_POSSIBLE_COLORS-color game, with repeated colors if it is built
+//    with REPEAT_COLORS defined like the firmware.
+//
+//    At each node the guesses are ranked by how many distinct feedbacks
+//    they split the remaining codes into (more is better, then guesses
+//    that could themselves be the code, then the smaller worst case).
+//    With -k 1 the best-ranked guess is simply taken.  With a larger -k
+//    the top k are each expanded into full subtrees and the one with the
+//    fewest total guesses is kept, which gets close to optimal play.
+//    Without repeated colors every opening guess is equivalent under
+//    swapping colors and positions, so the root's is fixed; with them,
+//    the root is chosen like any other node.
+//
+//    The tree is then checked by playing every code through book_next,
+//    and its size, depth and lookup cost are reported, alongside the
+//    cost of choosing each guess live with the same ranking.
+//
+//    Feedback comes from score_code, or with -f from a score table made
+//    by gen_scores for the same configuration.
+//
+//  USAGE
+//    gen_book [-k width] [-o file] [-t seconds] [-f table]
+//      -k  guesses expanded per node (default 32, at most 64)
+//      -o  write the table here (default: report only)
+//      -t  seconds to time the lookups
+//      -f  score table to take feedback from
+//
+//  BUILDING
+//    gcc -O2 -Wall -Ibsp -I../nios -o gen_book gen_book.c codeset.c
+//        lfsr_model.c lfsr_soft_if.c score_table.c score_batch.c
+//        ../nios/utilities.c ../nios/book.c ../nios/color_table.c
+//    ./gen_book -o ../nios/book_table.c
+//    (add -DREPEAT_COLORS to the gcc line for the repeated-colors book)
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for score_code
+#include "book.h"
+#include "codeset.h"
+#include "score_table.h"
+
+// Largest tree the 16-bit node indices can hold
+#define   GEN_MAX_NODES                   0xFFFF
+
+// Most guesses expanded per node
+#define   GEN_MAX_WIDTH                   64
+
+// Whether the codes may repeat colors, as in the firmware
+#ifdef REPEAT_COLORS
+#define   GEN_REPEATS                     TRUE
+#else
+#define   GEN_REPEATS                     FALSE
+#endif
+
+// Tree node while building; child[] holds tree indices, or -1
+typedef struct
+{
+  uint32  guess;
+  int32   child[BOOK_FEEDBACKS];
+} _gen_node_t;
+
+// Result of solving a set of codes
+typedef struct
+{
+  uint32  total;              // guesses summed over the codes
+  uint32  depth;              // most guesses any code needs
+  int32   node;               // tree index, or -1 if not emitted
+} _gen_result_t;
+
+static uint32*      _codes;           // every valid code (and guess)
+static uint32       _code_count;
+static uint32       _width;
+static _gen_node_t* _tree;
+static uint32       _tree_count;
+static uint64       _live_scores;     // score_code calls made by _rank
+static score_table_t _table;          // -f, or not open
+static uint16*      _index;           // -f: each code's table row
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _feedback
+//
+// DESCRIPTION: Feedback index of a guess against a code.
+//-------------------------------------------------------------------------
+static uint32 _feedback(uint32 secret, uint32 guess)
+{
+  uint32 score;
+
+  if (NULL != _index)
+  {
+    // the table's cells are book feedback indices already
+    return ST_CELL(&_table, _index[guess], _index[secret]);
+  } /* if */
+
+  score = score_code(secret, guess);
+
+  return BOOK_FEEDBACK(SCORE_P(score), SCORE_C(score));
+} /* _feedback */
+
+//-------------------------------------------------------------------------
+// NAME:        _rank
+//
+// DESCRIPTION: Ranks every guess against a set of codes and returns the
+//              best width of them, best first.
+// ARGUMENTS:   const uint32* set, uint32 n, the remaining codes
+//              uint32* best, receives up to width guesses
+//              uint32 width, how many to return
+// RETURNS:     uint32, number of guesses returned
+//-------------------------------------------------------------------------
+static uint32 _rank(const uint32* set, uint32 n, uint32* best, uint32 width)
+{
+  uint32 key[4];
+  uint32 keys[GEN_MAX_WIDTH][4];
+  uint32 sizes[BOOK_FEEDBACKS];
+  uint32 count = 0;
+  uint32 parts, worst, member;
+  uint32 g, i, j, f;
+
+  for (g = 0; g < _code_count; g++)
+  {
+    memset(sizes, 0, sizeof(sizes));
+    member = FALSE;
+    for (i = 0; i < n; i++)
+    {
+      sizes[_feedback(set[i], _codes[g])]++;
+      member |= (set[i] == _codes[g]);
+    } /* for i */
+    _live_scores += n;
+
+    parts = 0;
+    worst = 0;
+    for (f = 0; f < BOOK_FEEDBACKS; f++)
+    {
+      parts += (0 != sizes[f]);
+      worst  = (sizes[f] > worst) ? sizes[f] : worst;
+    } /* for f */
+
+    // larger keys are better: parts, then membership, then worst case
+    key[0] = parts;
+    key[1] = member;
+    key[2] = n - worst;
+    key[3] = g;
+
+    // insertion into the best-width list; ties keep the earlier guess
+    for (i = count; i > 0; i--)
+    {
+      if (keys[i - 1][0] > key[0] ||
+          (keys[i - 1][0] == key[0] && (keys[i - 1][1] > key[1] ||
+          (keys[i - 1][1] == key[1] && keys[i - 1][2] >= key[2]))))
+      {
+        break;
+      } /* if */
+    } /* for i */
+    if (i < width)
+    {
+      for (j = (count < width) ? count : width - 1; j > i; j--)
+      {
+        memcpy(keys[j], keys[j - 1], sizeof(key));
+      } /* for j */
+      memcpy(keys[i], key, sizeof(key));
+      count += (count < width);
+    } /* if */
+  } /* for g */
+
+  for (i = 0; i < count; i++)
+  {
+    best[i] = _codes[keys[i][3]];
+  } /* for i */
+  return count;
+} /* _rank */
+
+//-------------------------------------------------------------------------
+// NAME:        _solve
+//
+// DESCRIPTION: Finds a strategy for a set of codes.
+// ARGUMENTS:   const uint32* set, uint32 n, the remaining codes
+//              uint32 width, guesses to expand at this node
+//              uint32 emit, TRUE to add the strategy to the tree
+// RETURNS:     _gen_result_t, its cost (and tree node)
+//-------------------------------------------------------------------------
+static _gen_result_t _solve(const uint32* set, uint32 n, uint32 width,
+                            uint32 emit);
+
+static _gen_result_t _play(const uint32* set, uint32 n, uint32 guess,
+                           uint32 width, uint32 emit)
+{
+  _gen_result_t result;
+  _gen_result_t sub;
+  uint32*       parts;
+  uint32        start[BOOK_FEEDBACKS + 1];
+  uint32        fill[BOOK_FEEDBACKS];
+  uint32        node = 0;
+  uint32        i, f;
+
+  result.total = n;           // every code spends this guess
+  result.depth = 1;
+  result.node  = -1;
+
+  if (emit)
+  {
+    if (_tree_count == GEN_MAX_NODES)
+    {
+      fprintf(stderr, "gen_book: tree too large\n");
+      exit(1);
+    } /* if */
+    node = _tree_count++;
+    _tree[node].guess = guess;
+    for (f = 0; f < BOOK_FEEDBACKS; f++)
+    {
+      _tree[node].child[f] = -1;
+    } /* for f */
+    result.node = (int32)node;
+  } /* if */
+
+  // split the set by feedback (a counting sort, to keep the order)
+  memset(start, 0, sizeof(start));
+  for (i = 0; i < n; i++)
+  {
+    start[_feedback(set[i], guess) + 1]++;
+  } /* for i */
+  for (f = 0; f < BOOK_FEEDBACKS; f++)
+  {
+    start[f + 1] += start[f];
+    fill[f]       = start[f];
+  } /* for f */
+  parts = malloc(n * sizeof(uint32));
+  for (i = 0; i < n; i++)
+  {
+    parts[fill[_feedback(set[i], guess)]++] = set[i];
+  } /* for i */
+
+  for (f = 0; f < BOOK_FEEDBACKS; f++)
+  {
+    if (start[f] == start[f + 1] ||
+        BOOK_FEEDBACK(CB_COLOR_LENGTH, 0) == f)
+    {
+      continue;               // nothing left, or found it
+    } /* if */
+    sub = _solve(parts + start[f], start[f + 1] - start[f], width, emit);
+    result.total += sub.total;
+    if (sub.depth + 1 > result.depth)
+    {
+      result.depth = sub.depth + 1;
+    } /* if */
+    if (emit)
+    {
+      _tree[node].child[f] = sub.node;
+    } /* if */
+  } /* for f */
+
+  free(parts);
+  return result;
+} /* _play */
+
+static _gen_result_t _solve(const uint32* set, uint32 n, uint32 width,
+                            uint32 emit)
+{
+  _gen_result_t result;
+  _gen_result_t trial;
+  uint32*       best;
+  uint32        count;
+  uint32        choice;
+  uint32        i;
+
+  if (n <= 2)
+  {
+    // guess one of them; if it's wrong, the other is the code
+    return _play(set, n, set[0], width, emit);
+  } /* if */
+
+  best  = malloc(width * sizeof(uint32));
+  count = _rank(set, n, best, width);
+
+  choice = 0;
+  if (count > 1)
+  {
+    result.total = 0xFFFFFFFF;
+    result.depth = 0xFFFFFFFF;
+    for (i = 0; i < count; i++)
+    {
+      trial = _play(set, n, best[i], width, FALSE);
+      if (trial.total < result.total ||
+          (trial.total == result.total && trial.depth < result.depth))
+      {
+        result = trial;
+        choice = i;
+      } /* if */
+    } /* for i */
+  } /* if */
+
+  result = _play(set, n, best[choice], width, emit);
+  free(best);
+  return result;
+} /* _solve */
+
+//-------------------------------------------------------------------------
+// NAME:        _serialize
+//
+// DESCRIPTION: Lays the tree out breadth-first, so that every node's
+//              children are consecutive, in book_node_t form.
+// RETURNS:     uint32, number of nodes
+//-------------------------------------------------------------------------
+static uint32 _serialize(int32 root, book_node_t* book)
+{
+  int32*  order = malloc(_tree_count * sizeof(int32));
+  uint32  head  = 0;
+  uint32  tail  = 0;
+  uint32  f;
+  int32   t;
+
+  order[tail++] = root;
+  while (head < tail)
+  {
+    t = order[head];
+    book[head].guess = (uint16)_tree[t].guess;
+    book[head].mask  = 0;
+    book[head].first = (uint16)tail;
+    for (f = 0; f < BOOK_FEEDBACKS; f++)
+    {
+      if (_tree[t].child[f] >= 0)
+      {
+        book[head].mask |= (uint16)(1 << f);
+        order[tail++] = _tree[t].child[f];
+      } /* if */
+    } /* for f */
+    if (0 == book[head].mask)
+    {
+      book[head].first = 0;
+    } /* if leaf */
+    head++;
+  } /* while */
+
+  free(order);
+  return tail;
+} /* _serialize */
+
+//-------------------------------------------------------------------------
+// NAME:        _write_table
+//
+// DESCRIPTION: Writes book_table.c.
+//-------------------------------------------------------------------------
+static void _write_table(FILE* out, const book_node_t* book, uint32 nodes,
+                         uint32 width, double average, uint32 depth)
+{
+  char   str[CB_COLOR_LENGTH + 1];
+  uint32 i;
+
+  fprintf(out,
+    "//***************************  C Source Code  *****************************\n"
+    "//*************************************************************************\n"
+    "// vim: set ts=2 sw=2 tw=78 et :\n"
+    "//\n"
+    "//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>\n"
+    "//\n"
+    "//       LAB NAME:  Lab 7: Game System\n"
+    "//\n"
+    "//      FILE NAME:  book_table.c\n"
+    "//\n"
+    "//-------------------------------------------------------------------------\n"
+    "//\n"
+    "//  DESCRIPTION\n"
+    "//\n"
+    "//    Opening book for book.c.  GENERATED by host/gen_book -k %u; do not\n"
+    "//    edit.  %u nodes, %u bytes; %.4f guesses on average, %u at most.\n"
+    "//\n"
+    "//*************************************************************************\n"
+    "//*************************************************************************\n"
+    "\n"
+    "#include \"nios_std_types.h\"   // standard data types\n"
+    "#include \"codebreaker.h\"      // for CB_* defines\n"
+    "#include \"book.h\"\n"
+    "\n"
+    "// The table only takes memory when the hints or the analysis\n"
+    "// (analysis.c) use it\n"
+    "#if defined(BOOK_HINTS) || defined(GAME_ANALYSIS)\n"
+    "\n"
+    "#if (%u != CB_COLOR_LENGTH) || (%u != CB_POSSIBLE_COLORS) || \\\n"
+    "    %sdefined(REPEAT_COLORS)\n"
+    "#error \"book_table.c is out of date; rerun host/gen_book\"\n"
+    "#endif\n"
+    "\n"
+    "const uint32 book_node_count = %u;\n"
+    "\n"
+    "const book_node_t book_nodes[%u] =\n"
+    "{\n"
+    "  // guess   mask    first\n",
+    width, nodes, nodes * (uint32)sizeof(book_node_t), average, depth,
+    CB_COLOR_LENGTH, CB_POSSIBLE_COLORS, GEN_REPEATS ? "!" : "",
+    nodes, nodes);
+
+  for (i = 0; i < nodes; i++)
+  {
+    codeset_to_str(book[i].guess, CB_COLOR_LENGTH, str);
+    fprintf(out, "  { 0x%04x, 0x%04x, %5u },   // %5u %s\n",
+            book[i].guess, book[i].mask, book[i].first, i, str);
+  } /* for i */
+  fprintf(out, "};\n"
+               "\n"
+               "#endif /* BOOK_HINTS || GAME_ANALYSIS */\n");
+} /* _write_table */
+
+//-------------------------------------------------------------------------
+// NAME:        _walk
+//
+// DESCRIPTION: Plays one code through a book.
+// RETURNS:     uint32, guesses taken, or 0 if the book fails
+//-------------------------------------------------------------------------
+static uint32 _walk(const book_node_t* book, uint32 secret)
+{
+  uint32 node    = BOOK_ROOT;
+  uint32 guesses = 0;
+
+  while (BOOK_NONE != node && guesses <= BOOK_FEEDBACKS * 2)
+  {
+    guesses++;
+    if (book[node].guess == secret)
+    {
+      return guesses;
+    } /* if */
+    node = book_next(book, node, score_code(secret, book[node].guess));
+  } /* while */
+
+  return 0;
+} /* _walk */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, builds and checks the book, reports, and
+//              writes the table.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  uint32        histogram[BOOK_FEEDBACKS * 2 + 1];
+  const char*   out_path = NULL;
+  const char*   table_path = NULL;
+  double        seconds  = 0.5;
+  _gen_result_t result;
+  book_node_t*  book;
+  FILE*         out;
+  uint32        nodes;
+  uint32        total    = 0;
+  uint32        depth    = 0;
+  uint32        failures = 0;
+  uint32*       set;
+  uint32        n;
+  uint32        guess;
+  uint32        node;
+  uint32        at;
+  uint32        sink     = 0;
+  uint64        steps;
+  uint64        weight;
+  double        start, elapsed, build_time;
+  double        lookup_ns, live_ns, live_calls;
+  uint32        i, d;
+  int           opt;
+
+  _width = 32;
+  while (-1 != (opt = getopt(argc, argv, "k:o:t:f:")))
+  {
+    switch (opt)
+    {
+      case 'k':
+        _width = (uint32)atoi(optarg);
+        break;
+      case 'o':
+        out_path = optarg;
+        break;
+      case 't':
+        seconds = atof(optarg);
+        break;
+      case 'f':
+        table_path = optarg;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-k width] [-o file] [-t seconds] "
+                        "[-f table]\n", argv[0]);
+        return 2;
+    } /* switch */
+  } /* while */
+  if (_width < 1 || _width > GEN_MAX_WIDTH)
+  {
+    fprintf(stderr, "width must be 1 to %u\n", GEN_MAX_WIDTH);
+    return 2;
+  } /* if */
+
+  _code_count = (uint32)codeset_count(CB_COLOR_LENGTH, CB_POSSIBLE_COLORS,
+                                      GEN_REPEATS);
+  _codes      = malloc(_code_count * sizeof(uint32));
+  codeset_fill(_codes, CB_COLOR_LENGTH, CB_POSSIBLE_COLORS, GEN_REPEATS);
+  _tree       = malloc(GEN_MAX_NODES * sizeof(_gen_node_t));
+  _tree_count = 0;
+
+  if (NULL != table_path)
+  {
+    if (0 != score_table_open(&_table, table_path, CB_COLOR_LENGTH,
+                              CB_POSSIBLE_COLORS, GEN_REPEATS))
+    {
+      return 1;
+    } /* if */
+    _index = malloc((CODE_MASK + 1) * sizeof(uint16));
+    for (i = 0; i < _table.header->codes; i++)
+    {
+      _index[_table.codes[i]] = (uint16)i;
+    } /* for i */
+  } /* if */
+
+  // Build, with the opening fixed if every opening is alike
+  start      = _now();
+  result     = GEN_REPEATS ? _solve(_codes, _code_count, _width, TRUE)
+                           : _play(_codes, _code_count, _codes[0], _width,
+                                   TRUE);
+  build_time = _now() - start;
+
+  book  = malloc(_tree_count * sizeof(book_node_t));
+  nodes = _serialize(result.node, book);
+
+  // Check every code, and collect the depths
+  memset(histogram, 0, sizeof(histogram));
+  for (i = 0; i < _code_count; i++)
+  {
+    d = _walk(book, _codes[i]);
+    if (0 == d)
+    {
+      failures++;
+      continue;
+    } /* if */
+    histogram[d]++;
+    total += d;
+    depth  = (d > depth) ? d : depth;
+  } /* for i */
+  if (0 != failures || total != result.total)
+  {
+    fprintf(stderr, "gen_book: book fails on %u codes\n", failures);
+    return 1;
+  } /* if */
+
+  printf("%u pegs, %u colors, %s: %u codes, width %u, "
+         "built in %.2f s (feedback from %s)\n", CB_COLOR_LENGTH,
+         CB_POSSIBLE_COLORS, GEN_REPEATS ? "repeats" : "no repeats",
+         _code_count, _width, build_time,
+         (NULL != _index) ? table_path : "score_code");
+  printf("book           %u nodes, %u bytes\n", nodes,
+         nodes * (uint32)sizeof(book_node_t));
+  printf("guesses        %.4f average, %u at most\n",
+         (double)total / _code_count, depth);
+  for (d = 1; d <= depth; d++)
+  {
+    printf("  %2u guesses   %5u codes\n", d, histogram[d]);
+  } /* for d */
+
+  // Lookup cost: one book_next per guess, over every game
+  steps   = 0;
+  start   = _now();
+  do
+  {
+    for (i = 0; i < _code_count; i++)
+    {
+      node = BOOK_ROOT;
+      while (BOOK_NONE != node && book[node].guess != _codes[i])
+      {
+        node = book_next(book, node,
+                         score_code(_codes[i], book[node].guess));
+        steps++;
+      } /* while */
+      sink += node;
+    } /* for i */
+    elapsed = _now() - start;
+  } while (elapsed < seconds);
+  lookup_ns = elapsed * 1e9 / steps;
+
+  // Live cost: ranking every guess against the codes left at each node
+  // the book decides, as a solver on the board would have to.  Weighted
+  // by the codes passing through each node, this is the cost per guess
+  // over every possible game.
+  set       = malloc(_code_count * sizeof(uint32));
+  weight    = 0;
+  live_ns   = 0;
+  live_calls = 0;
+  for (node = 0; node < nodes; node++)
+  {
+    if (0 == book[node].mask)
+    {
+      continue;             // nothing left to decide
+    } /* if */
+
+    // the codes still possible here are those whose games reach it
+    n = 0;
+    for (i = 0; i < _code_count; i++)
+    {
+      at = BOOK_ROOT;
+      while (BOOK_NONE != at && at != node && book[at].guess != _codes[i])
+      {
+        at = book_next(book, at, score_code(_codes[i], book[at].guess));
+      } /* while */
+      if (at == node)
+      {
+        set[n++] = _codes[i];
+      } /* if */
+    } /* for i */
+
+    _live_scores = 0;
+    start        = _now();
+    _rank(set, n, &guess, 1);
+    live_ns     += (_now() - start) * 1e9 * n;
+    live_calls  += _live_scores * n;
+    weight      += n;
+    sink        += guess;
+  } /* for node */
+  free(set);
+  live_ns    /= weight;
+  live_calls /= weight;
+
+  printf("lookup         %.1f ns per guess (book_next)\n", lookup_ns);
+  printf("live solver    %.0f ns per guess, %.0f score_code calls "
+         "(%.0fx the lookup)\n", live_ns, live_calls, live_ns / lookup_ns);
+
+  if (NULL != out_path)
+  {
+    out = fopen(out_path, "w");
+    if (NULL == out)
+    {
+      perror(out_path);
+      return 1;
+    } /* if */
+    _write_table(out, book, nodes, _width, (double)total / _code_count,
+                 depth);
+    fclose(out);
+  } /* if */
+
+  if (0xFFFFFFFF == sink)
+  {
+    printf(" ");            // keep the results live
+  } /* if */
+  free(book);
+  free(_tree);
+  free(_codes);
+  return 0;
+} /* main */
@@ -0,0 +1,223 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  gen_colors.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Build-time generator for the firmware's color alphabet tables
+//    (color_table.c).  CB_COLOR_LETTERS in codebreaker.h is the only
+//    place the letters are defined; from it this makes:
+//      - color_class, which classifies every byte the UART can deliver
+//        (CC_* in utilities.h): whether it is printable, whether it is
+//        lower case, and which color it names, if any
+//      - color_letters, the letters themselves, for to_color
+//      - color_list, the letters as the instructions show them
+//
+//  USAGE
+//    gen_colors [-o file]
+//      -o  write the tables here (default: standard output)
+//
+//  BUILDING
+//    gcc -O2 -Wall -Ibsp -I../nios -o gen_colors gen_colors.c
+//    ./gen_colors -o ../nios/color_table.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_COLOR_LETTERS
+#include "utilities.h"        // for CC_*
+
+//-------------------------------------------------------------------------
+// NAME:        _classify
+//
+// DESCRIPTION: Works out the class of one byte.
+//-------------------------------------------------------------------------
+static uint8 _classify(uint32 byte)
+{
+  const char* letter;
+  uint8       class = 0;
+  uint32      upper = byte;
+
+  if (byte >= 0x20 && byte <= 0x7E)
+  {
+    class |= CC_PRINT;
+  } /* if */
+  if (byte >= 'a' && byte <= 'z')
+  {
+    class |= CC_LOWER;
+    upper -= 0x20;
+  } /* if */
+
+  letter = (0 == upper) ? NULL : strchr(CB_COLOR_LETTERS, (int)upper);
+  if (NULL != letter)
+  {
+    class |= CC_COLOR | (uint8)(letter - CB_COLOR_LETTERS);
+  } /* if */
+  return class;
+} /* _classify */
+
+//-------------------------------------------------------------------------
+// NAME:        _check_letters
+//
+// DESCRIPTION: Makes sure CB_COLOR_LETTERS can work: one upper-case letter
+//              per color, no repeats, and none that the hints use.
+// RETURNS:     int, 0 if it's fine
+//-------------------------------------------------------------------------
+static int _check_letters()
+{
+  const char* letters = CB_COLOR_LETTERS;
+  uint32      i;
+
+  if (CB_POSSIBLE_COLORS != strlen(letters))
+  {
+    fprintf(stderr, "gen_colors: CB_COLOR_LETTERS needs %u letters\n",
+            CB_POSSIBLE_COLORS);
+    return -1;
+  } /* if */
+  for (i = 0; i < CB_POSSIBLE_COLORS; i++)
+  {
+    if (letters[i] < 'A' || letters[i] > 'Z' ||
+        strchr(letters + i + 1, letters[i]) || 'X' == letters[i])
+    {
+      fprintf(stderr, "gen_colors: bad or repeated color letter '%c'\n",
+              letters[i]);
+      return -1;
+    } /* if */
+  } /* for i */
+  return 0;
+} /* _check_letters */
+
+//-------------------------------------------------------------------------
+// NAME:        _write_table
+//
+// DESCRIPTION: Writes color_table.c.
+//-------------------------------------------------------------------------
+static void _write_table(FILE* out)
+{
+  uint32 byte;
+  uint32 i;
+
+  fprintf(out,
+    "//***************************  C Source Code  *****************************\n"
+    "//*************************************************************************\n"
+    "// vim: set ts=2 sw=2 tw=78 et :\n"
+    "//\n"
+    "//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>\n"
+    "//\n"
+    "//       LAB NAME:  Lab 7: Game System\n"
+    "//\n"
+    "//      FILE NAME:  color_table.c\n"
+    "//\n"
+    "//-------------------------------------------------------------------------\n"
+    "//\n"
+    "//  DESCRIPTION\n"
+    "//\n"
+    "//    Color alphabet tables for the UART driver and utilities.c.\n"
+    "//    GENERATED by host/gen_colors from CB_COLOR_LETTERS (\"%s\"); do\n"
+    "//    not edit.\n"
+    "//\n"
+    "//*************************************************************************\n"
+    "//*************************************************************************\n"
+    "\n"
+    "#include \"nios_std_types.h\"   // standard data types\n"
+    "#include \"codebreaker.h\"      // for CB_* defines\n"
+    "#include \"utilities.h\"        // for CC_*\n"
+    "\n"
+    "#if (%u != CB_POSSIBLE_COLORS)\n"
+    "#error \"color_table.c is out of date; rerun host/gen_colors\"\n"
+    "#endif\n"
+    "\n"
+    "const uint8 color_letters[] = \"%s\";\n"
+    "\n"
+    "const uint8 color_list[] = \"",
+    CB_COLOR_LETTERS, CB_POSSIBLE_COLORS, CB_COLOR_LETTERS);
+
+  for (i = 0; i < CB_POSSIBLE_COLORS; i++)
+  {
+    fprintf(out, "%s%c", (0 == i) ? "" : ", ", CB_COLOR_LETTERS[i]);
+  } /* for i */
+  fprintf(out, "\";\n"
+               "\n"
+               "// CC_* class of each byte\n"
+               "const uint8 color_class[256] =\n"
+               "{\n");
+
+  for (byte = 0; byte < 256; byte += 8)
+  {
+    fprintf(out, " ");
+    for (i = byte; i < byte + 8; i++)
+    {
+      fprintf(out, " 0x%02x,", _classify(i));
+    } /* for i */
+    fprintf(out, "   // 0x%02x", byte);
+    if (byte >= 0x20 && byte + 7 <= 0x7E)
+    {
+      fputc(' ', out);
+      for (i = byte; i < byte + 8; i++)
+      {
+        fputc((int)i, out);
+      } /* for i */
+    } /* if printable */
+    fprintf(out, "\n");
+  } /* for byte */
+  fprintf(out, "};\n");
+} /* _write_table */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Checks the alphabet and writes the tables.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  const char* out_path = NULL;
+  FILE*       out      = stdout;
+  int         opt;
+
+  while (-1 != (opt = getopt(argc, argv, "o:")))
+  {
+    switch (opt)
+    {
+      case 'o':
+        out_path = optarg;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-o file]\n", argv[0]);
+        return 2;
+    } /* switch */
+  } /* while */
+
+  if (0 != _check_letters())
+  {
+    return 1;
+  } /* if */
+
+  if (NULL != out_path)
+  {
+    out = fopen(out_path, "w");
+    if (NULL == out)
+    {
+      perror(out_path);
+      return 1;
+    } /* if */
+  } /* if */
+  _write_table(out);
+  if (NULL != out_path)
+  {
+    fclose(out);
+  } /* if */
+  return 0;
+} /* main */
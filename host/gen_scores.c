@@ -0,0 +1,376 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  gen_scores.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Writes a score table (see score_table.h) for one configuration, or
+//    checks one.  Rows are computed a chunk at a time on every thread
+//    while the previous chunk is written, so the file goes out in a
+//    single pass in order, and only two chunks are ever held.
+//
+//    With -i the table is opened instead, and the time to map it is
+//    compared with the time it took to make; a sample of its cells is
+//    checked against score_one, and with -v every row against its CRC.
+//
+//  USAGE
+//    gen_scores [-p pegs] [-c colors] [-r] [-j threads] -o file
+//    gen_scores [-p pegs] [-c colors] [-r] [-v] -i file
+//      -p  positions per code (default CB_COLOR_LENGTH)
+//      -c  colors (default CB_POSSIBLE_COLORS)
+//      -r  allow repeated colors
+//      -j  threads (default one per CPU)
+//      -o  write the table here
+//      -i  check this table
+//      -v  with -i, check every row's CRC too
+//
+//  BUILDING
+//    gcc -O2 -Wall -pthread -Ibsp -I../nios -o gen_scores gen_scores.c
+//        score_table.c score_batch.c codeset.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "codeset.h"
+#include "score_batch.h"
+#include "score_table.h"
+
+// Rows each thread computes per chunk
+#define   GS_CHUNK_ROWS                   64
+
+// Most threads
+#define   GS_MAX_THREADS                  64
+
+// Cells checked against score_one by -i
+#define   GS_SPOT_CHECKS                  100000
+
+// One thread's part of a chunk
+typedef struct
+{
+  pthread_t thread;
+  uint32    first;                    // row
+  uint32    count;                    // rows
+  uint8*    cells;                    // count rows, row_bytes apart
+  uint32*   crcs;                     // count row CRCs
+} _gs_part_t;
+
+static st_header_t  _header;
+static uint32*      _codes;
+static uint32       _row_data;        // bytes of cells in a row
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _fill
+//
+// DESCRIPTION: Thread body: computes one part of a chunk.
+//-------------------------------------------------------------------------
+static void* _fill(void* arg)
+{
+  _gs_part_t* part = arg;
+  uint8*      cells;
+  uint32      i;
+
+  for (i = 0; i < part->count; i++)
+  {
+    cells = part->cells + (uint64)i * _header.row_bytes;
+    score_table_fill_row(_codes, _header.codes, _header.pegs,
+                         part->first + i, cells);
+    part->crcs[i] = st_crc32(0, cells, _row_data);
+  } /* for i */
+
+  return NULL;
+} /* _fill */
+
+//-------------------------------------------------------------------------
+// NAME:        _start_chunk
+//
+// DESCRIPTION: Starts the threads on the chunk beginning at a row.
+// RETURNS:     uint32, rows in the chunk
+//-------------------------------------------------------------------------
+static uint32 _start_chunk(_gs_part_t* parts, uint32 threads, uint32 row,
+                           uint8* cells, uint32* crcs)
+{
+  uint32 rows = 0;
+  uint32 t;
+
+  for (t = 0; t < threads; t++)
+  {
+    parts[t].first = row + rows;
+    parts[t].count = GS_CHUNK_ROWS;
+    if (parts[t].first + parts[t].count > _header.codes)
+    {
+      parts[t].count = _header.codes - parts[t].first;
+    } /* if last */
+    parts[t].cells = cells + (uint64)rows * _header.row_bytes;
+    parts[t].crcs  = crcs + rows;
+    rows += parts[t].count;
+    if (0 != parts[t].count)
+    {
+      pthread_create(&parts[t].thread, NULL, _fill, &parts[t]);
+    } /* if */
+  } /* for t */
+
+  return rows;
+} /* _start_chunk */
+
+//-------------------------------------------------------------------------
+// NAME:        _write
+//
+// DESCRIPTION: Writes, then zero-pads to a multiple of pad bytes.
+// RETURNS:     int, 0 on success, -1 on a write error
+//-------------------------------------------------------------------------
+static int _write(FILE* out, const void* data, uint64 length, uint64 pad)
+{
+  static const uint8 zeros[ST_PAGE];
+  uint64             extra = (pad - length % pad) % pad;
+
+  if (length != fwrite(data, 1, length, out) ||
+      extra != fwrite(zeros, 1, extra, out))
+  {
+    return -1;
+  } /* if */
+  return 0;
+} /* _write */
+
+//-------------------------------------------------------------------------
+// NAME:        _generate
+//
+// DESCRIPTION: Writes the table.
+// RETURNS:     int, 0 on success, -1 on failure
+//-------------------------------------------------------------------------
+static int _generate(const char* path, uint32 threads)
+{
+  _gs_part_t  parts[2][GS_MAX_THREADS];
+  uint8*      cells[2];
+  uint32*     crcs;
+  uint32      rows[2];
+  uint32      row;
+  uint32      chunk = threads * GS_CHUNK_ROWS;
+  uint32      now, t;
+  int         result = 0;
+  FILE*       out = fopen(path, "wb");
+
+  if (NULL == out)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+
+  cells[0] = calloc((uint64)chunk * _header.row_bytes, 1);
+  cells[1] = calloc((uint64)chunk * _header.row_bytes, 1);
+  crcs     = malloc((_header.codes + ST_TRAILER_WORDS) * sizeof(uint32));
+
+  result |= _write(out, &_header, sizeof(_header), ST_PAGE);
+  result |= _write(out, _codes, _header.codes * sizeof(uint32), ST_PAGE);
+
+  // compute chunk n + 1 while chunk n is written
+  now     = 0;
+  rows[0] = _start_chunk(parts[0], threads, 0, cells[0], crcs);
+  for (row = 0; row < _header.codes; row += rows[now], now ^= 1)
+  {
+    for (t = 0; t < threads; t++)
+    {
+      if (0 != parts[now][t].count)
+      {
+        pthread_join(parts[now][t].thread, NULL);
+      } /* if */
+    } /* for t */
+    rows[now ^ 1] = _start_chunk(parts[now ^ 1], threads, row + rows[now],
+                                 cells[now ^ 1], crcs + row + rows[now]);
+    result |= _write(out, cells[now], (uint64)rows[now] * _header.row_bytes,
+                     1);
+  } /* for row */
+
+  crcs[_header.codes + ST_CRCS_CRC] =
+    st_crc32(0, crcs, _header.codes * sizeof(uint32));
+  crcs[_header.codes + ST_CODES_CRC] =
+    st_crc32(0, _codes, _header.codes * sizeof(uint32));
+  result |= _write(out, crcs,
+                   (_header.codes + ST_TRAILER_WORDS) * sizeof(uint32), 1);
+  if (0 != fclose(out) || 0 != result)
+  {
+    fprintf(stderr, "%s: write failed\n", path);
+    result = -1;
+  } /* if */
+
+  free(cells[0]);
+  free(cells[1]);
+  free(crcs);
+  return result;
+} /* _generate */
+
+//-------------------------------------------------------------------------
+// NAME:        _check
+//
+// DESCRIPTION: Maps a table, times it, and checks a sample of its cells
+//              (and, if asked, every row's CRC).
+// RETURNS:     int, 0 if it is good, 1 if not
+//-------------------------------------------------------------------------
+static int _check(const char* path, uint32 pegs, uint32 colors,
+                  uint32 repeats, uint32 full)
+{
+  score_table_t table;
+  uint64        rng = 1;
+  uint32        wrong = 0;
+  uint32        bad;
+  uint32        row, col, b, i;
+  double        start, opened, checked;
+
+  start = _now();
+  if (0 != score_table_open(&table, path, pegs, colors, repeats))
+  {
+    return 1;
+  } /* if */
+  opened = _now() - start;
+
+  start = _now();
+  for (i = 0; i < GS_SPOT_CHECKS; i++)
+  {
+    rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+    row = (uint32)(rng >> 33) % table.header->codes;
+    col = (uint32)(rng >> 1) % table.header->codes;
+    b   = score_one(table.codes[col], table.codes[row], pegs);
+    wrong += (ST_CELL(&table, row, col) !=
+              ST_FEEDBACK(SB_BUCKET_P(b, pegs), SB_BUCKET_C(b, pegs), pegs));
+  } /* for i */
+  checked = _now() - start;
+
+  printf("%s: %u codes, %u-bit cells, %u-byte rows, %llu bytes\n", path,
+         table.header->codes, table.header->cell_bits,
+         table.header->row_bytes, (unsigned long long)table.size);
+  printf("opened in      %.6f s\n", opened);
+  printf("spot checks    %u of %u wrong, %.1f ns each\n", wrong,
+         GS_SPOT_CHECKS, checked * 1e9 / GS_SPOT_CHECKS);
+  bad = 0;
+  if (full)
+  {
+    start = _now();
+    bad   = score_table_verify(&table);
+    printf("row CRCs       %u of %u bad, %.3f s\n", bad,
+           table.header->codes, _now() - start);
+  } /* if */
+
+  score_table_close(&table);
+  return (0 == wrong && 0 == bad) ? 0 : 1;
+} /* _check */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, then writes or checks a table.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  uint32      pegs    = CB_COLOR_LENGTH;
+  uint32      colors  = CB_POSSIBLE_COLORS;
+  uint32      repeats = FALSE;
+  uint32      threads = (uint32)sysconf(_SC_NPROCESSORS_ONLN);
+  uint32      full    = FALSE;
+  const char* out_path = NULL;
+  const char* in_path  = NULL;
+  double      start;
+  int         opt;
+
+  while (-1 != (opt = getopt(argc, argv, "p:c:rj:o:i:v")))
+  {
+    switch (opt)
+    {
+      case 'p':
+        pegs = (uint32)atoi(optarg);
+        break;
+      case 'c':
+        colors = (uint32)atoi(optarg);
+        break;
+      case 'r':
+        repeats = TRUE;
+        break;
+      case 'j':
+        threads = (uint32)atoi(optarg);
+        break;
+      case 'o':
+        out_path = optarg;
+        break;
+      case 'i':
+        in_path = optarg;
+        break;
+      case 'v':
+        full = TRUE;
+        break;
+      default:
+        out_path = in_path = NULL;
+        break;
+    } /* switch */
+  } /* while */
+  if ((NULL == out_path) == (NULL == in_path))
+  {
+    fprintf(stderr, "usage: %s [-p pegs] [-c colors] [-r] [-j threads] "
+                    "-o file\n"
+                    "       %s [-p pegs] [-c colors] [-r] [-v] -i file\n",
+            argv[0], argv[0]);
+    return 2;
+  } /* if */
+  if (threads < 1 || threads > GS_MAX_THREADS)
+  {
+    fprintf(stderr, "threads must be 1 to %u\n", GS_MAX_THREADS);
+    return 2;
+  } /* if */
+  if (0 == score_table_layout(&_header, pegs, colors, repeats))
+  {
+    fprintf(stderr, "unsupported configuration\n");
+    return 2;
+  } /* if */
+
+  if (NULL != in_path)
+  {
+    return _check(in_path, pegs, colors, repeats, full);
+  } /* if */
+
+  _codes    = malloc(_header.codes * sizeof(uint32));
+  _row_data = (_header.codes * _header.cell_bits + 7) / 8;
+  codeset_fill(_codes, pegs, colors, repeats);
+  score_batch_select(SB_IMPL_AUTO);
+
+  start = _now();
+  if (0 != _generate(out_path, threads))
+  {
+    return 1;
+  } /* if */
+  printf("%u pegs, %u colors, %s: %u codes, %u threads (%s)\n", pegs,
+         colors, repeats ? "repeats" : "no repeats", _header.codes, threads,
+         score_batch_name(SB_IMPL_AUTO));
+  printf("%s: %llu bytes, %u-bit cells, %u-byte rows, made in %.3f s\n",
+         out_path, (unsigned long long)_header.file_size, _header.cell_bits,
+         _header.row_bytes, _now() - start);
+
+  free(_codes);
+  return 0;
+} /* main */
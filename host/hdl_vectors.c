@@ -0,0 +1,248 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  hdl_vectors.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Writes the vector files that the self-checking testbenches in vhdl/
+//    read.  The expected values come from the same software models that
+//    the firmware and the host tools are checked against, so a testbench
+//    run holds the hardware to those models, clock for clock.
+//
+//    -l  lfsr_peripheral_tb.vhd: bus accesses and expected values, one
+//        per line, in clock order:
+//            w <edge> <range>    write RANGE on rising edge <edge>
+//            r <edge> <value>    read BOUNDED on rising edge <edge>
+//        Edges count from the first one out of reset, as 1, and the LFSR
+//        is never seeded, so it starts from LFSR_MODEL_RESET.  <value> is
+//        the bounded value read, or -1 if the register must read stale.
+//        Each range in _hv_ranges is written once and then read on every
+//        clock for an LFSR period.  The register (read a clock late, as
+//        dout is registered) is held to lfsr_model_bounded_at, with the
+//        range written on the clock before the write's edge.
+//
+//    -s  score_ci_tb.vhd: every pair of packed codes with colors below
+//        CB_POSSIBLE_COLORS, repeats included, and score_code's score
+//        for it, one per line:
+//            <secret> <guess> <score>
+//
+//  USAGE
+//    hdl_vectors [-l file] [-s file]
+//      -l  write the LFSR testbench's vectors here
+//      -s  write the score testbench's vectors here
+//
+//  BUILDING
+//    gcc -O2 -Wall -Ibsp -I../nios -o hdl_vectors hdl_vectors.c
+//        lfsr_model.c lfsr_soft_if.c ../nios/utilities.c
+//        ../nios/color_table.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for score_code
+#include "lfsr_model.h"
+
+// Ranges the LFSR testbench writes, in order: the edges of the mask
+// logic, the firmware's secrets (CB_CODES) and taunts, and zero, which
+// never keeps anything
+static const uint16 _hv_ranges[] =
+{
+  1, 2, 3, 4, 6, 1296, 0x4000, 0x4001, 0x7FFF, 0x8000, 0, 5
+};
+
+//-------------------------------------------------------------------------
+// NAME:        _hv_lfsr
+//
+// DESCRIPTION: Writes the LFSR testbench's vectors.
+// ARGUMENTS:   FILE* out, where they go
+// RETURNS:     uint64, the lines written
+//-------------------------------------------------------------------------
+static uint64 _hv_lfsr(FILE* out)
+{
+  uint64 edge  = 1;             // the next edge with nothing on it yet
+  uint64 lines = 0;
+  uint64 written;
+  uint64 state_at;              // the clock state is the LFSR at
+  uint16 state = LFSR_MODEL_RESET;
+  uint32 r;
+  uint32 i;
+
+  state_at = 0;
+  for (r = 0; r < sizeof(_hv_ranges) / sizeof(_hv_ranges[0]); r++)
+  {
+    written = edge++;
+    fprintf(out, "w %llu %u\n", (unsigned long long)written,
+            _hv_ranges[r]);
+    lines++;
+
+    for (i = 0; i < LFSR_MODEL_PERIOD; i++, edge++)
+    {
+      // dout on this edge is the register after the one before it,
+      // which the model has at the clock before that
+      while (state_at < edge - 2)
+      {
+        state = lfsr_model_step(state);
+        state_at++;
+      } /* while */
+      fprintf(out, "r %llu %d\n", (unsigned long long)edge,
+              (int)lfsr_model_bounded_at(state, edge - 2, written - 1,
+                                         _hv_ranges[r]));
+      lines++;
+    } /* for i */
+  } /* for r */
+
+  return lines;
+} /* _hv_lfsr */
+
+//-------------------------------------------------------------------------
+// NAME:        _hv_score
+//
+// DESCRIPTION: Writes the score testbench's vectors: every secret, and
+//              for each, every guess, counting up in base
+//              CB_POSSIBLE_COLORS with slot 0 the lowest digit.
+// ARGUMENTS:   FILE* out, where they go
+// RETURNS:     uint64, the lines written
+//-------------------------------------------------------------------------
+static uint64 _hv_score(FILE* out)
+{
+  uint32* codes;
+  uint32  total = 1;
+  uint32  count = 0;
+  uint32  code  = 0;
+  uint64  lines = 0;
+  uint32  secret;
+  uint32  guess;
+  uint32  i;
+
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    total *= CB_POSSIBLE_COLORS;
+  } /* for i */
+  codes = malloc(total * sizeof(*codes));
+  if (NULL == codes)
+  {
+    return 0;
+  } /* if */
+
+  // Each packed code in turn: bump slot 0, carrying past the last color
+  while (count < total)
+  {
+    codes[count++] = code;
+    for (i = 0; i < CB_COLOR_LENGTH; i++)
+    {
+      if (CODE_SLOT(code, i) < CB_POSSIBLE_COLORS - 1)
+      {
+        code += 1 << (i * 4);
+        break;
+      } /* if no carry */
+      code &= ~(0xF << (i * 4));
+    } /* for i */
+  } /* while */
+
+  for (secret = 0; secret < total; secret++)
+  {
+    for (guess = 0; guess < total; guess++)
+    {
+      fprintf(out, "%u %u %u\n", codes[secret], codes[guess],
+              score_code(codes[secret], codes[guess]));
+      lines++;
+    } /* for guess */
+  } /* for secret */
+
+  free(codes);
+  return lines;
+} /* _hv_score */
+
+//-------------------------------------------------------------------------
+// NAME:        _hv_write
+//
+// DESCRIPTION: Writes one vector file.
+// ARGUMENTS:   const char* path, the file
+//              uint64 (*write)(FILE*), what goes in it
+//              const char* what, for the report
+// RETURNS:     int, 0 on success, 2 if the file can't be written
+//-------------------------------------------------------------------------
+static int _hv_write(const char* path, uint64 (*write)(FILE*),
+                     const char* what)
+{
+  FILE*  out;
+  uint64 lines;
+
+  out = fopen(path, "w");
+  if (NULL == out)
+  {
+    perror(path);
+    return 2;
+  } /* if */
+  lines = write(out);
+  if (0 != fclose(out))
+  {
+    perror(path);
+    return 2;
+  } /* if */
+  printf("%s: %llu %s vectors\n", path, (unsigned long long)lines, what);
+
+  return 0;
+} /* _hv_write */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Writes the vector files asked for.
+// ARGUMENTS:   int argc, char** argv, as in USAGE
+// RETURNS:     int, 0 on success, 2 on bad arguments or files
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  const char* lfsr_path  = NULL;
+  const char* score_path = NULL;
+  uint32      usage = FALSE;
+  int         status = 0;
+  int         opt;
+
+  while (-1 != (opt = getopt(argc, argv, "l:s:")))
+  {
+    switch (opt)
+    {
+      case 'l':
+        lfsr_path = optarg;
+        break;
+      case 's':
+        score_path = optarg;
+        break;
+      default:
+        usage = TRUE;
+        break;
+    } /* switch */
+  } /* while */
+  if (usage || (NULL == lfsr_path && NULL == score_path) || optind != argc)
+  {
+    fprintf(stderr, "usage: %s [-l file] [-s file]\n", argv[0]);
+    return 2;
+  } /* if */
+
+  if (NULL != lfsr_path)
+  {
+    status |= _hv_write(lfsr_path, _hv_lfsr, "LFSR");
+  } /* if */
+  if (NULL != score_path)
+  {
+    status |= _hv_write(score_path, _hv_score, "score");
+  } /* if */
+
+  return status;
+} /* main */
@@ -0,0 +1,230 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  lfsr_model.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    This file implements a bit-exact software model of the LFSR in
+//    lfsr_peripheral.vhd.  The hardware shifts once per clock, so the
+//    model can also jump ahead by an arbitrary number of clocks, which is
+//    what a CPU read some time after seeding actually observes.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "lfsr_model.h"
+
+// Jump tables: _lfsr_jump[k][b] is the state reached after 2^k clocks
+// from the state with only bit b set.  The LFSR is linear over GF(2), so
+// any state can be advanced by XORing the columns for its set bits.
+static uint16 _lfsr_jump[16][16];
+static uint32 _lfsr_jump_ready = FALSE;
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_model_step
+//
+// DESCRIPTION: Advances the LFSR by one clock, exactly as
+//              lfsr_register_p does: a right shift with the carry bit
+//              recirculated into bit 15 and XORed into the taps.
+// ARGUMENTS:   uint16 state, the current register value
+// RETURNS:     uint16, the register value one clock later
+//-------------------------------------------------------------------------
+uint16 lfsr_model_step(uint16 state)
+{
+  if (0 != (state & 0x1))
+  {
+    return (uint16)((state >> 1) ^ LFSR_MODEL_TAPS);
+  } /* if carry */
+
+  return (uint16)(state >> 1);
+} /* lfsr_model_step */
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_model_unstep
+//
+// DESCRIPTION: Undoes lfsr_model_step.  Bit 15 of the later state is the
+//              bit that was shifted out, which says whether the taps
+//              were applied.
+// ARGUMENTS:   uint16 state, the register value
+// RETURNS:     uint16, the register value one clock earlier
+//-------------------------------------------------------------------------
+uint16 lfsr_model_unstep(uint16 state)
+{
+  if (0 != (state & 0x8000))
+  {
+    return (uint16)(((state ^ LFSR_MODEL_TAPS) << 1) | 0x1);
+  } /* if carry */
+
+  return (uint16)(state << 1);
+} /* lfsr_model_unstep */
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_model_bounded
+//
+// DESCRIPTION: The bounded register's candidate for one LFSR state, as
+//              bounded_register_p forms it on a sample clock: the state less one, masked to
+//              the bits of range-1 (and to 15 bits), kept only if it is
+//              below the range.
+// ARGUMENTS:   uint16 state, the LFSR register value
+//              uint16 range, the range register value
+// RETURNS:     int32, the candidate, or -1 if it is rejected
+//-------------------------------------------------------------------------
+int32 lfsr_model_bounded(uint16 state, uint16 range)
+{
+  uint16 mask = (uint16)(range - 1);
+  uint16 candidate;
+
+  mask |= mask >> 1;
+  mask |= mask >> 2;
+  mask |= mask >> 4;
+  mask |= mask >> 8;
+  candidate = (uint16)(state - 1) & mask & LFSR_MODEL_BOUND_BITS;
+
+  return (candidate < range) ? (int32)candidate : -1;
+} /* lfsr_model_bounded */
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_model_bounded_at
+//
+// DESCRIPTION: The bounded register's value at a clock: the candidate of
+//              the latest sample clock (a multiple of LFSR_MODEL_SAMPLE)
+//              since the range was written that was kept, found by
+//              stepping the LFSR back.
+// ARGUMENTS:   uint16 state, the LFSR register value at clock now
+//              uint64 now, the clock
+//              uint64 since, the clock the range was written
+//              uint16 range, the range register value
+// RETURNS:     int32, the register's value, or -1 if no candidate has
+//              been kept since (it is stale)
+//-------------------------------------------------------------------------
+int32 lfsr_model_bounded_at(uint16 state, uint64 now, uint64 since,
+                            uint16 range)
+{
+  uint64 t = now - now % LFSR_MODEL_SAMPLE;
+  int32  value;
+  uint32 i;
+
+  if (0 == range)
+  {
+    return -1;
+  } /* if nothing is ever kept */
+
+  for (i = 0; i < now % LFSR_MODEL_SAMPLE; i++)
+  {
+    state = lfsr_model_unstep(state);
+  } /* for i */
+
+  while (t > since)
+  {
+    value = lfsr_model_bounded(state, range);
+    if (value >= 0 || t < LFSR_MODEL_SAMPLE)
+    {
+      return value;
+    } /* if kept, or no earlier sample */
+    for (i = 0; i < LFSR_MODEL_SAMPLE; i++)
+    {
+      state = lfsr_model_unstep(state);
+    } /* for i */
+    t -= LFSR_MODEL_SAMPLE;
+  } /* while */
+
+  return -1;
+} /* lfsr_model_bounded_at */
+
+//-------------------------------------------------------------------------
+// NAME:        _lfsr_apply
+//
+// DESCRIPTION: Applies one jump table to a state.
+//-------------------------------------------------------------------------
+static uint16 _lfsr_apply(uint16 table[16], uint16 state)
+{
+  uint16 result = 0;
+  uint32 bit;
+
+  for (bit = 0; bit < 16; bit++)
+  {
+    if (0 != (state & (1 << bit)))
+    {
+      result ^= table[bit];
+    } /* if */
+  } /* for bit */
+
+  return result;
+} /* _lfsr_apply */
+
+//-------------------------------------------------------------------------
+// NAME:        _lfsr_build_jumps
+//
+// DESCRIPTION: Fills the jump tables by repeated squaring.
+//-------------------------------------------------------------------------
+static void _lfsr_build_jumps()
+{
+  uint32 k;
+  uint32 bit;
+
+  for (bit = 0; bit < 16; bit++)
+  {
+    _lfsr_jump[0][bit] = lfsr_model_step((uint16)(1 << bit));
+  } /* for bit */
+
+  for (k = 1; k < 16; k++)
+  {
+    for (bit = 0; bit < 16; bit++)
+    {
+      _lfsr_jump[k][bit] = _lfsr_apply(_lfsr_jump[k-1],
+                                       _lfsr_jump[k-1][bit]);
+    } /* for bit */
+  } /* for k */
+
+  _lfsr_jump_ready = TRUE;
+} /* _lfsr_build_jumps */
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_model_advance
+//
+// DESCRIPTION: Advances the LFSR by an arbitrary number of clocks in
+//              O(log clocks) time.
+// ARGUMENTS:   uint16 state, the current register value
+//              uint64 clocks, number of clocks to advance
+// RETURNS:     uint16, the register value that many clocks later
+//-------------------------------------------------------------------------
+uint16 lfsr_model_advance(uint16 state, uint64 clocks)
+{
+  uint32 k;
+
+  // short hops are cheaper to step than to jump
+  if (clocks < 16)
+  {
+    while (clocks-- > 0)
+    {
+      state = lfsr_model_step(state);
+    } /* while */
+    return state;
+  } /* if */
+
+  if (!_lfsr_jump_ready)
+  {
+    _lfsr_build_jumps();
+  } /* if */
+
+  // the sequence repeats, so only the position within it matters
+  clocks %= LFSR_MODEL_PERIOD;
+  for (k = 0; 0 != clocks; k++, clocks >>= 1)
+  {
+    if (0 != (clocks & 1))
+    {
+      state = _lfsr_apply(_lfsr_jump[k], state);
+    } /* if */
+  } /* for k */
+
+  return state;
+} /* lfsr_model_advance */
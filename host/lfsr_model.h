@@ -0,0 +1,45 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  lfsr_model.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines the bit-exact software model of the 16-bit
+//      Galois LFSR in lfsr_peripheral.vhd.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_LFSR_MODEL__H
+#define __LAB_7_LFSR_MODEL__H
+
+#include "nios_std_types.h"   // standard data types
+
+// Feedback taps 16, 14, 13, 11, as applied to bits 15, 13, 12, 10
+#define   LFSR_MODEL_TAPS                 0xB400
+// Value of the LFSR register after reset
+#define   LFSR_MODEL_RESET                0xFFFF
+// Length of the maximal sequence
+#define   LFSR_MODEL_PERIOD               65535
+// Bits of a bounded value; bit 15 of the bounded register is its flag
+#define   LFSR_MODEL_BOUND_BITS           0x7FFF
+// Clocks between the bounded register's candidates
+#define   LFSR_MODEL_SAMPLE               16
+
+// Prototypes for public functions
+uint16 lfsr_model_step(uint16 state);
+uint16 lfsr_model_unstep(uint16 state);
+int32 lfsr_model_bounded(uint16 state, uint16 range);
+int32 lfsr_model_bounded_at(uint16 state, uint64 now, uint64 since,
+                            uint16 range);
+uint16 lfsr_model_advance(uint16 state, uint64 clocks);
+
+#endif /* __LAB_7_LFSR_MODEL__H */
@@ -0,0 +1,719 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  lfsr_quality.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Statistical checks of the LFSR as the firmware samples it.  The
+//    hardware shifts every clock and the CPU reads it some number of
+//    clocks apart, so what matters is not the raw sequence but the
+//    secrets generate_secret_code makes from reads at realistic spacing.
+//    Everything here runs the real generate_secret_code on the bit-exact
+//    model (through lfsr_soft_if.c), with the spacing drawn from two
+//    ranges: clocks between the reads within one secret, and clocks
+//    between secrets (a game's length, at 50 MHz).  The spacing comes
+//    from a separate generator seeded by -s; a fixed range (-G n:n)
+//    shows the LFSR with no help from the player's timing.
+//
+//    Checks:
+//      period    the sequence from reset repeats after 65535 clocks and
+//                visits every nonzero state; the jump-ahead and the
+//                inverse step agree with single steps; the bounded
+//                register's candidates are uniform over a period for
+//                the ranges the firmware uses (CB_CODES for secrets, 4
+//                for taunts)
+//      codes     the secret each LFSR state at a draw leads to, over
+//                every state (exact), and chi-square of the secrets
+//                drawn, over the CB_CODES codes
+//      slots     chi-square of each slot's colors
+//      words     serial correlation of raw reads at the read spacing
+//      serial    serial correlation of consecutive secrets' indices,
+//                and chi-square of consecutive secrets' first colors
+//
+//    A failed distribution check lists the codes (or colors, or pairs)
+//    furthest from their expected counts.  Then the model's throughput
+//    is timed.
+//
+//    A secret is a function of the one 16-bit state the draw starts
+//    from, so no code can be closer to uniform than 1 in 65535, and a
+//    sample much larger than that finds this granularity rather than a
+//    flaw; the exact check measures it directly.
+//
+//  USAGE
+//    lfsr_quality [-n secrets] [-g lo:hi] [-G lo:hi] [-s seed]
+//                 [-a alpha] [-t seconds] [-B]
+//      -n  secrets to draw (default half the LFSR period, 32767)
+//      -g  clocks between reads within a secret (default 40:200)
+//      -G  clocks between secrets (default 50000000:3000000000)
+//      -s  seed for the spacing, and (low 16 bits) the LFSR (default 1)
+//      -a  a check fails below this p-value (default 0.001)
+//      -t  seconds to time each benchmark (default 0.5)
+//      -B  skip the benchmarks
+//
+//  BUILDING
+//    gcc -O2 -Wall -Ibsp -I../nios -o lfsr_quality lfsr_quality.c
+//        lfsr_model.c lfsr_soft_if.c ../nios/utilities.c
+//        ../nios/color_table.c -lm
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for generate_secret_code
+#include "lfsr_if.h"          // the interface lfsr_soft_if.c stands in for
+#include "lfsr_model.h"       // bit-exact LFSR model
+
+// Codes and colors listed when a distribution check fails
+#define   LQ_WORST                        5
+
+// Checks of the jump-ahead against single steps
+#define   LQ_JUMP_CHECKS                  64
+#define   LQ_JUMP_MAX                     100000
+
+// Clocks between reads within lfsr_soft_if.c (it has no header)
+extern uint32 lfsr_soft_gap;
+
+// A spacing range, in clocks
+typedef struct
+{
+  uint32 lo;
+  uint32 hi;
+} _lq_gap_t;
+
+static _lq_gap_t  _read_gap   = { 40, 200 };
+static _lq_gap_t  _secret_gap = { 50000000, 3000000000U };
+static uint64     _rng;
+static double     _alpha      = 0.001;
+static uint32     _failures   = 0;
+
+// Code numbering: _index[code] is code_from_index's index, or -1
+static int32      _index[1 << (CB_COLOR_LENGTH * 4)];
+static uint32     _codes[CB_CODES];
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _spacing
+//
+// DESCRIPTION: Draws a spacing from a range (splitmix64, independent of
+//              the LFSR).
+//-------------------------------------------------------------------------
+static uint32 _spacing(const _lq_gap_t* gap)
+{
+  uint64 z;
+
+  _rng += 0x9E3779B97F4A7C15ULL;
+  z     = _rng;
+  z     = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z     = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z    ^= z >> 31;
+
+  return gap->lo + (uint32)(z % ((uint64)gap->hi - gap->lo + 1));
+} /* _spacing */
+
+//-------------------------------------------------------------------------
+// NAME:        _draw_secret
+//
+// DESCRIPTION: Lets a game's worth of clocks go by, then has the firmware
+//              pick a secret.
+// RETURNS:     uint32, the code's index
+//-------------------------------------------------------------------------
+static uint32 _draw_secret()
+{
+  lfsr_soft_gap = _spacing(&_secret_gap);
+  (void)lfsr_rand();
+  lfsr_soft_gap = _spacing(&_read_gap);
+
+  return (uint32)_index[generate_secret_code()];
+} /* _draw_secret */
+
+//-------------------------------------------------------------------------
+// NAME:        _gamma_q
+//
+// DESCRIPTION: Upper regularized incomplete gamma function, by its series
+//              or continued fraction (whichever converges).
+//-------------------------------------------------------------------------
+static double _gamma_q(double a, double x)
+{
+  double sum, term, b, c, d, h, an;
+  uint32 i;
+
+  if (x <= 0)
+  {
+    return 1.0;
+  } /* if */
+
+  if (x < a + 1)
+  {
+    term = sum = 1.0 / a;
+    for (i = 1; i < 1000 && fabs(term) > fabs(sum) * 1e-15; i++)
+    {
+      term *= x / (a + i);
+      sum  += term;
+    } /* for i */
+    return 1.0 - sum * exp(-x + a * log(x) - lgamma(a));
+  } /* if series */
+
+  b = x + 1 - a;
+  c = 1e300;
+  d = 1 / b;
+  h = d;
+  for (i = 1; i < 1000; i++)
+  {
+    an = -(double)i * (i - a);
+    b += 2;
+    d  = an * d + b;
+    d  = (fabs(d) < 1e-300) ? 1e-300 : d;
+    c  = b + an / c;
+    c  = (fabs(c) < 1e-300) ? 1e-300 : c;
+    d  = 1 / d;
+    h *= d * c;
+    if (fabs(d * c - 1) < 1e-15)
+    {
+      break;
+    } /* if converged */
+  } /* for i */
+  return exp(-x + a * log(x) - lgamma(a)) * h;
+} /* _gamma_q */
+
+//-------------------------------------------------------------------------
+// NAME:        _verdict
+//
+// DESCRIPTION: Prints one check's result and counts a failure.
+// RETURNS:     uint32, TRUE if it failed
+//-------------------------------------------------------------------------
+static uint32 _verdict(const char* name, const char* statistic, double p)
+{
+  uint32 failed = (p < _alpha);
+
+  printf("%-8s %-36s p %-10.4g %s\n", name, statistic, p,
+         failed ? "FAIL" : "pass");
+  _failures += failed;
+  return failed;
+} /* _verdict */
+
+//-------------------------------------------------------------------------
+// NAME:        _exact
+//
+// DESCRIPTION: Prints the result of a check with no p-value (it either
+//              holds or not) and counts a failure.
+//-------------------------------------------------------------------------
+static void _exact(const char* name, const char* statistic, uint32 holds)
+{
+  printf("%-8s %-36s exact        %s\n", name, statistic,
+         holds ? "pass" : "FAIL");
+  _failures += !holds;
+} /* _exact */
+
+//-------------------------------------------------------------------------
+// NAME:        _chi_square
+//
+// DESCRIPTION: Chi-square of counts against equal expected counts, and
+//              its p-value.
+// RETURNS:     double, the p-value
+//-------------------------------------------------------------------------
+static double _chi_square(const uint32* counts, uint32 cells, uint64 total,
+                          double* chi2)
+{
+  double expect = (double)total / cells;
+  double sum    = 0;
+  uint32 i;
+
+  for (i = 0; i < cells; i++)
+  {
+    sum += (counts[i] - expect) * (counts[i] - expect) / expect;
+  } /* for i */
+
+  *chi2 = sum;
+  return _gamma_q((cells - 1) / 2.0, sum / 2);
+} /* _chi_square */
+
+//-------------------------------------------------------------------------
+// NAME:        _list_worst
+//
+// DESCRIPTION: Lists the cells furthest from their expected count, named
+//              by a callback.
+//-------------------------------------------------------------------------
+static void _list_worst(const uint32* counts, uint32 cells, uint64 total,
+                        void (*name)(uint32 cell, char* text))
+{
+  double  expect = (double)total / cells;
+  uint8*  shown  = calloc(cells, 1);
+  char    text[32];
+  double  z, worst_z;
+  uint32  worst, i, k;
+
+  for (k = 0; k < LQ_WORST && k < cells; k++)
+  {
+    worst   = 0;
+    worst_z = -1;
+    for (i = 0; i < cells; i++)
+    {
+      z = fabs(counts[i] - expect) / sqrt(expect);
+      if (!shown[i] && z > worst_z)
+      {
+        worst   = i;
+        worst_z = z;
+      } /* if */
+    } /* for i */
+    shown[worst] = TRUE;
+    name(worst, text);
+    printf("           %-12s %8u, expected %.1f (z %+.2f)\n", text,
+           counts[worst], expect, (counts[worst] - expect) / sqrt(expect));
+  } /* for k */
+
+  free(shown);
+} /* _list_worst */
+
+//-------------------------------------------------------------------------
+// NAME:        _name_code, _name_color, _name_pair
+//
+// DESCRIPTION: Names a cell for _list_worst.
+//-------------------------------------------------------------------------
+static void _name_code(uint32 cell, char* text)
+{
+  to_colorstr(_codes[cell], (uint8*)text);
+} /* _name_code */
+
+static void _name_color(uint32 cell, char* text)
+{
+  text[0] = (char)to_color((uint8)cell);
+  text[1] = 0;
+} /* _name_color */
+
+static void _name_pair(uint32 cell, char* text)
+{
+  sprintf(text, "%c then %c", to_color((uint8)(cell / CB_POSSIBLE_COLORS)),
+          to_color((uint8)(cell % CB_POSSIBLE_COLORS)));
+} /* _name_pair */
+
+//-------------------------------------------------------------------------
+// NAME:        _serial
+//
+// DESCRIPTION: Lag-one serial correlation (Knuth's), and the two-sided
+//              p-value of its normal approximation.
+// RETURNS:     double, the p-value
+//-------------------------------------------------------------------------
+static double _serial(const double* u, uint32 n, double* corr)
+{
+  double sum = 0, sum2 = 0, lag = 0, den;
+  uint32 i;
+
+  for (i = 0; i < n; i++)
+  {
+    sum  += u[i];
+    sum2 += u[i] * u[i];
+    lag  += u[i] * u[(i + 1) % n];
+  } /* for i */
+
+  den   = n * sum2 - sum * sum;
+  *corr = (0 == den) ? 1 : (n * lag - sum * sum) / den;
+  return erfc(fabs(*corr) * sqrt((double)n) / sqrt(2.0));
+} /* _serial */
+
+//-------------------------------------------------------------------------
+// NAME:        _check_period
+//
+// DESCRIPTION: The model's period, jumps and inverse, and the bounded
+//              register's candidates over a period.
+//-------------------------------------------------------------------------
+static void _check_period()
+{
+  static const _lq_gap_t any_state = { 1, 0xFFFF };
+  static const _lq_gap_t any_jump  = { 0, LQ_JUMP_MAX };
+  uint8*  seen  = calloc(65536, 1);
+  static const uint16 ranges[2] = { CB_CODES, 4 };
+  uint32  count[CB_CODES];
+  uint32  steps = 0;
+  uint32  bad   = 0;
+  uint32  radix, r;
+  uint16  state = LFSR_MODEL_RESET;
+  uint16  walk;
+  uint32  i, k, clocks;
+  int32   value;
+  char    text[64];
+
+  do
+  {
+    bad  += seen[state];
+    seen[state] = TRUE;
+    bad  += (lfsr_model_unstep(lfsr_model_step(state)) != state);
+    state = lfsr_model_step(state);
+    steps++;
+  } while (LFSR_MODEL_RESET != state && steps <= LFSR_MODEL_PERIOD);
+  for (i = 1; i < 65536; i++)
+  {
+    bad += !seen[i];
+  } /* for i */
+  bad += seen[0];
+  sprintf(text, "period %u, %u states wrong", steps, bad);
+  _exact("period", text, (LFSR_MODEL_PERIOD == steps && 0 == bad));
+
+  bad = 0;
+  for (k = 0; k < LQ_JUMP_CHECKS; k++)
+  {
+    state  = (uint16)_spacing(&any_state);
+    clocks = _spacing(&any_jump);
+    for (walk = state, i = 0; i < clocks; i++)
+    {
+      walk = lfsr_model_step(walk);
+    } /* for i */
+    bad += (lfsr_model_advance(state, clocks) != walk);
+    bad += (lfsr_model_advance(state, LFSR_MODEL_PERIOD) != state);
+  } /* for k */
+  sprintf(text, "%u of %u jumps wrong", bad, LQ_JUMP_CHECKS);
+  _exact("period", text, (0 == bad));
+
+  bad = 0;
+  for (r = 0; r < 2; r++)
+  {
+    radix = ranges[r];
+    memset(count, 0, sizeof(count));
+    for (state = 1, i = 0; i < LFSR_MODEL_PERIOD; i++)
+    {
+      value = lfsr_model_bounded(state, (uint16)radix);
+      if (value >= 0)
+      {
+        count[value]++;
+      } /* if kept */
+      state = lfsr_model_step(state);
+    } /* for i */
+    // a power-of-two range's top value comes up once less
+    for (i = 1; i < radix; i++)
+    {
+      bad += (count[i] != count[0] &&
+              (0 != (radix & (radix - 1)) || i != radix - 1 ||
+               count[i] + 1 != count[0]));
+    } /* for i */
+  } /* for r */
+  sprintf(text, "bounded ranges %u and %u, %u uneven", ranges[0],
+          ranges[1], bad);
+  _exact("period", text, (0 == bad));
+
+  free(seen);
+} /* _check_period */
+
+//-------------------------------------------------------------------------
+// NAME:        _check_every_state
+//
+// DESCRIPTION: The secret drawn from each LFSR state on the first sample
+//              clock of a draw: the first candidate kept from there on,
+//              one per LFSR_MODEL_SAMPLE clocks.  Counted over every
+//              state, as if each were one draw.
+//-------------------------------------------------------------------------
+static void _check_every_state()
+{
+  uint32* counts = calloc(CB_CODES, sizeof(uint32));
+  uint16  state;
+  uint16  walk;
+  int32   value;
+  double  chi2, p;
+  char    text[64];
+
+  for (state = 1; 0 != state; state++)
+  {
+    walk = state;
+    while ((value = lfsr_model_bounded(walk, CB_CODES)) < 0)
+    {
+      walk = lfsr_model_advance(walk, LFSR_MODEL_SAMPLE);
+    } /* while rejected */
+    counts[value]++;
+  } /* for state */
+
+  p = _chi_square(counts, CB_CODES, LFSR_MODEL_PERIOD, &chi2);
+  sprintf(text, "every state, chi2 %.1f, %u df", chi2, CB_CODES - 1);
+  if (_verdict("codes", text, p))
+  {
+    _list_worst(counts, CB_CODES, LFSR_MODEL_PERIOD, _name_code);
+  } /* if */
+
+  free(counts);
+} /* _check_every_state */
+
+//-------------------------------------------------------------------------
+// NAME:        _check_secrets
+//
+// DESCRIPTION: Draws secrets and checks their distribution and the
+//              correlation between consecutive ones.
+//-------------------------------------------------------------------------
+static void _check_secrets(uint32 secrets)
+{
+  uint32* counts = calloc(CB_CODES, sizeof(uint32));
+  uint32* slots  = calloc(CB_COLOR_LENGTH * CB_POSSIBLE_COLORS,
+                          sizeof(uint32));
+  uint32* pairs  = calloc(CB_POSSIBLE_COLORS * CB_POSSIBLE_COLORS,
+                          sizeof(uint32));
+  double* u      = malloc(secrets * sizeof(double));
+  uint32  index, last = 0;
+  uint32  i, s;
+  double  chi2, p, corr;
+  char    text[64];
+
+  for (i = 0; i < secrets; i++)
+  {
+    index = _draw_secret();
+    counts[index]++;
+    for (s = 0; s < CB_COLOR_LENGTH; s++)
+    {
+      slots[s * CB_POSSIBLE_COLORS + CODE_SLOT(_codes[index], s)]++;
+    } /* for s */
+    if (0 != i)
+    {
+      pairs[CODE_SLOT(_codes[last], 0) * CB_POSSIBLE_COLORS +
+            CODE_SLOT(_codes[index], 0)]++;
+    } /* if */
+    u[i] = (index + 0.5) / CB_CODES;
+    last = index;
+  } /* for i */
+
+  p = _chi_square(counts, CB_CODES, secrets, &chi2);
+  sprintf(text, "chi2 %.1f, %u df", chi2, CB_CODES - 1);
+  if (_verdict("codes", text, p))
+  {
+    _list_worst(counts, CB_CODES, secrets, _name_code);
+  } /* if */
+
+  for (s = 0; s < CB_COLOR_LENGTH; s++)
+  {
+    p = _chi_square(slots + s * CB_POSSIBLE_COLORS, CB_POSSIBLE_COLORS,
+                    secrets, &chi2);
+    sprintf(text, "slot %u chi2 %.2f, %u df", s, chi2,
+            CB_POSSIBLE_COLORS - 1);
+    if (_verdict("slots", text, p))
+    {
+      _list_worst(slots + s * CB_POSSIBLE_COLORS, CB_POSSIBLE_COLORS,
+                  secrets, _name_color);
+    } /* if */
+  } /* for s */
+
+  p = _serial(u, secrets, &corr);
+  sprintf(text, "secret index lag 1, r %+.5f", corr);
+  _verdict("serial", text, p);
+
+  p = _chi_square(pairs, CB_POSSIBLE_COLORS * CB_POSSIBLE_COLORS,
+                  secrets - 1, &chi2);
+  sprintf(text, "first colors chi2 %.1f, %u df", chi2,
+          CB_POSSIBLE_COLORS * CB_POSSIBLE_COLORS - 1);
+  if (_verdict("serial", text, p))
+  {
+    _list_worst(pairs, CB_POSSIBLE_COLORS * CB_POSSIBLE_COLORS,
+                secrets - 1, _name_pair);
+  } /* if */
+
+  free(counts);
+  free(slots);
+  free(pairs);
+  free(u);
+} /* _check_secrets */
+
+//-------------------------------------------------------------------------
+// NAME:        _check_words
+//
+// DESCRIPTION: Serial correlation of raw reads, whole and low bits, at
+//              the read spacing.
+//-------------------------------------------------------------------------
+static void _check_words(uint32 reads)
+{
+  double* whole = malloc(reads * sizeof(double));
+  double* low   = malloc(reads * sizeof(double));
+  uint16  value;
+  uint32  i;
+  double  p, corr;
+  char    text[64];
+
+  for (i = 0; i < reads; i++)
+  {
+    lfsr_soft_gap = _spacing(&_read_gap);
+    value    = lfsr_rand();
+    whole[i] = value;
+    low[i]   = value & 0x7;
+  } /* for i */
+
+  p = _serial(whole, reads, &corr);
+  sprintf(text, "16-bit reads lag 1, r %+.5f", corr);
+  _verdict("words", text, p);
+  p = _serial(low, reads, &corr);
+  sprintf(text, "low 3 bits lag 1, r %+.5f", corr);
+  _verdict("words", text, p);
+
+  free(whole);
+  free(low);
+} /* _check_words */
+
+//-------------------------------------------------------------------------
+// NAME:        _bench
+//
+// DESCRIPTION: Times the model: single steps, jumps by the read spacing,
+//              bounded draws and whole secrets.
+//-------------------------------------------------------------------------
+static void _bench(double seconds)
+{
+  static const char* names[4] =
+  {
+    "lfsr_model_step", "lfsr_model_advance", "lfsr_rand_below(6)",
+    "generate_secret_code"
+  };
+  volatile uint32 sink  = 0;
+  uint16          state = 1;
+  uint64          done;
+  uint32          which, i;
+  double          start, elapsed;
+
+  lfsr_soft_gap = (_read_gap.lo + _read_gap.hi) / 2;
+  for (which = 0; which < 4; which++)
+  {
+    done  = 0;
+    start = _now();
+    do
+    {
+      for (i = 0; i < 4096; i++)
+      {
+        switch (which)
+        {
+          case 0:
+            state = lfsr_model_step(state);
+            break;
+          case 1:
+            state = lfsr_model_advance(state, lfsr_soft_gap);
+            break;
+          case 2:
+            state ^= lfsr_rand_below(6);
+            break;
+          default:
+            state ^= (uint16)generate_secret_code();
+            break;
+        } /* switch */
+      } /* for i */
+      done   += 4096;
+      elapsed = _now() - start;
+    } while (elapsed < seconds);
+    sink += state;
+    printf("bench    %-22s %12.0f per second\n", names[which],
+           done / elapsed);
+  } /* for which */
+} /* _bench */
+
+//-------------------------------------------------------------------------
+// NAME:        _parse_gap
+//
+// DESCRIPTION: Parses lo:hi (or a single n) into a spacing range.
+// RETURNS:     uint32, TRUE if it made sense
+//-------------------------------------------------------------------------
+static uint32 _parse_gap(const char* text, _lq_gap_t* gap)
+{
+  char* end;
+
+  gap->lo = (uint32)strtoul(text, &end, 0);
+  gap->hi = (':' == *end) ? (uint32)strtoul(end + 1, &end, 0) : gap->lo;
+  return (0 == *end && gap->lo >= 1 && gap->hi >= gap->lo);
+} /* _parse_gap */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, runs the checks and the benchmarks.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  uint32  secrets = LFSR_MODEL_PERIOD / 2;
+  uint32  seed    = 1;
+  uint32  bench   = TRUE;
+  double  seconds = 0.5;
+  uint32  i;
+  int     opt;
+
+  while (-1 != (opt = getopt(argc, argv, "n:g:G:s:a:t:B")))
+  {
+    switch (opt)
+    {
+      case 'n':
+        secrets = (uint32)atoi(optarg);
+        break;
+      case 'g':
+        secrets = _parse_gap(optarg, &_read_gap) ? secrets : 0;
+        break;
+      case 'G':
+        secrets = _parse_gap(optarg, &_secret_gap) ? secrets : 0;
+        break;
+      case 's':
+        seed = (uint32)strtoul(optarg, NULL, 0);
+        break;
+      case 'a':
+        _alpha = atof(optarg);
+        break;
+      case 't':
+        seconds = atof(optarg);
+        break;
+      case 'B':
+        bench = FALSE;
+        break;
+      default:
+        secrets = 0;
+        break;
+    } /* switch */
+  } /* while */
+  if (secrets < 2)
+  {
+    fprintf(stderr, "usage: %s [-n secrets] [-g lo:hi] [-G lo:hi] "
+                    "[-s seed] [-a alpha] [-t seconds] [-B]\n", argv[0]);
+    return 2;
+  } /* if */
+
+  memset(_index, 0xFF, sizeof(_index));
+  for (i = 0; i < CB_CODES; i++)
+  {
+    _codes[i]         = code_from_index(i);
+    _index[_codes[i]] = (int32)i;
+  } /* for i */
+  _rng = seed;
+  lfsr_rand_init((0 != (seed & 0xFFFF)) ? (uint16)seed : 1);
+
+  printf("%u secrets of %u codes, reads %u-%u clocks apart, secrets "
+         "%u-%u\n", secrets, CB_CODES, _read_gap.lo, _read_gap.hi,
+         _secret_gap.lo, _secret_gap.hi);
+  if (_read_gap.lo == _read_gap.hi && _secret_gap.lo == _secret_gap.hi)
+  {
+    printf("(fixed spacing: the secrets cycle within the LFSR's period, "
+           "so this is the LFSR alone)\n");
+  } /* if */
+  _check_period();
+  _check_every_state();
+  _check_secrets(secrets);
+  _check_words(secrets);
+  printf("%u check%s failed at p < %g\n", _failures,
+         (1 == _failures) ? "" : "s", _alpha);
+
+  if (bench)
+  {
+    _bench(seconds);
+  } /* if */
+
+  return (0 == _failures) ? 0 : 1;
+} /* main */
@@ -0,0 +1,110 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  lfsr_soft_if.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Host stand-in for lfsr_if.c.  Implements the same public functions
+//    on top of the software LFSR model, for host tools that link the
+//    firmware utilities without the register model.  Each read advances
+//    the model by lfsr_soft_gap clocks, the spacing between reads.  A
+//    bounded draw writes the range, then returns what the bounded
+//    register holds a read later, waiting for a candidate to be kept
+//    since the write, as lfsr_if.c does.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+
+#include "lfsr_if.h"          // the interface being stood in for
+#include "lfsr_model.h"       // bit-exact LFSR model
+
+// Clocks between consecutive reads
+uint32  lfsr_soft_gap = 1;
+
+static uint16 _lfsr_state  = LFSR_MODEL_RESET;
+static uint32 _lfsr_seeded = FALSE;
+static uint64 _lfsr_clock  = 0;
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_rand
+//
+// DESCRIPTION: Retrieves the next value from the LFSR model.
+// ARGUMENTS:   None
+// RETURNS:     uint16 random number
+//-------------------------------------------------------------------------
+uint16 lfsr_rand()
+{
+  _lfsr_state  = lfsr_model_advance(_lfsr_state, lfsr_soft_gap);
+  _lfsr_clock += lfsr_soft_gap;
+  return _lfsr_state;
+} /* lfsr_rand */
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_rand_below
+//
+// DESCRIPTION: Retrieves a uniform value below n from the LFSR model.
+// ARGUMENTS:   uint16 n, the range, 1 to LFSR_RANGE_MAX
+// RETURNS:     uint16 random number, 0 to n-1 (0 if n is 0 or 1)
+//-------------------------------------------------------------------------
+uint16 lfsr_rand_below(uint16 n)
+{
+  uint64 written;
+  int32  value;
+
+  if (n < 2)
+  {
+    return 0;
+  } /* if nothing to draw */
+
+  _lfsr_state  = lfsr_model_advance(_lfsr_state, lfsr_soft_gap);
+  _lfsr_clock += lfsr_soft_gap;
+  written      = _lfsr_clock;
+  while ((value = lfsr_model_bounded_at(_lfsr_state, _lfsr_clock,
+                                        written, n)) < 0)
+  {
+    _lfsr_state = lfsr_model_step(_lfsr_state);
+    _lfsr_clock++;
+  } /* while stale */
+
+  return (uint16)value;
+} /* lfsr_rand_below */
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_rand_valid
+//
+// DESCRIPTION: Validity check for LFSR readiness.
+// ARGUMENTS:   None
+// RETURNS:     uint32.  1 if the model has been seeded, 0 otherwise.
+//-------------------------------------------------------------------------
+uint32 lfsr_rand_valid()
+{
+  return _lfsr_seeded;
+} /* lfsr_rand_valid */
+
+//-------------------------------------------------------------------------
+// NAME:        lfsr_rand_init
+//
+// DESCRIPTION: Seeds the LFSR model
+// ARGUMENTS:   uint16 seed
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void lfsr_rand_init(uint16 seed)
+{
+  if (seed > 0)   // value must be > 0!!
+  {
+    _lfsr_state  = seed;
+    _lfsr_seeded = TRUE;
+  } /* if */
+
+  return;
+} /* lfsr_rand_init */
@@ -0,0 +1,826 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  microbench.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Microbenchmarks of the firmware's small hot paths: check_guess,
+//    score_code, generate_secret_code, convert_to_bcd, to_color,
+//    to_colorstr and the software timers' start and cancel, each over a
+//    few input distributions made from a fixed seed.  The firmware is
+//    linked as replay links it, on the register model, so the LFSR and
+//    timer accesses go through the model and are counted.
+//
+//    For each case it reports the best of several timed runs in ns/op
+//    and ops/s; the bus accesses and bus cycles per op, which are what
+//    the Nios would spend on the bus; and, where the kernel lets us
+//    count them, the host instructions retired per op.  With -o the
+//    results are written as JSON; with -b they are compared with a
+//    baseline written the same way, and any case that costs more bus
+//    cycles is flagged, as is any case slower by more than -r's
+//    threshold if one is given.
+//
+//  USAGE
+//    microbench [-s seed] [-t seconds] [-n runs] [-o file] [-b file]
+//               [-r percent] [-f filter]
+//      -s  seed for the inputs (default 1)
+//      -t  seconds per timed run (default 0.1)
+//      -n  timed runs per case; the best is kept (default 5)
+//      -o  write the results here, as JSON
+//      -b  compare with this baseline (see microbench_baseline.json)
+//      -r  regression threshold, percent slower (times aren't judged
+//          without it)
+//      -f  only cases whose name starts with this
+//
+//    Exits 1 if any case regressed, 2 on an error.  Times only compare on
+//    the same machine, and not always then: remake the baseline (-o) on
+//    the machine the comparisons will run on, and give -r a threshold
+//    above the run-to-run spread there, before judging them.  The bus
+//    counts compare anywhere, so the committed baseline is only held
+//    to those by default.  The checks CI runs:
+//      microbench -b microbench_baseline.json
+//          bus counts, against the committed baseline
+//      microbench -b <baseline made on the CI machine> -r 10
+//          times too, 10% at most slower, on a quiet machine that keeps
+//          its own baseline
+//
+//  BUILDING
+//    gcc -O2 -Wall -DHOST_MODEL -Ibsp -I. -I../nios -Dmain=firmware_main
+//        -c -o codebreaker.o ../nios/codebreaker.c
+//    gcc -O2 -Wall -DHOST_MODEL -Ibsp -I. -I../nios -o microbench
+//        microbench.c regmodel.c lfsr_model.c codebreaker.o
+//        ../nios/lfsr_if.c ../nios/pio_if.c ../nios/display_if.c
+//        ../nios/timer_if.c ../nios/uart_if.c ../nios/utilities.c
+//        ../nios/session_rec.c ../nios/book.c ../nios/book_table.c
+//        ../nios/color_table.c ../nios/analysis.c ../nios/defer.c
+//        ../nios/latency.c ../nios/msglog.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // for ALT_CPU_FREQ
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // the functions being measured
+#include "lfsr_if.h"          // for lfsr_rand_init
+#include "timer_if.h"         // for timer_event_*
+#include "regmodel.h"         // bus accounting
+
+// Inputs per case, cycled through
+#define   MB_INPUTS                       4096
+
+// Calls between clock checks
+#define   MB_BATCH                        4096
+
+// Results format
+#define   MB_VERSION                      1
+
+// Most cases
+#define   MB_MAX_CASES                    32
+
+// Software timers the timer cases cycle through
+#define   MB_EVENTS                       64
+
+// From codebreaker.c, which has no header for it
+uint32 check_guess(uint32 secret, uint32 guess, uint32 length, uint8* hint);
+
+// One case's inputs: two operands per call
+typedef struct
+{
+  uint32  a[MB_INPUTS];
+  uint32  b[MB_INPUTS];
+} _mb_inputs_t;
+
+// One case
+typedef struct
+{
+  const char* name;
+  const char* inputs;
+  void      (*make)(_mb_inputs_t* in);
+  uint32    (*run)(const _mb_inputs_t* in, uint32 calls);
+} _mb_case_t;
+
+// One result
+typedef struct
+{
+  double  ns;                 // per op, best run
+  double  instructions;       // host, per op; < 0 if not counted
+  double  accesses;           // bus, per op
+  double  cycles;             // bus, per op
+} _mb_result_t;
+
+static uint64         _rng;
+static uint64         _bus_accesses;
+static volatile uint32 _sink;
+static timer_event_t  _events[MB_EVENTS];
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _random
+//
+// DESCRIPTION: Input generator (splitmix64), below a bound.
+//-------------------------------------------------------------------------
+static uint32 _random(uint32 below)
+{
+  uint64 z;
+
+  _rng += 0x9E3779B97F4A7C15ULL;
+  z     = _rng;
+  z     = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z     = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z    ^= z >> 31;
+
+  return (uint32)(z % below);
+} /* _random */
+
+//-------------------------------------------------------------------------
+// NAME:        _bus_access
+//
+// DESCRIPTION: Register model hook: counts bus accesses.
+//-------------------------------------------------------------------------
+static void _bus_access(uint32 periph, uint32 reg, uint32 write,
+                        uint32 value, const char* func, uint32 cycles,
+                        uint32 count)
+{
+  _bus_accesses += count;
+} /* _bus_access */
+
+//-------------------------------------------------------------------------
+// NAME:        _any_colors
+//
+// DESCRIPTION: A packed guess of any colors, repeats allowed, as a player
+//              might type it.
+//-------------------------------------------------------------------------
+static uint32 _any_colors()
+{
+  uint32 code = 0;
+  uint32 i;
+
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    code |= _random(CB_POSSIBLE_COLORS) << (i * 4);
+  } /* for i */
+
+  return code;
+} /* _any_colors */
+
+//-------------------------------------------------------------------------
+// NAME:        _make_*
+//
+// DESCRIPTION: Input distributions.  a is the secret (or the value), b
+//              the guess; check_guess's length is in b's top byte.
+//-------------------------------------------------------------------------
+static void _make_guess_random(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = code_from_index(_random(CB_CODES));
+    in->b[i] = _any_colors() | (CB_COLOR_LENGTH << 24);
+  } /* for i */
+} /* _make_guess_random */
+
+static void _make_guess_solved(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = code_from_index(_random(CB_CODES));
+    in->b[i] = in->a[i] | (CB_COLOR_LENGTH << 24);
+  } /* for i */
+} /* _make_guess_solved */
+
+static void _make_guess_rotated(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  // every color right, none in place (without repeats)
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = code_from_index(_random(CB_CODES));
+    in->b[i] = ((in->a[i] >> 4) |
+                (CODE_SLOT(in->a[i], 0) << ((CB_COLOR_LENGTH - 1) * 4))) |
+               (CB_COLOR_LENGTH << 24);
+  } /* for i */
+} /* _make_guess_rotated */
+
+static void _make_guess_short(_mb_inputs_t* in)
+{
+  uint32 length;
+  uint32 i;
+
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    length   = 1 + _random(CB_COLOR_LENGTH - 1);
+    in->a[i] = code_from_index(_random(CB_CODES));
+    in->b[i] = (_any_colors() & ((1 << (length * 4)) - 1)) | (length << 24);
+  } /* for i */
+} /* _make_guess_short */
+
+static void _make_small(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  // guess counts, as the display shows them
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = _random(100);
+  } /* for i */
+} /* _make_small */
+
+static void _make_word(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = _random(0x10000);
+  } /* for i */
+} /* _make_word */
+
+static void _make_color(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = _random(CB_POSSIBLE_COLORS);
+  } /* for i */
+} /* _make_color */
+
+static void _make_byte(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = _random(0x100);
+  } /* for i */
+} /* _make_byte */
+
+static void _make_none(_mb_inputs_t* in)
+{
+} /* _make_none */
+
+static void _make_delays(_mb_inputs_t* in)
+{
+  uint32 i;
+
+  // an empty wheel, then delays of up to ten seconds, the games' spread
+  memset(_events, 0, sizeof(_events));
+  timer_init();
+  for (i = 0; i < MB_INPUTS; i++)
+  {
+    in->a[i] = TIMER_EVENT_MIN_DELAY + _random(10 * ALT_CPU_FREQ);
+    in->b[i] = _random(MB_EVENTS);
+  } /* for i */
+} /* _make_delays */
+
+//-------------------------------------------------------------------------
+// NAME:        _run_*
+//
+// DESCRIPTION: Makes a number of calls, cycling through the inputs.
+// RETURNS:     uint32, something of every result, so none is skipped
+//-------------------------------------------------------------------------
+static uint32 _run_check_guess(const _mb_inputs_t* in, uint32 calls)
+{
+  uint8  hint[CB_COLOR_LENGTH + 1];
+  uint32 sum = 0;
+  uint32 i, k;
+
+  for (i = 0; i < calls; i++)
+  {
+    k    = i & (MB_INPUTS - 1);
+    sum += check_guess(in->a[k], in->b[k] & 0xFFFFFF, in->b[k] >> 24, hint);
+    sum += hint[0];
+  } /* for i */
+
+  return sum;
+} /* _run_check_guess */
+
+static uint32 _run_score_code(const _mb_inputs_t* in, uint32 calls)
+{
+  uint32 sum = 0;
+  uint32 i, k;
+
+  for (i = 0; i < calls; i++)
+  {
+    k    = i & (MB_INPUTS - 1);
+    sum += score_code(in->a[k], in->b[k] & 0xFFFFFF);
+  } /* for i */
+
+  return sum;
+} /* _run_score_code */
+
+static uint32 _run_secret(const _mb_inputs_t* in, uint32 calls)
+{
+  uint32 sum = 0;
+  uint32 i;
+
+  for (i = 0; i < calls; i++)
+  {
+    sum += generate_secret_code();
+  } /* for i */
+
+  return sum;
+} /* _run_secret */
+
+static uint32 _run_bcd(const _mb_inputs_t* in, uint32 calls)
+{
+  uint32 sum = 0;
+  uint32 i;
+
+  for (i = 0; i < calls; i++)
+  {
+    sum += convert_to_bcd((uint16)in->a[i & (MB_INPUTS - 1)]);
+  } /* for i */
+
+  return sum;
+} /* _run_bcd */
+
+static uint32 _run_to_color(const _mb_inputs_t* in, uint32 calls)
+{
+  uint32 sum = 0;
+  uint32 i;
+
+  for (i = 0; i < calls; i++)
+  {
+    sum += to_color((uint8)in->a[i & (MB_INPUTS - 1)]);
+  } /* for i */
+
+  return sum;
+} /* _run_to_color */
+
+static uint32 _run_to_colorstr(const _mb_inputs_t* in, uint32 calls)
+{
+  uint8  text[CB_COLOR_LENGTH + 1];
+  uint32 sum = 0;
+  uint32 i;
+
+  for (i = 0; i < calls; i++)
+  {
+    to_colorstr(in->a[i & (MB_INPUTS - 1)], text);
+    sum += text[0];
+  } /* for i */
+
+  return sum;
+} /* _run_to_colorstr */
+
+static uint32 _run_timer_start(const _mb_inputs_t* in, uint32 calls)
+{
+  uint32 i, k;
+
+  // re-arms: the wheel fills up to MB_EVENTS and stays there
+  for (i = 0; i < calls; i++)
+  {
+    k = i & (MB_INPUTS - 1);
+    timer_event_start(&_events[in->b[k]], in->a[k], 0, NULL, 0);
+  } /* for i */
+
+  return timer_wakeups;
+} /* _run_timer_start */
+
+static uint32 _run_timer_cancel(const _mb_inputs_t* in, uint32 calls)
+{
+  uint32 sum = 0;
+  uint32 i, k;
+
+  for (i = 0; i < calls; i++)
+  {
+    k    = i & (MB_INPUTS - 1);
+    timer_event_start(&_events[in->b[k]], in->a[k], 0, NULL, 0);
+    sum += timer_event_cancel(&_events[in->b[k]]);
+  } /* for i */
+
+  return sum;
+} /* _run_timer_cancel */
+
+static const _mb_case_t _cases[] =
+{
+  { "check_guess",          "random",  _make_guess_random,  _run_check_guess },
+  { "check_guess",          "solved",  _make_guess_solved,  _run_check_guess },
+  { "check_guess",          "rotated", _make_guess_rotated, _run_check_guess },
+  { "check_guess",          "short",   _make_guess_short,   _run_check_guess },
+  { "score_code",           "random",  _make_guess_random,  _run_score_code },
+  { "score_code",           "solved",  _make_guess_solved,  _run_score_code },
+  { "generate_secret_code", "lfsr",    _make_none,          _run_secret },
+  { "convert_to_bcd",       "0-99",    _make_small,         _run_bcd },
+  { "convert_to_bcd",       "0-65535", _make_word,          _run_bcd },
+  { "to_color",             "valid",   _make_color,         _run_to_color },
+  { "to_color",             "0-255",   _make_byte,          _run_to_color },
+  { "to_colorstr",          "codes",   _make_guess_random,  _run_to_colorstr },
+  { "timer_event_start",    "rearm",   _make_delays,        _run_timer_start },
+  { "timer_event_start",    "+cancel", _make_delays,        _run_timer_cancel },
+};
+#define   MB_CASES    (sizeof(_cases) / sizeof(_cases[0]))
+
+//-------------------------------------------------------------------------
+// NAME:        _counter_open
+//
+// DESCRIPTION: Opens a host instruction counter for this thread.
+// RETURNS:     int, its descriptor, or -1 if the kernel won't count
+//-------------------------------------------------------------------------
+static int _counter_open()
+{
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.type           = PERF_TYPE_HARDWARE;
+  attr.size           = sizeof(attr);
+  attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv     = 1;
+
+  return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+} /* _counter_open */
+
+//-------------------------------------------------------------------------
+// NAME:        _counter_read
+//
+// DESCRIPTION: Reads the instruction counter (0 if there is none).
+//-------------------------------------------------------------------------
+static uint64 _counter_read(int fd)
+{
+  uint64 count = 0;
+
+  if (fd < 0 || sizeof(count) != read(fd, &count, sizeof(count)))
+  {
+    return 0;
+  } /* if */
+  return count;
+} /* _counter_read */
+
+//-------------------------------------------------------------------------
+// NAME:        _measure
+//
+// DESCRIPTION: Times a case: the best of several runs, each calling it in
+//              batches until its time is up.  The bus and instruction
+//              counts come from a separate run of one batch.
+//-------------------------------------------------------------------------
+static void _measure(const _mb_case_t* c, double seconds, uint32 runs,
+                     int counter, _mb_result_t* result)
+{
+  static _mb_inputs_t in;
+  uint64 calls;
+  uint64 busy, instructions;
+  double start, elapsed, ns;
+  uint32 r;
+
+  memset(&in, 0, sizeof(in));
+  c->make(&in);
+
+  // counts, from one batch
+  _bus_accesses = 0;
+  busy          = rm_busy_cycles;
+  instructions  = _counter_read(counter);
+  _sink        += c->run(&in, MB_BATCH);
+  instructions  = _counter_read(counter) - instructions;
+  result->accesses     = (double)_bus_accesses / MB_BATCH;
+  result->cycles       = (double)(rm_busy_cycles - busy) / MB_BATCH;
+  result->instructions = (counter < 0) ? -1.0
+                                       : (double)instructions / MB_BATCH;
+
+  // one untimed run, to settle the caches and the clock
+  start = _now();
+  while (_now() - start < seconds)
+  {
+    _sink += c->run(&in, MB_BATCH);
+  } /* while */
+
+  result->ns = 0;
+  for (r = 0; r < runs; r++)
+  {
+    calls = 0;
+    start = _now();
+    do
+    {
+      _sink  += c->run(&in, MB_BATCH);
+      calls  += MB_BATCH;
+      elapsed = _now() - start;
+    } while (elapsed < seconds);
+    ns = elapsed * 1e9 / calls;
+    if (0 == r || ns < result->ns)
+    {
+      result->ns = ns;
+    } /* if best */
+  } /* for r */
+} /* _measure */
+
+//-------------------------------------------------------------------------
+// NAME:        _config
+//
+// DESCRIPTION: The configuration line of the JSON results, which a
+//              baseline must match to be compared with.
+//-------------------------------------------------------------------------
+static void _config(char* text, size_t size, uint32 seed)
+{
+  snprintf(text, size,
+           "  \"config\": { \"pegs\": %u, \"colors\": %u, "
+           "\"repeats\": %s, \"seed\": %u },",
+           CB_COLOR_LENGTH, CB_POSSIBLE_COLORS,
+#ifdef REPEAT_COLORS
+           "true",
+#else
+           "false",
+#endif
+           seed);
+} /* _config */
+
+//-------------------------------------------------------------------------
+// NAME:        _write_json
+//
+// DESCRIPTION: Writes the results, one case per line.
+// RETURNS:     int, 0 on success, -1 on failure
+//-------------------------------------------------------------------------
+static int _write_json(const char* path, uint32 seed, const uint8* ran,
+                       const _mb_result_t* results)
+{
+  char    config[160];
+  char    count[32];
+  uint32  i, first = TRUE;
+  FILE*   out = fopen(path, "w");
+
+  if (NULL == out)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+
+  _config(config, sizeof(config), seed);
+  fprintf(out, "{\n  \"tool\": \"microbench\",\n  \"version\": %u,\n%s\n"
+               "  \"results\": [\n", MB_VERSION, config);
+  for (i = 0; i < MB_CASES; i++)
+  {
+    if (!ran[i])
+    {
+      continue;
+    } /* if */
+    if (results[i].instructions < 0)
+    {
+      strcpy(count, "null");
+    } /* if */
+    else
+    {
+      sprintf(count, "%.1f", results[i].instructions);
+    } /* else */
+    fprintf(out, "%s    { \"name\": \"%s\", \"inputs\": \"%s\", "
+                 "\"ns_per_op\": %.3f, \"ops_per_sec\": %.0f, "
+                 "\"host_instructions_per_op\": %s, "
+                 "\"bus_accesses_per_op\": %.2f, "
+                 "\"bus_cycles_per_op\": %.2f }",
+            first ? "" : ",\n", _cases[i].name, _cases[i].inputs,
+            results[i].ns, 1e9 / results[i].ns, count,
+            results[i].accesses, results[i].cycles);
+    first = FALSE;
+  } /* for i */
+  fprintf(out, "\n  ]\n}\n");
+
+  if (0 != fclose(out))
+  {
+    perror(path);
+    return -1;
+  } /* if */
+  return 0;
+} /* _write_json */
+
+//-------------------------------------------------------------------------
+// NAME:        _compare
+//
+// DESCRIPTION: Compares the results with a baseline written by -o,
+//              printing each case's change.  A case regresses if it
+//              costs any more bus cycles, which don't vary from run to
+//              run, or if it is slower by more than the threshold, if
+//              there is one (it is negative if not).
+// RETURNS:     int, the number of regressions, or -1 if the baseline
+//              can't be used
+//-------------------------------------------------------------------------
+static int _compare(const char* path, uint32 seed, const uint8* ran,
+                    const _mb_result_t* results, double threshold)
+{
+  char        line[512];
+  char        config[160];
+  char        name[64], inputs[64];
+  const char* field;
+  const char* verdict;
+  double      base, base_cycles, change, cycles;
+  uint32      matched = FALSE;
+  int         regressions = 0;
+  uint32      i;
+  FILE*       in = fopen(path, "r");
+
+  if (NULL == in)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+
+  // times are only comparable for the same configuration and inputs
+  _config(config, sizeof(config), seed);
+  while (!matched && NULL != fgets(line, sizeof(line), in))
+  {
+    line[strcspn(line, "\n")] = 0;
+    matched = (0 == strcmp(line, config));
+  } /* while */
+  if (!matched)
+  {
+    fprintf(stderr, "%s: made for another configuration or seed\n", path);
+    fclose(in);
+    return -1;
+  } /* if */
+
+  rewind(in);
+  printf("\n%-22s %-8s %12s %12s %9s %9s\n", "vs baseline", "inputs",
+         "base ns/op", "ns/op", "change", "bus cyc");
+  while (NULL != fgets(line, sizeof(line), in))
+  {
+    field = strstr(line, "\"bus_cycles_per_op\": ");
+    if (3 != sscanf(line, " { \"name\": \"%63[^\"]\", \"inputs\": "
+                          "\"%63[^\"]\", \"ns_per_op\": %lf",
+                    name, inputs, &base) ||
+        NULL == field ||
+        1 != sscanf(field + strlen("\"bus_cycles_per_op\": "), "%lf",
+                    &base_cycles))
+    {
+      continue;
+    } /* if not a result */
+    for (i = 0; i < MB_CASES; i++)
+    {
+      if (!ran[i] || 0 != strcmp(name, _cases[i].name) ||
+          0 != strcmp(inputs, _cases[i].inputs))
+      {
+        continue;
+      } /* if another case */
+      change  = (results[i].ns - base) * 100 / base;
+      cycles  = results[i].cycles - base_cycles;
+      cycles  = (cycles > -0.005 && cycles < 0.005) ? 0 : cycles;
+      verdict = "";
+      if (cycles > 0)
+      {
+        verdict = "  REGRESSION (bus)";
+      } /* if */
+      else if (threshold >= 0 && change > threshold)
+      {
+        verdict = "  REGRESSION";
+      } /* else if */
+      printf("%-22s %-8s %12.3f %12.3f %+8.1f%% %+9.2f%s\n", name, inputs,
+             base, results[i].ns, change, cycles, verdict);
+      regressions += ('\0' != verdict[0]);
+    } /* for i */
+  } /* while */
+  fclose(in);
+
+  return regressions;
+} /* _compare */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, measures every case, then writes and
+//              compares the results.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  _mb_result_t  results[MB_MAX_CASES];
+  uint8         ran[MB_MAX_CASES];
+  uint32        seed      = 1;
+  uint32        runs      = 5;
+  double        seconds   = 0.1;
+  double        threshold = -1;   // times aren't judged
+  const char*   out_path  = NULL;
+  const char*   base_path = NULL;
+  const char*   filter    = "";
+  char          count[32];
+  int           counter;
+  int           regressions = 0;
+  uint32        i;
+  int           opt;
+
+  while (-1 != (opt = getopt(argc, argv, "s:t:n:o:b:r:f:")))
+  {
+    switch (opt)
+    {
+      case 's':
+        seed = (uint32)strtoul(optarg, NULL, 0);
+        break;
+      case 't':
+        seconds = atof(optarg);
+        break;
+      case 'n':
+        runs = (uint32)atoi(optarg);
+        break;
+      case 'o':
+        out_path = optarg;
+        break;
+      case 'b':
+        base_path = optarg;
+        break;
+      case 'r':
+        threshold = atof(optarg);
+        break;
+      case 'f':
+        filter = optarg;
+        break;
+      default:
+        runs = 0;
+        break;
+    } /* switch */
+  } /* while */
+  if (runs < 1 || seconds <= 0)
+  {
+    fprintf(stderr, "usage: %s [-s seed] [-t seconds] [-n runs] [-o file] "
+                    "[-b file] [-r percent] [-f filter]\n", argv[0]);
+    return 2;
+  } /* if */
+
+  rm_reset();
+  rm_hooks.access = _bus_access;
+  lfsr_rand_init((0 != (seed & 0xFFFF)) ? (uint16)seed : 1);
+  counter = _counter_open();
+
+  printf("%u pegs, %u colors, %u codes; best of %u x %.2f s; host "
+         "instructions %s\n\n", CB_COLOR_LENGTH, CB_POSSIBLE_COLORS,
+         CB_CODES, runs, seconds,
+         (counter < 0) ? "not counted (no perf counter)" : "counted");
+  printf("%-22s %-8s %10s %14s %10s %9s %9s\n", "function", "inputs",
+         "ns/op", "ops/s", "host ins", "bus acc", "bus cyc");
+  memset(ran, 0, sizeof(ran));
+  for (i = 0; i < MB_CASES; i++)
+  {
+    if (0 != strncmp(_cases[i].name, filter, strlen(filter)))
+    {
+      continue;
+    } /* if filtered out */
+    _rng = seed;
+    _measure(&_cases[i], seconds, runs, counter, &results[i]);
+    ran[i] = TRUE;
+    if (results[i].instructions < 0)
+    {
+      strcpy(count, "-");
+    } /* if */
+    else
+    {
+      sprintf(count, "%.1f", results[i].instructions);
+    } /* else */
+    printf("%-22s %-8s %10.3f %14.0f %10s %9.2f %9.2f\n", _cases[i].name,
+           _cases[i].inputs, results[i].ns, 1e9 / results[i].ns, count,
+           results[i].accesses, results[i].cycles);
+  } /* for i */
+
+  if (NULL != out_path && 0 != _write_json(out_path, seed, ran, results))
+  {
+    return 2;
+  } /* if */
+  if (NULL != base_path)
+  {
+    regressions = _compare(base_path, seed, ran, results, threshold);
+    if (regressions < 0)
+    {
+      return 2;
+    } /* if */
+    printf("%d regression%s", regressions, (1 == regressions) ? "" : "s");
+    if (threshold >= 0)
+    {
+      printf(" (bus cycles, or over %.0f%% slower)\n", threshold);
+    } /* if */
+    else
+    {
+      printf(" (bus cycles; -r judges times too)\n");
+    } /* else */
+  } /* if */
+
+  if (counter >= 0)
+  {
+    close(counter);
+  } /* if */
+  return (0 == regressions) ? 0 : 1;
+} /* main */
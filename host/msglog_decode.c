@@ -0,0 +1,173 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  msglog_decode.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Renders the firmware's message log (msglog.c) as text.  The log is
+//    found in console captures of the board or of host/replay, as the
+//    "LOG BEGIN" ... "LOG END" blocks msglog_dump sends at the end of
+//    each game, and each message number is looked up in the dictionary
+//    in msglog.h, which this tool is built with.  Times are from the
+//    first message of each block.  The firmware only sends the blocks
+//    when it is built with MSG_LOG (see codebreaker.h).
+//
+//  USAGE
+//    msglog_decode [-d] [capture ...]
+//      -d  print the dictionary instead
+//    Reads standard input if no capture is given.
+//
+//  BUILDING
+//    gcc -O2 -Wall -Ibsp -I../nios -o msglog_decode msglog_decode.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // for ALT_CPU_FREQ
+#include "msglog.h"
+
+// The dictionary, from msglog.h
+#define _MD_NAME(id, format)      #id,
+#define _MD_FORMAT(id, format)    format,
+static const char* _md_names[MSGLOG_COUNT] =
+{
+  MSGLOG_MESSAGES(_MD_NAME)
+};
+static const char* _md_formats[MSGLOG_COUNT] =
+{
+  MSGLOG_MESSAGES(_MD_FORMAT)
+};
+
+//-------------------------------------------------------------------------
+// NAME:        _decode
+//
+// DESCRIPTION: Finds the message logs in a capture and prints them.
+// ARGUMENTS:   FILE* in, the capture
+// RETURNS:     void
+//-------------------------------------------------------------------------
+static void _decode(FILE* in)
+{
+  char          text[256];
+  unsigned int  lost;
+  unsigned int  time;
+  unsigned int  id;
+  unsigned int  a;
+  unsigned int  b;
+  uint32        in_block = FALSE;
+  uint32        first    = TRUE;
+  uint32        last     = 0;
+  uint64        elapsed  = 0;
+
+  while (NULL != fgets(text, sizeof(text), in))
+  {
+    if (1 == sscanf(text, "LOG BEGIN %x", &lost))
+    {
+      in_block = TRUE;
+      first    = TRUE;
+      elapsed  = 0;
+      printf("--- message log\n");
+      if (0 != lost)
+      {
+        printf("(%u earlier messages were overwritten)\n", lost);
+      } /* if */
+    } /* if begin */
+    else if (0 == strncmp(text, "LOG END", 7))
+    {
+      in_block = FALSE;
+    } /* else if end */
+    else if (in_block &&
+             4 == sscanf(text, "LOG %x %x %x %x", &time, &id, &a, &b))
+    {
+      // The timestamp counter wraps; add up the differences instead
+      if (!first)
+      {
+        elapsed += (uint32)(time - last);
+      } /* if */
+      first = FALSE;
+      last  = time;
+
+      printf("%12.6f  ", (double)elapsed / ALT_CPU_FREQ);
+      if (id < MSGLOG_COUNT)
+      {
+        printf(_md_formats[id], a, b);
+        putchar('\n');
+      } /* if */
+      else
+      {
+        printf("message %u, not in this dictionary (%08x %08x)\n",
+               id, a, b);
+      } /* else */
+    } /* else if message */
+  } /* while */
+} /* _decode */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Decodes each capture named, or standard input.
+// ARGUMENTS:   int argc, char** argv, as in USAGE
+// RETURNS:     int, 0 on success, 2 on bad arguments or files
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  uint32  dictionary = FALSE;
+  uint32  id;
+  FILE*   in;
+  int     status = 0;
+  int     opt;
+
+  while (-1 != (opt = getopt(argc, argv, "d")))
+  {
+    switch (opt)
+    {
+      case 'd':
+        dictionary = TRUE;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-d] [capture ...]\n", argv[0]);
+        return 2;
+    } /* switch */
+  } /* while */
+
+  if (dictionary)
+  {
+    for (id = 0; id < MSGLOG_COUNT; id++)
+    {
+      printf("%02x  %-20s %s\n", id, _md_names[id], _md_formats[id]);
+    } /* for id */
+    return 0;
+  } /* if */
+
+  if (optind == argc)
+  {
+    _decode(stdin);
+  } /* if */
+  for (; optind < argc; optind++)
+  {
+    in = fopen(argv[optind], "r");
+    if (NULL == in)
+    {
+      perror(argv[optind]);
+      status = 2;
+      continue;
+    } /* if */
+    _decode(in);
+    fclose(in);
+  } /* for */
+
+  return status;
+} /* main */
@@ -0,0 +1,1380 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  regmodel.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Host register model of the Game System.  The firmware in ../nios is
+//    compiled with HOST_MODEL defined, which routes every register access
+//    through rm_read/rm_write and every polling loop through rm_idle.
+//    The model keeps a simulated 50 MHz clock, advances it by a fixed
+//    cost per bus access, models the peripherals in nios_system.qsys
+//    against that clock, and calls the registered ISRs in priority order
+//    whenever an enabled interrupt line is up.
+//
+//    When the firmware idles, the clock jumps straight to the next thing
+//    that can happen (a stimulus event, an interrupting timeout, or the
+//    countdown reaching zero), so
+//    minutes of game time run in milliseconds.  Busy-waits on a full UART
+//    transmit FIFO are skipped the same way, with the polls they would
+//    have made still reported to the access hook.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // base addresses being modelled
+#include "lfsr_model.h"       // bit-exact LFSR
+#include "regmodel.h"
+
+// Hardware register indices (in units of the peripheral's data width)
+#define   TMR_STATUS          0
+#define   TMR_CONTROL         1
+#define   TMR_PERIOD_L        2
+#define   TMR_PERIOD_H        3
+#define   TMR_SNAP_L          4
+#define   TMR_SNAP_H          5
+#define   TMR_STATUS_TO       0x1
+#define   TMR_STATUS_RUN      0x2
+#define   TMR_CONTROL_ITO     0x1
+#define   TMR_CONTROL_CONT    0x2
+#define   TMR_CONTROL_START   0x4
+#define   TMR_CONTROL_STOP    0x8
+
+#define   DISPLAY_DIGITS      0
+#define   DISPLAY_CONTROL     1
+
+#define   CD_STATUS           0
+#define   CD_CONTROL          1
+#define   CD_LOAD             2
+#define   CD_REMAINING        3
+#define   CD_STATUS_EXPIRED   0x1
+#define   CD_STATUS_RUNNING   0x2
+#define   CD_CONTROL_IE       0x1
+#define   CD_CONTROL_SHOW     0x2
+#define   CD_CONTROL_START    0x4
+#define   CD_CONTROL_STOP     0x8
+#define   CD_DIGITS           0x03    // HEX1..HEX0, wired in codebreaker_top
+
+#define   PIO_DATA            0
+#define   PIO_DIRECTION       1
+#define   PIO_IRQMASK         2
+#define   PIO_EDGECAPTURE     3
+#define   PIO_KEYS_MASK       0x3
+
+#define   UART_DATA           0
+#define   UART_CONTROL        1
+#define   UART_DATA_RVALID    0x00008000
+#define   UART_CONTROL_RE     0x00000001
+#define   UART_CONTROL_WE     0x00000002
+#define   UART_CONTROL_RI     0x00000100
+#define   UART_CONTROL_WI     0x00000200
+#define   UART_CONTROL_AC     0x00000400
+#define   UART_WIRQ_THRESHOLD 8
+
+#define   LFSR_STATUS         0
+#define   LFSR_CONTROL        1
+#define   LFSR_VALUE          2
+#define   LFSR_SEED           3
+#define   LFSR_RANGE          4
+#define   LFSR_BOUNDED        5
+#define   LFSR_BOUNDED_STALE  0x8000
+
+#define   RM_NEVER            0xFFFFFFFFFFFFFFFFULL
+
+// Address map
+typedef struct
+{
+  unsigned long base;
+  unsigned long span;
+  uint32        periph;
+  uint32        shift;        // log2 of the register width in bytes
+} _rm_window_t;
+
+static const _rm_window_t _rm_map[] =
+{
+  { TIMER_GAME_1SEC_BASE,        0x20, RM_TIMER_GAME,    2 },
+  { TIMER_LED_TOGGLE_500MS_BASE, 0x20, RM_TIMER_TS,      2 },
+  { DISPLAY_0_BASE,              0x08, RM_DISPLAY,       2 },
+  { PIO_LEDS_BASE,               0x10, RM_PIO_LEDS,      2 },
+  { PIO_KEYS_BASE,               0x10, RM_PIO_KEYS,      2 },
+  { JTAG_UART_0_BASE,            0x08, RM_UART,          2 },
+  { LFSR_16_0_BASE,              0x10, RM_LFSR,          1 },
+  { SYSID_QSYS_0_BASE,           0x08, RM_SYSID,         2 },
+  { COUNTDOWN_0_BASE,            0x10, RM_COUNTDOWN,     2 },
+};
+
+static const char* _rm_names[RM_PERIPHERALS] =
+{
+  "timer_game_1sec", "timer_led_toggle_500ms", "display_0",
+  "pio_leds", "pio_keys", "jtag_uart_0", "lfsr_16_0", "sysid_qsys_0",
+  "countdown_0"
+};
+
+static const char* _rm_irq_names[RM_IRQS] =
+{
+  "TIMER_GAME_1SEC_IRQ", "JTAG_UART_0_IRQ", "PIO_KEYS_IRQ",
+  "TIMER_LED_TOGGLE_500MS_IRQ", "COUNTDOWN_0_IRQ"
+};
+
+// Interval timer
+typedef struct
+{
+  uint64  period;
+  uint32  writeable;          // period registers can be written
+  uint32  always_run;
+  uint32  running;
+  uint64  next_timeout;       // when running
+  uint64  remaining;          // when stopped
+  uint32  status;
+  uint32  control;
+  uint32  snap;
+} _rm_timer_t;
+
+// Countdown peripheral (countdown_peripheral.vhd)
+typedef struct
+{
+  uint32  load;               // BCD, as written
+  uint32  count;              // binary
+  uint32  running;
+  uint32  expired;
+  uint32  control;            // IE and SHOW
+  uint64  next_tick;          // when running
+} _rm_countdown_t;
+
+// Stimulus queue entry
+typedef struct
+{
+  uint64  when;
+  uint64  seq;
+  uint32  type;
+  uint32  data;
+} _rm_event_t;
+
+// Configuration
+uint32      rm_sysid_timestamp;
+uint32      rm_timer_external;
+uint32      rm_key_edges;
+uint32      rm_uart_tx_cycles;
+uint32      rm_isr_cycles;
+uint32      rm_read_cycles[RM_PERIPHERALS];
+uint32      rm_write_cycles[RM_PERIPHERALS];
+uint64      rm_cycle_limit;
+rm_hooks_t  rm_hooks;
+
+// State and statistics
+uint64      rm_cycles;
+uint64      rm_busy_cycles;
+uint64      rm_isr_count[RM_IRQS];
+uint64      rm_isr_total[RM_IRQS];
+uint64      rm_isr_max[RM_IRQS];
+uint64      rm_irq_raised[RM_IRQS];
+int32       rm_current_irq;
+uint32      rm_uart_overruns;
+
+// Peripherals
+static _rm_timer_t  _rm_timer[2];
+static uint32       _rm_pio_out[RM_PERIPHERALS];
+static uint32       _rm_display[2];
+static _rm_countdown_t _rm_countdown;
+static uint32       _rm_keys_down;
+static uint32       _rm_keys_irqmask;
+static uint32       _rm_keys_edges;
+static uint8        _rm_rx[RM_UART_FIFO];
+static uint32       _rm_rx_head, _rm_rx_count;
+static uint32       _rm_tx_count;
+static uint64       _rm_tx_last;
+static uint32       _rm_uart_control;
+static uint32       _rm_uart_spinning;
+static uint16       _rm_lfsr_state;
+static uint64       _rm_lfsr_t0;
+static uint32       _rm_lfsr_seeded;
+static uint16       _rm_lfsr_seed;
+static uint16       _rm_lfsr_range;
+static uint64       _rm_lfsr_range_t;
+static uint16*      _rm_lfsr_queue;
+static uint32       _rm_lfsr_queued, _rm_lfsr_taken, _rm_lfsr_alloc;
+
+// Interrupt controller
+static void       (*_rm_isr[RM_IRQS])(void*);
+static void*        _rm_isr_context[RM_IRQS];
+static uint32       _rm_irq_enabled[RM_IRQS];
+static uint32       _rm_irq_line[RM_IRQS];
+static uint32       _rm_irq_global;
+
+// Stimulus queue
+static _rm_event_t* _rm_events;
+static uint32       _rm_event_count, _rm_event_alloc;
+static uint64       _rm_event_seq;
+
+// Run control
+static jmp_buf      _rm_jmp;
+static uint32       _rm_stop_reason;
+
+static void _rm_update();
+static void _rm_dispatch();
+
+//-------------------------------------------------------------------------
+// NAME:        rm_periph_name, rm_irq_name
+//
+// DESCRIPTION: Names peripherals and interrupts as Qsys does, for reports.
+//-------------------------------------------------------------------------
+const char* rm_periph_name(uint32 periph)
+{
+  return (periph < RM_PERIPHERALS) ? _rm_names[periph] : "?";
+} /* rm_periph_name */
+
+const char* rm_irq_name(uint32 irq)
+{
+  return (irq < RM_IRQS) ? _rm_irq_names[irq] : "?";
+} /* rm_irq_name */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_stop
+//
+// DESCRIPTION: Abandons the firmware and returns from rm_run.
+//-------------------------------------------------------------------------
+static void _rm_stop(uint32 reason)
+{
+  _rm_stop_reason = reason;
+  longjmp(_rm_jmp, 1);
+} /* _rm_stop */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_reset
+//
+// DESCRIPTION: Puts the model in its power-on state with default costs:
+//              two cycles per bus access, one more for LFSR reads
+//              (readWaitTime 1 in lfsr_16_hw.tcl), and a JTAG host that
+//              drains a character every 2000 cycles.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rm_reset()
+{
+  uint32 i;
+
+  free(_rm_events);
+  free(_rm_lfsr_queue);
+
+  rm_sysid_timestamp = 0;
+  rm_timer_external  = FALSE;
+  rm_key_edges       = RM_EDGE_FALLING | RM_EDGE_RISING;
+  rm_uart_tx_cycles  = 2000;
+  rm_isr_cycles      = 120;
+  rm_cycle_limit     = 0;
+  memset(&rm_hooks, 0, sizeof(rm_hooks));
+  for (i = 0; i < RM_PERIPHERALS; i++)
+  {
+    rm_read_cycles[i]  = 2;
+    rm_write_cycles[i] = 2;
+  } /* for i */
+  rm_read_cycles[RM_LFSR] = 3;
+
+  rm_cycles        = 0;
+  rm_busy_cycles   = 0;
+  rm_current_irq   = -1;
+  rm_uart_overruns = 0;
+  memset(rm_isr_count, 0, sizeof(rm_isr_count));
+  memset(rm_isr_total, 0, sizeof(rm_isr_total));
+  memset(rm_isr_max, 0, sizeof(rm_isr_max));
+  memset(rm_irq_raised, 0, sizeof(rm_irq_raised));
+
+  memset(_rm_timer, 0, sizeof(_rm_timer));
+  _rm_timer[0].period       = TIMER_GAME_1SEC_LOAD_VALUE + 1;
+  _rm_timer[0].remaining    = _rm_timer[0].period;
+  _rm_timer[0].writeable    = TRUE;
+  _rm_timer[1].period       = TIMER_LED_TOGGLE_500MS_LOAD_VALUE + 1;
+  _rm_timer[1].always_run   = TRUE;
+  _rm_timer[1].running      = TRUE;
+  _rm_timer[1].next_timeout = _rm_timer[1].period;
+
+  memset(_rm_pio_out, 0, sizeof(_rm_pio_out));
+  memset(_rm_display, 0, sizeof(_rm_display));
+  memset(&_rm_countdown, 0, sizeof(_rm_countdown));
+  _rm_keys_down     = 0;
+  _rm_keys_irqmask  = 0;
+  _rm_keys_edges    = 0;
+  _rm_rx_head       = 0;
+  _rm_rx_count      = 0;
+  _rm_tx_count      = 0;
+  _rm_tx_last       = 0;
+  _rm_uart_control  = 0;
+  _rm_uart_spinning = FALSE;
+  _rm_lfsr_state    = LFSR_MODEL_RESET;
+  _rm_lfsr_t0       = 0;
+  _rm_lfsr_seeded   = FALSE;
+  _rm_lfsr_seed     = 0;
+  _rm_lfsr_range    = 0;
+  _rm_lfsr_range_t  = 0;
+  _rm_lfsr_queue    = NULL;
+  _rm_lfsr_queued   = 0;
+  _rm_lfsr_taken    = 0;
+  _rm_lfsr_alloc    = 0;
+
+  memset(_rm_isr, 0, sizeof(_rm_isr));
+  memset(_rm_isr_context, 0, sizeof(_rm_isr_context));
+  memset(_rm_irq_enabled, 0, sizeof(_rm_irq_enabled));
+  memset(_rm_irq_line, 0, sizeof(_rm_irq_line));
+  _rm_irq_global = TRUE;
+
+  _rm_events      = NULL;
+  _rm_event_count = 0;
+  _rm_event_alloc = 0;
+  _rm_event_seq   = 0;
+} /* rm_reset */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_schedule
+//
+// DESCRIPTION: Queues a stimulus event.  Events at the same cycle are
+//              delivered in the order they were scheduled.
+// ARGUMENTS:   uint64 when, simulated cycle
+//              uint32 type, one of RM_EV_*
+//              uint32 data, event argument
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rm_schedule(uint64 when, uint32 type, uint32 data)
+{
+  _rm_event_t event;
+  uint32      pos;
+
+  if (_rm_event_count == _rm_event_alloc)
+  {
+    _rm_event_alloc = _rm_event_alloc ? _rm_event_alloc * 2 : 256;
+    _rm_events = realloc(_rm_events, _rm_event_alloc * sizeof(_rm_event_t));
+  } /* if */
+
+  event.when = when;
+  event.seq  = _rm_event_seq++;
+  event.type = type;
+  event.data = data;
+
+  // The queue is kept sorted with the next event last, so that popping
+  // is cheap; events are usually scheduled in time order.
+  pos = _rm_event_count;
+  while (pos > 0 && _rm_events[pos - 1].when <= when)
+  {
+    _rm_events[pos] = _rm_events[pos - 1];
+    pos--;
+  } /* while */
+  _rm_events[pos] = event;
+  _rm_event_count++;
+} /* rm_schedule */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_lfsr_bounded
+//
+// DESCRIPTION: The bounded register now (see lfsr_model_bounded_at).
+// RETURNS:     uint16, the register value (LFSR_BOUNDED_STALE if no
+//              candidate has been kept since the range was written)
+//-------------------------------------------------------------------------
+static uint16 _rm_lfsr_bounded()
+{
+  uint16 state;
+  int32  value;
+
+  state = lfsr_model_advance(_rm_lfsr_state, rm_cycles - _rm_lfsr_t0);
+  value = lfsr_model_bounded_at(state, rm_cycles, _rm_lfsr_range_t,
+                                _rm_lfsr_range);
+
+  return (value < 0) ? LFSR_BOUNDED_STALE : (uint16)value;
+} /* _rm_lfsr_bounded */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_lfsr_queue
+//
+// DESCRIPTION: Queues a value to be returned by the next LFSR or bounded
+//              read in place of the modelled one, for replaying recorded
+//              draws.
+// ARGUMENTS:   uint16 value
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rm_lfsr_queue(uint16 value)
+{
+  if (_rm_lfsr_queued == _rm_lfsr_alloc)
+  {
+    _rm_lfsr_alloc = _rm_lfsr_alloc ? _rm_lfsr_alloc * 2 : 64;
+    _rm_lfsr_queue = realloc(_rm_lfsr_queue,
+                             _rm_lfsr_alloc * sizeof(uint16));
+  } /* if */
+  _rm_lfsr_queue[_rm_lfsr_queued++] = value;
+} /* rm_lfsr_queue */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_bcd
+//
+// DESCRIPTION: Two BCD digits of a binary count, as the countdown keeps
+//              them.
+//-------------------------------------------------------------------------
+static uint32 _rm_bcd(uint32 count)
+{
+  return ((count / 10) << 4) | (count % 10);
+} /* _rm_bcd */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_output
+//
+// DESCRIPTION: Returns the last value written to an output PIO, or the
+//              digits on HEX7..HEX0: the display controller's, with the
+//              countdown's on HEX1..HEX0 as codebreaker_top wires them.
+//-------------------------------------------------------------------------
+uint32 rm_output(uint32 periph)
+{
+  if (RM_DISPLAY == periph)
+  {
+    return (_rm_display[DISPLAY_DIGITS] & ~0xFF) |
+           _rm_bcd(_rm_countdown.count);
+  } /* if */
+  return _rm_pio_out[periph];
+} /* rm_output */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_display_control
+//
+// DESCRIPTION: Returns the display controller's control register, with
+//              the enables of HEX1..HEX0 taken from the countdown.
+//-------------------------------------------------------------------------
+uint32 rm_display_control()
+{
+  return (_rm_display[DISPLAY_CONTROL] & ~CD_DIGITS) |
+         ((0 != (_rm_countdown.control & CD_CONTROL_SHOW)) ? CD_DIGITS : 0);
+} /* rm_display_control */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_timer_*
+//
+// DESCRIPTION: Interval timer model (altera_avalon_timer, with a fixed
+//              or a writeable period).
+//-------------------------------------------------------------------------
+static uint64 _rm_timer_counter(_rm_timer_t* timer)
+{
+  if (timer->running)
+  {
+    return timer->next_timeout - rm_cycles - 1;
+  } /* if */
+  return timer->remaining - 1;
+} /* _rm_timer_counter */
+
+static void _rm_timer_update(_rm_timer_t* timer, uint32 external)
+{
+  while (timer->running && timer->next_timeout <= rm_cycles)
+  {
+    if (!external)
+    {
+      timer->status |= TMR_STATUS_TO;
+    } /* if */
+    if (timer->always_run || 0 != (timer->control & TMR_CONTROL_CONT))
+    {
+      timer->next_timeout += timer->period;
+    } /* if */
+    else
+    {
+      timer->running   = FALSE;
+      timer->remaining = timer->period;
+    } /* else */
+  } /* while */
+} /* _rm_timer_update */
+
+static uint32 _rm_timer_read(_rm_timer_t* timer, uint32 reg)
+{
+  switch (reg)
+  {
+    case TMR_STATUS:
+      return timer->status | (timer->running ? TMR_STATUS_RUN : 0);
+    case TMR_CONTROL:
+      return timer->control;
+    case TMR_PERIOD_L:
+      return (uint32)((timer->period - 1) & 0xFFFF);
+    case TMR_PERIOD_H:
+      return (uint32)((timer->period - 1) >> 16);
+    case TMR_SNAP_L:
+      return timer->snap & 0xFFFF;
+    case TMR_SNAP_H:
+      return timer->snap >> 16;
+  } /* switch */
+  return 0;
+} /* _rm_timer_read */
+
+static void _rm_timer_write(_rm_timer_t* timer, uint32 reg, uint32 value)
+{
+  switch (reg)
+  {
+    case TMR_STATUS:
+      timer->status &= ~TMR_STATUS_TO;
+      break;
+    case TMR_CONTROL:
+      timer->control = value & (TMR_CONTROL_ITO | TMR_CONTROL_CONT);
+      if (timer->always_run)
+      {
+        break;
+      } /* if */
+      if (0 != (value & TMR_CONTROL_STOP) && timer->running)
+      {
+        timer->remaining = timer->next_timeout - rm_cycles;
+        timer->running   = FALSE;
+      } /* if stop */
+      if (0 != (value & TMR_CONTROL_START) && !timer->running)
+      {
+        timer->next_timeout = rm_cycles + timer->remaining;
+        timer->running      = TRUE;
+      } /* if start */
+      break;
+    case TMR_PERIOD_L:
+    case TMR_PERIOD_H:
+      // A write stops the counter and reloads it, with the new period if
+      // Qsys made it writeable.
+      if (timer->writeable)
+      {
+        if (TMR_PERIOD_L == reg)
+        {
+          timer->period = (((timer->period - 1) & ~0xFFFFULL) |
+                           (value & 0xFFFF)) + 1;
+        } /* if */
+        else
+        {
+          timer->period = (((timer->period - 1) & 0xFFFF) |
+                           ((uint64)(value & 0xFFFF) << 16)) + 1;
+        } /* else */
+      } /* if */
+      if (!timer->always_run)
+      {
+        timer->running   = FALSE;
+        timer->remaining = timer->period;
+      } /* if */
+      break;
+    case TMR_SNAP_L:
+    case TMR_SNAP_H:
+      timer->snap = (uint32)_rm_timer_counter(timer);
+      break;
+  } /* switch */
+} /* _rm_timer_write */
+
+static uint64 _rm_timer_next(_rm_timer_t* timer, uint32 external)
+{
+  if (timer->running && !external &&
+      0 != (timer->control & TMR_CONTROL_ITO))
+  {
+    return timer->next_timeout;
+  } /* if */
+  return RM_NEVER;
+} /* _rm_timer_next */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_countdown_*
+//
+// DESCRIPTION: Countdown peripheral model.  It counts down once a second
+//              and expires on reaching zero.  With rm_timer_external set
+//              it holds at one instead, and RM_EV_TICK expires it.
+//-------------------------------------------------------------------------
+static void _rm_countdown_expire()
+{
+  _rm_countdown.count   = 0;
+  _rm_countdown.running = FALSE;
+  _rm_countdown.expired = TRUE;
+} /* _rm_countdown_expire */
+
+static void _rm_countdown_update()
+{
+  while (_rm_countdown.running && _rm_countdown.next_tick <= rm_cycles)
+  {
+    if (rm_timer_external && 1 == _rm_countdown.count)
+    {
+      _rm_countdown.next_tick = RM_NEVER;
+      break;
+    } /* if */
+    _rm_countdown.next_tick += ALT_CPU_FREQ;
+    if (0 == --_rm_countdown.count)
+    {
+      _rm_countdown_expire();
+    } /* if */
+  } /* while */
+} /* _rm_countdown_update */
+
+static uint32 _rm_countdown_read(uint32 reg)
+{
+  switch (reg)
+  {
+    case CD_STATUS:
+      return (_rm_countdown.expired ? CD_STATUS_EXPIRED : 0) |
+             (_rm_countdown.running ? CD_STATUS_RUNNING : 0);
+    case CD_CONTROL:
+      return _rm_countdown.control;
+    case CD_LOAD:
+      return _rm_countdown.load;
+    case CD_REMAINING:
+      return (_rm_countdown.count << 8) | _rm_bcd(_rm_countdown.count);
+  } /* switch */
+  return 0;
+} /* _rm_countdown_read */
+
+static void _rm_countdown_write(uint32 reg, uint32 value)
+{
+  switch (reg)
+  {
+    case CD_STATUS:
+      _rm_countdown.expired = FALSE;
+      break;
+    case CD_CONTROL:
+      _rm_countdown.control = value & (CD_CONTROL_IE | CD_CONTROL_SHOW);
+      if (0 != (value & CD_CONTROL_STOP))
+      {
+        _rm_countdown.running = FALSE;
+      } /* if stop */
+      else if (0 != (value & CD_CONTROL_START))
+      {
+        if (0 == _rm_countdown.count)
+        {
+          _rm_countdown_expire();
+        } /* if */
+        else
+        {
+          _rm_countdown.running   = TRUE;
+          _rm_countdown.next_tick = rm_cycles + ALT_CPU_FREQ;
+        } /* else */
+      } /* else if start */
+      break;
+    case CD_LOAD:
+      _rm_countdown.load    = value & 0xFF;
+      _rm_countdown.count   = ((value >> 4) & 0xF) * 10 + (value & 0xF);
+      _rm_countdown.running = FALSE;
+      break;
+  } /* switch */
+} /* _rm_countdown_write */
+
+static uint64 _rm_countdown_next()
+{
+  if (_rm_countdown.running && !rm_timer_external &&
+      0 != (_rm_countdown.control & CD_CONTROL_IE))
+  {
+    return _rm_countdown.next_tick +
+           (uint64)(_rm_countdown.count - 1) * ALT_CPU_FREQ;
+  } /* if */
+  return RM_NEVER;
+} /* _rm_countdown_next */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_uart_*
+//
+// DESCRIPTION: JTAG UART model.  The host side drains the transmit FIFO
+//              at one character every rm_uart_tx_cycles.
+//-------------------------------------------------------------------------
+static void _rm_uart_update()
+{
+  uint64 drained;
+
+  if (0 == _rm_tx_count)
+  {
+    _rm_tx_last = rm_cycles;
+    return;
+  } /* if */
+
+  drained = (rm_cycles - _rm_tx_last) / rm_uart_tx_cycles;
+  if (drained >= _rm_tx_count)
+  {
+    _rm_tx_count = 0;
+    _rm_tx_last  = rm_cycles;
+  } /* if */
+  else
+  {
+    _rm_tx_count -= (uint32)drained;
+    _rm_tx_last  += drained * rm_uart_tx_cycles;
+  } /* else */
+} /* _rm_uart_update */
+
+static uint32 _rm_uart_control_value()
+{
+  uint32 value = _rm_uart_control;
+
+  if (_rm_rx_count > 0)
+  {
+    value |= UART_CONTROL_RI & ((value & UART_CONTROL_RE) << 8);
+  } /* if */
+  if (RM_UART_FIFO - _rm_tx_count >= UART_WIRQ_THRESHOLD)
+  {
+    value |= UART_CONTROL_WI & ((value & UART_CONTROL_WE) << 8);
+  } /* if */
+
+  return value | ((RM_UART_FIFO - _rm_tx_count) << 16);
+} /* _rm_uart_control_value */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_next_time
+//
+// DESCRIPTION: Finds the next cycle at which something can change by
+//              itself: a stimulus event, an interrupting timeout or
+//              countdown expiry, or (if requested) the UART draining a
+//              character.
+//-------------------------------------------------------------------------
+static uint64 _rm_next_time(uint32 include_uart)
+{
+  uint64 next = RM_NEVER;
+  uint64 when;
+
+  if (_rm_event_count > 0)
+  {
+    next = _rm_events[_rm_event_count - 1].when;
+  } /* if */
+
+  when = _rm_timer_next(&_rm_timer[0], rm_timer_external);
+  next = (when < next) ? when : next;
+  when = _rm_timer_next(&_rm_timer[1], FALSE);
+  next = (when < next) ? when : next;
+  when = _rm_countdown_next();
+  next = (when < next) ? when : next;
+
+  if (include_uart && _rm_tx_count > 0)
+  {
+    when = _rm_tx_last + rm_uart_tx_cycles;
+    next = (when < next) ? when : next;
+  } /* if */
+
+  return next;
+} /* _rm_next_time */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_apply
+//
+// DESCRIPTION: Applies one stimulus event to the peripherals.
+//-------------------------------------------------------------------------
+static void _rm_apply(_rm_event_t* event)
+{
+  uint32 changed;
+
+  if (NULL != rm_hooks.stimulus)
+  {
+    rm_hooks.stimulus(event->type, event->data);
+  } /* if */
+
+  switch (event->type)
+  {
+    case RM_EV_UART_RX:
+      if (_rm_rx_count < RM_UART_FIFO)
+      {
+        _rm_rx[(_rm_rx_head + _rm_rx_count++) % RM_UART_FIFO] =
+          (uint8)event->data;
+      } /* if */
+      else
+      {
+        rm_uart_overruns++;
+      } /* else */
+      break;
+    case RM_EV_KEY_DOWN:
+      changed        = event->data & ~_rm_keys_down & PIO_KEYS_MASK;
+      _rm_keys_down |= changed;
+      if (0 != (rm_key_edges & RM_EDGE_FALLING))
+      {
+        _rm_keys_edges |= changed;      // the keys are active-low
+      } /* if */
+      break;
+    case RM_EV_KEY_UP:
+      changed        = event->data & _rm_keys_down;
+      _rm_keys_down &= ~changed;
+      if (0 != (rm_key_edges & RM_EDGE_RISING))
+      {
+        _rm_keys_edges |= changed;
+      } /* if */
+      break;
+    case RM_EV_TICK:
+      _rm_countdown_expire();
+      break;
+    case RM_EV_STOP:
+      _rm_stop(RM_STOP_EVENT);
+      break;
+  } /* switch */
+} /* _rm_apply */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_update
+//
+// DESCRIPTION: Brings every peripheral up to the current cycle and
+//              recomputes the interrupt lines.
+//-------------------------------------------------------------------------
+static void _rm_update()
+{
+  _rm_event_t event;
+  uint32      line[RM_IRQS];
+  uint32      irq;
+
+  if (0 != rm_cycle_limit && rm_cycles >= rm_cycle_limit)
+  {
+    _rm_stop(RM_STOP_LIMIT);
+  } /* if */
+
+  while (_rm_event_count > 0 &&
+         _rm_events[_rm_event_count - 1].when <= rm_cycles)
+  {
+    event = _rm_events[--_rm_event_count];
+    _rm_apply(&event);
+  } /* while */
+
+  _rm_timer_update(&_rm_timer[0], rm_timer_external);
+  _rm_timer_update(&_rm_timer[1], FALSE);
+  _rm_countdown_update();
+  _rm_uart_update();
+
+  line[0] = (0 != (_rm_timer[0].status & TMR_STATUS_TO) &&
+             0 != (_rm_timer[0].control & TMR_CONTROL_ITO));
+  line[1] = (0 != (_rm_uart_control_value() &
+                   (UART_CONTROL_RI | UART_CONTROL_WI)));
+  line[2] = (0 != (_rm_keys_edges & _rm_keys_irqmask));
+  line[3] = (0 != (_rm_timer[1].status & TMR_STATUS_TO) &&
+             0 != (_rm_timer[1].control & TMR_CONTROL_ITO));
+  line[4] = (_rm_countdown.expired &&
+             0 != (_rm_countdown.control & CD_CONTROL_IE));
+
+  for (irq = 0; irq < RM_IRQS; irq++)
+  {
+    if (line[irq] && !_rm_irq_line[irq])
+    {
+      rm_irq_raised[irq] = rm_cycles;
+      if (NULL != rm_hooks.irq_raise)
+      {
+        rm_hooks.irq_raise(irq);
+      } /* if */
+    } /* if rising */
+    _rm_irq_line[irq] = line[irq];
+  } /* for irq */
+} /* _rm_update */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_dispatch
+//
+// DESCRIPTION: Runs ISRs for pending interrupts, highest priority first,
+//              unless interrupts are off or an ISR is already running
+//              (the HAL doesn't nest them).
+//-------------------------------------------------------------------------
+static void _rm_dispatch()
+{
+  uint64 start;
+  uint64 spent;
+  uint32 irq;
+  uint32 spinning;
+
+  while (rm_current_irq < 0 && _rm_irq_global)
+  {
+    for (irq = 0; irq < RM_IRQS; irq++)
+    {
+      if (_rm_irq_line[irq] && _rm_irq_enabled[irq] && NULL != _rm_isr[irq])
+      {
+        break;
+      } /* if */
+    } /* for irq */
+    if (irq == RM_IRQS)
+    {
+      return;
+    } /* if nothing pending */
+
+    start           = rm_cycles;
+    rm_current_irq  = (int32)irq;
+    rm_cycles      += rm_isr_cycles / 2;
+    rm_busy_cycles += rm_isr_cycles / 2;
+    if (NULL != rm_hooks.isr_enter)
+    {
+      rm_hooks.isr_enter(irq);
+    } /* if */
+
+    // a busy-wait the ISR interrupted isn't the ISR's own
+    spinning          = _rm_uart_spinning;
+    _rm_uart_spinning = FALSE;
+    _rm_isr[irq](_rm_isr_context[irq]);
+    _rm_uart_spinning = spinning;
+
+    rm_cycles      += rm_isr_cycles - rm_isr_cycles / 2;
+    rm_busy_cycles += rm_isr_cycles - rm_isr_cycles / 2;
+    if (NULL != rm_hooks.isr_exit)
+    {
+      rm_hooks.isr_exit(irq);
+    } /* if */
+    rm_current_irq  = -1;
+
+    spent = rm_cycles - start;
+    rm_isr_count[irq]++;
+    rm_isr_total[irq] += spent;
+    if (spent > rm_isr_max[irq])
+    {
+      rm_isr_max[irq] = spent;
+    } /* if */
+
+    _rm_update();
+  } /* while */
+} /* _rm_dispatch */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_decode
+//
+// DESCRIPTION: Maps an address to a peripheral and register index.
+//-------------------------------------------------------------------------
+static uint32 _rm_decode(unsigned long addr, uint32* reg)
+{
+  uint32 i;
+
+  for (i = 0; i < sizeof(_rm_map) / sizeof(_rm_map[0]); i++)
+  {
+    if (addr >= _rm_map[i].base && addr < _rm_map[i].base + _rm_map[i].span)
+    {
+      *reg = (uint32)((addr - _rm_map[i].base) >> _rm_map[i].shift);
+      return _rm_map[i].periph;
+    } /* if */
+  } /* for i */
+
+  fprintf(stderr, "regmodel: access to unmapped address 0x%lx\n", addr);
+  abort();
+} /* _rm_decode */
+
+//-------------------------------------------------------------------------
+// NAME:        _rm_access_done
+//
+// DESCRIPTION: Reports an access to the hook and takes any interrupts
+//              that became pending.
+//-------------------------------------------------------------------------
+static void _rm_access_done(uint32 periph, uint32 reg, uint32 write,
+                            uint32 value, const char* func, uint32 cycles,
+                            uint32 count)
+{
+  if (NULL != rm_hooks.access)
+  {
+    rm_hooks.access(periph, reg, write, value, func, cycles, count);
+  } /* if */
+
+  _rm_update();
+  _rm_dispatch();
+} /* _rm_access_done */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_read
+//
+// DESCRIPTION: Models a bus read from the firmware.
+// ARGUMENTS:   unsigned long addr, address being read
+//              uint32 size, access width in bytes
+//              const char* func, calling function
+// RETURNS:     uint32, the value read
+//-------------------------------------------------------------------------
+uint32 rm_read(unsigned long addr, uint32 size, const char* func)
+{
+  uint32 value  = 0;
+  uint32 polls  = 1;
+  uint32 cost;
+  uint32 reg;
+  uint32 periph;
+  uint64 next;
+
+  periph = _rm_decode(addr, &reg);
+  cost   = rm_read_cycles[periph];
+  rm_cycles      += cost;
+  rm_busy_cycles += cost;
+  _rm_update();
+
+  switch (periph)
+  {
+    case RM_TIMER_GAME:
+    case RM_TIMER_TS:
+      value = _rm_timer_read(&_rm_timer[periph - RM_TIMER_GAME], reg);
+      break;
+
+    case RM_DISPLAY:
+      value = _rm_display[reg] >> ((addr & 3) * 8);
+      break;
+
+    case RM_PIO_LEDS:
+      value = (PIO_DATA == reg) ? _rm_pio_out[periph] : 0;
+      break;
+
+    case RM_PIO_KEYS:
+      switch (reg)
+      {
+        case PIO_DATA:
+          value = ~_rm_keys_down & PIO_KEYS_MASK;   // keys are active-low
+          break;
+        case PIO_IRQMASK:
+          value = _rm_keys_irqmask;
+          break;
+        case PIO_EDGECAPTURE:
+          value = _rm_keys_edges;
+          break;
+      } /* switch */
+      break;
+
+    case RM_UART:
+      if (UART_DATA == reg)
+      {
+        _rm_uart_spinning = FALSE;
+        if (_rm_rx_count > 0)
+        {
+          value = _rm_rx[_rm_rx_head] | UART_DATA_RVALID;
+          _rm_rx_head = (_rm_rx_head + 1) % RM_UART_FIFO;
+          _rm_rx_count--;
+          value |= _rm_rx_count << 16;              // RAVAIL
+        } /* if */
+        break;
+      } /* if data */
+
+      // A second consecutive look at a full transmit FIFO is a busy-wait;
+      // skip to whenever something next changes and count the polls the
+      // CPU would have made meanwhile.
+      if (RM_UART_FIFO == _rm_tx_count && _rm_uart_spinning)
+      {
+        next = _rm_next_time(TRUE);
+        if (next > rm_cycles && RM_NEVER != next)
+        {
+          polls          += (uint32)((next - rm_cycles) / cost);
+          rm_busy_cycles += next - rm_cycles;
+          rm_cycles       = next;
+          _rm_update();
+        } /* if */
+      } /* if */
+      value = _rm_uart_control_value();
+      _rm_uart_spinning = (RM_UART_FIFO == _rm_tx_count);
+      break;
+
+    case RM_LFSR:
+      switch (reg)
+      {
+        case LFSR_STATUS:
+          value = (_rm_lfsr_seeded ? 0x1 : 0) | (_rm_lfsr_seed ? 0x2 : 0) |
+                  ((_rm_lfsr_bounded() & LFSR_BOUNDED_STALE) ? 0 : 0x4);
+          break;
+        case LFSR_VALUE:
+          if (_rm_lfsr_taken < _rm_lfsr_queued)
+          {
+            value = _rm_lfsr_queue[_rm_lfsr_taken++];
+          } /* if replaying */
+          else
+          {
+            value = lfsr_model_advance(_rm_lfsr_state,
+                                       rm_cycles - _rm_lfsr_t0);
+          } /* else */
+          break;
+        case LFSR_SEED:
+          value = _rm_lfsr_seed;
+          break;
+        case LFSR_RANGE:
+          value = _rm_lfsr_range;
+          break;
+        case LFSR_BOUNDED:
+          if (_rm_lfsr_taken < _rm_lfsr_queued)
+          {
+            value = _rm_lfsr_queue[_rm_lfsr_taken++];
+          } /* if replaying */
+          else
+          {
+            value = _rm_lfsr_bounded();
+          } /* else */
+          break;
+      } /* switch */
+      break;
+
+    case RM_SYSID:
+      value = (0 == reg) ? SYSID_QSYS_0_ID : rm_sysid_timestamp;
+      break;
+
+    case RM_COUNTDOWN:
+      value = _rm_countdown_read(reg);
+      break;
+  } /* switch */
+
+  if (size < 4)
+  {
+    value &= (1u << (size * 8)) - 1;
+  } /* if */
+
+  _rm_access_done(periph, reg, FALSE, value, func, cost * polls, polls);
+  return value;
+} /* rm_read */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_write
+//
+// DESCRIPTION: Models a bus write from the firmware.
+// ARGUMENTS:   unsigned long addr, address being written
+//              uint32 size, access width in bytes
+//              uint32 value, the value written
+//              const char* func, calling function
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rm_write(unsigned long addr, uint32 size, uint32 value,
+              const char* func)
+{
+  uint32 lanes;
+  uint32 cost;
+  uint32 reg;
+  uint32 periph;
+
+  periph = _rm_decode(addr, &reg);
+  cost   = rm_write_cycles[periph];
+  rm_cycles      += cost;
+  rm_busy_cycles += cost;
+  _rm_update();
+
+  if (size < 4)
+  {
+    value &= (1u << (size * 8)) - 1;
+  } /* if */
+
+  switch (periph)
+  {
+    case RM_TIMER_GAME:
+    case RM_TIMER_TS:
+      _rm_timer_write(&_rm_timer[periph - RM_TIMER_GAME], reg, value);
+      break;
+
+    case RM_DISPLAY:
+      // byte and halfword writes only touch their own lanes
+      lanes = (size < 4) ? ((1u << (size * 8)) - 1) << ((addr & 3) * 8)
+                         : 0xFFFFFFFF;
+      _rm_display[reg] = (_rm_display[reg] & ~lanes) |
+                         ((value << ((addr & 3) * 8)) & lanes);
+      if (DISPLAY_CONTROL == reg)
+      {
+        _rm_display[reg] &= 0xFFFF;
+      } /* if */
+      if (NULL != rm_hooks.output)
+      {
+        rm_hooks.output(periph, _rm_display[reg]);
+      } /* if */
+      break;
+
+    case RM_PIO_LEDS:
+      if (PIO_DATA == reg)
+      {
+        _rm_pio_out[periph] = value;
+        if (NULL != rm_hooks.output)
+        {
+          rm_hooks.output(periph, value);
+        } /* if */
+      } /* if */
+      break;
+
+    case RM_PIO_KEYS:
+      if (PIO_IRQMASK == reg)
+      {
+        _rm_keys_irqmask = value & PIO_KEYS_MASK;
+      } /* if */
+      else if (PIO_EDGECAPTURE == reg)
+      {
+        _rm_keys_edges &= ~value;     // bitClearingEdgeCapReg
+      } /* else if */
+      break;
+
+    case RM_UART:
+      _rm_uart_spinning = FALSE;
+      if (UART_DATA == reg)
+      {
+        if (_rm_tx_count < RM_UART_FIFO)
+        {
+          if (0 == _rm_tx_count)
+          {
+            _rm_tx_last = rm_cycles;
+          } /* if */
+          _rm_tx_count++;
+          if (NULL != rm_hooks.uart_tx)
+          {
+            rm_hooks.uart_tx((uint8)value);
+          } /* if */
+        } /* if room */
+      } /* if data */
+      else
+      {
+        _rm_uart_control = value & (UART_CONTROL_RE | UART_CONTROL_WE);
+      } /* else */
+      break;
+
+    case RM_LFSR:
+      if (LFSR_SEED == reg)
+      {
+        _rm_lfsr_seed = (uint16)value;
+      } /* if */
+      else if (LFSR_RANGE == reg)
+      {
+        _rm_lfsr_range   = (uint16)value;
+        _rm_lfsr_range_t = rm_cycles;
+      } /* else if */
+      else if (LFSR_CONTROL == reg && 0 != (value & 0x1) &&
+               0 != _rm_lfsr_seed)
+      {
+        _rm_lfsr_state  = _rm_lfsr_seed;
+        _rm_lfsr_t0     = rm_cycles;
+        _rm_lfsr_seeded = TRUE;
+      } /* else if */
+      break;
+
+    case RM_COUNTDOWN:
+      _rm_countdown_write(reg, value);
+      break;
+  } /* switch */
+
+  _rm_access_done(periph, reg, TRUE, value, func, cost, 1);
+} /* rm_write */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_idle
+//
+// DESCRIPTION: Called from the firmware's polling loops.  Jumps the clock
+//              to the next stimulus or interrupting timeout and takes the
+//              resulting interrupts.  Ends the run if nothing is left to
+//              happen.
+// ARGUMENTS:   const char* func, calling function
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rm_idle(const char* func)
+{
+  uint64 next;
+  uint64 since;
+
+  if (rm_current_irq >= 0 || !_rm_irq_global)
+  {
+    return;           // can't wait for anything with interrupts off
+  } /* if */
+
+  // Nothing left to wait for once the stimulus has run out, unless the
+  // countdown is still going (the timestamp timer doesn't count).
+  if (0 == _rm_event_count &&
+      RM_NEVER == _rm_timer_next(&_rm_timer[0], rm_timer_external) &&
+      RM_NEVER == _rm_countdown_next())
+  {
+    _rm_stop(RM_STOP_IDLE);
+  } /* if */
+
+  since = rm_cycles;
+  next = _rm_next_time(FALSE);
+  if (next > rm_cycles)
+  {
+    rm_cycles = next;
+  } /* if */
+  rm_cycles++;        // the loop itself takes some time
+  rm_busy_cycles++;
+
+  if (NULL != rm_hooks.idle)
+  {
+    rm_hooks.idle(since, func);
+  } /* if */
+
+  _rm_update();
+  _rm_dispatch();
+} /* rm_idle */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_irq_age
+//
+// DESCRIPTION: Tells the firmware how long ago an interrupt line rose;
+//              called from its ISRs to measure interrupt latency.
+// ARGUMENTS:   uint32 irq, interrupt line
+// RETURNS:     uint32, cycles, or 0xFFFFFFFF if the line isn't up
+//-------------------------------------------------------------------------
+uint32 rm_irq_age(uint32 irq)
+{
+  uint64 age;
+
+  if (irq >= RM_IRQS || !_rm_irq_line[irq])
+  {
+    return 0xFFFFFFFF;
+  } /* if */
+
+  age = rm_cycles - rm_irq_raised[irq];
+  return (age < 0xFFFFFFFF) ? (uint32)age : 0xFFFFFFFE;
+} /* rm_irq_age */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_trace
+//
+// DESCRIPTION: Passes one of the firmware's trace points to the mark
+//              hook.  Takes no simulated time.
+// ARGUMENTS:   uint32 kind, one of RM_TRACE_*
+//              const char* name, string literal naming the span or state
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rm_trace(uint32 kind, const char* name)
+{
+  if (NULL != rm_hooks.mark)
+  {
+    rm_hooks.mark(kind, name);
+  } /* if */
+} /* rm_trace */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_run
+//
+// DESCRIPTION: Runs firmware until it returns or the model stops it.
+// ARGUMENTS:   int (*entry)(void), the firmware's main
+// RETURNS:     uint32, one of RM_STOP_*
+//-------------------------------------------------------------------------
+uint32 rm_run(int (*entry)(void))
+{
+  if (0 == setjmp(_rm_jmp))
+  {
+    entry();
+    _rm_stop_reason = RM_STOP_RETURNED;
+  } /* if */
+
+  rm_current_irq = -1;
+  return _rm_stop_reason;
+} /* rm_run */
+
+//-------------------------------------------------------------------------
+// NAME:        rm_isr_register, rm_irq_*
+//
+// DESCRIPTION: The interrupt controller, as seen through sys/alt_irq.h.
+//              Registering an ISR enables its interrupt, as the HAL does.
+//-------------------------------------------------------------------------
+int rm_isr_register(uint32 irq, void (*isr)(void*), void* context)
+{
+  if (irq >= RM_IRQS)
+  {
+    return -1;
+  } /* if */
+
+  _rm_isr[irq]          = isr;
+  _rm_isr_context[irq]  = context;
+  _rm_irq_enabled[irq]  = (NULL != isr);
+  return 0;
+} /* rm_isr_register */
+
+int rm_irq_enable(uint32 irq, uint32 enable)
+{
+  if (irq >= RM_IRQS)
+  {
+    return -1;
+  } /* if */
+
+  _rm_irq_enabled[irq] = enable;
+  if (enable)
+  {
+    _rm_dispatch();
+  } /* if */
+  return 0;
+} /* rm_irq_enable */
+
+int rm_irq_enabled(uint32 irq)
+{
+  return (irq < RM_IRQS) ? (int)_rm_irq_enabled[irq] : 0;
+} /* rm_irq_enabled */
+
+uint32 rm_irq_disable_all()
+{
+  uint32 context = _rm_irq_global;
+
+  _rm_irq_global = FALSE;
+  return context;
+} /* rm_irq_disable_all */
+
+void rm_irq_enable_all(uint32 context)
+{
+  _rm_irq_global = context;
+  if (context)
+  {
+    _rm_dispatch();
+  } /* if */
+} /* rm_irq_enable_all */
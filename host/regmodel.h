@@ -0,0 +1,126 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  regmodel.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for regmodel.c, the host
+//      register model of the Game System.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_REGMODEL__H
+#define __LAB_7_REGMODEL__H
+
+#include "nios_std_types.h"   // standard data types
+
+// Modelled peripherals
+#define   RM_TIMER_GAME                   0
+#define   RM_TIMER_TS                     1
+#define   RM_DISPLAY                      2
+#define   RM_PIO_LEDS                     3
+#define   RM_PIO_KEYS                     4
+#define   RM_UART                         5
+#define   RM_LFSR                         6
+#define   RM_SYSID                        7
+#define   RM_COUNTDOWN                    8
+#define   RM_PERIPHERALS                  9
+
+// Interrupt lines, numbered as in nios_system.qsys (0 = highest priority)
+#define   RM_IRQS                         5
+
+// Stimulus events
+#define   RM_EV_UART_RX                   1   // data: character
+#define   RM_EV_KEY_DOWN                  2   // data: PIO key mask
+#define   RM_EV_KEY_UP                    3   // data: PIO key mask
+#define   RM_EV_TICK                      4   // countdown reaches zero
+#define   RM_EV_STOP                      5   // end the run
+
+// Reasons rm_run returns
+#define   RM_STOP_RETURNED                0   // firmware main returned
+#define   RM_STOP_IDLE                    1   // idle with no stimulus left
+#define   RM_STOP_EVENT                   2   // RM_EV_STOP reached
+#define   RM_STOP_LIMIT                   3   // rm_cycle_limit reached
+
+// Key edges the keys PIO captures (its edgeType parameter)
+#define   RM_EDGE_FALLING                 0x1
+#define   RM_EDGE_RISING                  0x2
+
+// Firmware trace points (CPU_TRACE_* in hw_access.h)
+#define   RM_TRACE_BEGIN                  0   // name: span being entered
+#define   RM_TRACE_END                    1   // name: span being left
+#define   RM_TRACE_STATE                  2   // name: new game state
+
+// Depth of the JTAG UART FIFOs
+#define   RM_UART_FIFO                    64
+
+// Observation hooks; any may be NULL
+typedef struct
+{
+  // every register access (count > 1 for skipped busy-wait polls)
+  void (*access)(uint32 periph, uint32 reg, uint32 write, uint32 value,
+                 const char* func, uint32 cycles, uint32 count);
+  void (*isr_enter)(uint32 irq);
+  void (*isr_exit)(uint32 irq);
+  void (*uart_tx)(uint8 byte);
+  void (*output)(uint32 periph, uint32 value);
+  void (*stimulus)(uint32 type, uint32 data);
+  void (*irq_raise)(uint32 irq);                  // a line rose
+  void (*idle)(uint64 since, const char* func);   // clock skipped ahead
+  void (*mark)(uint32 kind, const char* name);    // CPU_TRACE_* points
+} rm_hooks_t;
+
+// Configuration; set after rm_reset and before rm_run
+extern uint32     rm_sysid_timestamp;   // seeds the LFSR in main()
+extern uint32     rm_timer_external;    // countdown ends only on RM_EV_TICK
+extern uint32     rm_key_edges;         // RM_EDGE_* captured by the keys
+extern uint32     rm_uart_tx_cycles;    // cycles to drain one TX byte
+extern uint32     rm_isr_cycles;        // interrupt entry + exit cost
+extern uint32     rm_read_cycles[RM_PERIPHERALS];
+extern uint32     rm_write_cycles[RM_PERIPHERALS];
+extern uint64     rm_cycle_limit;       // 0 for no limit
+extern rm_hooks_t rm_hooks;
+
+// State and statistics
+extern uint64     rm_cycles;            // simulated clock
+extern uint64     rm_busy_cycles;       // cycles not skipped while idle
+extern uint64     rm_isr_count[RM_IRQS];
+extern uint64     rm_isr_total[RM_IRQS];    // cycles spent in each ISR
+extern uint64     rm_isr_max[RM_IRQS];      // longest single ISR
+extern uint64     rm_irq_raised[RM_IRQS];   // when each line last rose
+extern int32      rm_current_irq;       // ISR being run, or -1
+extern uint32     rm_uart_overruns;     // RX characters lost to a full FIFO
+
+// Prototypes for the host side
+void rm_reset();
+void rm_schedule(uint64 when, uint32 type, uint32 data);
+void rm_lfsr_queue(uint16 value);
+uint32 rm_run(int (*entry)(void));
+uint32 rm_output(uint32 periph);
+uint32 rm_display_control();
+const char* rm_periph_name(uint32 periph);
+const char* rm_irq_name(uint32 irq);
+
+// Prototypes for the firmware side (via hw_access.h and sys/alt_irq.h)
+uint32 rm_read(unsigned long addr, uint32 size, const char* func);
+void rm_write(unsigned long addr, uint32 size, uint32 value,
+              const char* func);
+void rm_idle(const char* func);
+uint32 rm_irq_age(uint32 irq);
+void rm_trace(uint32 kind, const char* name);
+int rm_isr_register(uint32 irq, void (*isr)(void*), void* context);
+int rm_irq_enable(uint32 irq, uint32 enable);
+int rm_irq_enabled(uint32 irq);
+uint32 rm_irq_disable_all();
+void rm_irq_enable_all(uint32 context);
+
+#endif /* __LAB_7_REGMODEL__H */
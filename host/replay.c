@@ -0,0 +1,795 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  replay.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Replays a recorded game session through the unmodified firmware,
+//    running on the host register model (regmodel.c) in virtual time.
+//
+//    The input is one of:
+//      - a captured console session; the last "REC BEGIN" ... "REC END"
+//        block printed by rec_dump is used
+//      - a binary log, as written by -o ("CBR1" followed by the log)
+//      - a script of stimulus, one event per line:
+//            <seconds> seed <n>
+//            <seconds> key <1|2>
+//            <seconds> down <1|2>        (key edges alone, e.g. bounce)
+//            <seconds> up <1|2>
+//            <seconds> type <text>       (\n for Enter, 1 ms per char)
+//            <seconds> tick              (the countdown reaches zero)
+//            <seconds> lfsr <value>
+//            <seconds> stop
+//        with '#' starting a comment.  Times are absolute.
+//
+//    A recorded log replays every input at the cycle it was logged,
+//    with the countdown ending at its recorded expiry and LFSR reads
+//    returning the recorded values, so the replay does not depend on
+//    the model's timing matching the board's.  A script drives the
+//    model's own timers and LFSR instead.
+//
+//    sessions/ holds the regression sessions.  Built as below, each
+//    must replay with its console hash, and the logs with the same
+//    events:
+//      replay -q -c -x bb2653e1 sessions/c1.txt   (captured; two guesses,
+//                                                 then time runs out)
+//      replay -q -c -x 9bfed8dc sessions/c5.txt   (captured; four book
+//                                                 guesses)
+//      replay -q -x a3926c0d sessions/s5.txt      (script)
+//    A change that moves a hash on purpose updates it here.
+//
+//  USAGE
+//    replay [-q] [-a] [-p file] [-b file] [-w periph=r[/w]] [-d] [-c]
+//           [-o file] [-x hash] [-l seconds] [-t file [-T events]] input
+//      -q  don't print the firmware's console output
+//      -a  profile bus accesses by firmware function and register
+//      -p  save the bus profile, for a later -b
+//      -b  compare the bus profile with one saved by -p
+//      -w  bus cycles per read (and write) of a peripheral, named as in
+//          Qsys; may be repeated (e.g. -w lfsr_16_0=3/2)
+//      -d  print the input log as text and exit
+//      -c  check that the replay logged the same events as the input
+//      -o  write the replay's own log, in binary
+//      -x  expected console hash; exit status 1 if it differs
+//      -l  stop after this much virtual time
+//      -t  write a timeline of the run for chrome://tracing or Perfetto
+//      -T  keep only the last this many timeline events
+//
+//  BUILDING
+//    gcc -O2 -Wall -DHOST_MODEL -DSESSION_RECORD -Ibsp -I. -I../nios
+//        -Dmain=firmware_main -c -o codebreaker.o ../nios/codebreaker.c
+//    gcc -O2 -Wall -DHOST_MODEL -DSESSION_RECORD -Ibsp -I. -I../nios
+//        -o replay replay.c regmodel.c bustrace.c chrometrace.c
+//        lfsr_model.c codebreaker.o
+//        ../nios/lfsr_if.c ../nios/pio_if.c ../nios/display_if.c
+//        ../nios/timer_if.c ../nios/uart_if.c ../nios/utilities.c
+//        ../nios/session_rec.c ../nios/book.c ../nios/book_table.c
+//        ../nios/color_table.c ../nios/analysis.c ../nios/defer.c
+//        ../nios/latency.c ../nios/msglog.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // for ALT_CPU_FREQ
+#include "regmodel.h"
+#include "session_rec.h"
+#include "pio_if.h"           // for PIO_KEYS_*
+#include "bustrace.h"
+#include "chrometrace.h"
+#include "defer.h"            // for defer_* statistics
+
+// The firmware has to log what it replays, for -c and -o
+#ifndef SESSION_RECORD
+  #error "build replay and the firmware with -DSESSION_RECORD"
+#endif /* SESSION_RECORD */
+
+// How long a scripted key stays down, in cycles (well over the debounce)
+#define   REPLAY_KEY_HOLD                 (ALT_CPU_FREQ / 20)
+// Spacing of typed characters in scripts, in cycles
+#define   REPLAY_TYPE_GAP                 (ALT_CPU_FREQ / 1000)
+// Default seed for scripts
+#define   REPLAY_DEFAULT_SEED             0x5EED
+// Binary log magic
+#define   REPLAY_MAGIC                    "CBR1"
+// Most -w options
+#define   REPLAY_COSTS                    16
+
+// The firmware's main, renamed when codebreaker.c is compiled
+int firmware_main(void);
+
+// Console output of the firmware
+static uint8*   _console;
+static uint32   _console_length, _console_alloc;
+static uint32   _quiet;
+
+static const char* _rec_names[] =
+{
+  "?", "seed", "uart_rx", "key", "tick", "lfsr"
+};
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _uart_tx
+//
+// DESCRIPTION: Register model hook; collects the firmware's output.
+//-------------------------------------------------------------------------
+static void _uart_tx(uint8 byte)
+{
+  if (_console_length == _console_alloc)
+  {
+    _console_alloc = _console_alloc ? _console_alloc * 2 : 65536;
+    _console = realloc(_console, _console_alloc);
+  } /* if */
+  _console[_console_length++] = byte;
+
+  if (!_quiet)
+  {
+    putchar(byte);
+  } /* if */
+} /* _uart_tx */
+
+//-------------------------------------------------------------------------
+// NAME:        _console_hash
+//
+// DESCRIPTION: 32-bit FNV-1a hash of the console output, used to compare
+//              runs.  The REC dump lines are skipped, since the event
+//              timestamps in them move by a few cycles between runs.
+//-------------------------------------------------------------------------
+static uint32 _console_hash(const uint8* data, uint32 length)
+{
+  uint32 hash = 0x811C9DC5;
+  uint32 bol  = TRUE;     // at the beginning of a line
+  uint32 skip = FALSE;    // in a REC line
+  uint32 i;
+
+  for (i = 0; i < length; i++)
+  {
+    if (bol)
+    {
+      skip = (i + 4 <= length && 0 == memcmp(data + i, "REC ", 4));
+    } /* if */
+    bol = ('\n' == data[i]);
+    if (!skip)
+    {
+      hash = (hash ^ data[i]) * 0x01000193;
+    } /* if */
+  } /* for i */
+  return hash;
+} /* _console_hash */
+
+//-------------------------------------------------------------------------
+// NAME:        _read_file
+//
+// DESCRIPTION: Reads a whole file, NUL-terminated.
+// RETURNS:     uint8*, the contents (NULL on error)
+//-------------------------------------------------------------------------
+static uint8* _read_file(const char* path, uint32* length)
+{
+  FILE*  file;
+  uint8* data;
+  long   size;
+
+  file = fopen(path, "rb");
+  if (NULL == file)
+  {
+    return NULL;
+  } /* if */
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  data = malloc(size + 1);
+  *length = (uint32)fread(data, 1, size, file);
+  data[*length] = NULL;
+  fclose(file);
+  return data;
+} /* _read_file */
+
+//-------------------------------------------------------------------------
+// NAME:        _parse_dump
+//
+// DESCRIPTION: Extracts the log from the last REC block of a console
+//              capture.
+// RETURNS:     int32, log length, or -1 if there is no complete block
+//-------------------------------------------------------------------------
+static int32 _parse_dump(const char* text, uint8* log, uint32 size,
+                         uint32* truncated)
+{
+  const char* block = NULL;
+  const char* line;
+  const char* next;
+  uint32      length = 0;
+  uint32      byte;
+
+  for (line = text; NULL != (line = strstr(line, "REC BEGIN")); line++)
+  {
+    block = line;
+  } /* for */
+  if (NULL == block)
+  {
+    return -1;
+  } /* if */
+  *truncated = (0 == strncmp(block, "REC BEGIN TRUNCATED", 19));
+
+  for (line = strchr(block, '\n'); NULL != line; line = next)
+  {
+    line++;
+    next = strchr(line, '\n');
+    if (0 == strncmp(line, "REC END", 7))
+    {
+      return (int32)length;
+    } /* if */
+    if (0 != strncmp(line, "REC ", 4))
+    {
+      continue;         // firmware output interleaved with the dump
+    } /* if */
+    for (line += 4; 1 == sscanf(line, "%2x", &byte); line += 2)
+    {
+      if (length < size)
+      {
+        log[length++] = (uint8)byte;
+      } /* if */
+    } /* for */
+  } /* for line */
+
+  return -1;
+} /* _parse_dump */
+
+//-------------------------------------------------------------------------
+// NAME:        _next_event
+//
+// DESCRIPTION: Decodes one event from a log.
+// RETURNS:     uint32, TRUE if an event was decoded
+//-------------------------------------------------------------------------
+static uint32 _next_event(const uint8* log, uint32 length, uint32* pos,
+                          uint32* type, uint32* delta, uint32* data)
+{
+  static const uint8 payload_sizes[] = REC_PAYLOAD_SIZES;
+
+  uint32 delta_bytes;
+  uint32 i;
+
+  if (*pos >= length)
+  {
+    return FALSE;
+  } /* if */
+
+  *type       = log[*pos] >> 4;
+  delta_bytes = log[*pos] & 0xF;
+  if (0 == *type || *type >= sizeof(payload_sizes) || delta_bytes > 4 ||
+      *pos + 1 + delta_bytes + payload_sizes[*type] > length)
+  {
+    fprintf(stderr, "replay: bad log entry at byte %u\n", *pos);
+    return FALSE;
+  } /* if */
+  (*pos)++;
+
+  *delta = 0;
+  for (i = 0; i < delta_bytes; i++)
+  {
+    *delta |= (uint32)log[(*pos)++] << (i * 8);
+  } /* for i */
+  *data = 0;
+  for (i = 0; i < payload_sizes[*type]; i++)
+  {
+    *data |= (uint32)log[(*pos)++] << (i * 8);
+  } /* for i */
+
+  return TRUE;
+} /* _next_event */
+
+//-------------------------------------------------------------------------
+// NAME:        _print_log
+//
+// DESCRIPTION: Prints a log as text, one event per line.
+//-------------------------------------------------------------------------
+static void _print_log(const uint8* log, uint32 length)
+{
+  uint64 when = 0;
+  uint32 pos  = 0;
+  uint32 type, delta, data;
+
+  while (_next_event(log, length, &pos, &type, &delta, &data))
+  {
+    when += delta;
+    printf("%12.6f %-8s", (double)when / ALT_CPU_FREQ, _rec_names[type]);
+    switch (type)
+    {
+      case REC_UART_RX:
+        printf(" 0x%02X", data);
+        if (data >= 0x20 && data <= 0x7E)
+        {
+          printf(" '%c'", data);
+        } /* if */
+        break;
+      case REC_SEED:
+      case REC_LFSR:
+        printf(" 0x%04X", data);
+        break;
+      case REC_KEY:
+        printf(" edges 0x%X down 0x%X", data & 0xF, data >> 4);
+        break;
+    } /* switch */
+    printf("\n");
+  } /* while */
+} /* _print_log */
+
+//-------------------------------------------------------------------------
+// NAME:        _schedule_log
+//
+// DESCRIPTION: Turns a recorded log into stimulus for the model.
+// RETURNS:     uint32, number of events
+//-------------------------------------------------------------------------
+static uint32 _schedule_log(const uint8* log, uint32 length)
+{
+  uint64 when   = 0;
+  uint32 pos    = 0;
+  uint32 events = 0;
+  uint32 type, delta, data;
+
+  rm_timer_external = TRUE;
+  while (_next_event(log, length, &pos, &type, &delta, &data))
+  {
+    when += delta;
+    events++;
+    switch (type)
+    {
+      case REC_SEED:
+        rm_sysid_timestamp = data;
+        break;
+      case REC_UART_RX:
+        rm_schedule(when, RM_EV_UART_RX, data);
+        break;
+      case REC_KEY:
+        // edges on keys now down were presses; the rest were releases
+        rm_schedule(when, RM_EV_KEY_DOWN, data & (data >> 4));
+        rm_schedule(when, RM_EV_KEY_UP, data & ~(data >> 4) & 0xF);
+        break;
+      case REC_TICK:
+        rm_schedule(when, RM_EV_TICK, 0);
+        break;
+      case REC_LFSR:
+        rm_lfsr_queue((uint16)data);
+        break;
+    } /* switch */
+  } /* while */
+
+  return events;
+} /* _schedule_log */
+
+//-------------------------------------------------------------------------
+// NAME:        _schedule_script
+//
+// DESCRIPTION: Turns a text script into stimulus for the model.
+// RETURNS:     int32, number of events, or -1 on a syntax error
+//-------------------------------------------------------------------------
+static int32 _schedule_script(char* text)
+{
+  int32   events = 0;
+  uint32  lineno = 0;
+  char*   line;
+  char*   next;
+  char    verb[16];
+  double  seconds;
+  uint64  when;
+  int     used;
+  char*   arg;
+  uint32  key;
+
+  rm_sysid_timestamp = REPLAY_DEFAULT_SEED;
+  for (line = text; NULL != line; line = next)
+  {
+    lineno++;
+    next = strchr(line, '\n');
+    if (NULL != next)
+    {
+      *next++ = NULL;
+    } /* if */
+    if (NULL != strchr(line, '#'))
+    {
+      *strchr(line, '#') = NULL;
+    } /* if */
+    if (2 != sscanf(line, " %lf %15s %n", &seconds, verb, &used))
+    {
+      if (1 == sscanf(line, " %15s", verb))
+      {
+        fprintf(stderr, "replay: line %u: expected <seconds> <event>\n",
+                lineno);
+        return -1;
+      } /* if not blank */
+      continue;
+    } /* if */
+    when = (uint64)(seconds * ALT_CPU_FREQ);
+    arg  = line + used;
+    events++;
+
+    if (0 == strcmp(verb, "seed"))
+    {
+      rm_sysid_timestamp = (uint32)strtoul(arg, NULL, 0);
+    } /* if */
+    else if (0 == strcmp(verb, "key") || 0 == strcmp(verb, "down") ||
+             0 == strcmp(verb, "up"))
+    {
+      key = (uint32)atoi(arg);
+      if (key < 1 || key > PIO_KEYS_COUNT)
+      {
+        fprintf(stderr, "replay: line %u: no such key\n", lineno);
+        return -1;
+      } /* if */
+      key = 1 << (key - 1);
+      if ('u' != verb[0])
+      {
+        rm_schedule(when, RM_EV_KEY_DOWN, key);
+      } /* if */
+      if ('d' != verb[0])
+      {
+        rm_schedule(('k' == verb[0]) ? when + REPLAY_KEY_HOLD : when,
+                    RM_EV_KEY_UP, key);
+      } /* if */
+    } /* else if */
+    else if (0 == strcmp(verb, "type"))
+    {
+      for (; NULL != *arg && '\r' != *arg; arg++, when += REPLAY_TYPE_GAP)
+      {
+        if ('\\' == arg[0] && 'n' == arg[1])
+        {
+          rm_schedule(when, RM_EV_UART_RX, '\n');
+          arg++;
+        } /* if */
+        else
+        {
+          rm_schedule(when, RM_EV_UART_RX, (uint8)*arg);
+        } /* else */
+      } /* for */
+    } /* else if */
+    else if (0 == strcmp(verb, "tick"))
+    {
+      rm_timer_external = TRUE;
+      rm_schedule(when, RM_EV_TICK, 0);
+    } /* else if */
+    else if (0 == strcmp(verb, "lfsr"))
+    {
+      rm_lfsr_queue((uint16)strtoul(arg, NULL, 0));
+    } /* else if */
+    else if (0 == strcmp(verb, "stop"))
+    {
+      rm_schedule(when, RM_EV_STOP, 0);
+    } /* else if */
+    else
+    {
+      fprintf(stderr, "replay: line %u: unknown event '%s'\n", lineno, verb);
+      return -1;
+    } /* else */
+  } /* for line */
+
+  return events;
+} /* _schedule_script */
+
+//-------------------------------------------------------------------------
+// NAME:        _same_events
+//
+// DESCRIPTION: Compares two logs event by event, ignoring timing.  If
+//              prefix is set, b may carry on after a ends.
+// RETURNS:     uint32, TRUE if they match
+//-------------------------------------------------------------------------
+static uint32 _same_events(const uint8* a, uint32 a_length,
+                           const uint8* b, uint32 b_length, uint32 prefix)
+{
+  uint32 a_pos = 0, b_pos = 0;
+  uint32 a_type, a_delta, a_data;
+  uint32 b_type, b_delta, b_data;
+  uint32 a_more, b_more;
+  uint32 index = 0;
+
+  do
+  {
+    a_more = _next_event(a, a_length, &a_pos, &a_type, &a_delta, &a_data);
+    b_more = _next_event(b, b_length, &b_pos, &b_type, &b_delta, &b_data);
+    if (prefix && !a_more)
+    {
+      break;
+    } /* if */
+    if (a_more != b_more ||
+        (a_more && (a_type != b_type || a_data != b_data)))
+    {
+      fprintf(stderr, "replay: logs differ at event %u\n", index);
+      return FALSE;
+    } /* if */
+    index++;
+  } while (a_more);
+
+  return TRUE;
+} /* _same_events */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Loads the input, runs the firmware, prints a summary.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  static const char* stop_names[] =
+  {
+    "firmware returned", "idle", "stop event", "time limit"
+  };
+
+  uint32  print_only = FALSE;
+  uint32  profile    = FALSE;
+  char*   save_path  = NULL;
+  char*   base_path  = NULL;
+  uint32  check      = FALSE;
+  char*   out_path   = NULL;
+  uint32  expected   = 0;
+  uint32  check_hash = FALSE;
+  double  limit      = 0;
+  char*   trace_path = NULL;
+  uint32  trace_ring = 0;
+  uint8*  input;
+  uint32  input_length;
+  uint8*  log        = NULL;
+  int32   log_length = -1;
+  uint32  truncated  = FALSE;
+  uint8*  replayed;
+  uint32  replayed_length;
+  uint32  stop;
+  uint32  hash;
+  uint32  failed     = FALSE;
+  double  start;
+  double  wall;
+  double  virtual;
+  FILE*   out;
+  uint32  irq;
+  uint32  digit;
+  char*   costs[REPLAY_COSTS];
+  uint32  cost_count = 0;
+  uint32  i;
+  int     opt;
+
+  while (-1 != (opt = getopt(argc, argv, "qap:b:w:dco:x:l:t:T:")))
+  {
+    switch (opt)
+    {
+      case 'q':
+        _quiet = TRUE;
+        break;
+      case 'a':
+        profile = TRUE;
+        break;
+      case 'p':
+        save_path = optarg;
+        break;
+      case 'b':
+        base_path = optarg;
+        break;
+      case 'w':
+        costs[cost_count++ % REPLAY_COSTS] = optarg;
+        break;
+      case 'd':
+        print_only = TRUE;
+        break;
+      case 'c':
+        check = TRUE;
+        break;
+      case 'o':
+        out_path = optarg;
+        break;
+      case 'x':
+        expected   = (uint32)strtoul(optarg, NULL, 16);
+        check_hash = TRUE;
+        break;
+      case 'l':
+        limit = atof(optarg);
+        break;
+      case 't':
+        trace_path = optarg;
+        break;
+      case 'T':
+        trace_ring = (uint32)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        optind = argc;
+        break;
+    } /* switch */
+  } /* while */
+  if (optind != argc - 1)
+  {
+    fprintf(stderr, "usage: %s [-q] [-a] [-p file] [-b file] "
+                    "[-w periph=r[/w]] [-d] [-c] [-o file] [-x hash] "
+                    "[-l seconds] [-t file [-T events]] input\n", argv[0]);
+    return 2;
+  } /* if */
+
+  input = _read_file(argv[optind], &input_length);
+  if (NULL == input)
+  {
+    perror(argv[optind]);
+    return 2;
+  } /* if */
+
+  rm_reset();
+  rm_hooks.uart_tx = _uart_tx;
+  if (profile || NULL != save_path || NULL != base_path)
+  {
+    rm_hooks.access = bt_access;
+  } /* if */
+  for (i = 0; i < cost_count && i < REPLAY_COSTS; i++)
+  {
+    if (0 != bt_set_cost(costs[i]))
+    {
+      fprintf(stderr, "replay: bad -w %s\n", costs[i]);
+      return 2;
+    } /* if */
+  } /* for i */
+  rm_cycle_limit   = (uint64)(limit * ALT_CPU_FREQ);
+  if (NULL != trace_path && 0 != ct_attach(trace_ring))
+  {
+    fprintf(stderr, "replay: no memory for the timeline\n");
+    return 2;
+  } /* if */
+
+  // Work out what kind of input this is
+  if (input_length >= 4 && 0 == memcmp(input, REPLAY_MAGIC, 4))
+  {
+    log        = input + 4;
+    log_length = (int32)(input_length - 4);
+  } /* if binary */
+  else if (NULL != strstr((char*)input, "REC BEGIN"))
+  {
+    log        = malloc(input_length);
+    log_length = _parse_dump((char*)input, log, input_length, &truncated);
+    if (log_length < 0)
+    {
+      fprintf(stderr, "replay: no complete REC block in %s\n", argv[optind]);
+      return 2;
+    } /* if */
+  } /* else if capture */
+
+  if (NULL != log)
+  {
+    if (print_only)
+    {
+      _print_log(log, (uint32)log_length);
+      return 0;
+    } /* if */
+    if (truncated)
+    {
+      fprintf(stderr, "replay: log was truncated; replaying what there is\n");
+    } /* if */
+    _schedule_log(log, (uint32)log_length);
+  } /* if log */
+  else if (print_only || check || _schedule_script((char*)input) < 0)
+  {
+    if (print_only || check)
+    {
+      fprintf(stderr, "replay: -d and -c need a recorded log\n");
+    } /* if */
+    return 2;
+  } /* else if script */
+
+  // Run the firmware until the stimulus runs out
+  start = _now();
+  stop  = rm_run(firmware_main);
+  wall  = _now() - start;
+
+  // Summary
+  virtual = (double)rm_cycles / ALT_CPU_FREQ;
+  hash    = _console_hash(_console, _console_length);
+  fprintf(stderr, "\n--- replay: stopped (%s)\n", stop_names[stop]);
+  fprintf(stderr, "virtual time   %.6f s (%llu cycles, %llu busy)\n",
+          virtual, (unsigned long long)rm_cycles,
+          (unsigned long long)rm_busy_cycles);
+  fprintf(stderr, "wall time      %.6f s (%.0fx real time)\n",
+          wall, (wall > 0) ? virtual / wall : 0);
+  for (irq = 0; irq < RM_IRQS; irq++)
+  {
+    fprintf(stderr, "%-26s %8llu ISRs, longest %llu cycles\n",
+            rm_irq_name(irq), (unsigned long long)rm_isr_count[irq],
+            (unsigned long long)rm_isr_max[irq]);
+  } /* for irq */
+  fprintf(stderr, "deferred work  %u items (%u dropped), at most %u "
+          "waiting, longest wait %u cycles\n", defer_posted, defer_dropped,
+          defer_max_depth, defer_max_delay);
+  fprintf(stderr, "console        %u bytes, hash %08x\n",
+          _console_length, hash);
+  fprintf(stderr, "LEDs           red %s, green %s\n",
+          (rm_output(RM_PIO_LEDS) & PIO_LEDS_RED_MASK) ? "on" : "off",
+          (rm_output(RM_PIO_LEDS) & PIO_LEDS_GREEN_MASK) ? "on" : "off");
+  fprintf(stderr, "display        [");
+  for (digit = 8; digit-- > 0; )
+  {
+    // blank displays show as '.'
+    fputc((rm_display_control() & (1 << digit))
+          ? "0123456789AbCdEF"[(rm_output(RM_DISPLAY) >> (digit * 4)) & 0xF]
+          : '.', stderr);
+  } /* for digit */
+  fprintf(stderr, "]\n");
+  if (0 != rm_uart_overruns)
+  {
+    fprintf(stderr, "UART overruns  %u\n", rm_uart_overruns);
+  } /* if */
+  if (profile)
+  {
+    bt_print(stderr);
+  } /* if */
+  if (NULL != save_path && 0 != bt_save(save_path))
+  {
+    return 2;
+  } /* if */
+  if (NULL != base_path && 0 != bt_diff(stderr, base_path))
+  {
+    return 2;
+  } /* if */
+  if (NULL != trace_path)
+  {
+    if (0 != ct_write(trace_path))
+    {
+      return 2;
+    } /* if */
+    fprintf(stderr, "timeline       %llu events (%llu dropped) in %s\n",
+            (unsigned long long)ct_recorded,
+            (unsigned long long)ct_dropped, trace_path);
+  } /* if */
+
+  replayed = rec_log(&replayed_length);
+  if (NULL != out_path)
+  {
+    out = fopen(out_path, "wb");
+    if (NULL == out)
+    {
+      perror(out_path);
+      return 2;
+    } /* if */
+    fwrite(REPLAY_MAGIC, 1, 4, out);
+    fwrite(replayed, 1, replayed_length, out);
+    fclose(out);
+  } /* if */
+
+  if (check)
+  {
+    // A truncated input only covers the start of what was replayed
+    if (_same_events(log, (uint32)log_length, replayed, replayed_length,
+                     truncated))
+    {
+      fprintf(stderr, "events         match the input\n");
+    } /* if */
+    else
+    {
+      failed = TRUE;
+    } /* else */
+  } /* if */
+  if (check_hash && hash != expected)
+  {
+    fprintf(stderr, "replay: console hash %08x, expected %08x\n",
+            hash, expected);
+    failed = TRUE;
+  } /* if */
+
+  return failed ? 1 : 0;
+} /* main */
@@ -0,0 +1,849 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  sample_solve.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Anytime solver for code spaces too large to list, such as 8 pegs
+//    with 12 colors (430 million codes), where gen_book's exact sets and
+//    full ranking are out of reach.  Each guess is chosen within a time
+//    and memory budget in two phases:
+//
+//    1. Sample codes consistent with the feedback so far.  A depth-first
+//       walk assigns one position at a time, in a random color order,
+//       and prunes a branch as soon as some earlier guess could no longer
+//       get its feedback: the P so far must stay within reach of that
+//       guess's P, and the color matches (P + C, the sum over colors of
+//       the smaller count) within reach of its P + C.  Without repeats,
+//       the positions left may also be more than the colors left that
+//       the guess doesn't have, forcing more matches.  If the whole
+//       consistent set fits in the memory budget, and can be listed in
+//       an eighth of the time budget, it is listed exactly; otherwise
+//       each walk stops at its first code, and the walks are repeated
+//       until half the time budget or the memory runs out.
+//       Walks are not uniform over the set, but they cover it widely.
+//
+//    2. Score candidate guesses against the sample (or a random part of
+//       it, -k) with score_batch and keep the one with the smallest sum
+//       of squared feedback counts (the expected share of the sample
+//       left after it), preferring guesses that could be the code.  The
+//       sample itself is tried first, in random order, and then other
+//       codes.  The best guess so far is always available, so the phase
+//       simply stops at the deadline.
+//
+//    Both phases run on every thread.  Each game is played against a
+//    secret from the seed; the same secrets are replayed at each budget,
+//    so the report shows what more time buys.
+//
+//  USAGE
+//    sample_solve [-p pegs] [-c colors] [-r] [-t seconds,...] [-m MiB]
+//                 [-k codes] [-j threads] [-n games] [-s seed] [-v]
+//      -p  positions per code (default 8)
+//      -c  colors (default 12)
+//      -r  allow repeated colors
+//      -t  time budgets per guess, comma-separated (default 0.01,0.1)
+//      -m  memory for the sample, in MiB (default 64)
+//      -k  codes of the sample each guess is scored against (default
+//          4096, 0 for all); more leaves less time for other guesses
+//      -j  threads (default one per CPU)
+//      -n  games per budget (default 10)
+//      -s  seed for the secrets (default 1)
+//      -v  trace each guess, and how its quality grew with time
+//
+//  BUILDING
+//    gcc -O2 -Wall -pthread -Ibsp -I../nios -o sample_solve
+//        sample_solve.c score_batch.c codeset.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codeset.h"
+#include "score_batch.h"
+
+// Limits
+#define   SS_MAX_THREADS                  64
+#define   SS_MAX_TURNS                    32    // a game is lost after
+#define   SS_MAX_BUDGETS                  16
+#define   SS_MAX_LOG                      64    // improvements traced
+
+// Nodes one sampling walk may visit before it is abandoned
+#define   SS_WALK_NODES                   (1 << 12)
+
+// Nodes between clock checks during the exact listing
+#define   SS_CLOCK_NODES                  (1 << 10)
+
+// One guess and its feedback, as the walk needs them
+typedef struct
+{
+  uint32  guess;
+  uint32  slot[CODESET_MAX_PEGS];     // the guess's color per position
+  uint32  hist[CODESET_MAX_COLORS];   // the guess's count of each color
+  uint32  p;                          // P
+  uint32  pc;                         // P + C
+  uint32  others;                     // colors not in the guess
+  uint32  bucket;                     // SB_BUCKET(p, c, pegs)
+} _ss_turn_t;
+
+// A depth-first walk over the consistent codes
+typedef struct
+{
+  uint64  rng;                        // xorshift state
+  uint32  random;                     // TRUE for a random color order
+  uint32* out;
+  uint32  found;
+  uint32  limit;                      // codes wanted
+  uint64  nodes;
+  uint64  node_limit;
+  uint32  aborted;                    // ran out of nodes or time
+  double  deadline;
+  uint32  hist[CODESET_MAX_COLORS];   // colors assigned so far
+  uint32  p[CODESET_MAX_PEGS + 1][SS_MAX_TURNS];
+  uint32  pc[CODESET_MAX_PEGS + 1][SS_MAX_TURNS];
+} _ss_walk_t;
+
+// Per-thread state
+typedef struct
+{
+  pthread_t   thread;
+  _ss_walk_t  walk;
+  uint32*     codes;                  // this thread's share of the sample
+  uint32      count;
+  uint32      limit;
+  uint64      best_key;
+  uint64      scored;
+} _ss_worker_t;
+
+// An improvement in the best guess
+typedef struct
+{
+  double  time;                       // since the guess began
+  uint64  tried;                      // guesses scored by then
+  double  share;                      // expected share of the sample left
+} _ss_log_t;
+
+// Configuration
+static uint32       _pegs;
+static uint32       _colors;
+static uint32       _repeats;
+static uint64       _space;           // codeset_count
+static uint32       _threads;
+static uint32       _verbose;
+
+// The game so far
+static _ss_turn_t   _turns[SS_MAX_TURNS];
+static uint32       _turn_count;
+
+// The current guess's work
+static _ss_worker_t _workers[SS_MAX_THREADS];
+static uint32*      _sample;
+static uint32       _sample_count;
+static uint32       _judge_count;     // how many guesses are scored against
+static uint32       _judge_limit;     // -k
+static uint32       _sample_exact;    // TRUE if it is the whole set
+static uint32       _sample_limit;    // codes the memory budget holds
+static uint32*      _all;             // every code, if it fits, else NULL
+static double       _start;
+static double       _list_deadline;
+static double       _sample_deadline;
+static double       _deadline;
+static uint64       _next;            // next candidate guess to score
+static volatile uint32 _done;         // TRUE once a perfect split is found
+static uint64       _best_key;
+static uint32       _best;
+static _ss_log_t    _log[SS_MAX_LOG];
+static uint32       _log_count;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _rand
+//
+// DESCRIPTION: xorshift64*, one generator per thread.
+//-------------------------------------------------------------------------
+static uint32 _rand(uint64* state)
+{
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return (uint32)((*state * 0x2545F4914F6CDD1DULL) >> 32);
+} /* _rand */
+
+//-------------------------------------------------------------------------
+// NAME:        _random_code
+//
+// DESCRIPTION: A uniformly chosen valid code.
+//-------------------------------------------------------------------------
+static uint32 _random_code(uint64* rng)
+{
+  uint32 code;
+  uint32 i;
+
+  do
+  {
+    code = 0;
+    for (i = 0; i < _pegs; i++)
+    {
+      code |= (_rand(rng) % _colors) << (i * 4);
+    } /* for i */
+  } while (!_repeats && !codeset_valid(code, _pegs, _colors, FALSE));
+
+  return code;
+} /* _random_code */
+
+//-------------------------------------------------------------------------
+// NAME:        _walk
+//
+// DESCRIPTION: Assigns position pos and everything after it, depth first,
+//              adding each consistent code found to w->out.
+// RETURNS:     uint32, TRUE to stop (enough codes, or out of nodes/time)
+//-------------------------------------------------------------------------
+static uint32 _walk(_ss_walk_t* w, uint32 pos, uint32 code)
+{
+  uint32 order[CODESET_MAX_COLORS];
+  uint32 left = _pegs - pos - 1;      // positions after this one
+  uint32 color;
+  uint32 p, pc;
+  uint32 spare;                       // unused colors not in a guess
+  uint32 i, j, t;
+
+  if (pos == _pegs)
+  {
+    w->out[w->found++] = code;
+    return (w->found >= w->limit);
+  } /* if a whole code */
+
+  if (++w->nodes > w->node_limit ||
+      (0 == (w->nodes % SS_CLOCK_NODES) && _now() > w->deadline))
+  {
+    w->aborted = TRUE;
+    return TRUE;
+  } /* if out of nodes or time */
+
+  for (i = 0; i < _colors; i++)
+  {
+    order[i] = i;
+  } /* for i */
+  if (w->random)
+  {
+    for (i = _colors - 1; i > 0; i--)
+    {
+      j        = _rand(&w->rng) % (i + 1);
+      color    = order[i];
+      order[i] = order[j];
+      order[j] = color;
+    } /* for i */
+  } /* if */
+
+  for (i = 0; i < _colors; i++)
+  {
+    color = order[i];
+    if (!_repeats && 0 != w->hist[color])
+    {
+      continue;
+    } /* if used */
+
+    for (t = 0; t < _turn_count; t++)
+    {
+      p  = w->p[pos][t]  + (_turns[t].slot[pos] == color);
+      pc = w->pc[pos][t] + (w->hist[color] < _turns[t].hist[color]);
+      if (p > _turns[t].p || p + left < _turns[t].p ||
+          pc > _turns[t].pc || pc + left < _turns[t].pc)
+      {
+        break;
+      } /* if this guess's feedback is out of reach */
+      spare = _turns[t].others - (pos + 1 - pc);
+      if (!_repeats && left > spare && pc + (left - spare) > _turns[t].pc)
+      {
+        break;
+      } /* if the unused colors would force too many matches */
+      w->p[pos + 1][t]  = p;
+      w->pc[pos + 1][t] = pc;
+    } /* for t */
+    if (t < _turn_count)
+    {
+      continue;
+    } /* if pruned */
+
+    w->hist[color]++;
+    if (_walk(w, pos + 1, code | (color << (pos * 4))))
+    {
+      w->hist[color]--;
+      return TRUE;
+    } /* if */
+    w->hist[color]--;
+  } /* for i */
+
+  return FALSE;
+} /* _walk */
+
+//-------------------------------------------------------------------------
+// NAME:        _walk_start
+//
+// DESCRIPTION: Prepares a walk from the first position.
+//-------------------------------------------------------------------------
+static void _walk_start(_ss_walk_t* w, uint32* out, uint32 limit,
+                        uint32 random, uint64 node_limit, double deadline)
+{
+  w->out        = out;
+  w->found      = 0;
+  w->limit      = limit;
+  w->random     = random;
+  w->nodes      = 0;
+  w->node_limit = node_limit;
+  w->deadline   = deadline;
+  w->aborted    = FALSE;
+  memset(w->hist, 0, sizeof(w->hist));
+  memset(w->p[0], 0, sizeof(w->p[0]));
+  memset(w->pc[0], 0, sizeof(w->pc[0]));
+} /* _walk_start */
+
+//-------------------------------------------------------------------------
+// NAME:        _sampler
+//
+// DESCRIPTION: Thread body for phase 1: random walks until this thread's
+//              share of the memory or half the time is used.
+//-------------------------------------------------------------------------
+static void* _sampler(void* arg)
+{
+  _ss_worker_t* me = arg;
+  uint32        walks = 0;
+
+  me->count = 0;
+  while (me->count < me->limit)
+  {
+    if (0 == (++walks % 16) && _now() > _sample_deadline)
+    {
+      break;
+    } /* if out of time */
+    _walk_start(&me->walk, me->codes + me->count, 1, TRUE, SS_WALK_NODES,
+                _sample_deadline);
+    _walk(&me->walk, 0, 0);
+    me->count += me->walk.found;
+  } /* while */
+
+  return NULL;
+} /* _sampler */
+
+//-------------------------------------------------------------------------
+// NAME:        _scorer
+//
+// DESCRIPTION: Thread body for phase 2: scores candidate guesses against
+//              the sample until the deadline, the candidates run out, or
+//              some thread finds a guess that no other can beat.
+//-------------------------------------------------------------------------
+static void* _scorer(void* arg)
+{
+  _ss_worker_t* me = arg;
+  uint32        buckets[SB_BUCKETS(SB_MAX_PEGS)];
+  uint32        win = SB_BUCKET(_pegs, 0, _pegs);
+  uint64        others = (NULL != _all) ? _space : 0;
+  uint64        key;
+  uint64        k;
+  uint32        guess;
+  uint32        b;
+
+  me->best_key = ~0ULL;
+  me->scored   = 0;
+  while (!_done)
+  {
+    if (0 == (me->scored % 8) && _now() > _deadline)
+    {
+      break;
+    } /* if out of time */
+
+    // the sample first, then every code (or random ones)
+    k = __sync_fetch_and_add(&_next, 1);
+    if (k < _sample_count)
+    {
+      guess = _sample[k];
+    } /* if */
+    else if (NULL == _all)
+    {
+      guess = _random_code(&me->walk.rng);
+    } /* else if */
+    else if (k - _sample_count < others)
+    {
+      guess = _all[k - _sample_count];
+    } /* else if */
+    else
+    {
+      break;
+    } /* else no more */
+
+    score_batch(guess, _sample, _judge_count, _pegs, buckets, NULL);
+    me->scored++;
+
+    // smaller is better: the sum of squares, then not being a candidate
+    key = 0;
+    for (b = 0; b < SB_BUCKETS(_pegs); b++)
+    {
+      key += (uint64)buckets[b] * buckets[b];
+    } /* for b */
+    key = key * 2 + (0 == buckets[win]);
+    if (key >= me->best_key)
+    {
+      continue;
+    } /* if no better */
+    me->best_key = key;
+
+    pthread_mutex_lock(&_lock);
+    if (key < _best_key)
+    {
+      _best_key = key;
+      _best     = guess;
+      if (_log_count < SS_MAX_LOG)
+      {
+        _log[_log_count].time  = _now() - _start;
+        _log[_log_count].tried = __sync_fetch_and_add(&_next, 0);
+        _log[_log_count].share = (double)(key / 2) /
+                                 ((double)_judge_count * _judge_count);
+        _log_count++;
+      } /* if */
+      if (key / 2 == _judge_count && 0 == (key & 1))
+      {
+        _done = TRUE;         // every code apart, and it could be the code
+      } /* if */
+    } /* if */
+    pthread_mutex_unlock(&_lock);
+  } /* while */
+
+  return NULL;
+} /* _scorer */
+
+//-------------------------------------------------------------------------
+// NAME:        _cmp_code
+//
+// DESCRIPTION: qsort comparison for packed codes.
+//-------------------------------------------------------------------------
+static int _cmp_code(const void* a, const void* b)
+{
+  uint32 x = *(const uint32*)a;
+  uint32 y = *(const uint32*)b;
+
+  return (x > y) - (x < y);
+} /* _cmp_code */
+
+//-------------------------------------------------------------------------
+// NAME:        _sample_codes
+//
+// DESCRIPTION: Phase 1: fills _sample with codes consistent with the
+//              game so far, exactly if they fit, and shuffles them.
+//-------------------------------------------------------------------------
+static void _sample_codes(uint64* rng)
+{
+  uint32  buckets[SB_BUCKETS(SB_MAX_PEGS)];
+  uint32  i, j, code, t;
+
+  _sample_count = 0;
+  _sample_exact = FALSE;
+  if (0 == _turn_count && _space <= _sample_limit)
+  {
+    _sample_count = codeset_fill(_sample, _pegs, _colors, _repeats);
+    _sample_exact = TRUE;
+  } /* if it all fits */
+  else if (0 != _turn_count)
+  {
+    // list them all, unless there are too many to hold (one more than
+    // fits, to tell) or to find in time
+    _walk_start(&_workers[0].walk, _sample, _sample_limit + 1, FALSE,
+                ~0ULL, _list_deadline);
+    _walk(&_workers[0].walk, 0, 0);
+    if (!_workers[0].walk.aborted && _workers[0].walk.found <= _sample_limit)
+    {
+      _sample_count = _workers[0].walk.found;
+      _sample_exact = TRUE;
+    } /* if */
+  } /* else if */
+
+  if (!_sample_exact)
+  {
+    for (i = 0; i < _threads; i++)
+    {
+      pthread_create(&_workers[i].thread, NULL, _sampler, &_workers[i]);
+    } /* for i */
+    for (i = 0; i < _threads; i++)
+    {
+      pthread_join(_workers[i].thread, NULL);
+      memcpy(_sample + _sample_count, _workers[i].codes,
+             _workers[i].count * sizeof(uint32));
+      _sample_count += _workers[i].count;
+    } /* for i */
+
+    // different walks may end at the same code
+    qsort(_sample, _sample_count, sizeof(uint32), _cmp_code);
+    for (i = 0, j = 0; i < _sample_count; i++)
+    {
+      if (0 == j || _sample[i] != _sample[j - 1])
+      {
+        _sample[j++] = _sample[i];
+      } /* if */
+    } /* for i */
+    _sample_count = j;
+  } /* if sampling */
+
+  if (0 == _sample_count)
+  {
+    // out of time before any walk finished: finish one, however long
+    _walk_start(&_workers[0].walk, _sample, 1, TRUE, ~0ULL, 1e300);
+    _walk(&_workers[0].walk, 0, 0);
+    _sample_count = _workers[0].walk.found;
+  } /* if */
+
+  // every code must give every earlier guess its feedback
+  for (t = 0; t < _turn_count; t++)
+  {
+    score_batch(_turns[t].guess, _sample, _sample_count, _pegs, buckets,
+                NULL);
+    if (buckets[_turns[t].bucket] != _sample_count)
+    {
+      fprintf(stderr, "sample_solve: inconsistent sample\n");
+      exit(1);
+    } /* if */
+  } /* for t */
+
+  // score the candidates in random order, not the listing's
+  for (i = _sample_count; i > 1; i--)
+  {
+    j              = _rand(rng) % i;
+    code           = _sample[i - 1];
+    _sample[i - 1] = _sample[j];
+    _sample[j]     = code;
+  } /* for i */
+} /* _sample_codes */
+
+//-------------------------------------------------------------------------
+// NAME:        _choose
+//
+// DESCRIPTION: Chooses the next guess within the budget.
+// RETURNS:     uint32, the guess
+//-------------------------------------------------------------------------
+static uint32 _choose(double budget, uint64* rng, uint64* scored)
+{
+  uint32 i;
+
+  _start           = _now();
+  _list_deadline   = _start + budget / 8;
+  _sample_deadline = _start + budget / 2;
+  _deadline        = _start + budget;
+
+  _sample_codes(rng);
+  if (_sample_count <= 2)
+  {
+    // one of them; if it's wrong, the other is the code
+    *scored = 0;
+    _log_count = 0;
+    return _sample[0];
+  } /* if */
+
+  _judge_count = (0 != _judge_limit && _sample_count > _judge_limit)
+                 ? _judge_limit : _sample_count;
+  _next      = 0;
+  _done      = FALSE;
+  _best_key  = ~0ULL;
+  _best      = _sample[0];
+  _log_count = 0;
+  for (i = 0; i < _threads; i++)
+  {
+    pthread_create(&_workers[i].thread, NULL, _scorer, &_workers[i]);
+  } /* for i */
+  *scored = 0;
+  for (i = 0; i < _threads; i++)
+  {
+    pthread_join(_workers[i].thread, NULL);
+    *scored += _workers[i].scored;
+  } /* for i */
+
+  return _best;
+} /* _choose */
+
+//-------------------------------------------------------------------------
+// NAME:        _play
+//
+// DESCRIPTION: Plays one game against a secret.
+// ARGUMENTS:   uint32 secret, the code to find
+//              double budget, seconds per guess
+//              uint64* rng, the solver's generator
+//              uint32* first_sample, receives the first guess's sample size
+//              uint64* scored, accumulates guesses scored
+// RETURNS:     uint32, guesses taken, or 0 if it gave up
+//-------------------------------------------------------------------------
+static uint32 _play(uint32 secret, double budget, uint64* rng,
+                    uint32* first_sample, uint64* scored)
+{
+  char        str[CODESET_MAX_PEGS + 1];
+  _ss_turn_t* turn;
+  uint64      tried;
+  uint32      guess;
+  uint32      i;
+
+  _turn_count = 0;
+  while (_turn_count < SS_MAX_TURNS)
+  {
+    guess = _choose(budget, rng, &tried);
+    *scored += tried;
+    if (0 == _turn_count)
+    {
+      *first_sample = _sample_count;
+    } /* if */
+
+    turn         = &_turns[_turn_count++];
+    turn->guess  = guess;
+    turn->bucket = score_one(secret, guess, _pegs);
+    turn->p      = SB_BUCKET_P(turn->bucket, _pegs);
+    turn->pc     = turn->p + SB_BUCKET_C(turn->bucket, _pegs);
+    memset(turn->hist, 0, sizeof(turn->hist));
+    for (i = 0; i < _pegs; i++)
+    {
+      turn->slot[i] = (guess >> (i * 4)) & 0xF;
+      turn->hist[turn->slot[i]]++;
+    } /* for i */
+    turn->others = 0;
+    for (i = 0; i < _colors; i++)
+    {
+      turn->others += (0 == turn->hist[i]);
+    } /* for i */
+
+    if (_verbose)
+    {
+      codeset_to_str(guess, _pegs, str);
+      printf("  %2u  %s  %uP %uC  sample %9u%s  scored %8llu  %.4f s\n",
+             _turn_count, str, turn->p, turn->pc - turn->p,
+             _sample_count, _sample_exact ? " (all)" : "      ",
+             (unsigned long long)tried, _now() - _start);
+      for (i = 0; i < _log_count; i++)
+      {
+        printf("        %9.6f s  %8llu scored  %.6f of sample left\n",
+               _log[i].time, (unsigned long long)_log[i].tried,
+               _log[i].share);
+      } /* for i */
+    } /* if */
+
+    if (turn->p == _pegs)
+    {
+      return _turn_count;
+    } /* if found */
+  } /* while */
+
+  return 0;
+} /* _play */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, then plays the same games at each budget
+//              and reports.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  double  budgets[SS_MAX_BUDGETS];
+  uint32  budget_count = 0;
+  char*   list = "0.01,0.1";
+  char*   next;
+  uint32  megabytes = 64;
+  uint32  games = 10;
+  uint32  seed  = 1;
+  uint32* secrets;
+  uint64  rng;
+  uint64  scored;
+  uint32  first = 0;
+  uint64  first_total;
+  uint32  taken, total, worst, failed;
+  uint32  share;
+  uint32  b, g, i;
+  char    str[CODESET_MAX_PEGS + 1];
+  double  start, elapsed;
+  int     opt;
+
+  _pegs    = 8;
+  _colors  = 12;
+  _repeats = FALSE;
+  _threads = (uint32)sysconf(_SC_NPROCESSORS_ONLN);
+  _verbose = FALSE;
+  _judge_limit = 4096;
+  while (-1 != (opt = getopt(argc, argv, "p:c:rt:m:k:j:n:s:v")))
+  {
+    switch (opt)
+    {
+      case 'p':
+        _pegs = (uint32)atoi(optarg);
+        break;
+      case 'c':
+        _colors = (uint32)atoi(optarg);
+        break;
+      case 'r':
+        _repeats = TRUE;
+        break;
+      case 't':
+        list = optarg;
+        break;
+      case 'm':
+        megabytes = (uint32)atoi(optarg);
+        break;
+      case 'k':
+        _judge_limit = (uint32)atoi(optarg);
+        break;
+      case 'j':
+        _threads = (uint32)atoi(optarg);
+        break;
+      case 'n':
+        games = (uint32)atoi(optarg);
+        break;
+      case 's':
+        seed = (uint32)strtoul(optarg, NULL, 0);
+        break;
+      case 'v':
+        _verbose = TRUE;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-p pegs] [-c colors] [-r] "
+                        "[-t seconds,...] [-m MiB] [-k codes] "
+                        "[-j threads] "
+                        "[-n games] [-s seed] [-v]\n", argv[0]);
+        return 2;
+    } /* switch */
+  } /* while */
+
+  for (next = list; budget_count < SS_MAX_BUDGETS && '\0' != *next; )
+  {
+    budgets[budget_count] = strtod(next, &next);
+    if (budgets[budget_count] <= 0)
+    {
+      fprintf(stderr, "bad time budget list: %s\n", list);
+      return 2;
+    } /* if */
+    budget_count++;
+    next += (',' == *next);
+  } /* for */
+
+  _space = codeset_count(_pegs, _colors, _repeats);
+  if (_pegs < 1 || _pegs > SB_MAX_PEGS || _colors < 2 ||
+      _colors > CODESET_MAX_COLORS || 0 == _space)
+  {
+    fprintf(stderr, "unsupported configuration\n");
+    return 2;
+  } /* if */
+  if (_threads < 1 || _threads > SS_MAX_THREADS)
+  {
+    fprintf(stderr, "threads must be 1 to %u\n", SS_MAX_THREADS);
+    return 2;
+  } /* if */
+
+  // half the memory for the threads' shares, half for the merged sample
+  _sample_limit = (uint32)(((uint64)megabytes << 20) / (2 * sizeof(uint32)));
+  if (_sample_limit < _threads)
+  {
+    fprintf(stderr, "not enough memory for a sample\n");
+    return 2;
+  } /* if */
+  _sample = malloc((_sample_limit + 1) * sizeof(uint32));  // +1: see above
+  share   = _sample_limit / _threads;
+  for (i = 0; i < _threads; i++)
+  {
+    _workers[i].codes    = malloc(share * sizeof(uint32));
+    _workers[i].limit    = share;
+    _workers[i].walk.rng = 0x9E3779B97F4A7C15ULL * (i + 1) + seed;
+  } /* for i */
+  _all = NULL;
+  if (_space <= _sample_limit)
+  {
+    _all = malloc(_space * sizeof(uint32));
+    codeset_fill(_all, _pegs, _colors, _repeats);
+  } /* if small enough to try every guess */
+
+  // pick the kernel before the threads race to
+  score_batch_select(SB_IMPL_AUTO);
+
+  secrets = malloc(games * sizeof(uint32));
+  rng     = 0x5DEECE66DULL ^ seed;
+  for (g = 0; g < games; g++)
+  {
+    secrets[g] = _random_code(&rng);
+  } /* for g */
+
+  printf("%u pegs, %u colors, %s: %llu codes, %u threads (%s), "
+         "%u MiB (%u codes)\n", _pegs, _colors,
+         _repeats ? "repeats" : "no repeats", (unsigned long long)_space,
+         _threads, score_batch_name(SB_IMPL_AUTO), megabytes,
+         _sample_limit);
+  if (!_verbose)
+  {
+    printf("%10s %6s %8s %6s %7s %12s %12s %9s\n", "budget", "games",
+           "guesses", "worst", "failed", "1st sample", "scored/turn",
+           "time");
+  } /* if */
+
+  for (b = 0; b < budget_count; b++)
+  {
+    total       = 0;
+    worst       = 0;
+    failed      = 0;
+    scored      = 0;
+    first_total = 0;
+    start       = _now();
+    for (g = 0; g < games; g++)
+    {
+      rng = 0x2545F4914F6CDD1DULL ^ ((uint64)seed << 32) ^ g;
+      if (_verbose)
+      {
+        codeset_to_str(secrets[g], _pegs, str);
+        printf("budget %g s, game %u, secret %s\n", budgets[b], g + 1, str);
+      } /* if */
+      taken = _play(secrets[g], budgets[b], &rng, &first, &scored);
+      first_total += first;
+      if (0 == taken)
+      {
+        failed++;
+        continue;
+      } /* if */
+      total += taken;
+      worst  = (taken > worst) ? taken : worst;
+    } /* for g */
+    elapsed = _now() - start;
+
+    if (!_verbose)
+    {
+      printf("%8g s %6u %8.3f %6u %7u %12llu %12.0f %7.2f s\n",
+             budgets[b], games,
+             (games > failed) ? (double)total / (games - failed) : 0.0,
+             worst, failed, (unsigned long long)(first_total / games),
+             (double)scored / (total + failed * SS_MAX_TURNS), elapsed);
+    } /* if */
+  } /* for b */
+
+  for (i = 0; i < _threads; i++)
+  {
+    free(_workers[i].codes);
+  } /* for i */
+  free(_sample);
+  free(_all);
+  free(secrets);
+  return 0;
+} /* main */
@@ -0,0 +1,620 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  score_batch.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Scores one packed guess against an array of packed codes and
+//    histograms the feedback, for the host-side solvers and analysis
+//    tools.  The scores are score_code's: P counts the zero four-bit
+//    slots of the guess XOR the code, and P + C sums, over the colors,
+//    the smaller of the two codes' counts of that color.  Only the
+//    guess's colors can contribute, and those are known up front, so
+//    each is replicated into every slot; XORing that against the code
+//    and counting the zero slots gives the code's count of the color,
+//    which is then capped at the guess's.
+//
+//    score_pairs scores unrelated (secret, guess) pairs instead, where
+//    nothing can be prepared per guess: P + C sums, over every color,
+//    the smaller of the two codes' counts of it, each count taken the
+//    same way against the color replicated into every slot.
+//
+//    Scalar, SSE4.1 and AVX2 kernels are provided for both.  The widest
+//    kernel the CPU supports is chosen on first use; score_batch_select
+//    can force a particular one.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <string.h>
+#include <immintrin.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "score_batch.h"
+
+// A guess, prepared for the kernels
+typedef struct
+{
+  uint32  guess;              // packed guess
+  uint32  lsbs;               // low bit of each used slot
+  uint32  colors;             // distinct colors in the guess
+  uint32  rep[SB_MAX_PEGS];   // each color, in every slot
+  uint32  want[SB_MAX_PEGS];  // ... and how many times the guess has it
+} _sb_guess_t;
+
+// Kernel signature: the guess, and the output arrays
+typedef void (*_sb_kernel_t)(const _sb_guess_t* g, uint32 pegs,
+                             const uint32* codes, uint32 count,
+                             uint32* buckets, uint16* feedback);
+
+// Pair kernel signature
+typedef void (*_sb_pair_kernel_t)(const uint32* secrets,
+                                  const uint32* guesses, uint32 count,
+                                  uint32 pegs, uint32 colors,
+                                  uint16* feedback);
+
+static _sb_kernel_t       _sb_kernel = NULL;
+static _sb_pair_kernel_t  _sb_pairs  = NULL;
+static uint32             _sb_impl   = SB_IMPL_AUTO;
+
+// Sub-histograms per kernel, so consecutive codes landing in the same
+// bucket don't serialize on one counter
+#define   SB_LANES                        4
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_slots
+//
+// DESCRIPTION: Counts the four-bit slots in which two codes agree.
+//-------------------------------------------------------------------------
+static inline uint32 _sb_slots(uint32 a, uint32 b, uint32 lsbs)
+{
+  uint32 diff;
+
+  diff  = a ^ b;
+  diff |= diff >> 1;
+  diff |= diff >> 2;
+  diff  = ~diff & lsbs;
+  return (diff * 0x11111111) >> 28;
+} /* _sb_slots */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_count
+//
+// DESCRIPTION: Scalar scoring of one code against the prepared guess.
+// RETURNS:     uint32, feedback bucket
+//-------------------------------------------------------------------------
+static inline uint32 _sb_count(const _sb_guess_t* g, uint32 pegs,
+                               uint32 code)
+{
+  uint32 exact   = _sb_slots(code, g->guess, g->lsbs);
+  uint32 matches = 0;
+  uint32 have;
+  uint32 k;
+
+  for (k = 0; k < g->colors; k++)
+  {
+    have     = _sb_slots(code, g->rep[k], g->lsbs);
+    matches += (have < g->want[k]) ? have : g->want[k];
+  } /* for k */
+
+  return SB_BUCKET(exact, matches - exact, pegs);
+} /* _sb_count */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_scalar
+//
+// DESCRIPTION: Portable kernel.
+//-------------------------------------------------------------------------
+static void _sb_scalar(const _sb_guess_t* g, uint32 pegs,
+                       const uint32* codes, uint32 count,
+                       uint32* buckets, uint16* feedback)
+{
+  uint32 bucket;
+  uint32 i;
+
+  for (i = 0; i < count; i++)
+  {
+    bucket = _sb_count(g, pegs, codes[i]);
+    buckets[bucket]++;
+    if (NULL != feedback)
+    {
+      feedback[i] = (uint16)bucket;
+    } /* if */
+  } /* for i */
+} /* _sb_scalar */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_sse4
+//
+// DESCRIPTION: SSE4.1 kernel, four codes per step.  The slot matches for
+//              each of the guess's colors are summed with one multiply per
+//              lane and capped at the guess's count with an unsigned min.
+//-------------------------------------------------------------------------
+__attribute__((target("sse4.1")))
+static void _sb_sse4(const _sb_guess_t* g, uint32 pegs,
+                     const uint32* codes, uint32 count,
+                     uint32* buckets, uint16* feedback)
+{
+  uint32  hist[SB_LANES][SB_BUCKETS(SB_MAX_PEGS)];
+  uint32  nbuckets = SB_BUCKETS(pegs);
+  uint32  idx[4] __attribute__((aligned(16)));
+  __m128i rep[SB_MAX_PEGS];
+  __m128i want[SB_MAX_PEGS];
+  __m128i v_guess  = _mm_set1_epi32((int)g->guess);
+  __m128i v_lsbs   = _mm_set1_epi32((int)g->lsbs);
+  __m128i v_sum4   = _mm_set1_epi32(0x11111111);
+  __m128i v_stride = _mm_set1_epi32((int)(SB_C_LIMIT(pegs) + 1));
+  __m128i code, diff, p, m, have;
+  uint32  i, k, b;
+
+  memset(hist, 0, sizeof(hist));
+  for (k = 0; k < g->colors; k++)
+  {
+    rep[k]  = _mm_set1_epi32((int)g->rep[k]);
+    want[k] = _mm_set1_epi32((int)g->want[k]);
+  } /* for k */
+
+  for (i = 0; i + 4 <= count; i += 4)
+  {
+    code = _mm_loadu_si128((const __m128i*)(codes + i));
+
+    // P: one bit per matching slot, summed into the top nibble
+    diff = _mm_xor_si128(code, v_guess);
+    diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 1));
+    diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 2));
+    p    = _mm_srli_epi32(_mm_mullo_epi32(_mm_andnot_si128(diff, v_lsbs),
+                                          v_sum4), 28);
+
+    // P + C: the code's count of each guess color, capped
+    m = _mm_setzero_si128();
+    for (k = 0; k < g->colors; k++)
+    {
+      diff = _mm_xor_si128(code, rep[k]);
+      diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 1));
+      diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 2));
+      have = _mm_srli_epi32(_mm_mullo_epi32(_mm_andnot_si128(diff, v_lsbs),
+                                            v_sum4), 28);
+      m    = _mm_add_epi32(m, _mm_min_epu32(have, want[k]));
+    } /* for k */
+    m = _mm_add_epi32(_mm_mullo_epi32(p, v_stride), _mm_sub_epi32(m, p));
+    _mm_store_si128((__m128i*)idx, m);
+
+    hist[0][idx[0]]++;
+    hist[1][idx[1]]++;
+    hist[2][idx[2]]++;
+    hist[3][idx[3]]++;
+    if (NULL != feedback)
+    {
+      feedback[i+0] = (uint16)idx[0];
+      feedback[i+1] = (uint16)idx[1];
+      feedback[i+2] = (uint16)idx[2];
+      feedback[i+3] = (uint16)idx[3];
+    } /* if */
+  } /* for i */
+
+  for (b = 0; b < nbuckets; b++)
+  {
+    buckets[b] += hist[0][b] + hist[1][b] + hist[2][b] + hist[3][b];
+  } /* for b */
+
+  _sb_scalar(g, pegs, codes + i, count - i, buckets,
+             (NULL != feedback) ? feedback + i : NULL);
+} /* _sb_sse4 */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_avx2
+//
+// DESCRIPTION: AVX2 kernel, eight codes per step.  Same arithmetic as
+//              _sb_sse4.
+//-------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static void _sb_avx2(const _sb_guess_t* g, uint32 pegs,
+                     const uint32* codes, uint32 count,
+                     uint32* buckets, uint16* feedback)
+{
+  uint32  hist[SB_LANES][SB_BUCKETS(SB_MAX_PEGS)];
+  uint32  nbuckets = SB_BUCKETS(pegs);
+  uint32  idx[8] __attribute__((aligned(32)));
+  __m256i rep[SB_MAX_PEGS];
+  __m256i want[SB_MAX_PEGS];
+  __m256i v_guess  = _mm256_set1_epi32((int)g->guess);
+  __m256i v_lsbs   = _mm256_set1_epi32((int)g->lsbs);
+  __m256i v_sum4   = _mm256_set1_epi32(0x11111111);
+  __m256i v_stride = _mm256_set1_epi32((int)(SB_C_LIMIT(pegs) + 1));
+  __m256i code, diff, p, m, have;
+  uint32  i, k, b;
+
+  memset(hist, 0, sizeof(hist));
+  for (k = 0; k < g->colors; k++)
+  {
+    rep[k]  = _mm256_set1_epi32((int)g->rep[k]);
+    want[k] = _mm256_set1_epi32((int)g->want[k]);
+  } /* for k */
+
+  for (i = 0; i + 8 <= count; i += 8)
+  {
+    code = _mm256_loadu_si256((const __m256i*)(codes + i));
+
+    diff = _mm256_xor_si256(code, v_guess);
+    diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 1));
+    diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 2));
+    p    = _mm256_srli_epi32(
+             _mm256_mullo_epi32(_mm256_andnot_si256(diff, v_lsbs), v_sum4),
+             28);
+
+    m = _mm256_setzero_si256();
+    for (k = 0; k < g->colors; k++)
+    {
+      diff = _mm256_xor_si256(code, rep[k]);
+      diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 1));
+      diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 2));
+      have = _mm256_srli_epi32(
+               _mm256_mullo_epi32(_mm256_andnot_si256(diff, v_lsbs),
+                                  v_sum4), 28);
+      m    = _mm256_add_epi32(m, _mm256_min_epu32(have, want[k]));
+    } /* for k */
+    m = _mm256_add_epi32(_mm256_mullo_epi32(p, v_stride),
+                         _mm256_sub_epi32(m, p));
+    _mm256_store_si256((__m256i*)idx, m);
+
+    hist[0][idx[0]]++;
+    hist[1][idx[1]]++;
+    hist[2][idx[2]]++;
+    hist[3][idx[3]]++;
+    hist[0][idx[4]]++;
+    hist[1][idx[5]]++;
+    hist[2][idx[6]]++;
+    hist[3][idx[7]]++;
+    if (NULL != feedback)
+    {
+      _mm_storeu_si128((__m128i*)(feedback + i),
+                       _mm_packus_epi32(_mm256_castsi256_si128(m),
+                                        _mm256_extracti128_si256(m, 1)));
+    } /* if */
+  } /* for i */
+
+  for (b = 0; b < nbuckets; b++)
+  {
+    buckets[b] += hist[0][b] + hist[1][b] + hist[2][b] + hist[3][b];
+  } /* for b */
+
+  _sb_scalar(g, pegs, codes + i, count - i, buckets,
+             (NULL != feedback) ? feedback + i : NULL);
+} /* _sb_avx2 */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_pairs_scalar
+//
+// DESCRIPTION: Portable pair kernel.
+//-------------------------------------------------------------------------
+static void _sb_pairs_scalar(const uint32* secrets, const uint32* guesses,
+                             uint32 count, uint32 pegs, uint32 colors,
+                             uint16* feedback)
+{
+  uint32 lsbs = 0x11111111 & (0xFFFFFFFF >> (32 - (pegs * 4)));
+  uint32 exact, matches, have, want;
+  uint32 i, k;
+
+  for (i = 0; i < count; i++)
+  {
+    exact   = _sb_slots(secrets[i], guesses[i], lsbs);
+    matches = 0;
+    for (k = 0; k < colors; k++)
+    {
+      have     = _sb_slots(secrets[i], k * lsbs, lsbs);
+      want     = _sb_slots(guesses[i], k * lsbs, lsbs);
+      matches += (have < want) ? have : want;
+    } /* for k */
+    feedback[i] = (uint16)SB_BUCKET(exact, matches - exact, pegs);
+  } /* for i */
+} /* _sb_pairs_scalar */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_pairs_sse4
+//
+// DESCRIPTION: SSE4.1 pair kernel, four pairs per step.  Same arithmetic
+//              as _sb_sse4, with both codes counted for each color.
+//-------------------------------------------------------------------------
+__attribute__((target("sse4.1")))
+static void _sb_pairs_sse4(const uint32* secrets, const uint32* guesses,
+                           uint32 count, uint32 pegs, uint32 colors,
+                           uint16* feedback)
+{
+  uint32  lsbs     = 0x11111111 & (0xFFFFFFFF >> (32 - (pegs * 4)));
+  __m128i v_lsbs   = _mm_set1_epi32((int)lsbs);
+  __m128i v_sum4   = _mm_set1_epi32(0x11111111);
+  __m128i v_stride = _mm_set1_epi32((int)(SB_C_LIMIT(pegs) + 1));
+  __m128i secret, guess, rep, diff, p, m, have, want;
+  uint32  i, k;
+
+  for (i = 0; i + 4 <= count; i += 4)
+  {
+    secret = _mm_loadu_si128((const __m128i*)(secrets + i));
+    guess  = _mm_loadu_si128((const __m128i*)(guesses + i));
+
+    diff = _mm_xor_si128(secret, guess);
+    diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 1));
+    diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 2));
+    p    = _mm_srli_epi32(_mm_mullo_epi32(_mm_andnot_si128(diff, v_lsbs),
+                                          v_sum4), 28);
+
+    m = _mm_setzero_si128();
+    for (k = 0; k < colors; k++)
+    {
+      rep  = _mm_set1_epi32((int)(k * lsbs));
+      diff = _mm_xor_si128(secret, rep);
+      diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 1));
+      diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 2));
+      have = _mm_srli_epi32(_mm_mullo_epi32(_mm_andnot_si128(diff, v_lsbs),
+                                            v_sum4), 28);
+      diff = _mm_xor_si128(guess, rep);
+      diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 1));
+      diff = _mm_or_si128(diff, _mm_srli_epi32(diff, 2));
+      want = _mm_srli_epi32(_mm_mullo_epi32(_mm_andnot_si128(diff, v_lsbs),
+                                            v_sum4), 28);
+      m    = _mm_add_epi32(m, _mm_min_epu32(have, want));
+    } /* for k */
+    m = _mm_add_epi32(_mm_mullo_epi32(p, v_stride), _mm_sub_epi32(m, p));
+    _mm_storel_epi64((__m128i*)(feedback + i), _mm_packus_epi32(m, m));
+  } /* for i */
+
+  _sb_pairs_scalar(secrets + i, guesses + i, count - i, pegs, colors,
+                   feedback + i);
+} /* _sb_pairs_sse4 */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_pairs_avx2
+//
+// DESCRIPTION: AVX2 pair kernel, eight pairs per step.
+//-------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static void _sb_pairs_avx2(const uint32* secrets, const uint32* guesses,
+                           uint32 count, uint32 pegs, uint32 colors,
+                           uint16* feedback)
+{
+  uint32  lsbs     = 0x11111111 & (0xFFFFFFFF >> (32 - (pegs * 4)));
+  __m256i v_lsbs   = _mm256_set1_epi32((int)lsbs);
+  __m256i v_sum4   = _mm256_set1_epi32(0x11111111);
+  __m256i v_stride = _mm256_set1_epi32((int)(SB_C_LIMIT(pegs) + 1));
+  __m256i secret, guess, rep, diff, p, m, have, want;
+  uint32  i, k;
+
+  for (i = 0; i + 8 <= count; i += 8)
+  {
+    secret = _mm256_loadu_si256((const __m256i*)(secrets + i));
+    guess  = _mm256_loadu_si256((const __m256i*)(guesses + i));
+
+    diff = _mm256_xor_si256(secret, guess);
+    diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 1));
+    diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 2));
+    p    = _mm256_srli_epi32(
+             _mm256_mullo_epi32(_mm256_andnot_si256(diff, v_lsbs), v_sum4),
+             28);
+
+    m = _mm256_setzero_si256();
+    for (k = 0; k < colors; k++)
+    {
+      rep  = _mm256_set1_epi32((int)(k * lsbs));
+      diff = _mm256_xor_si256(secret, rep);
+      diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 1));
+      diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 2));
+      have = _mm256_srli_epi32(
+               _mm256_mullo_epi32(_mm256_andnot_si256(diff, v_lsbs),
+                                  v_sum4), 28);
+      diff = _mm256_xor_si256(guess, rep);
+      diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 1));
+      diff = _mm256_or_si256(diff, _mm256_srli_epi32(diff, 2));
+      want = _mm256_srli_epi32(
+               _mm256_mullo_epi32(_mm256_andnot_si256(diff, v_lsbs),
+                                  v_sum4), 28);
+      m    = _mm256_add_epi32(m, _mm256_min_epu32(have, want));
+    } /* for k */
+    m = _mm256_add_epi32(_mm256_mullo_epi32(p, v_stride),
+                         _mm256_sub_epi32(m, p));
+    _mm_storeu_si128((__m128i*)(feedback + i),
+                     _mm_packus_epi32(_mm256_castsi256_si128(m),
+                                      _mm256_extracti128_si256(m, 1)));
+  } /* for i */
+
+  _sb_pairs_scalar(secrets + i, guesses + i, count - i, pegs, colors,
+                   feedback + i);
+} /* _sb_pairs_avx2 */
+
+//-------------------------------------------------------------------------
+// NAME:        score_batch_supported
+//
+// DESCRIPTION: Reports whether this CPU can run a kernel.
+// ARGUMENTS:   uint32 impl, one of SB_IMPL_*
+// RETURNS:     uint32, TRUE if supported
+//-------------------------------------------------------------------------
+uint32 score_batch_supported(uint32 impl)
+{
+  __builtin_cpu_init();
+
+  switch (impl)
+  {
+    case SB_IMPL_AUTO:
+    case SB_IMPL_SCALAR:
+      return TRUE;
+    case SB_IMPL_SSE4:
+      return __builtin_cpu_supports("sse4.1") ? TRUE : FALSE;
+    case SB_IMPL_AVX2:
+      return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+  } /* switch */
+
+  return FALSE;
+} /* score_batch_supported */
+
+//-------------------------------------------------------------------------
+// NAME:        score_batch_select
+//
+// DESCRIPTION: Chooses the kernels used by score_batch and score_pairs.
+//              SB_IMPL_AUTO picks the widest the CPU supports.
+// ARGUMENTS:   uint32 impl, one of SB_IMPL_*
+// RETURNS:     uint32, the kernel now in use, or SB_IMPL_AUTO if the
+//              requested one isn't supported (the selection is unchanged)
+//-------------------------------------------------------------------------
+uint32 score_batch_select(uint32 impl)
+{
+  if (!score_batch_supported(impl))
+  {
+    return SB_IMPL_AUTO;
+  } /* if */
+
+  if (SB_IMPL_AUTO == impl)
+  {
+    impl = score_batch_supported(SB_IMPL_AVX2) ? SB_IMPL_AVX2 :
+           score_batch_supported(SB_IMPL_SSE4) ? SB_IMPL_SSE4 :
+                                                 SB_IMPL_SCALAR;
+  } /* if */
+
+  switch (impl)
+  {
+    case SB_IMPL_AVX2:
+      _sb_kernel = _sb_avx2;
+      _sb_pairs  = _sb_pairs_avx2;
+      break;
+    case SB_IMPL_SSE4:
+      _sb_kernel = _sb_sse4;
+      _sb_pairs  = _sb_pairs_sse4;
+      break;
+    default:
+      _sb_kernel = _sb_scalar;
+      _sb_pairs  = _sb_pairs_scalar;
+      break;
+  } /* switch */
+  _sb_impl = impl;
+
+  return impl;
+} /* score_batch_select */
+
+//-------------------------------------------------------------------------
+// NAME:        score_batch_name
+//
+// DESCRIPTION: Names a kernel, for reports.
+// ARGUMENTS:   uint32 impl, one of SB_IMPL_*
+// RETURNS:     const char*, the name
+//-------------------------------------------------------------------------
+const char* score_batch_name(uint32 impl)
+{
+  switch (impl)
+  {
+    case SB_IMPL_SCALAR:
+      return "scalar";
+    case SB_IMPL_SSE4:
+      return "sse4";
+    case SB_IMPL_AVX2:
+      return "avx2";
+  } /* switch */
+
+  return (NULL == _sb_kernel) ? "auto" : score_batch_name(_sb_impl);
+} /* score_batch_name */
+
+//-------------------------------------------------------------------------
+// NAME:        _sb_prepare
+//
+// DESCRIPTION: Lists the guess's distinct colors, each replicated into
+//              every used slot, with how many times the guess has it.
+//-------------------------------------------------------------------------
+static void _sb_prepare(uint32 guess, uint32 pegs, _sb_guess_t* g)
+{
+  uint32 mask = 0xFFFFFFFF >> (32 - (pegs * 4));
+  uint32 color;
+  uint32 i, k;
+
+  g->guess  = guess & mask;
+  g->lsbs   = 0x11111111 & mask;
+  g->colors = 0;
+  for (i = 0; i < pegs; i++)
+  {
+    color = (guess >> (i * 4)) & 0xF;
+    for (k = 0; k < g->colors && g->rep[k] != color * g->lsbs; k++)
+    {
+    } /* for k */
+    if (k == g->colors)
+    {
+      g->rep[k]  = color * g->lsbs;
+      g->want[k] = 0;
+      g->colors++;
+    } /* if new color */
+    g->want[k]++;
+  } /* for i */
+} /* _sb_prepare */
+
+//-------------------------------------------------------------------------
+// NAME:        score_one
+//
+// DESCRIPTION: Scores a single code, for callers that don't batch.
+// ARGUMENTS:   uint32 secret, packed code
+//              uint32 guess, packed guess
+//              uint32 pegs, positions per code (1..SB_MAX_PEGS)
+// RETURNS:     uint32, feedback bucket (see SB_BUCKET)
+//-------------------------------------------------------------------------
+uint32 score_one(uint32 secret, uint32 guess, uint32 pegs)
+{
+  _sb_guess_t g;
+
+  _sb_prepare(guess, pegs, &g);
+  return _sb_count(&g, pegs, secret);
+} /* score_one */
+
+//-------------------------------------------------------------------------
+// NAME:        score_batch
+//
+// DESCRIPTION: Scores a guess against every code in an array.
+// ARGUMENTS:   uint32 guess, packed guess
+//              const uint32* codes, packed codes to score against
+//              uint32 count, number of codes
+//              uint32 pegs, positions per code (1..SB_MAX_PEGS)
+//              uint32* buckets, receives SB_BUCKETS(pegs) counts, indexed
+//                               by SB_BUCKET(p, c, pegs)
+//              uint16* feedback, receives each code's bucket (or NULL)
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void score_batch(uint32 guess, const uint32* codes, uint32 count,
+                 uint32 pegs, uint32* buckets, uint16* feedback)
+{
+  _sb_guess_t g;
+
+  if (NULL == _sb_kernel)
+  {
+    score_batch_select(SB_IMPL_AUTO);
+  } /* if */
+
+  memset(buckets, 0, SB_BUCKETS(pegs) * sizeof(uint32));
+  _sb_prepare(guess, pegs, &g);
+  _sb_kernel(&g, pegs, codes, count, buckets, feedback);
+} /* score_batch */
+
+//-------------------------------------------------------------------------
+// NAME:        score_pairs
+//
+// DESCRIPTION: Scores each secret against its own guess.  Safe to call
+//              from several threads at once, once a kernel is chosen.
+// ARGUMENTS:   const uint32* secrets, const uint32* guesses, packed
+//                                     codes, count of each; every slot
+//                                     must hold a color below colors
+//              uint32 count, number of pairs
+//              uint32 pegs, positions per code (1..SB_MAX_PEGS)
+//              uint32 colors, colors in use (1..16)
+//              uint16* feedback, receives each pair's bucket
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void score_pairs(const uint32* secrets, const uint32* guesses, uint32 count,
+                 uint32 pegs, uint32 colors, uint16* feedback)
+{
+  if (NULL == _sb_pairs)
+  {
+    score_batch_select(SB_IMPL_AUTO);
+  } /* if */
+
+  _sb_pairs(secrets, guesses, count, pegs, colors, feedback);
+} /* score_pairs */
@@ -0,0 +1,50 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  score_batch.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for score_batch.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_SCORE_BATCH__H
+#define __LAB_7_SCORE_BATCH__H
+
+#include "nios_std_types.h"   // standard data types
+
+// Feedback buckets.  P + C is at most pegs.
+#define   SB_MAX_PEGS                     8
+#define   SB_C_LIMIT(pegs)                (pegs)
+#define   SB_BUCKETS(pegs)                (((pegs) + 1) * (SB_C_LIMIT(pegs) + 1))
+#define   SB_BUCKET(p, c, pegs)           ((p) * (SB_C_LIMIT(pegs) + 1) + (c))
+#define   SB_BUCKET_P(b, pegs)            ((b) / (SB_C_LIMIT(pegs) + 1))
+#define   SB_BUCKET_C(b, pegs)            ((b) % (SB_C_LIMIT(pegs) + 1))
+
+// Kernel implementations
+#define   SB_IMPL_AUTO                    0
+#define   SB_IMPL_SCALAR                  1
+#define   SB_IMPL_SSE4                    2
+#define   SB_IMPL_AVX2                    3
+#define   SB_IMPL_COUNT                   4
+
+// Prototypes for public functions
+uint32 score_batch_supported(uint32 impl);
+uint32 score_batch_select(uint32 impl);
+const char* score_batch_name(uint32 impl);
+uint32 score_one(uint32 secret, uint32 guess, uint32 pegs);
+void score_batch(uint32 guess, const uint32* codes, uint32 count,
+                 uint32 pegs, uint32* buckets, uint16* feedback);
+void score_pairs(const uint32* secrets, const uint32* guesses, uint32 count,
+                 uint32 pegs, uint32 colors, uint16* feedback);
+
+#endif /* __LAB_7_SCORE_BATCH__H */
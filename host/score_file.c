@@ -0,0 +1,909 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  score_file.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Scores a file of recorded (secret, guess) pairs, for offline
+//    analysis of more games than fit in memory.  Input is text, one pair
+//    per line, each code either color letters as to_colorstr writes them
+//    (either case) or a packed code in hex ("0x3210"), separated by
+//    spaces, tabs or a comma; or, with -b, binary: little-endian uint32
+//    pairs, secret first.  Blank lines are skipped.  Each pair's feedback
+//    is written in order as one byte, P << 4 | C (-f bin); as "P C"
+//    lines (-f counts); or as hint lines, P's then C's (-f hint; the
+//    firmware prints its hint in guess order, which the counts don't
+//    keep).  A pair that doesn't parse is written as 0xFF or "?".
+//
+//    The file is read a chunk at a time and each chunk split among the
+//    threads at line boundaries, so memory stays at two chunks however
+//    large the file.  While the threads score one chunk, the previous
+//    one's results are written and the next one read, so with enough
+//    threads the drive is the limit.  Lines in the form to_colorstr's
+//    output gives ("GBRO YWGB") are parsed 16 bytes at a time with
+//    SSE4.1: every byte is compared with every color letter at once and
+//    the colors packed into nibbles with a shuffle and a multiply-add.
+//    Anything else falls back to a line at a time parser.  Pairs are
+//    scored with score_pairs, a batch at a time.
+//
+//    With -G the tool writes a file of random pairs instead, in the
+//    input format, for timing.
+//
+//  USAGE
+//    score_file [-b] [-f bin|counts|hint] [-j threads] [-m MiB] [-s]
+//               -o output input
+//    score_file [-b] -G pairs -o output
+//      -b  binary input (or, with -G, output)
+//      -f  output format (default bin)
+//      -j  threads (default one per CPU)
+//      -m  chunk size in MiB (default 16)
+//      -s  no SIMD: line at a time parsing and the scalar scorer
+//      -G  write this many random pairs
+//      -o  output file, or - for stdout
+//    The input may be - for stdin.  The summary goes to stdout, or to
+//    stderr if the output does.  Exits 1 if any pair didn't parse.
+//
+//  BUILDING
+//    gcc -O2 -Wall -pthread -Ibsp -I../nios -o score_file score_file.c
+//        score_batch.c ../nios/color_table.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <immintrin.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for CC_*
+#include "score_batch.h"
+
+// Pairs scored per score_pairs call
+#define   SF_BATCH                        4096
+
+// Most threads
+#define   SF_MAX_THREADS                  64
+
+// Bytes past a chunk's data that may be read (by the 16-byte loads) or
+// written (a final newline)
+#define   SF_PAD                          64
+
+// A line as to_colorstr's output gives it: code, space, code, newline
+#define   SF_RECORD                       (2 * CB_COLOR_LENGTH + 2)
+
+// Marks a pair that didn't parse
+#define   SF_BAD                          0xFFFFFFFF
+
+// Output formats
+#define   SF_OUT_BIN                      0
+#define   SF_OUT_COUNTS                   1
+#define   SF_OUT_HINT                     2
+
+// Longest output per pair: a full hint and its newline
+#define   SF_OUT_MAX                      (CB_COLOR_LENGTH + 1)
+
+// Feedback given a pair that didn't parse, past the real buckets
+#define   SF_BAD_BUCKET                   SB_BUCKETS(CB_COLOR_LENGTH)
+
+// One chunk of input
+typedef struct
+{
+  uint8*    data;                     // chunk bytes + SF_PAD
+  size_t    size;                     // bytes held
+  size_t    used;                     // of those, whole records
+} _sf_chunk_t;
+
+// One thread's part of a chunk
+typedef struct
+{
+  pthread_t     thread;
+  const uint8*  begin;
+  const uint8*  end;                  // just past a newline (or record)
+  uint8*        out;                  // results, out_len bytes
+  size_t        out_len;
+  size_t        out_cap;
+  uint64        pairs;
+  uint64        bad;
+  uint64        first_bad;            // pair number in the part
+} _sf_part_t;
+
+extern const uint8 color_letters[];
+extern const uint8 color_class[256];
+
+static uint32 _binary;
+static uint32 _format = SF_OUT_BIN;
+static uint32 _simd   = TRUE;
+static uint8  _byte[SF_BAD_BUCKET + 1];
+static uint8  _text[SF_BAD_BUCKET + 1][SF_OUT_MAX];
+static uint8  _text_len[SF_BAD_BUCKET + 1];
+
+//-------------------------------------------------------------------------
+// NAME:        _now
+//
+// DESCRIPTION: Monotonic clock in seconds.
+//-------------------------------------------------------------------------
+static double _now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+} /* _now */
+
+//-------------------------------------------------------------------------
+// NAME:        _valid
+//
+// DESCRIPTION: Checks a packed code: a color in every slot, nothing above.
+//-------------------------------------------------------------------------
+static uint32 _valid(uint32 code)
+{
+  uint32 i;
+
+  if (0 != (code >> (CB_COLOR_LENGTH * 4)))
+  {
+    return FALSE;
+  } /* if */
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    if (CODE_SLOT(code, i) >= CB_POSSIBLE_COLORS)
+    {
+      return FALSE;
+    } /* if */
+  } /* for i */
+  return TRUE;
+} /* _valid */
+
+//-------------------------------------------------------------------------
+// NAME:        _parse_code
+//
+// DESCRIPTION: Parses one code: CB_COLOR_LENGTH color letters, or 0x and
+//              a packed code in hex.
+// RETURNS:     uint32, TRUE if it is a valid code
+//-------------------------------------------------------------------------
+static uint32 _parse_code(const uint8* text, uint32 length, uint32* code)
+{
+  uint32 value = 0;
+  uint32 i;
+
+  if (length > 2 && '0' == text[0] && 'x' == (text[1] | 0x20))
+  {
+    if (length > 10)
+    {
+      return FALSE;
+    } /* if */
+    for (i = 2; i < length; i++)
+    {
+      if (text[i] >= '0' && text[i] <= '9')
+      {
+        value = (value << 4) | (text[i] - '0');
+      } /* if */
+      else if ((text[i] | 0x20) >= 'a' && (text[i] | 0x20) <= 'f')
+      {
+        value = (value << 4) | ((text[i] | 0x20) - 'a' + 10);
+      } /* else if */
+      else
+      {
+        return FALSE;
+      } /* else */
+    } /* for i */
+    *code = value;
+    return _valid(value);
+  } /* if hex */
+
+  if (CB_COLOR_LENGTH != length)
+  {
+    return FALSE;
+  } /* if */
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    if (0 == (color_class[text[i]] & CC_COLOR))
+    {
+      return FALSE;
+    } /* if */
+    value |= (uint32)(color_class[text[i]] & CC_COLOR_MASK) << (i * 4);
+  } /* for i */
+  *code = value;
+  return TRUE;
+} /* _parse_code */
+
+//-------------------------------------------------------------------------
+// NAME:        _parse_line
+//
+// DESCRIPTION: Parses one line (without its newline) into a pair.
+// RETURNS:     int, 1 if it is a pair, 0 if not, -1 if it is blank
+//-------------------------------------------------------------------------
+static int _parse_line(const uint8* line, const uint8* end, uint32* secret,
+                       uint32* guess)
+{
+  const uint8* token[3];
+  uint32       length[3];
+  uint32       tokens = 0;
+
+  while (line < end)
+  {
+    if (' ' == *line || '\t' == *line || ',' == *line || '\r' == *line)
+    {
+      line++;
+      continue;
+    } /* if separator */
+    if (tokens == 2)
+    {
+      return 0;               // too many
+    } /* if */
+    token[tokens] = line;
+    while (line < end && ' ' != *line && '\t' != *line && ',' != *line &&
+           '\r' != *line)
+    {
+      line++;
+    } /* while */
+    length[tokens] = (uint32)(line - token[tokens]);
+    tokens++;
+  } /* while */
+
+  if (0 == tokens)
+  {
+    return -1;
+  } /* if */
+  return (2 == tokens && _parse_code(token[0], length[0], secret) &&
+          _parse_code(token[1], length[1], guess)) ? 1 : 0;
+} /* _parse_line */
+
+//-------------------------------------------------------------------------
+// NAME:        _parse_fast
+//
+// DESCRIPTION: Parses lines in to_colorstr's form, one 16-byte load each,
+//              until one isn't.  The load may run past end, into the
+//              chunk's padding at worst.
+// RETURNS:     uint32, pairs parsed; *text is moved past them
+//-------------------------------------------------------------------------
+__attribute__((target("sse4.1")))
+static uint32 _parse_fast(const uint8** text, const uint8* end,
+                          uint32* secrets, uint32* guesses, uint32 max)
+{
+  __m128i       letter[CB_POSSIBLE_COLORS];
+  __m128i       color[CB_POSSIBLE_COLORS];
+  uint8         shape[16];
+  uint8         order[16];
+  const uint8*  p = *text;
+  uint32        letters = 0;
+  uint32        seps;
+  uint32        n = 0;
+  __m128i       v_shape, v_order, v_pair;
+  __m128i       bytes, lower, eq, index, found, packed;
+  uint32        i;
+
+  // where the letters are, what the rest must be, and where each
+  // letter's color goes: the secret's to bytes 0-7, the guess's to 8-15
+  memset(shape, 0, sizeof(shape));
+  memset(order, 0x80, sizeof(order));
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    letters     |= (1 << i) | (1 << (CB_COLOR_LENGTH + 1 + i));
+    order[i]     = (uint8)i;
+    order[8 + i] = (uint8)(CB_COLOR_LENGTH + 1 + i);
+  } /* for i */
+  shape[CB_COLOR_LENGTH] = ' ';
+  shape[SF_RECORD - 1]   = '\n';
+  seps    = (1 << CB_COLOR_LENGTH) | (1 << (SF_RECORD - 1));
+  v_shape = _mm_loadu_si128((const __m128i*)shape);
+  v_order = _mm_loadu_si128((const __m128i*)order);
+  v_pair  = _mm_set1_epi16(0x1001);
+  for (i = 0; i < CB_POSSIBLE_COLORS; i++)
+  {
+    letter[i] = _mm_set1_epi8((char)(color_letters[i] | 0x20));
+    color[i]  = _mm_set1_epi8((char)i);
+  } /* for i */
+
+  while (n < max && end - p >= SF_RECORD)
+  {
+    bytes = _mm_loadu_si128((const __m128i*)p);
+    lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+    index = _mm_setzero_si128();
+    found = _mm_setzero_si128();
+    for (i = 0; i < CB_POSSIBLE_COLORS; i++)
+    {
+      eq    = _mm_cmpeq_epi8(lower, letter[i]);
+      index = _mm_or_si128(index, _mm_and_si128(eq, color[i]));
+      found = _mm_or_si128(found, eq);
+    } /* for i */
+    if (letters != ((uint32)_mm_movemask_epi8(found) & letters) ||
+        seps != ((uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, v_shape)) &
+                 seps))
+    {
+      break;
+    } /* if not in form */
+
+    // colors to their bytes, then each pair of bytes to one: b0 + 16 b1
+    packed = _mm_maddubs_epi16(_mm_shuffle_epi8(index, v_order), v_pair);
+    packed = _mm_packus_epi16(packed, packed);
+    secrets[n] = (uint32)_mm_cvtsi128_si32(packed);
+    guesses[n] = (uint32)_mm_extract_epi32(packed, 1);
+    n++;
+    p += SF_RECORD;
+  } /* while */
+
+  *text = p;
+  return n;
+} /* _parse_fast */
+
+//-------------------------------------------------------------------------
+// NAME:        _parse_text
+//
+// DESCRIPTION: Parses up to max pairs of text, the fast way while it
+//              lasts and a line at a time otherwise.
+// RETURNS:     uint32, pairs parsed (SF_BAD for those that didn't);
+//              *text is moved past them
+//-------------------------------------------------------------------------
+static uint32 _parse_text(const uint8** text, const uint8* end,
+                          uint32* secrets, uint32* guesses, uint32 max)
+{
+  const uint8* p = *text;
+  const uint8* line_end;
+  uint32       n = 0;
+  int          result;
+
+  while (n < max && p < end)
+  {
+    if (_simd)
+    {
+      n += _parse_fast(&p, end, secrets + n, guesses + n, max - n);
+      if (n == max || p == end)
+      {
+        break;
+      } /* if */
+    } /* if */
+
+    // every part ends with a newline
+    line_end = memchr(p, '\n', end - p);
+    result   = _parse_line(p, line_end, &secrets[n], &guesses[n]);
+    p        = line_end + 1;
+    if (result < 0)
+    {
+      continue;
+    } /* if blank */
+    if (0 == result)
+    {
+      secrets[n] = guesses[n] = SF_BAD;
+    } /* if */
+    n++;
+  } /* while */
+
+  *text = p;
+  return n;
+} /* _parse_text */
+
+//-------------------------------------------------------------------------
+// NAME:        _parse_binary
+//
+// DESCRIPTION: Takes up to max binary pairs.
+// RETURNS:     uint32, pairs taken; *data is moved past them
+//-------------------------------------------------------------------------
+static uint32 _parse_binary(const uint8** data, const uint8* end,
+                            uint32* secrets, uint32* guesses, uint32 max)
+{
+  const uint8* p = *data;
+  uint32       n;
+
+  for (n = 0; n < max && p < end; n++, p += 8)
+  {
+    memcpy(&secrets[n], p, 4);
+    memcpy(&guesses[n], p + 4, 4);
+    if (!_valid(secrets[n]) || !_valid(guesses[n]))
+    {
+      secrets[n] = guesses[n] = SF_BAD;
+    } /* if */
+  } /* for n */
+
+  *data = p;
+  return n;
+} /* _parse_binary */
+
+//-------------------------------------------------------------------------
+// NAME:        _score
+//
+// DESCRIPTION: Thread body: parses, scores and formats one part.
+//-------------------------------------------------------------------------
+static void* _score(void* arg)
+{
+  _sf_part_t*   part = arg;
+  uint32        secrets[SF_BATCH];
+  uint32        guesses[SF_BATCH];
+  uint16        feedback[SF_BATCH];
+  uint32        bad_at[SF_BATCH];
+  const uint8*  p = part->begin;
+  uint8*        out;
+  uint32        n, bad, i;
+
+  part->out_len   = 0;
+  part->pairs     = 0;
+  part->bad       = 0;
+  part->first_bad = 0;
+  while (p < part->end)
+  {
+    n = _binary ? _parse_binary(&p, part->end, secrets, guesses, SF_BATCH)
+                : _parse_text(&p, part->end, secrets, guesses, SF_BATCH);
+
+    // pairs that didn't parse are scored as any code, then marked
+    bad = 0;
+    for (i = 0; i < n; i++)
+    {
+      if (SF_BAD == secrets[i])
+      {
+        secrets[i] = guesses[i] = 0;
+        bad_at[bad++] = i;
+      } /* if */
+    } /* for i */
+    score_pairs(secrets, guesses, n, CB_COLOR_LENGTH, CB_POSSIBLE_COLORS,
+                feedback);
+    for (i = 0; i < bad; i++)
+    {
+      feedback[bad_at[i]] = SF_BAD_BUCKET;
+    } /* for i */
+    if (0 != bad && 0 == part->bad)
+    {
+      part->first_bad = part->pairs + bad_at[0];
+    } /* if */
+    part->bad += bad;
+
+    if (part->out_cap - part->out_len < (size_t)n * SF_OUT_MAX)
+    {
+      part->out_cap = 2 * part->out_cap + (size_t)n * SF_OUT_MAX;
+      part->out     = realloc(part->out, part->out_cap);
+    } /* if */
+    out = part->out + part->out_len;
+    if (SF_OUT_BIN == _format)
+    {
+      for (i = 0; i < n; i++)
+      {
+        *out++ = _byte[feedback[i]];
+      } /* for i */
+    } /* if */
+    else
+    {
+      for (i = 0; i < n; i++)
+      {
+        memcpy(out, _text[feedback[i]], SF_OUT_MAX);
+        out += _text_len[feedback[i]];
+      } /* for i */
+    } /* else */
+    part->out_len = out - part->out;
+    part->pairs  += n;
+  } /* while */
+
+  return NULL;
+} /* _score */
+
+//-------------------------------------------------------------------------
+// NAME:        _tables
+//
+// DESCRIPTION: Builds each bucket's output.
+//-------------------------------------------------------------------------
+static void _tables()
+{
+  uint32 p, c, b, k;
+
+  for (b = 0; b < SF_BAD_BUCKET; b++)
+  {
+    p = SB_BUCKET_P(b, CB_COLOR_LENGTH);
+    c = SB_BUCKET_C(b, CB_COLOR_LENGTH);
+    _byte[b] = (uint8)((p << 4) | c);
+    k = 0;
+    if (SF_OUT_COUNTS == _format)
+    {
+      _text[b][k++] = (uint8)('0' + p);
+      _text[b][k++] = ' ';
+      _text[b][k++] = (uint8)('0' + c);
+    } /* if */
+    else
+    {
+      memset(&_text[b][k], 'P', p);
+      memset(&_text[b][k + p], 'C', c);
+      k += p + c;
+    } /* else */
+    _text[b][k++] = '\n';
+    _text_len[b]  = (uint8)k;
+  } /* for b */
+
+  _byte[SF_BAD_BUCKET]    = 0xFF;
+  _text[SF_BAD_BUCKET][0] = '?';
+  _text[SF_BAD_BUCKET][1] = '\n';
+  _text_len[SF_BAD_BUCKET] = 2;
+} /* _tables */
+
+//-------------------------------------------------------------------------
+// NAME:        _read
+//
+// DESCRIPTION: Fills a chunk: the previous chunk's partial record, then
+//              as much of the file as fits.  At the end of the file a
+//              last line is given its newline.
+// RETURNS:     int, 0 on success, -1 on failure
+//-------------------------------------------------------------------------
+static int _read(int fd, _sf_chunk_t* chunk, size_t capacity,
+                 const _sf_chunk_t* previous, const char* path)
+{
+  const uint8*  last;
+  ssize_t       got = 1;
+
+  chunk->size = 0;
+  if (NULL != previous)
+  {
+    chunk->size = previous->size - previous->used;
+    memmove(chunk->data, previous->data + previous->used, chunk->size);
+  } /* if */
+  while (chunk->size < capacity &&
+         0 < (got = read(fd, chunk->data + chunk->size,
+                         capacity - chunk->size)))
+  {
+    chunk->size += got;
+  } /* while */
+  if (got < 0)
+  {
+    perror(path);
+    return -1;
+  } /* if */
+
+  if (_binary)
+  {
+    chunk->used = chunk->size - chunk->size % 8;
+    if (0 == got && chunk->used != chunk->size)
+    {
+      fprintf(stderr, "%s: ends in a partial pair\n", path);
+      return -1;
+    } /* if */
+    return 0;
+  } /* if */
+
+  if (0 == got && 0 != chunk->size && '\n' != chunk->data[chunk->size - 1])
+  {
+    chunk->data[chunk->size++] = '\n';
+  } /* if end of file */
+  for (last = chunk->data + chunk->size;
+       last > chunk->data && '\n' != last[-1]; last--)
+  {
+  } /* for last */
+  chunk->used = (size_t)(last - chunk->data);
+  if (0 == chunk->used && chunk->size == capacity)
+  {
+    fprintf(stderr, "%s: line longer than a chunk\n", path);
+    return -1;
+  } /* if */
+  return 0;
+} /* _read */
+
+//-------------------------------------------------------------------------
+// NAME:        _start
+//
+// DESCRIPTION: Splits a chunk's records among the threads (at newlines,
+//              or on pairs) and starts them.
+//-------------------------------------------------------------------------
+static void _start(_sf_part_t* parts, uint32 threads,
+                   const _sf_chunk_t* chunk)
+{
+  const uint8*  end = chunk->data + chunk->used;
+  const uint8*  at  = chunk->data;
+  const uint8*  cut;
+  uint32        t;
+
+  for (t = 0; t < threads; t++)
+  {
+    cut = chunk->data + chunk->used * (t + 1) / threads;
+    if (_binary)
+    {
+      cut = chunk->data + ((cut - chunk->data) & ~(size_t)7);
+    } /* if */
+    else if (cut < end)
+    {
+      cut = (const uint8*)memchr(cut, '\n', end - cut) + 1;
+    } /* else if */
+    if (cut < at)
+    {
+      cut = at;
+    } /* if */
+    parts[t].begin = at;
+    parts[t].end   = cut;
+    at = cut;
+    pthread_create(&parts[t].thread, NULL, _score, &parts[t]);
+  } /* for t */
+} /* _start */
+
+//-------------------------------------------------------------------------
+// NAME:        _write
+//
+// DESCRIPTION: Writes all of a buffer.
+// RETURNS:     int, 0 on success, -1 on failure
+//-------------------------------------------------------------------------
+static int _write(int fd, const uint8* data, size_t length)
+{
+  ssize_t put;
+
+  while (0 != length)
+  {
+    put = write(fd, data, length);
+    if (put <= 0)
+    {
+      return -1;
+    } /* if */
+    data   += put;
+    length -= put;
+  } /* while */
+  return 0;
+} /* _write */
+
+//-------------------------------------------------------------------------
+// NAME:        _generate
+//
+// DESCRIPTION: Writes random pairs, any colors in any slots.
+// RETURNS:     int, 0 on success, -1 on failure
+//-------------------------------------------------------------------------
+static int _generate(int fd, uint64 pairs)
+{
+  uint8   buffer[SF_BATCH * SF_RECORD];
+  uint64  rng = 1;
+  uint64  bits;
+  uint32  code[2];
+  uint32  n, i, j, k;
+  uint8*  out;
+
+  while (0 != pairs)
+  {
+    n   = (pairs < SF_BATCH) ? (uint32)pairs : SF_BATCH;
+    out = buffer;
+    for (i = 0; i < n; i++)
+    {
+      // each slot's color from a byte of a random word
+      for (j = 0; j < 2; j++)
+      {
+        rng     = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+        bits    = rng;
+        code[j] = 0;
+        for (k = 0; k < CB_COLOR_LENGTH; k++, bits >>= 8)
+        {
+          code[j] |= (uint32)(((bits & 0xFF) * CB_POSSIBLE_COLORS) >> 8)
+                     << (k * 4);
+        } /* for k */
+      } /* for j */
+
+      if (_binary)
+      {
+        memcpy(out, &code[0], 4);
+        memcpy(out + 4, &code[1], 4);
+        out += 8;
+        continue;
+      } /* if */
+      for (j = 0; j < 2; j++)
+      {
+        for (k = 0; k < CB_COLOR_LENGTH; k++)
+        {
+          *out++ = color_letters[CODE_SLOT(code[j], k)];
+        } /* for k */
+        *out++ = (0 == j) ? ' ' : '\n';
+      } /* for j */
+    } /* for i */
+    if (0 != _write(fd, buffer, out - buffer))
+    {
+      return -1;
+    } /* if */
+    pairs -= n;
+  } /* while */
+
+  return 0;
+} /* _generate */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses options, then scores the file (or writes one): each
+//              chunk is read while the one before it is scored, and its
+//              results written while the one after it is.
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  static _sf_part_t parts[2][SF_MAX_THREADS];
+  _sf_chunk_t       chunk[2];
+  uint32            threads  = (uint32)sysconf(_SC_NPROCESSORS_ONLN);
+  size_t            capacity = (size_t)16 << 20;
+  uint64            generate = 0;
+  const char*       out_path = NULL;
+  const char*       in_path  = NULL;
+  FILE*             report;
+  int               in_fd, out_fd;
+  uint64            pairs = 0, bad = 0, first_bad = 0;
+  uint64            bytes = 0;
+  double            start, elapsed, t;
+  double            reading = 0, writing = 0;
+  uint32            now, k;
+  int               failed = FALSE;
+  int               opt;
+
+  while (-1 != (opt = getopt(argc, argv, "bf:j:m:sG:o:")))
+  {
+    switch (opt)
+    {
+      case 'b':
+        _binary = TRUE;
+        break;
+      case 'f':
+        _format = (0 == strcmp(optarg, "bin"))    ? SF_OUT_BIN    :
+                  (0 == strcmp(optarg, "counts")) ? SF_OUT_COUNTS :
+                  (0 == strcmp(optarg, "hint"))   ? SF_OUT_HINT   : 99;
+        break;
+      case 'j':
+        threads = (uint32)atoi(optarg);
+        break;
+      case 'm':
+        capacity = (size_t)atoi(optarg) << 20;
+        break;
+      case 's':
+        _simd = FALSE;
+        break;
+      case 'G':
+        generate = strtoull(optarg, NULL, 0);
+        break;
+      case 'o':
+        out_path = optarg;
+        break;
+      default:
+        out_path = NULL;
+        break;
+    } /* switch */
+  } /* while */
+  in_path = (optind + 1 == argc) ? argv[optind] : NULL;
+  if (NULL == out_path || (0 == generate) == (NULL == in_path) ||
+      99 == _format)
+  {
+    fprintf(stderr, "usage: %s [-b] [-f bin|counts|hint] [-j threads] "
+                    "[-m MiB] [-s] -o output input\n"
+                    "       %s [-b] -G pairs -o output\n", argv[0], argv[0]);
+    return 2;
+  } /* if */
+  if (threads < 1 || threads > SF_MAX_THREADS || 0 == capacity)
+  {
+    fprintf(stderr, "threads must be 1 to %u, chunks at least 1 MiB\n",
+            SF_MAX_THREADS);
+    return 2;
+  } /* if */
+
+  out_fd = (0 == strcmp(out_path, "-")) ? STDOUT_FILENO
+           : open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0)
+  {
+    perror(out_path);
+    return 2;
+  } /* if */
+  report = (STDOUT_FILENO == out_fd) ? stderr : stdout;
+  if (0 != generate)
+  {
+    if (0 != _generate(out_fd, generate) || 0 != close(out_fd))
+    {
+      perror(out_path);
+      return 1;
+    } /* if */
+    return 0;
+  } /* if */
+
+  in_fd = (0 == strcmp(in_path, "-")) ? STDIN_FILENO
+          : open(in_path, O_RDONLY);
+  if (in_fd < 0)
+  {
+    perror(in_path);
+    return 2;
+  } /* if */
+  posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  _tables();
+  if (!_simd || !score_batch_supported(SB_IMPL_SSE4) || SF_RECORD > 16)
+  {
+    _simd = FALSE;
+    score_batch_select(SB_IMPL_SCALAR);
+  } /* if */
+  else
+  {
+    score_batch_select(SB_IMPL_AUTO);
+  } /* else */
+  chunk[0].data = malloc(capacity + SF_PAD);
+  chunk[1].data = malloc(capacity + SF_PAD);
+  memset(chunk[0].data, 0, capacity + SF_PAD);
+  memset(chunk[1].data, 0, capacity + SF_PAD);
+
+  // chunk n + 1 is read while chunk n is scored; chunk n's results are
+  // written while chunk n + 1 is scored
+  start = _now();
+  now   = 0;
+  if (0 != _read(in_fd, &chunk[0], capacity, NULL, in_path))
+  {
+    return 1;
+  } /* if */
+  reading = _now() - start;
+  _start(parts[0], threads, &chunk[0]);
+  while (!failed)
+  {
+    t = _now();
+    if (0 != chunk[now].used &&
+        0 != _read(in_fd, &chunk[now ^ 1], capacity, &chunk[now], in_path))
+    {
+      failed = TRUE;
+      chunk[now ^ 1].used = 0;
+    } /* if */
+    else if (0 == chunk[now].used)
+    {
+      chunk[now ^ 1].size = chunk[now ^ 1].used = 0;
+    } /* else if */
+    reading += _now() - t;
+
+    for (k = 0; k < threads; k++)
+    {
+      pthread_join(parts[now][k].thread, NULL);
+    } /* for k */
+    if (0 != chunk[now ^ 1].used)
+    {
+      _start(parts[now ^ 1], threads, &chunk[now ^ 1]);
+    } /* if */
+
+    t = _now();
+    for (k = 0; k < threads; k++)
+    {
+      if (0 != parts[now][k].bad && 0 == bad)
+      {
+        first_bad = pairs + parts[now][k].first_bad;
+      } /* if */
+      bad   += parts[now][k].bad;
+      pairs += parts[now][k].pairs;
+      if (!failed &&
+          0 != _write(out_fd, parts[now][k].out, parts[now][k].out_len))
+      {
+        perror(out_path);
+        failed = TRUE;
+      } /* if */
+    } /* for k */
+    writing += _now() - t;
+    bytes   += chunk[now].used;
+
+    if (0 == chunk[now ^ 1].used)
+    {
+      break;
+    } /* if */
+    now ^= 1;
+  } /* while */
+  if (0 != close(out_fd))
+  {
+    perror(out_path);
+    failed = TRUE;
+  } /* if */
+  elapsed = _now() - start;
+
+  fprintf(report, "%s: %llu pairs, %llu bytes, %u threads (%s parser, %s "
+                  "scorer)\n", in_path, (unsigned long long)pairs,
+          (unsigned long long)bytes, threads, _simd ? "sse4" : "scalar",
+          score_batch_name(SB_IMPL_AUTO));
+  fprintf(report, "%.3f s: %.4g pairs/s, %.1f MB/s in; %.3f s reading, "
+                  "%.3f s writing\n", elapsed, pairs / elapsed,
+          bytes / elapsed / 1e6, reading, writing);
+  if (0 != bad)
+  {
+    fprintf(report, "%llu pairs didn't parse, the first pair %llu\n",
+            (unsigned long long)bad, (unsigned long long)first_bad + 1);
+  } /* if */
+
+  for (k = 0; k < threads; k++)
+  {
+    free(parts[0][k].out);
+    free(parts[1][k].out);
+  } /* for k */
+  free(chunk[0].data);
+  free(chunk[1].data);
+  return (failed || 0 != bad) ? 1 : 0;
+} /* main */
@@ -0,0 +1,376 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  score_table.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Precomputed feedback tables on disk, for the larger configurations
+//    the analysis tools run (1296 codes with repeats, 32768 for 5 pegs
+//    and 8 colors) where rescoring every pair at startup costs more than
+//    the work itself.  gen_scores writes a table; tools map it read-only
+//    and index it directly, with nothing to parse.  Opening checks the
+//    header, its CRC and the layout, then the codes and the row CRCs
+//    against their own CRCs, which reads only those sections (4 bytes a
+//    code each); score_table_verify checks every row, for callers
+//    willing to read the whole file.
+//
+//    The layout is in score_table.h.  A table is only ever opened for
+//    the configuration it was made for, so its key, (pegs, colors,
+//    repeats), is checked along with the version.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "codeset.h"
+#include "score_batch.h"
+#include "score_table.h"
+
+// CRC-32 (IEEE, reflected), by byte
+static uint32 _st_crc_table[256];
+
+//-------------------------------------------------------------------------
+// NAME:        _st_crc_init
+//
+// DESCRIPTION: Builds the CRC table.  score_table_layout calls this, so
+//              it has happened before any caller can have threads
+//              computing CRCs.
+//-------------------------------------------------------------------------
+static void _st_crc_init()
+{
+  uint32 crc;
+  uint32 i, k;
+
+  if (0 != _st_crc_table[1])
+  {
+    return;
+  } /* if done */
+  for (i = 0; i < 256; i++)
+  {
+    crc = i;
+    for (k = 0; k < 8; k++)
+    {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+    } /* for k */
+    _st_crc_table[i] = crc;
+  } /* for i */
+} /* _st_crc_init */
+
+//-------------------------------------------------------------------------
+// NAME:        st_crc32
+//
+// DESCRIPTION: Continues a CRC-32 over more data.
+// ARGUMENTS:   uint32 crc, the CRC so far (0 to start)
+//              const void* data, size_t length, the data
+// RETURNS:     uint32, the CRC including the data
+//-------------------------------------------------------------------------
+uint32 st_crc32(uint32 crc, const void* data, size_t length)
+{
+  const uint8* byte = data;
+
+  _st_crc_init();
+  crc = ~crc;
+  while (0 != length--)
+  {
+    crc = (crc >> 8) ^ _st_crc_table[(crc ^ *byte++) & 0xFF];
+  } /* while */
+  return ~crc;
+} /* st_crc32 */
+
+//-------------------------------------------------------------------------
+// NAME:        score_table_layout
+//
+// DESCRIPTION: Fills in a header for a configuration: every field but
+//              the CRC, which is computed last.
+// ARGUMENTS:   st_header_t* header, receives the header
+//              uint32 pegs, uint32 colors, uint32 repeats, configuration
+// RETURNS:     uint64, the file size, or 0 if the configuration is
+//              unsupported
+//-------------------------------------------------------------------------
+uint64 score_table_layout(st_header_t* header, uint32 pegs, uint32 colors,
+                          uint32 repeats)
+{
+  uint64 codes = codeset_count(pegs, colors, repeats);
+  uint64 bytes;
+  uint32 stride;
+
+  _st_crc_init();
+  memset(header, 0, sizeof(*header));
+  if (pegs < 1 || pegs > SB_MAX_PEGS || colors < 1 ||
+      colors > CODESET_MAX_COLORS || 0 == codes || codes > 0x100000)
+  {
+    return 0;
+  } /* if */
+
+  // a row smaller than a page gets a power-of-two stride, so rows pack
+  // whole into pages; a larger one starts on a page of its own
+  bytes = (codes * ST_CELL_BITS(pegs) + 7) / 8;
+  if (bytes < ST_PAGE)
+  {
+    for (stride = 16; stride < bytes; stride *= 2)
+    {
+    } /* for stride */
+  } /* if */
+  else
+  {
+    stride = (uint32)((bytes + ST_PAGE - 1) & ~(uint64)(ST_PAGE - 1));
+  } /* else */
+
+  memcpy(header->magic, ST_MAGIC, sizeof(header->magic));
+  header->version      = ST_VERSION;
+  header->pegs         = pegs;
+  header->colors       = colors;
+  header->repeats      = repeats ? 1 : 0;
+  header->codes        = (uint32)codes;
+  header->cell_bits    = ST_CELL_BITS(pegs);
+  header->row_bytes    = stride;
+  header->codes_offset = ST_PAGE;
+  header->rows_offset  = header->codes_offset +
+                         ((codes * sizeof(uint32) + ST_PAGE - 1) &
+                          ~(uint64)(ST_PAGE - 1));
+  header->crcs_offset  = header->rows_offset + codes * stride;
+  header->file_size    = header->crcs_offset +
+                         (codes + ST_TRAILER_WORDS) * sizeof(uint32);
+  header->header_crc   = st_crc32(0, header, sizeof(*header));
+  return header->file_size;
+} /* score_table_layout */
+
+//-------------------------------------------------------------------------
+// NAME:        score_table_fill_row
+//
+// DESCRIPTION: Computes one row's cells.  Safe to call from several
+//              threads at once, once score_batch has chosen its kernel.
+// ARGUMENTS:   const uint32* codes, uint32 count, every code, in order
+//              uint32 pegs, positions per code
+//              uint32 row, the guess's index
+//              uint8* cells, receives the row's cells (not the padding)
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void score_table_fill_row(const uint32* codes, uint32 count, uint32 pegs,
+                          uint32 row, uint8* cells)
+{
+  uint8   map[SB_BUCKETS(SB_MAX_PEGS)];
+  uint32  buckets[SB_BUCKETS(SB_MAX_PEGS)];
+  uint16* feedback = malloc(count * sizeof(uint16));
+  uint32  b, j;
+
+  for (b = 0; b < SB_BUCKETS(pegs); b++)
+  {
+    map[b] = (uint8)ST_FEEDBACK(SB_BUCKET_P(b, pegs), SB_BUCKET_C(b, pegs),
+                                pegs);
+  } /* for b */
+
+  score_batch(codes[row], codes, count, pegs, buckets, feedback);
+  if (4 == ST_CELL_BITS(pegs))
+  {
+    memset(cells, 0, (count + 1) / 2);
+    for (j = 0; j < count; j++)
+    {
+      cells[j >> 1] |= map[feedback[j]] << ((j & 1) * 4);
+    } /* for j */
+  } /* if */
+  else
+  {
+    for (j = 0; j < count; j++)
+    {
+      cells[j] = map[feedback[j]];
+    } /* for j */
+  } /* else */
+
+  free(feedback);
+} /* score_table_fill_row */
+
+//-------------------------------------------------------------------------
+// NAME:        score_table_open
+//
+// DESCRIPTION: Maps a table and checks that it is whole and made for the
+//              given configuration.  Only the header, the codes and the
+//              CRCs are read; the rows are paged in as they are used.
+// ARGUMENTS:   score_table_t* table, receives the mapping
+//              const char* path, the file
+//              uint32 pegs, uint32 colors, uint32 repeats, configuration
+// RETURNS:     int, 0 on success, -1 (with a message) if it can't be used
+//-------------------------------------------------------------------------
+int score_table_open(score_table_t* table, const char* path, uint32 pegs,
+                     uint32 colors, uint32 repeats)
+{
+  st_header_t   expect;
+  st_header_t   header;
+  struct stat   st;
+  const char*   problem = NULL;
+  int           fd;
+
+  memset(table, 0, sizeof(*table));
+  fd = open(path, O_RDONLY);
+  if (fd < 0 || 0 != fstat(fd, &st))
+  {
+    perror(path);
+    if (fd >= 0)
+    {
+      close(fd);
+    } /* if */
+    return -1;
+  } /* if */
+  if ((uint64)st.st_size < ST_PAGE)
+  {
+    fprintf(stderr, "%s: not a score table\n", path);
+    close(fd);
+    return -1;
+  } /* if */
+
+  table->size = (size_t)st.st_size;
+  table->map  = mmap(NULL, table->size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (MAP_FAILED == table->map)
+  {
+    perror(path);
+    table->map = NULL;
+    return -1;
+  } /* if */
+  table->header = table->map;
+
+  // identification, then integrity, then the key, then the layout
+  header            = *table->header;
+  header.header_crc = 0;
+  if (0 != memcmp(header.magic, ST_MAGIC, sizeof(header.magic)))
+  {
+    problem = "not a score table";
+  } /* if */
+  else if (ST_VERSION != header.version)
+  {
+    problem = "unsupported score table version";
+  } /* else if */
+  else if (st_crc32(0, &header, sizeof(header)) !=
+           table->header->header_crc)
+  {
+    problem = "header CRC mismatch";
+  } /* else if */
+  else if (pegs != header.pegs || colors != header.colors ||
+           (repeats ? 1 : 0) != header.repeats)
+  {
+    problem = "made for another configuration";
+  } /* else if */
+  else if (0 == score_table_layout(&expect, pegs, colors, repeats) ||
+           0 != memcmp(&expect, table->header, sizeof(expect)))
+  {
+    problem = "unexpected layout";
+  } /* else if */
+  else if (expect.file_size != (uint64)st.st_size)
+  {
+    problem = "truncated";
+  } /* else if */
+
+  if (NULL == problem)
+  {
+    table->codes = (const uint32*)((const uint8*)table->map +
+                                   header.codes_offset);
+    table->rows  = (const uint8*)table->map + header.rows_offset;
+    table->crcs  = (const uint32*)((const uint8*)table->map +
+                                   header.crcs_offset);
+    if (st_crc32(0, table->crcs, header.codes * sizeof(uint32)) !=
+        table->crcs[header.codes + ST_CRCS_CRC])
+    {
+      problem = "row CRCs damaged";
+    } /* if */
+    else if (st_crc32(0, table->codes, header.codes * sizeof(uint32)) !=
+             table->crcs[header.codes + ST_CODES_CRC])
+    {
+      problem = "codes damaged";
+    } /* else if */
+  } /* if */
+
+  if (NULL != problem)
+  {
+    fprintf(stderr, "%s: %s\n", path, problem);
+    score_table_close(table);
+    return -1;
+  } /* if */
+
+  return 0;
+} /* score_table_open */
+
+//-------------------------------------------------------------------------
+// NAME:        score_table_verify
+//
+// DESCRIPTION: Checks every row against its CRC (which reads the whole
+//              file).
+// ARGUMENTS:   const score_table_t* table, an open table
+// RETURNS:     uint32, the number of damaged rows
+//-------------------------------------------------------------------------
+uint32 score_table_verify(const score_table_t* table)
+{
+  uint32 bytes = (table->header->codes * table->header->cell_bits + 7) / 8;
+  uint32 bad   = 0;
+  uint32 row;
+
+  for (row = 0; row < table->header->codes; row++)
+  {
+    bad += (st_crc32(0, ST_ROW(table, row), bytes) != table->crcs[row]);
+  } /* for row */
+
+  return bad;
+} /* score_table_verify */
+
+//-------------------------------------------------------------------------
+// NAME:        score_table_index
+//
+// DESCRIPTION: Finds a code's row (and column).
+// ARGUMENTS:   const score_table_t* table, an open table
+//              uint32 code, packed code
+// RETURNS:     int32, its index, or -1 if it isn't in the table
+//-------------------------------------------------------------------------
+int32 score_table_index(const score_table_t* table, uint32 code)
+{
+  uint32 low  = 0;
+  uint32 high = table->header->codes;
+  uint32 mid;
+
+  // codeset_fill's order is increasing
+  while (low < high)
+  {
+    mid = (low + high) / 2;
+    if (table->codes[mid] < code)
+    {
+      low = mid + 1;
+    } /* if */
+    else
+    {
+      high = mid;
+    } /* else */
+  } /* while */
+
+  return (low < table->header->codes && table->codes[low] == code)
+         ? (int32)low : -1;
+} /* score_table_index */
+
+//-------------------------------------------------------------------------
+// NAME:        score_table_close
+//
+// DESCRIPTION: Unmaps a table.
+// ARGUMENTS:   score_table_t* table, an open (or failed) table
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void score_table_close(score_table_t* table)
+{
+  if (NULL != table->map)
+  {
+    munmap(table->map, table->size);
+  } /* if */
+  memset(table, 0, sizeof(*table));
+} /* score_table_close */
@@ -0,0 +1,105 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  score_table.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines the on-disk score table format and the
+//      constants/prototypes for score_table.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_SCORE_TABLE__H
+#define __LAB_7_SCORE_TABLE__H
+
+#include <stddef.h>
+
+#include "nios_std_types.h"   // standard data types
+
+// File identification
+#define   ST_MAGIC                        "CBSCORES"
+#define   ST_VERSION                      2
+
+// Sections start on page boundaries, and no row crosses one needlessly
+#define   ST_PAGE                         4096
+
+// Feedback cells: the (P, C) triangle, numbered like BOOK_FEEDBACK, so a
+// table for the firmware's configuration holds book feedback indices
+#define   ST_FEEDBACKS(pegs)      (((pegs) + 1) * ((pegs) + 2) / 2)
+#define   ST_FEEDBACK(p, c, pegs) ((p) * (2 * (pegs) + 3 - (p)) / 2 + (c))
+#define   ST_CELL_BITS(pegs)      ((ST_FEEDBACKS(pegs) <= 16) ? 4 : 8)
+
+// The file, all little-endian:
+//
+//   page 0     st_header_t, zero padded
+//   codes      uint32 per row: the packed code, in codeset_fill order
+//   rows       one per guess, row_bytes apart; cell j is the feedback of
+//              code j against the row's guess
+//   trailer    uint32 CRC-32 per row (of its cells, not the padding),
+//              then the CRC-32 of those, then the CRC-32 of the codes
+//
+// The CRCs come last so that a generator can write the whole file in
+// one pass.  Version 1 had no CRC of the codes.
+typedef struct
+{
+  char    magic[8];                   // ST_MAGIC, not terminated
+  uint32  version;                    // ST_VERSION
+  uint32  header_crc;                 // CRC-32 of the header, this as 0
+  uint32  pegs;
+  uint32  colors;
+  uint32  repeats;
+  uint32  codes;                      // rows, and cells per row
+  uint32  cell_bits;                  // ST_CELL_BITS(pegs)
+  uint32  row_bytes;                  // row stride
+  uint64  codes_offset;
+  uint64  rows_offset;
+  uint64  crcs_offset;
+  uint64  file_size;
+} st_header_t;
+
+// An open (mapped) table
+typedef struct
+{
+  const st_header_t*  header;
+  const uint32*       codes;
+  const uint8*        rows;
+  const uint32*       crcs;
+  void*               map;
+  size_t              size;
+} score_table_t;
+
+// One cell
+#define   ST_CELL(table, row, col)                                        \
+  ((4 == (table)->header->cell_bits)                                      \
+    ? ((ST_ROW(table, row)[(col) >> 1] >> (((col) & 1) * 4)) & 0xF)      \
+    : ST_ROW(table, row)[col])
+#define   ST_ROW(table, row)                                              \
+  ((table)->rows + (uint64)(row) * (table)->header->row_bytes)
+
+// Trailer words after the row CRCs
+#define   ST_CRCS_CRC                     0   // CRC-32 of the row CRCs
+#define   ST_CODES_CRC                    1   // CRC-32 of the codes
+#define   ST_TRAILER_WORDS                2
+
+// Prototypes for public functions
+uint32 st_crc32(uint32 crc, const void* data, size_t length);
+uint64 score_table_layout(st_header_t* header, uint32 pegs, uint32 colors,
+                          uint32 repeats);
+void score_table_fill_row(const uint32* codes, uint32 count, uint32 pegs,
+                          uint32 row, uint8* cells);
+int score_table_open(score_table_t* table, const char* path, uint32 pegs,
+                     uint32 colors, uint32 repeats);
+uint32 score_table_verify(const score_table_t* table);
+int32 score_table_index(const score_table_t* table, uint32 code);
+void score_table_close(score_table_t* table);
+
+#endif /* __LAB_7_SCORE_TABLE__H */
@@ -0,0 +1,347 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  uart_flood.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Floods the JTAG UART receive path with guesses, on the host register
+//    model, and accounts for every character.  The unmodified driver
+//    (uart_if.c, with its deferred echo) runs under a main loop like the
+//    one game_loop waits in: run the deferred work, pick up a line with
+//    uart_RecvCode if there is one, and idle.  The input is a stream of
+//    four-color lines ("GBRO\n", ...) sent in bursts of -b characters at
+//    the link rate, with the bursts spaced to give an average rate of -r.
+//
+//    A character can be lost in two places: the 64-byte receive FIFO
+//    overflows if the ISR doesn't run often enough, and the ISR refuses
+//    characters while the last line hasn't been picked up yet or the line
+//    is already full.  Each is counted, along with the characters that
+//    made it into a line, the echoes sent back (which the deferred work
+//    queue can also drop), and the ISR's cycles per character.
+//
+//    -m searches for the highest average rate that loses nothing, to
+//    compare before and after a driver change; -f makes the run at a
+//    given rate a pass/fail check.
+//
+//  USAGE
+//    uart_flood [-r rate] [-b burst] [-l rate] [-n chars] [-m] [-f rate]
+//      -r  average input rate, characters/s (default 2000)
+//      -b  characters per burst (default 5, one line)
+//      -l  rate within a burst, characters/s (default 100000)
+//      -n  characters to send per run (default 10000)
+//      -m  find the highest rate at which nothing is lost
+//      -f  exit status 1 if anything is lost at this rate
+//
+//  BUILDING
+//    gcc -O2 -Wall -DHOST_MODEL -Ibsp -I. -I../nios -o uart_flood
+//        uart_flood.c regmodel.c lfsr_model.c ../nios/lfsr_if.c
+//        ../nios/pio_if.c ../nios/display_if.c ../nios/timer_if.c
+//        ../nios/uart_if.c ../nios/utilities.c ../nios/session_rec.c
+//        ../nios/color_table.c ../nios/defer.c ../nios/latency.c
+//        ../nios/msglog.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // for ALT_CPU_FREQ, JTAG_UART_0_IRQ
+#include "regmodel.h"
+#include "hw_access.h"        // for CPU_IDLE
+#include "codebreaker.h"      // for CB_COLOR_LETTERS, CB_COLOR_LENGTH
+#include "defer.h"            // for defer_run and its statistics
+#include "uart_if.h"
+
+// When the input starts, after uart_init has had its say
+#define   UF_START                        (ALT_CPU_FREQ / 100)
+
+// Rates -m searches between, characters/s, and how closely
+#define   UF_MIN_RATE                     10
+#define   UF_PRECISION                    100   // 1%
+
+// What happened to the characters of one run
+typedef struct
+{
+  uint32  sent;
+  uint32  overruns;           // lost to a full receive FIFO
+  uint32  read;               // taken from the FIFO by the ISR
+  uint32  accepted;           // in lines picked up, newlines included
+  uint32  lines;              // lines picked up
+  uint32  short_lines;        // ... with fewer than CB_COLOR_LENGTH colors
+  uint32  echoed;
+  uint32  echoes_dropped;     // deferred echoes lost to a full queue
+  uint64  isr_cycles;
+  uint64  isrs;
+  uint64  cycles;             // simulated time the run took
+} _uf_result_t;
+
+static _uf_result_t _result;
+static uint32       _counting;  // TRUE once the input is due
+
+//-------------------------------------------------------------------------
+// NAME:        _uf_access, _uf_uart_tx
+//
+// DESCRIPTION: Register model hooks: count the characters the ISR reads
+//              and the echoes sent.
+//-------------------------------------------------------------------------
+static void _uf_access(uint32 periph, uint32 reg, uint32 write,
+                       uint32 value, const char* func, uint32 cycles,
+                       uint32 count)
+{
+  if (RM_UART == periph && JTAG_DATA_REG_OFFSET == reg && !write &&
+      0 != (value & JTAG_UART_RV_BIT_MASK))
+  {
+    _result.read++;
+  } /* if */
+} /* _uf_access */
+
+static void _uf_uart_tx(uint8 byte)
+{
+  if (_counting)
+  {
+    _result.echoed++;
+  } /* if */
+} /* _uf_uart_tx */
+
+//-------------------------------------------------------------------------
+// NAME:        _uf_main
+//
+// DESCRIPTION: Firmware side: the driver and a main loop that picks up
+//              each line as soon as it can.  Returns only through the
+//              model, when the input has run out.
+//-------------------------------------------------------------------------
+static int _uf_main()
+{
+  uint32 code;
+  uint32 length;
+
+  uart_init();
+  uart_SetMode(UART_GAMEMODE);
+  _counting = TRUE;
+
+  while (1)
+  {
+    defer_run();
+    if (uart_RecvCode(&code, &length))
+    {
+      _result.lines++;
+      _result.accepted += length + 1;
+      if (length < CB_COLOR_LENGTH)
+      {
+        _result.short_lines++;
+      } /* if */
+    } /* if */
+    CPU_IDLE();
+  } /* while */
+
+  return 0;
+} /* _uf_main */
+
+//-------------------------------------------------------------------------
+// NAME:        _uf_run
+//
+// DESCRIPTION: Floods the receive path once.
+// ARGUMENTS:   double rate, average characters/s
+//              uint32 burst, characters per burst
+//              double link, characters/s within a burst
+//              uint32 chars, characters to send
+// RETURNS:     uint32, characters lost
+//-------------------------------------------------------------------------
+static uint32 _uf_run(double rate, uint32 burst, double link, uint32 chars)
+{
+  static const char letters[] = CB_COLOR_LETTERS;
+
+  double per_burst = burst * ALT_CPU_FREQ / rate;
+  double per_char  = ALT_CPU_FREQ / ((link > rate) ? link : rate);
+  uint32 line      = CB_COLOR_LENGTH + 1;
+  uint32 i;
+  uint8  c;
+
+  rm_reset();
+  rm_hooks.access  = _uf_access;
+  rm_hooks.uart_tx = _uf_uart_tx;
+  memset(&_result, 0, sizeof(_result));
+  _counting       = FALSE;
+  defer_posted    = 0;
+  defer_dropped   = 0;
+  defer_max_depth = 0;
+  defer_max_delay = 0;
+
+  // Latest first, since the model keeps its queue with the next event
+  // last; scheduled in time order, each would shift the whole queue.
+  for (i = chars; i-- > 0; )
+  {
+    if (CB_COLOR_LENGTH == i % line)
+    {
+      c = '\n';
+    } /* if */
+    else
+    {
+      // each line is a different rotation of the colors
+      c = letters[(i / line + i % line) % (sizeof(letters) - 1)];
+    } /* else */
+    rm_schedule(UF_START + (uint64)((i / burst) * per_burst +
+                                    (i % burst) * per_char),
+                RM_EV_UART_RX, c);
+  } /* for i */
+
+  rm_run(_uf_main);
+
+  _result.sent           = chars;
+  _result.overruns       = rm_uart_overruns;
+  _result.echoes_dropped = defer_dropped;
+  _result.isr_cycles     = rm_isr_total[JTAG_UART_0_IRQ];
+  _result.isrs           = rm_isr_count[JTAG_UART_0_IRQ];
+  _result.cycles         = rm_cycles - UF_START;
+
+  return _result.sent - _result.accepted;
+} /* _uf_run */
+
+//-------------------------------------------------------------------------
+// NAME:        _uf_print
+//
+// DESCRIPTION: Reports the last run.
+//-------------------------------------------------------------------------
+static void _uf_print(double rate, uint32 burst, double link)
+{
+  uint32 refused = _result.read - _result.accepted;
+  uint32 read    = (0 != _result.read) ? _result.read : 1;
+
+  printf("%.0f chars/s in bursts of %u at %.0f chars/s: %u sent in "
+         "%.3f s\n", rate, burst, link, _result.sent,
+         (double)_result.cycles / ALT_CPU_FREQ);
+  printf("  lost to FIFO overrun  %8u\n", _result.overruns);
+  printf("  refused by the ISR    %8u\n", refused);
+  printf("  accepted              %8u  (%u lines, %u short)\n",
+         _result.accepted, _result.lines, _result.short_lines);
+  printf("  echoed                %8u  (%u dropped)\n",
+         _result.echoed, _result.echoes_dropped);
+  printf("  ISR                   %8llu runs, %.1f cycles/char\n",
+         (unsigned long long)_result.isrs,
+         (double)_result.isr_cycles / read);
+} /* _uf_print */
+
+//-------------------------------------------------------------------------
+// NAME:        main
+//
+// DESCRIPTION: Parses the options and runs the floods asked for.
+// ARGUMENTS:   int argc, char** argv, as in USAGE
+// RETURNS:     int, 0 on success, 1 if -f lost input, 2 on bad arguments
+//-------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  double  rate   = 2000;
+  uint32  burst  = CB_COLOR_LENGTH + 1;
+  double  link   = 100000;
+  uint32  chars  = 10000;
+  uint32  search = FALSE;
+  double  target = 0;
+  double  lo;
+  double  hi;
+  double  mid;
+  uint32  lost;
+  int     status = 0;
+  int     opt;
+
+  while (-1 != (opt = getopt(argc, argv, "r:b:l:n:mf:")))
+  {
+    switch (opt)
+    {
+      case 'r':
+        rate = atof(optarg);
+        break;
+      case 'b':
+        burst = (uint32)atoi(optarg);
+        break;
+      case 'l':
+        link = atof(optarg);
+        break;
+      case 'n':
+        chars = (uint32)atoi(optarg);
+        break;
+      case 'm':
+        search = TRUE;
+        break;
+      case 'f':
+        target = atof(optarg);
+        break;
+      default:
+        rate = 0;
+        break;
+    } /* switch */
+  } /* while */
+  if (rate <= 0 || 0 == burst || link <= 0 || 0 == chars ||
+      target < 0 || optind != argc)
+  {
+    fprintf(stderr, "usage: %s [-r rate] [-b burst] [-l rate] [-n chars] "
+                    "[-m] [-f rate]\n", argv[0]);
+    return 2;
+  } /* if */
+
+  if (!search && 0 == target)
+  {
+    _uf_run(rate, burst, link, chars);
+    _uf_print(rate, burst, link);
+  } /* if */
+
+  if (search)
+  {
+    // Binary search on a lossless low end and a lossy high end
+    lo = UF_MIN_RATE;
+    hi = link;
+    if (0 == _uf_run(hi, burst, link, chars))
+    {
+      printf("nothing lost even at the link rate, %.0f chars/s\n", link);
+    } /* if */
+    else if (0 != _uf_run(lo, burst, link, chars))
+    {
+      printf("input lost even at %.0f chars/s: ", lo);
+      _uf_print(lo, burst, link);
+    } /* else if */
+    else
+    {
+      while (hi - lo > lo / UF_PRECISION)
+      {
+        mid = (lo + hi) / 2;
+        if (0 == _uf_run(mid, burst, link, chars))
+        {
+          lo = mid;
+        } /* if */
+        else
+        {
+          hi = mid;
+        } /* else */
+      } /* while */
+      printf("highest rate without loss: %.0f chars/s "
+             "(bursts of %u at %.0f chars/s)\n", lo, burst, link);
+      _uf_run(hi, burst, link, chars);
+      printf("just above it, ");
+      _uf_print(hi, burst, link);
+    } /* else */
+  } /* if */
+
+  if (0 != target)
+  {
+    lost = _uf_run(target, burst, link, chars);
+    _uf_print(target, burst, link);
+    if (0 != lost)
+    {
+      printf("FAIL: %u characters lost at %.0f chars/s\n", lost, target);
+      status = 1;
+    } /* if */
+  } /* if */
+
+  return status;
+} /* main */
@@ -0,0 +1,579 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  analysis.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Post-game analysis.  Given the secret and the player's guesses, works
+//    out for each guess how many codes were still possible before and
+//    after it, how much it told the player (in bits), the best guess
+//    there was to make, and how many guesses the best play from that
+//    point would have needed.
+//
+//    "Best" is the opening book while the player is on it, and otherwise
+//    the book generator's ranking: the guess that splits the codes left
+//    into the most distinct feedbacks.  An opening that repeats colors
+//    the way the book's does is the book's in other colors, so the player
+//    stays on the book, recolored, until their first guess that the book
+//    wouldn't make.  Ranking costs a score_code call per possible guess
+//    per code left, so the best guess for each set of codes is kept in a
+//    small cache; the look-ahead for par revisits the same sets over and
+//    over.  Every set is the codes that would have given some guesses
+//    the scores they got, so an entry keeps those guesses and scores,
+//    and a hit is only taken if every code of the set would have given
+//    them too: the two sets are then the same, as they are the same
+//    size.  The hash of the set just finds the entry.
+//
+//    Nothing here touches hardware, so the host tools link it as is,
+//    built with GAME_ANALYSIS; without it, none of this is compiled.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for score_code, to_colorstr, code_from_index
+#include "book.h"             // for the opening book
+#include "analysis.h"
+
+#ifdef GAME_ANALYSIS
+
+// Feedback counter index of a packed score.  P + C is at most
+// CB_COLOR_LENGTH.
+#define   _FEEDBACK(score)    (SCORE_P(score) * (CB_COLOR_LENGTH + 1) + \
+                               SCORE_C(score))
+#define   _FEEDBACKS          ((CB_COLOR_LENGTH + 1) * (CB_COLOR_LENGTH + 1))
+
+// One guess and its score: the codes that would have given that score
+typedef struct
+{
+  uint16  guess;
+  uint16  score;
+} _analysis_clue_t;
+
+// Partition cache entry: the best guess for one set of codes
+typedef struct
+{
+  uint32  key;                // hash of the set
+  uint16  count;              // codes in the set
+  uint16  best;               // best-ranked guess
+  uint32  depth;              // clues that make the set
+  _analysis_clue_t  path[ANALYSIS_PATH_MAX];
+} _analysis_entry_t;
+
+uint16  _analysis_codes[ANALYSIS_CODES];    // every code, in order
+uint16  _analysis_set[ANALYSIS_CODES];      // codes possible so far
+uint16  _analysis_scratch[ANALYSIS_CODES];  // look-ahead set
+_analysis_entry_t _analysis_cache[ANALYSIS_CACHE_SIZE];
+
+// The clues that made the set being ranked, from every code (only the
+// first ANALYSIS_PATH_MAX are kept)
+_analysis_clue_t  _analysis_path[ANALYSIS_PATH_MAX];
+uint32            _analysis_depth;
+
+uint32  analysis_cache_hits;
+uint32  analysis_cache_misses;
+
+//-------------------------------------------------------------------------
+// NAME:        _log2_q8
+//
+// DESCRIPTION: Base-2 logarithm in fixed point, 8 fractional bits, by
+//              repeated squaring of the normalized value.
+// ARGUMENTS:   uint32 x, at least 1 and below 65536
+// RETURNS:     uint32, log2(x) * 256
+//-------------------------------------------------------------------------
+uint32 _log2_q8(uint32 x)
+{
+  uint32 result;
+  uint32 bit;
+  uint32 y;
+
+  // integer part: the position of the top bit
+  bit = 15;
+  while (0 == (x >> bit))
+  {
+    bit--;
+  } /* while */
+  result = bit << 8;
+
+  // fraction: normalize to a Q15 mantissa in [1, 2); each squaring then
+  // yields the next bit
+  y = (x << 15) >> bit;
+  for (bit = 128; bit > 0; bit >>= 1)
+  {
+    y = (y * y) >> 15;
+    if (y >= (2 << 15))
+    {
+      y       >>= 1;
+      result   += bit;
+    } /* if */
+  } /* for bit */
+
+  return result;
+} /* _log2_q8 */
+
+//-------------------------------------------------------------------------
+// NAME:        _filter
+//
+// DESCRIPTION: Keeps only the codes that would have given a guess the
+//              score it got, in place and in order.
+// ARGUMENTS:   uint16* set, uint32 count, the codes
+//              uint32 guess, uint32 score, the guess and its score
+// RETURNS:     uint32, codes kept
+//-------------------------------------------------------------------------
+uint32 _filter(uint16* set, uint32 count, uint32 guess, uint32 score)
+{
+  uint32 kept = 0;
+  uint32 i;
+
+  for (i = 0; i < count; i++)
+  {
+    if (score_code(set[i], guess) == score)
+    {
+      set[kept++] = set[i];
+    } /* if */
+  } /* for i */
+
+  return kept;
+} /* _filter */
+
+//-------------------------------------------------------------------------
+// NAME:        _clue
+//
+// DESCRIPTION: Adds a guess and its score to the path of the set being
+//              ranked, once the set has been filtered by them.
+// ARGUMENTS:   uint32 guess, uint32 score, the guess and its score
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void _clue(uint32 guess, uint32 score)
+{
+  if (_analysis_depth < ANALYSIS_PATH_MAX)
+  {
+    _analysis_path[_analysis_depth].guess = (uint16)guess;
+    _analysis_path[_analysis_depth].score = (uint16)score;
+  } /* if */
+  _analysis_depth++;
+} /* _clue */
+
+//-------------------------------------------------------------------------
+// NAME:        _rank
+//
+// DESCRIPTION: Finds the best guess for a set of codes, the way
+//              host/gen_book ranks them: most distinct feedbacks, then a
+//              guess that could be the code, then the smallest worst
+//              case.
+// ARGUMENTS:   const uint16* set, uint32 count, the codes (at least 3)
+// RETURNS:     uint32, the best guess
+//-------------------------------------------------------------------------
+uint32 _rank(const uint16* set, uint32 count)
+{
+  uint16 sizes[_FEEDBACKS];
+  uint32 best       = _analysis_codes[0];
+  uint32 best_parts = 0;
+  uint32 best_worst = count + 1;
+  uint32 best_in    = FALSE;
+  uint32 guess;
+  uint32 parts, worst, member;
+  uint32 f, g, i;
+
+  for (g = 0; g < ANALYSIS_CODES; g++)
+  {
+    guess  = _analysis_codes[g];
+    parts  = 0;
+    worst  = 0;
+    member = FALSE;
+    for (f = 0; f < _FEEDBACKS; f++)
+    {
+      sizes[f] = 0;
+    } /* for f */
+
+    for (i = 0; i < count; i++)
+    {
+      if (parts + (count - i) < best_parts)
+      {
+        break;                // can't catch up with the best any more
+      } /* if */
+      f = _FEEDBACK(score_code(set[i], guess));
+      if (0 == sizes[f]++)
+      {
+        parts++;
+      } /* if new part */
+      if (sizes[f] > worst)
+      {
+        worst = sizes[f];
+      } /* if */
+      member |= (set[i] == guess);
+    } /* for i */
+
+    if (parts > best_parts ||
+        (parts == best_parts && (member > best_in ||
+        (member == best_in && worst < best_worst))))
+    {
+      best       = guess;
+      best_parts = parts;
+      best_worst = worst;
+      best_in    = member;
+      if (parts == count && member)
+      {
+        break;                // every code told apart; can't do better
+      } /* if */
+    } /* if better */
+  } /* for g */
+
+  return best;
+} /* _rank */
+
+//-------------------------------------------------------------------------
+// NAME:        _best
+//
+// DESCRIPTION: The best guess for a set of codes, through the cache.
+//              The set must be the one _analysis_path makes.
+// ARGUMENTS:   const uint16* set, uint32 count, the codes
+// RETURNS:     uint32, the best guess
+//-------------------------------------------------------------------------
+uint32 _best(const uint16* set, uint32 count)
+{
+  _analysis_entry_t* entry;
+  uint32 key = 2166136261u;   // FNV-1a
+  uint32 hit;
+  uint32 i, k;
+
+  if (count <= 2)
+  {
+    return set[0];            // guess one; if wrong, it's the other
+  } /* if */
+  if (ANALYSIS_CODES == count)
+  {
+    // the book has already chosen an opening
+    return book_nodes[BOOK_ROOT].guess;
+  } /* if */
+
+  for (i = 0; i < count; i++)
+  {
+    key = (key ^ set[i]) * 16777619u;
+  } /* for i */
+
+  // A hit needs every code to fit the entry's clues; the entry's set is
+  // every code that does, and it is as big as this one
+  entry = &_analysis_cache[key & (ANALYSIS_CACHE_SIZE - 1)];
+  hit   = (entry->key == key && entry->count == count);
+  for (i = 0; hit && i < count; i++)
+  {
+    for (k = 0; hit && k < entry->depth; k++)
+    {
+      hit = (score_code(set[i], entry->path[k].guess) ==
+             entry->path[k].score);
+    } /* for k */
+  } /* for i */
+  if (hit)
+  {
+    analysis_cache_hits++;
+    return entry->best;
+  } /* if hit */
+
+  analysis_cache_misses++;
+  if (_analysis_depth > ANALYSIS_PATH_MAX)
+  {
+    return _rank(set, count);   // too many clues to keep
+  } /* if */
+  entry->key   = key;
+  entry->count = (uint16)count;
+  entry->best  = (uint16)_rank(set, count);
+  entry->depth = _analysis_depth;
+  for (k = 0; k < _analysis_depth; k++)
+  {
+    entry->path[k] = _analysis_path[k];
+  } /* for k */
+  return entry->best;
+} /* _best */
+
+//-------------------------------------------------------------------------
+// NAME:        _recolor
+//
+// DESCRIPTION: Applies a color permutation to every slot of a code.
+// ARGUMENTS:   uint32 code, the code
+//              const uint8* map, new color for each color
+// RETURNS:     uint32, the recolored code
+//-------------------------------------------------------------------------
+uint32 _recolor(uint32 code, const uint8* map)
+{
+  uint32 result = 0;
+  uint32 i;
+
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    result |= (uint32)map[(code >> (i * 4)) & 0xF] << (i * 4);
+  } /* for i */
+
+  return result;
+} /* _recolor */
+
+//-------------------------------------------------------------------------
+// NAME:        _opening_map
+//
+// DESCRIPTION: Finds a color permutation that turns an opening guess into
+//              the book's.  Scores don't change when both codes are
+//              recolored alike, so after any opening that repeats colors
+//              in the same places as the book's the game is the book's,
+//              recolored.
+// ARGUMENTS:   uint32 guess, the opening guess
+//              uint8* map, receives the permutation
+//              uint8* unmap, receives its inverse
+// RETURNS:     uint32, TRUE if there is one
+//-------------------------------------------------------------------------
+uint32 _opening_map(uint32 guess, uint8* map, uint8* unmap)
+{
+  uint32 book = book_nodes[BOOK_ROOT].guess;
+  uint32 from, to;
+  uint32 i;
+
+  for (from = 0; from < CB_POSSIBLE_COLORS; from++)
+  {
+    map[from]   = 0xFF;
+    unmap[from] = 0xFF;
+  } /* for from */
+
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    from = (guess >> (i * 4)) & 0xF;
+    to   = (book >> (i * 4)) & 0xF;
+    if (map[from] != to && (0xFF != map[from] || 0xFF != unmap[to]))
+    {
+      return FALSE;             // colors repeat in different places
+    } /* if */
+    map[from] = (uint8)to;
+    unmap[to] = (uint8)from;
+  } /* for i */
+
+  // the colors in neither guess pair off in order
+  to = 0;
+  for (from = 0; from < CB_POSSIBLE_COLORS; from++)
+  {
+    if (0xFF == map[from])
+    {
+      while (0xFF != unmap[to])
+      {
+        to++;
+      } /* while */
+      map[from] = (uint8)to;
+      unmap[to] = (uint8)from;
+    } /* if */
+  } /* for from */
+
+  return TRUE;
+} /* _opening_map */
+
+//-------------------------------------------------------------------------
+// NAME:        _par
+//
+// DESCRIPTION: Plays the best guesses against the secret, starting from
+//              the codes in _analysis_scratch (which it consumes).
+// ARGUMENTS:   uint32 secret, the secret code
+//              uint32 count, codes in _analysis_scratch
+// RETURNS:     uint32, guesses needed, counting the winning one
+//-------------------------------------------------------------------------
+uint32 _par(uint32 secret, uint32 count)
+{
+  uint32 depth   = _analysis_depth;
+  uint32 guesses = 0;
+  uint32 guess;
+  uint32 score;
+
+  while (count > 0)
+  {
+    guesses++;
+    guess = _best(_analysis_scratch, count);
+    if (guess == secret)
+    {
+      break;
+    } /* if */
+    score = score_code(secret, guess);
+    count = _filter(_analysis_scratch, count, guess, score);
+    _clue(guess, score);
+  } /* while */
+
+  _analysis_depth = depth;
+  return guesses;
+} /* _par */
+
+//-------------------------------------------------------------------------
+// NAME:        analysis_game
+//
+// DESCRIPTION: Analyzes every guess of a game.
+// ARGUMENTS:   uint32 secret, the packed secret code
+//              const uint32* guesses, uint32 count, the packed guesses,
+//                                     in order (at most
+//                                     ANALYSIS_MAX_GUESSES are used)
+//              analysis_step_t* steps, receives one entry per guess
+// RETURNS:     uint32, number of guesses analyzed
+//-------------------------------------------------------------------------
+uint32 analysis_game(uint32 secret, const uint32* guesses, uint32 count,
+                     analysis_step_t* steps)
+{
+  uint8  map[CB_POSSIBLE_COLORS];     // player's colors to the book's
+  uint8  unmap[CB_POSSIBLE_COLORS];
+  uint32 book_node = BOOK_ROOT;       // BOOK_NONE once off the book
+  uint32 left      = ANALYSIS_CODES;
+  uint32 node;
+  uint32 i, j;
+
+  if (count > ANALYSIS_MAX_GUESSES)
+  {
+    count = ANALYSIS_MAX_GUESSES;
+  } /* if */
+
+  for (i = 0; i < ANALYSIS_CODES; i++)
+  {
+    _analysis_set[i] = _analysis_codes[i];
+  } /* for i */
+  _analysis_depth = 0;
+  for (i = 0; i < CB_POSSIBLE_COLORS; i++)
+  {
+    map[i]   = (uint8)i;
+    unmap[i] = (uint8)i;
+  } /* for i */
+
+  for (i = 0; i < count; i++)
+  {
+    steps[i].guess  = guesses[i];
+    steps[i].score  = score_code(secret, guesses[i]);
+    steps[i].before = (uint16)left;
+
+    // Any opening is the book's opening in other colors; play the rest
+    // of the game in the book's colors.
+    if (0 == i && !_opening_map(guesses[0], map, unmap))
+    {
+      book_node = BOOK_NONE;
+    } /* if */
+
+    if (BOOK_NONE != book_node)
+    {
+      // on the book, the best play is just a walk down it
+      steps[i].best = (uint16)_recolor(book_nodes[book_node].guess, unmap);
+      steps[i].par  = 1;
+      for (node = book_node;
+           book_nodes[node].guess != _recolor(secret, map); steps[i].par++)
+      {
+        node = book_next(book_nodes, node,
+                         score_code(secret,
+                                    _recolor(book_nodes[node].guess,
+                                             unmap)));
+      } /* for */
+    } /* if on the book */
+    else
+    {
+      steps[i].best = (uint16)_best(_analysis_set, left);
+      for (j = 0; j < left; j++)
+      {
+        _analysis_scratch[j] = _analysis_set[j];
+      } /* for j */
+      steps[i].par = (uint16)_par(secret, left);
+    } /* else */
+
+    left = _filter(_analysis_set, left, guesses[i], steps[i].score);
+    _clue(guesses[i], steps[i].score);
+    steps[i].after = (uint16)left;
+    steps[i].bits  = (uint16)(_log2_q8(steps[i].before) -
+                              _log2_q8(left));
+
+    if (BOOK_NONE != book_node &&
+        _recolor(guesses[i], map) == book_nodes[book_node].guess)
+    {
+      book_node = book_next(book_nodes, book_node, steps[i].score);
+    } /* if still on the book */
+    else
+    {
+      book_node = BOOK_NONE;
+    } /* else */
+  } /* for i */
+
+  return count;
+} /* analysis_game */
+
+//-------------------------------------------------------------------------
+// NAME:        analysis_format
+//
+// DESCRIPTION: Formats one analyzed guess as a line of the report, under
+//              ANALYSIS_HEADING.
+// ARGUMENTS:   const analysis_step_t* step, the guess
+//              uint32 index, its number in the game (from 1)
+//              uint8* line, receives ANALYSIS_LINE_LENGTH characters or
+//                           fewer, newline and terminator included
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void analysis_format(const analysis_step_t* step, uint32 index,
+                     uint8* line)
+{
+  uint8  code[CB_COLOR_LENGTH + 1];
+  uint32 hundredths = (step->bits * 100 + 128) >> 8;
+  uint32 i;
+
+  line = put_number(line, index, 3, ' ');
+  line = put_string(line, "  ");
+  to_colorstr(step->guess, code);
+  line = put_string(line, (char*)code);
+  line = put_string(line, "  ");
+
+  // the hint, P's first
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    *line++ = (i < SCORE_P(step->score)) ? 'P' :
+              (i < SCORE_P(step->score) + SCORE_C(step->score)) ? 'C' : ' ';
+  } /* for i */
+
+  line = put_string(line, "  ");
+  line = put_number(line, step->before, 4, ' ');
+  line = put_string(line, " -> ");
+  line = put_number(line, step->after, 4, ' ');
+  line = put_string(line, "  ");
+  line = put_number(line, hundredths / 100, 2, ' ');
+  line = put_string(line, ".");
+  line = put_number(line, hundredths % 100, 2, '0');
+  line = put_string(line, "  ");
+  to_colorstr(step->best, code);
+  line = put_string(line, (char*)code);
+  line = put_string(line, "  ");
+  line = put_number(line, step->par, 3, ' ');
+  line = put_string(line, "\n");
+  *line = NULL;
+
+  return;
+} /* analysis_format */
+
+//-------------------------------------------------------------------------
+// NAME:        analysis_init
+//
+// DESCRIPTION: Lists every code and empties the cache.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void analysis_init()
+{
+  uint32 i;
+
+  for (i = 0; i < ANALYSIS_CODES; i++)
+  {
+    _analysis_codes[i] = (uint16)code_from_index(i);
+  } /* for i */
+
+  for (i = 0; i < ANALYSIS_CACHE_SIZE; i++)
+  {
+    _analysis_cache[i].key   = 0;
+    _analysis_cache[i].count = 0;
+    _analysis_cache[i].depth = 0;
+  } /* for i */
+  analysis_cache_hits   = 0;
+  analysis_cache_misses = 0;
+
+  return;
+} /* analysis_init */
+
+#endif /* GAME_ANALYSIS */
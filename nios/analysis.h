@@ -0,0 +1,67 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  analysis.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for analysis.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_ANALYSIS__H
+#define __LAB_7_ANALYSIS__H
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+
+// Number of codes in the game
+#define   ANALYSIS_CODES          CB_CODES
+
+// Most guesses analyzed per game
+#define   ANALYSIS_MAX_GUESSES    32
+
+// Entries in the partition cache (a power of two), and the most guesses
+// that can have made a set it keeps
+#define   ANALYSIS_CACHE_SIZE     32
+#define   ANALYSIS_PATH_MAX       4
+
+// Length of one formatted report line, with its newline and terminator
+#define   ANALYSIS_LINE_LENGTH    49
+
+// Report column headings, matching analysis_format
+#define   ANALYSIS_HEADING \
+  "  #  guess hint    codes left   bits  best  par\n"
+
+// Analysis of one guess
+typedef struct
+{
+  uint32  guess;              // packed guess
+  uint32  score;              // its packed score, from score_code
+  uint16  before;             // codes still possible before the guess
+  uint16  after;              // ... and after it
+  uint16  bits;               // information gained, in 1/256 bits
+  uint16  best;               // best-ranked guess there was to make
+  uint16  par;                // guesses best-ranked play needed from here
+} analysis_step_t;
+
+// Partition cache statistics
+extern uint32 analysis_cache_hits;
+extern uint32 analysis_cache_misses;
+
+// Prototypes for public functions
+uint32 analysis_game(uint32 secret, const uint32* guesses, uint32 count,
+                     analysis_step_t* steps);
+void analysis_format(const analysis_step_t* step, uint32 index,
+                     uint8* line);
+void analysis_init();
+
+#endif /* __LAB_7_ANALYSIS__H */
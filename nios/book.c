@@ -0,0 +1,66 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  book.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Walks the precomputed strategy tree ("book") in book_table.c, which
+//    is generated offline by host/gen_book.  Each step is a table lookup,
+//    so the firmware can suggest the next guess without any searching.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "utilities.h"        // for SCORE_P, SCORE_C
+#include "book.h"
+
+// Number of bits set in each nibble
+static const uint8 _book_bits[16] =
+{
+  0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+};
+
+//-------------------------------------------------------------------------
+// NAME:        book_next
+//
+// DESCRIPTION: Follows one edge of the book: the node reached after
+//              playing the node's guess and getting a score for it.
+// ARGUMENTS:   const book_node_t* book, the tree (normally book_nodes)
+//              uint32 node, the current node
+//              uint32 score, packed score of the node's guess, as
+//                            returned by score_code
+// RETURNS:     uint32, the next node, or BOOK_NONE if the code has been
+//              found or the book can't have produced that score
+//-------------------------------------------------------------------------
+uint32 book_next(const book_node_t* book, uint32 node, uint32 score)
+{
+  uint32 feedback;
+  uint32 below;
+
+  if (BOOK_NONE == node)
+  {
+    return BOOK_NONE;
+  } /* if */
+
+  feedback = BOOK_FEEDBACK(SCORE_P(score), SCORE_C(score));
+  if (feedback >= BOOK_FEEDBACKS ||
+      0 == (book[node].mask & (1 << feedback)))
+  {
+    return BOOK_NONE;
+  } /* if no child */
+
+  // children are stored in feedback order, so count the ones before ours
+  below = book[node].mask & ((1 << feedback) - 1);
+  return book[node].first + _book_bits[below & 0xF] +
+         _book_bits[(below >> 4) & 0xF] + _book_bits[(below >> 8) & 0xF] +
+         _book_bits[(below >> 12) & 0xF];
+} /* book_next */
@@ -0,0 +1,54 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  book.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for book.c and the
+//      generated book_table.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_BOOK__H
+#define __LAB_7_BOOK__H
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_COLOR_LENGTH
+
+// Feedback index of a (P, C) score.  Without repeated colors P + C is at
+// most CB_COLOR_LENGTH, so the scores form a triangle, row P holding
+// CB_COLOR_LENGTH + 1 - P entries.
+#define   BOOK_FEEDBACKS      (((CB_COLOR_LENGTH) + 1) * ((CB_COLOR_LENGTH) + 2) / 2)
+#define   BOOK_FEEDBACK(p, c) ((p) * (2 * (CB_COLOR_LENGTH) + 3 - (p)) / 2 + (c))
+
+// Special node indices
+#define   BOOK_ROOT           0
+#define   BOOK_NONE           0xFFFF  // feedback the book can't have produced
+
+// One node per guess the strategy makes.  Its children, one per feedback
+// that leaves codes to find, are stored together starting at node first,
+// in feedback order; bit f of mask is set if feedback f has a child.
+typedef struct
+{
+  uint16  guess;              // packed code to play
+  uint16  mask;               // feedbacks with children
+  uint16  first;              // index of the first child
+} book_node_t;
+
+// The generated tree (book_table.c)
+extern const book_node_t book_nodes[];
+extern const uint32      book_node_count;
+
+// Prototypes for public functions
+uint32 book_next(const book_node_t* book, uint32 node, uint32 score);
+
+#endif /* __LAB_7_BOOK__H */
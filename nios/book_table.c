@@ -0,0 +1,407 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  book_table.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Opening book for book.c.  GENERATED by host/gen_book -k 32; do not
+//    edit.  366 nodes, 2196 bytes; 4.0167 guesses on average, 5 at most.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "book.h"
+
+// The table only takes memory when the hints or the analysis
+// (analysis.c) use it
+#if defined(BOOK_HINTS) || defined(GAME_ANALYSIS)
+
+#if (4 != CB_COLOR_LENGTH) || (6 != CB_POSSIBLE_COLORS) || \
+    defined(REPEAT_COLORS)
+#error "book_table.c is out of date; rerun host/gen_book"
+#endif
+
+const uint32 book_node_count = 366;
+
+const book_node_t book_nodes[366] =
+{
+  // guess   mask    first
+  { 0x0123, 0x1fdc,     1 },   //     0 ORBG
+  { 0x1245, 0x1fdc,    11 },   //     1 WYRB
+  { 0x1234, 0x1fdc,    21 },   //     2 YORB
+  { 0x1230, 0x0910,    31 },   //     3 GORB
+  { 0x0245, 0x1fdc,    34 },   //     4 WYRG
+  { 0x0234, 0x1fdc,    44 },   //     5 YORG
+  { 0x0134, 0x0488,    54 },   //     6 YOBG
+  { 0x0245, 0x1dcc,    57 },   //     7 WYRG
+  { 0x0134, 0x17cc,    65 },   //     8 YOBG
+  { 0x0132, 0x0110,    73 },   //     9 ROBG
+  { 0x0134, 0x1ec0,    75 },   //    10 YOBG
+  { 0x3054, 0x0910,    81 },   //    11 YWGO
+  { 0x4051, 0x1fdc,    84 },   //    12 BWGY
+  { 0x0514, 0x1488,    94 },   //    13 YBWG
+  { 0x3405, 0x0910,    98 },   //    14 WGYO
+  { 0x3541, 0x1fdc,   101 },   //    15 BYWO
+  { 0x1452, 0x0110,   111 },   //    16 RWYB
+  { 0x3045, 0x0000,     0 },   //    17 WYGO
+  { 0x1405, 0x15c8,   113 },   //    18 WGYB
+  { 0x1542, 0x0110,   119 },   //    19 RYWB
+  { 0x1045, 0x1200,   121 },   //    20 WYGB
+  { 0x2501, 0x1d98,   123 },   //    21 BGWR
+  { 0x3410, 0x1fdc,   130 },   //    22 GBYO
+  { 0x2341, 0x0110,   140 },   //    23 BYOR
+  { 0x5032, 0x1d98,   142 },   //    24 ROGW
+  { 0x4031, 0x17dc,   149 },   //    25 BOGY
+  { 0x1342, 0x0110,   158 },   //    26 RYOB
+  { 0x1025, 0x1988,   160 },   //    27 WRGB
+  { 0x1304, 0x05cc,   165 },   //    28 YGOB
+  { 0x1432, 0x0110,   171 },   //    29 ROYB
+  { 0x1034, 0x0600,   173 },   //    30 YOGB
+  { 0x2301, 0x0010,   175 },   //    31 BGOR
+  { 0x1302, 0x0110,   176 },   //    32 RGOB
+  { 0x1032, 0x0010,   178 },   //    33 ROGB
+  { 0x1453, 0x0910,   179 },   //    34 OWYB
+  { 0x1524, 0x1ddc,   182 },   //    35 YRWB
+  { 0x4520, 0x0900,   191 },   //    36 GRWY
+  { 0x1543, 0x0010,   193 },   //    37 OYWB
+  { 0x4325, 0x0f9c,   194 },   //    38 WROY
+  { 0x0452, 0x0010,   202 },   //    39 RWYG
+  { 0x3145, 0x0000,     0 },   //    40 WYBO
+  { 0x0415, 0x1184,   203 },   //    41 WBYG
+  { 0x0254, 0x0100,   207 },   //    42 YWRG
+  { 0x0345, 0x0000,     0 },   //    43 WYOG
+  { 0x3105, 0x1d98,   208 },   //    44 WGBO
+  { 0x1403, 0x0fdc,   215 },   //    45 OGYB
+  { 0x2403, 0x0910,   224 },   //    46 OGYR
+  { 0x5132, 0x1998,   227 },   //    47 ROBW
+  { 0x1324, 0x11dc,   233 },   //    48 YROB
+  { 0x0124, 0x0488,   240 },   //    49 YRBG
+  { 0x0215, 0x0880,   243 },   //    50 WBRG
+  { 0x0241, 0x04c8,   245 },   //    51 BYRG
+  { 0x0432, 0x0000,     0 },   //    52 ROYG
+  { 0x0214, 0x0200,   249 },   //    53 YBRG
+  { 0x1203, 0x0110,   250 },   //    54 OGRB
+  { 0x0312, 0x0100,   252 },   //    55 RBOG
+  { 0x0231, 0x0100,   253 },   //    56 BORG
+  { 0x4153, 0x0000,     0 },   //    57 OWBY
+  { 0x4523, 0x0880,   254 },   //    58 ORWY
+  { 0x5143, 0x0000,     0 },   //    59 OYBW
+  { 0x0154, 0x0480,   256 },   //    60 YWBG
+  { 0x0524, 0x0000,     0 },   //    61 YRWG
+  { 0x0543, 0x0000,     0 },   //    62 OYWG
+  { 0x0425, 0x0000,     0 },   //    63 WRYG
+  { 0x0145, 0x0000,     0 },   //    64 WYBG
+  { 0x1523, 0x0400,   258 },   //    65 ORWB
+  { 0x1423, 0x0400,   259 },   //    66 ORYB
+  { 0x0253, 0x0588,   260 },   //    67 OWRG
+  { 0x0243, 0x06c8,   264 },   //    68 OYRG
+  { 0x0413, 0x0100,   269 },   //    69 OBYG
+  { 0x0152, 0x0000,     0 },   //    70 RWBG
+  { 0x0324, 0x0480,   270 },   //    71 YROG
+  { 0x0135, 0x0000,     0 },   //    72 WOBG
+  { 0x1023, 0x0000,     0 },   //    73 ORGB
+  { 0x0213, 0x0110,   272 },   //    74 OBRG
+  { 0x0523, 0x0400,   274 },   //    75 ORWG
+  { 0x0423, 0x0400,   275 },   //    76 ORYG
+  { 0x0125, 0x0000,     0 },   //    77 WRBG
+  { 0x0153, 0x0000,     0 },   //    78 OWBG
+  { 0x0143, 0x0000,     0 },   //    79 OYBG
+  { 0x0124, 0x0000,     0 },   //    80 YRBG
+  { 0x4530, 0x0800,   276 },   //    81 GOWY
+  { 0x4350, 0x0100,   277 },   //    82 GWOY
+  { 0x3450, 0x0110,   278 },   //    83 GWYO
+  { 0x2534, 0x0100,   280 },   //    84 YOWR
+  { 0x2504, 0x0340,   281 },   //    85 YGWR
+  { 0x5410, 0x0000,     0 },   //    86 GBYW
+  { 0x2354, 0x0110,   284 },   //    87 YWOR
+  { 0x2450, 0x0050,   286 },   //    88 GWYR
+  { 0x4510, 0x0110,   288 },   //    89 GBWY
+  { 0x4352, 0x0000,     0 },   //    90 RWOY
+  { 0x2054, 0x0044,   290 },   //    91 YWGR
+  { 0x4501, 0x0000,     0 },   //    92 BGWY
+  { 0x4052, 0x0200,   292 },   //    93 RWGY
+  { 0x2451, 0x0000,     0 },   //    94 BWYR
+  { 0x5412, 0x0000,     0 },   //    95 RBYW
+  { 0x4512, 0x0000,     0 },   //    96 RBWY
+  { 0x2514, 0x0000,     0 },   //    97 YBWR
+  { 0x5340, 0x0000,     0 },   //    98 GYOW
+  { 0x3540, 0x0010,   293 },   //    99 GYWO
+  { 0x4305, 0x0000,     0 },   //   100 WGOY
+  { 0x2405, 0x0110,   294 },   //   101 WGYR
+  { 0x1054, 0x0944,   296 },   //   102 YWGB
+  { 0x1354, 0x0100,   300 },   //   103 YWOB
+  { 0x5042, 0x0000,     0 },   //   104 RYGW
+  { 0x1504, 0x0044,   301 },   //   105 YGWB
+  { 0x1534, 0x0010,   303 },   //   106 YOWB
+  { 0x2540, 0x0000,     0 },   //   107 GYWR
+  { 0x5041, 0x0000,     0 },   //   108 BYGW
+  { 0x5341, 0x0000,     0 },   //   109 BYOW
+  { 0x3542, 0x0000,     0 },   //   110 RYWO
+  { 0x2541, 0x0010,   304 },   //   111 BYWR
+  { 0x2415, 0x0010,   305 },   //   112 WBYR
+  { 0x5240, 0x0000,     0 },   //   113 GYRW
+  { 0x2345, 0x0100,   306 },   //   114 WYOR
+  { 0x2045, 0x0000,     0 },   //   115 WYGR
+  { 0x1540, 0x0000,     0 },   //   116 GYWB
+  { 0x4205, 0x0000,     0 },   //   117 WGRY
+  { 0x1435, 0x0000,     0 },   //   118 WOYB
+  { 0x4215, 0x0000,     0 },   //   119 WBRY
+  { 0x1254, 0x0100,   307 },   //   120 YWRB
+  { 0x3245, 0x0000,     0 },   //   121 WYRO
+  { 0x1345, 0x0000,     0 },   //   122 WYOB
+  { 0x3015, 0x0500,   308 },   //   123 WBGO
+  { 0x5012, 0x0000,     0 },   //   124 RBGW
+  { 0x3051, 0x0188,   310 },   //   125 BWGO
+  { 0x2015, 0x0000,     0 },   //   126 WBGR
+  { 0x2305, 0x0500,   313 },   //   127 WGOR
+  { 0x2051, 0x0100,   315 },   //   128 BWGR
+  { 0x3501, 0x0000,     0 },   //   129 BGWO
+  { 0x2351, 0x0000,     0 },   //   130 BWOR
+  { 0x2041, 0x0008,   316 },   //   131 BYGR
+  { 0x4301, 0x0000,     0 },   //   132 BGOY
+  { 0x2315, 0x0800,   317 },   //   133 WBOR
+  { 0x2340, 0x0188,   318 },   //   134 GYOR
+  { 0x3041, 0x0000,     0 },   //   135 BYGO
+  { 0x3512, 0x0000,     0 },   //   136 RBWO
+  { 0x3402, 0x0000,     0 },   //   137 RGYO
+  { 0x3401, 0x0010,   321 },   //   138 BGYO
+  { 0x2410, 0x0000,     0 },   //   139 GBYR
+  { 0x3412, 0x0000,     0 },   //   140 RBYO
+  { 0x4312, 0x0000,     0 },   //   141 RBOY
+  { 0x1305, 0x0800,   322 },   //   142 WGOB
+  { 0x3205, 0x0800,   323 },   //   143 WGRO
+  { 0x1502, 0x0110,   324 },   //   144 RGWB
+  { 0x2530, 0x0000,     0 },   //   145 GOWR
+  { 0x1052, 0x0000,     0 },   //   146 RWGB
+  { 0x2035, 0x0000,     0 },   //   147 WOGR
+  { 0x5031, 0x0000,     0 },   //   148 BOGW
+  { 0x1352, 0x0010,   326 },   //   149 RWOB
+  { 0x1402, 0x0088,   327 },   //   150 RGYB
+  { 0x1340, 0x0000,     0 },   //   151 GYOB
+  { 0x3251, 0x0000,     0 },   //   152 BWRO
+  { 0x1042, 0x0118,   329 },   //   153 RYGB
+  { 0x3014, 0x0000,     0 },   //   154 YBGO
+  { 0x2531, 0x0000,     0 },   //   155 BOWR
+  { 0x4201, 0x0000,     0 },   //   156 BGRY
+  { 0x4032, 0x0000,     0 },   //   157 ROGY
+  { 0x2431, 0x0000,     0 },   //   158 BOYR
+  { 0x2314, 0x0010,   332 },   //   159 YBOR
+  { 0x5230, 0x0000,     0 },   //   160 GORW
+  { 0x1530, 0x0000,     0 },   //   161 GOWB
+  { 0x1250, 0x0000,     0 },   //   162 GWRB
+  { 0x1205, 0x0000,     0 },   //   163 WGRB
+  { 0x1035, 0x0000,     0 },   //   164 WOGB
+  { 0x5231, 0x0000,     0 },   //   165 BORW
+  { 0x4230, 0x0000,     0 },   //   166 GORY
+  { 0x1532, 0x0000,     0 },   //   167 ROWB
+  { 0x1240, 0x0008,   333 },   //   168 GYRB
+  { 0x1430, 0x0000,     0 },   //   169 GOYB
+  { 0x3204, 0x0000,     0 },   //   170 YGRO
+  { 0x3214, 0x0000,     0 },   //   171 YBRO
+  { 0x4231, 0x0000,     0 },   //   172 BORY
+  { 0x1235, 0x0000,     0 },   //   173 WORB
+  { 0x1204, 0x0000,     0 },   //   174 YGRB
+  { 0x3012, 0x0000,     0 },   //   175 RBGO
+  { 0x2031, 0x0000,     0 },   //   176 BOGR
+  { 0x2310, 0x0010,   334 },   //   177 GBOR
+  { 0x3210, 0x0000,     0 },   //   178 GBRO
+  { 0x5134, 0x0000,     0 },   //   179 YOBW
+  { 0x3154, 0x0010,   335 },   //   180 YWBO
+  { 0x5413, 0x0000,     0 },   //   181 OBYW
+  { 0x4053, 0x0100,   336 },   //   182 OWGY
+  { 0x2453, 0x0040,   337 },   //   183 OWYR
+  { 0x4152, 0x0000,     0 },   //   184 RWBY
+  { 0x4503, 0x0000,     0 },   //   185 OGWY
+  { 0x5104, 0x0000,     0 },   //   186 YGBW
+  { 0x2154, 0x0010,   338 },   //   187 YWBR
+  { 0x5324, 0x0000,     0 },   //   188 YROW
+  { 0x4521, 0x0000,     0 },   //   189 BRWY
+  { 0x3524, 0x0000,     0 },   //   190 YRWO
+  { 0x5024, 0x0000,     0 },   //   191 YRGW
+  { 0x5420, 0x0000,     0 },   //   192 GRYW
+  { 0x4135, 0x0000,     0 },   //   193 WOBY
+  { 0x0451, 0x0110,   339 },   //   194 BWYG
+  { 0x0534, 0x0014,   341 },   //   195 YOWG
+  { 0x2543, 0x0000,     0 },   //   196 OYWR
+  { 0x0354, 0x0000,     0 },   //   197 YWOG
+  { 0x4253, 0x0000,     0 },   //   198 OWRY
+  { 0x4105, 0x0000,     0 },   //   199 WGBY
+  { 0x1425, 0x0000,     0 },   //   200 WRYB
+  { 0x3425, 0x0000,     0 },   //   201 WRYO
+  { 0x4025, 0x0000,     0 },   //   202 WRGY
+  { 0x5243, 0x0000,     0 },   //   203 OYRW
+  { 0x2145, 0x0000,     0 },   //   204 WYBR
+  { 0x0541, 0x0000,     0 },   //   205 BYWG
+  { 0x0435, 0x0000,     0 },   //   206 WOYG
+  { 0x0542, 0x0000,     0 },   //   207 RYWG
+  { 0x2513, 0x0098,   343 },   //   208 OBWR
+  { 0x1053, 0x0800,   346 },   //   209 OWGB
+  { 0x1025, 0x1090,   347 },   //   210 WRGB
+  { 0x1503, 0x0000,     0 },   //   211 OGWB
+  { 0x3152, 0x0400,   350 },   //   212 RWBO
+  { 0x3150, 0x0000,     0 },   //   213 GWBO
+  { 0x2105, 0x0000,     0 },   //   214 WGBR
+  { 0x3025, 0x0900,   351 },   //   215 WRGO
+  { 0x2140, 0x0418,   353 },   //   216 GYBR
+  { 0x3140, 0x0000,     0 },   //   217 GYBO
+  { 0x2053, 0x0000,     0 },   //   218 OWGR
+  { 0x3421, 0x0008,   356 },   //   219 BRYO
+  { 0x4013, 0x0000,     0 },   //   220 OBGY
+  { 0x2503, 0x0000,     0 },   //   221 OGWR
+  { 0x1420, 0x0080,   357 },   //   222 GRYB
+  { 0x1043, 0x0000,     0 },   //   223 OYGB
+  { 0x4320, 0x0000,     0 },   //   224 GROY
+  { 0x3420, 0x0000,     0 },   //   225 GRYO
+  { 0x2043, 0x0000,     0 },   //   226 OYGR
+  { 0x0315, 0x0800,   358 },   //   227 WBOG
+  { 0x1253, 0x0000,     0 },   //   228 OWRB
+  { 0x0512, 0x0000,     0 },   //   229 RBWG
+  { 0x5213, 0x0000,     0 },   //   230 OBRW
+  { 0x2135, 0x0000,     0 },   //   231 WOBR
+  { 0x5130, 0x0000,     0 },   //   232 GOBW
+  { 0x5203, 0x0000,     0 },   //   233 OGRW
+  { 0x0412, 0x0008,   359 },   //   234 RBYG
+  { 0x4132, 0x0100,   360 },   //   235 ROBY
+  { 0x0352, 0x0000,     0 },   //   236 RWOG
+  { 0x0341, 0x0018,   361 },   //   237 BYOG
+  { 0x1243, 0x0000,     0 },   //   238 OYRB
+  { 0x1024, 0x0000,     0 },   //   239 YRGB
+  { 0x4203, 0x0000,     0 },   //   240 OGRY
+  { 0x0342, 0x0000,     0 },   //   241 RYOG
+  { 0x3024, 0x0000,     0 },   //   242 YRGO
+  { 0x0531, 0x0000,     0 },   //   243 BOWG
+  { 0x0251, 0x0000,     0 },   //   244 BWRG
+  { 0x2134, 0x0000,     0 },   //   245 YOBR
+  { 0x0532, 0x0000,     0 },   //   246 ROWG
+  { 0x0314, 0x0000,     0 },   //   247 YBOG
+  { 0x0431, 0x0000,     0 },   //   248 BOYG
+  { 0x0235, 0x0000,     0 },   //   249 WORG
+  { 0x3021, 0x0000,     0 },   //   250 BRGO
+  { 0x1320, 0x0010,   363 },   //   251 GROB
+  { 0x3102, 0x0000,     0 },   //   252 RGBO
+  { 0x2130, 0x0000,     0 },   //   253 GOBR
+  { 0x5124, 0x0000,     0 },   //   254 YRBW
+  { 0x5423, 0x0000,     0 },   //   255 ORYW
+  { 0x4125, 0x0000,     0 },   //   256 WRBY
+  { 0x0453, 0x0000,     0 },   //   257 OWYG
+  { 0x5023, 0x0000,     0 },   //   258 ORGW
+  { 0x4023, 0x0000,     0 },   //   259 ORGY
+  { 0x3125, 0x0400,   364 },   //   260 WRBO
+  { 0x0521, 0x0000,     0 },   //   261 BRWG
+  { 0x0325, 0x0000,     0 },   //   262 WROG
+  { 0x2153, 0x0000,     0 },   //   263 OWBR
+  { 0x4120, 0x0000,     0 },   //   264 GRBY
+  { 0x5103, 0x0000,     0 },   //   265 OGBW
+  { 0x0421, 0x0000,     0 },   //   266 BRYG
+  { 0x0513, 0x0000,     0 },   //   267 OBWG
+  { 0x2143, 0x0000,     0 },   //   268 OYBR
+  { 0x4103, 0x0000,     0 },   //   269 OGBY
+  { 0x0142, 0x0000,     0 },   //   270 RYBG
+  { 0x3124, 0x0000,     0 },   //   271 YRBO
+  { 0x3120, 0x0000,     0 },   //   272 GRBO
+  { 0x0321, 0x0010,   365 },   //   273 BROG
+  { 0x5123, 0x0000,     0 },   //   274 ORBW
+  { 0x4123, 0x0000,     0 },   //   275 ORBY
+  { 0x5430, 0x0000,     0 },   //   276 GOYW
+  { 0x5304, 0x0000,     0 },   //   277 YGOW
+  { 0x5034, 0x0000,     0 },   //   278 YOGW
+  { 0x3504, 0x0000,     0 },   //   279 YGWO
+  { 0x5432, 0x0000,     0 },   //   280 ROYW
+  { 0x5314, 0x0000,     0 },   //   281 YBOW
+  { 0x5402, 0x0000,     0 },   //   282 RGYW
+  { 0x3514, 0x0000,     0 },   //   283 YBWO
+  { 0x4532, 0x0000,     0 },   //   284 ROWY
+  { 0x3452, 0x0000,     0 },   //   285 RWYO
+  { 0x4502, 0x0000,     0 },   //   286 RGWY
+  { 0x5431, 0x0000,     0 },   //   287 BOYW
+  { 0x5401, 0x0000,     0 },   //   288 BGYW
+  { 0x5014, 0x0000,     0 },   //   289 YBGW
+  { 0x4531, 0x0000,     0 },   //   290 BOWY
+  { 0x3451, 0x0000,     0 },   //   291 BWYO
+  { 0x4351, 0x0000,     0 },   //   292 BWOY
+  { 0x4035, 0x0000,     0 },   //   293 WOGY
+  { 0x4250, 0x0000,     0 },   //   294 GWRY
+  { 0x5204, 0x0000,     0 },   //   295 YGRW
+  { 0x2435, 0x0000,     0 },   //   296 WOYR
+  { 0x5234, 0x0000,     0 },   //   297 YORW
+  { 0x4015, 0x0000,     0 },   //   298 WBGY
+  { 0x1450, 0x0000,     0 },   //   299 GWYB
+  { 0x4315, 0x0000,     0 },   //   300 WBOY
+  { 0x5342, 0x0000,     0 },   //   301 RYOW
+  { 0x3254, 0x0000,     0 },   //   302 YWRO
+  { 0x3415, 0x0000,     0 },   //   303 WBYO
+  { 0x5214, 0x0000,     0 },   //   304 YBRW
+  { 0x4251, 0x0000,     0 },   //   305 BWRY
+  { 0x4235, 0x0000,     0 },   //   306 WORY
+  { 0x5241, 0x0000,     0 },   //   307 BYRW
+  { 0x5310, 0x0000,     0 },   //   308 GBOW
+  { 0x3052, 0x0000,     0 },   //   309 RWGO
+  { 0x5302, 0x0000,     0 },   //   310 RGOW
+  { 0x2350, 0x0000,     0 },   //   311 GWOR
+  { 0x3510, 0x0000,     0 },   //   312 GBWO
+  { 0x3502, 0x0000,     0 },   //   313 RGWO
+  { 0x5301, 0x0000,     0 },   //   314 BGOW
+  { 0x2510, 0x0000,     0 },   //   315 GBWR
+  { 0x4302, 0x0000,     0 },   //   316 RGOY
+  { 0x5312, 0x0000,     0 },   //   317 RBOW
+  { 0x4012, 0x0000,     0 },   //   318 RBGY
+  { 0x2401, 0x0000,     0 },   //   319 BGYR
+  { 0x3042, 0x0000,     0 },   //   320 RYGO
+  { 0x4310, 0x0000,     0 },   //   321 GBOY
+  { 0x1350, 0x0000,     0 },   //   322 GWOB
+  { 0x3250, 0x0000,     0 },   //   323 GWRO
+  { 0x5210, 0x0000,     0 },   //   324 GBRW
+  { 0x5201, 0x0000,     0 },   //   325 BGRW
+  { 0x3215, 0x0000,     0 },   //   326 WBRO
+  { 0x3240, 0x0000,     0 },   //   327 GYRO
+  { 0x2304, 0x0000,     0 },   //   328 YGOR
+  { 0x2430, 0x0000,     0 },   //   329 GOYR
+  { 0x4210, 0x0000,     0 },   //   330 GBRY
+  { 0x2014, 0x0000,     0 },   //   331 YBGR
+  { 0x3241, 0x0000,     0 },   //   332 BYRO
+  { 0x2034, 0x0000,     0 },   //   333 YOGR
+  { 0x3201, 0x0000,     0 },   //   334 BGRO
+  { 0x4513, 0x0000,     0 },   //   335 OBWY
+  { 0x5403, 0x0000,     0 },   //   336 OGYW
+  { 0x4150, 0x0000,     0 },   //   337 GWBY
+  { 0x5421, 0x0000,     0 },   //   338 BRYW
+  { 0x5140, 0x0000,     0 },   //   339 GYBW
+  { 0x0514, 0x0000,     0 },   //   340 YBWG
+  { 0x5142, 0x0000,     0 },   //   341 RYBW
+  { 0x5043, 0x0000,     0 },   //   342 OYGW
+  { 0x5021, 0x0000,     0 },   //   343 BRGW
+  { 0x5321, 0x0000,     0 },   //   344 BROW
+  { 0x1520, 0x0000,     0 },   //   345 GRWB
+  { 0x5013, 0x0000,     0 },   //   346 OBGW
+  { 0x2150, 0x0000,     0 },   //   347 GWBR
+  { 0x3521, 0x0000,     0 },   //   348 BRWO
+  { 0x1325, 0x0000,     0 },   //   349 WROB
+  { 0x5102, 0x0000,     0 },   //   350 RGBW
+  { 0x5320, 0x0000,     0 },   //   351 GROW
+  { 0x3520, 0x0000,     0 },   //   352 GRWO
+  { 0x4321, 0x0000,     0 },   //   353 BROY
+  { 0x4021, 0x0000,     0 },   //   354 BRGY
+  { 0x3142, 0x0000,     0 },   //   355 RYBO
+  { 0x4102, 0x0000,     0 },   //   356 RGBY
+  { 0x2413, 0x0000,     0 },   //   357 OBYR
+  { 0x0351, 0x0000,     0 },   //   358 BWOG
+  { 0x4130, 0x0000,     0 },   //   359 GOBY
+  { 0x4213, 0x0000,     0 },   //   360 OBRY
+  { 0x2104, 0x0000,     0 },   //   361 YGBR
+  { 0x3104, 0x0000,     0 },   //   362 YGBO
+  { 0x2013, 0x0000,     0 },   //   363 OBGR
+  { 0x5120, 0x0000,     0 },   //   364 GRBW
+  { 0x2103, 0x0000,     0 },   //   365 OGBR
+};
+
+#endif /* BOOK_HINTS || GAME_ANALYSIS */
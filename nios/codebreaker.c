@@ -21,88 +21,191 @@
 #include "nios_std_types.h"         // for standard embedded types
 #include "system.h"                 // for Qsys defines
 
+#include "analysis.h"
+#include "book.h"
+#include "defer.h"
+#include "display_if.h"
+#include "hw_access.h"
+#include "latency.h"
 #include "lfsr_if.h"
+#include "msglog.h"
 #include "pio_if.h"
+#include "session_rec.h"
 #include "timer_if.h"
 #include "uart_if.h"
 #include "utilities.h"
 
 #include "codebreaker.h"
 
+// Newline fragment, for ending messages built with uart_SendV
+static const uart_frag_t _newline = UART_CONST("\n");
 
+// Taunts for a wrong guess
+static const uart_frag_t _taunts[4] =
+{
+  UART_CONST(CB_NOTRIGHT1),
+  UART_CONST(CB_NOTRIGHT2),
+  UART_CONST(CB_NOTRIGHT3),
+  UART_CONST(CB_NOTRIGHT4)
+};
 
 //-------------------------------------------------------------------------
 // NAME:        check_guess
 //
-// DESCRIPTION: Checks each character in the guess to determine if it is
-//              in the actual secret code, and if so, whether it is in the
-//              right position.
+// DESCRIPTION: Checks each color in the guess to determine if it is in
+//              the actual secret code, and if so, whether it is in the
+//              right position.  Each secret position answers for at most
+//              one guess color: the one in the same position if they
+//              match, otherwise the first unanswered one of its color.  So
+//              a color repeated in the guess earns no more hints than the
+//              secret has of it.
 // ARGUMENTS:
-//    secret  uint8*  pointer to the secret code (null-terminated string)
-//    guess   uint8*  pointer to the user's guess (null-terminated string)
-//    hint    uint8*  pointer to a place to put the guess (again, string)
+//    secret  uint32  the secret code, packed
+//    guess   uint32  the user's guess, packed as by uart_RecvCode
+//    length  uint32  number of colors in the guess
+//    hint    uint8*  pointer to a place to put the hint (a string, one
+//                    P or C per guess color, in guess order)
 // RETURNS:
 //    uint32  TRUE or FALSE depending on whether they're a winner
 //-------------------------------------------------------------------------
-uint32 check_guess(uint8* secret, uint8* guess, uint8* hint)
+uint32 check_guess(uint32 secret, uint32 guess, uint32 length, uint8* hint)
 {
-  uint32  result  = FALSE;    /* end result */
-  uint32  got_p   = FALSE;
-  uint32  got_c   = FALSE;
+  uint32  exact = 0;          /* colors in the right position */
+  uint32  used  = 0;          /* secret positions already answered */
+  uint32  color;
 
   // Indices for loops
   uint32  secret_idx;
   uint32  guess_idx;
   uint32  hint_idx = 0;
 
-  for (guess_idx = 0; guess_idx < CB_COLOR_LENGTH; guess_idx++)
+  // Exact matches first, so they can't be taken as C by an earlier guess
+  // color of the same color
+  for (guess_idx = 0; guess_idx < length; guess_idx++)
   {
-    if (NULL == guess[guess_idx])
+    if (CODE_SLOT(guess, guess_idx) == CODE_SLOT(secret, guess_idx))
     {
-      // we're out of characters on the input
-      result = FALSE;
-      hint[hint_idx] = NULL;
-      break;
-    } /* if null */
+      used |= 1 << guess_idx;
+    } /* if */
+  } /* for guess_idx */
+
+  for (guess_idx = 0; guess_idx < length; guess_idx++)
+  {
+    color = CODE_SLOT(guess, guess_idx);
+    if (color == CODE_SLOT(secret, guess_idx))
+    {
+      // in the correct position!
+      hint[hint_idx++] = 'P';
+      exact++;
+      continue;
+    } /* if position */
     for (secret_idx = 0; secret_idx < CB_COLOR_LENGTH; secret_idx++)
     {
-      if (NULL == secret[secret_idx])
-      {
-        // this is a big problem...
-        uart_SendString((uint8*)"secret too short?  aborting check_guess\n");
-        return FALSE;
-      } /* if on fire */
-      if (guess[guess_idx] == secret[secret_idx])
+      if (0 == (used & (1 << secret_idx)) &&
+          color == CODE_SLOT(secret, secret_idx))
       {
-        // we have a match!
-        if (guess_idx == secret_idx)
-        {
-          // in the correct position!
-          hint[hint_idx++] = 'P';
-          got_p = TRUE;
-        } /* if position */
-        else
-        {
-          // not in the correct position!
-          hint[hint_idx++] = 'C';
-          got_c = TRUE;
-        } /* else */
+        // not in the correct position!
+        hint[hint_idx++] = 'C';
+        used |= 1 << secret_idx;
+        break;
       } /* if match */
     } /* for secret_idx */
   } /* for guess_idx */
 
-  if (got_p && !got_c && (CB_COLOR_LENGTH == hint_idx))
-  {
-    // We have a winner!
-    result = TRUE;
-  } /* if winner */
-
   // null-terminate the hint string
   hint[hint_idx] = NULL;
 
-  return result;
+  // We have a winner if every color was in place
+  return (CB_COLOR_LENGTH == exact);
 } /* check_guess */
 
+//-------------------------------------------------------------------------
+// NAME:        filter_candidates
+//
+// DESCRIPTION: Drops the codes that a guess's score rules out from the
+//              set of codes that could still be the secret, and counts
+//              what is left.  The set has a bit per code, numbered as by
+//              code_from_index; a guess costs CB_CODES scores.
+// ARGUMENTS:
+//    set     uint32* the set, CB_CANDIDATE_WORDS words
+//    guess   uint32  a complete guess, as a code
+//    score   uint32  its score, as from score_code
+// RETURNS:     uint32, number of codes left
+//-------------------------------------------------------------------------
+uint32 filter_candidates(uint32* set, uint32 guess, uint32 score)
+{
+  uint32  left = 0;
+  uint32  index;
+
+  for (index = 0; index < CB_CODES; index++)
+  {
+    if (0 == (set[index >> 5] & (1 << (index & 31))))
+    {
+      continue;
+    } /* if gone already */
+    if (score_code(code_from_index(index), guess) == score)
+    {
+      left++;
+    } /* if still possible */
+    else
+    {
+      set[index >> 5] &= ~(1 << (index & 31));
+    } /* else */
+  } /* for index */
+
+  return left;
+} /* filter_candidates */
+
+#ifdef GAME_ANALYSIS
+//-------------------------------------------------------------------------
+// NAME:        report_analysis
+//
+// DESCRIPTION: Sends the post-game analysis of the player's guesses,
+//              and how long it took the CPU to work out.
+// ARGUMENTS:
+//    secret  uint32  the secret code
+//    guesses uint32* the player's guesses, as codes
+//    count   uint32  number of guesses
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void report_analysis(uint32 secret, uint32* guesses, uint32 count)
+{
+  static analysis_step_t steps[ANALYSIS_MAX_GUESSES];
+  uint8   line[ANALYSIS_LINE_LENGTH];
+  uint8*  end;
+  uint32  hits   = analysis_cache_hits;
+  uint32  misses = analysis_cache_misses;
+  uint32  cycles;
+  uint32  i;
+
+  if (0 == count)
+  {
+    return;     // nothing to say
+  } /* if */
+
+  cycles = timer_timestamp();
+  count  = analysis_game(secret, guesses, count, steps);
+  cycles = timer_timestamp() - cycles;
+  UART_SEND_CONST(CB_ANALYSIS);
+  UART_SEND_CONST(ANALYSIS_HEADING);
+  for (i = 0; i < count; i++)
+  {
+    analysis_format(&steps[i], i + 1, line);
+    uart_SendString(line);
+  } /* for i */
+
+  end = put_string(line, "Analyzed in ");
+  end = put_number(end, cycles / (ALT_CPU_FREQ / 1000000), 8, ' ');
+  end = put_string(end, " us; ranked ");
+  end = put_number(end, analysis_cache_misses - misses, 4, ' ');
+  end = put_string(end, ", cached ");
+  end = put_number(end, analysis_cache_hits - hits, 4, ' ');
+  end = put_string(end, "\n");
+  *end = '\0';
+  uart_SendString(line);
+} /* report_analysis */
+#endif /* GAME_ANALYSIS */
+
 //-------------------------------------------------------------------------
 // NAME:        game_loop
 //
@@ -115,27 +218,65 @@ void game_loop()
 {
   uint32  secret_code;
   uint8   secret_code_str[CB_COLOR_LENGTH+1];
-  uint8   input_str[UART_RECVBUFFER];
+  uint32  guess_code;
+  uint32  guess_length;
+  uint8   guess_str[CB_COLOR_LENGTH+1];
   uint8   hint_str[CB_COLOR_LENGTH+1];
 
   uint32  loser = FALSE;
   uint32  winner = FALSE;
+  uint32  guesses = 0;
+
+  // Codes the hints so far leave possible, for HEX7..HEX4
+  uint32  candidates[CB_CANDIDATE_WORDS];
+  uint32  candidates_left = CB_CODES;
+
+  // Pieces of the message being sent; each reply goes out in one call
+  uart_frag_t reply[8];
+  uint32      parts;
+
+  #ifdef BOOK_HINTS
+    uint32  book_node = BOOK_ROOT;    // BOOK_NONE once off the book
+    uint8   book_str[CB_COLOR_LENGTH+1];
+  #endif /* BOOK_HINTS */
+
+  #ifdef GAME_ANALYSIS
+    uint32  guess_codes[ANALYSIS_MAX_GUESSES];
+    uint32  analyzed = 0;
+  #endif /* GAME_ANALYSIS */
+
+  #ifdef IRQ_LATENCY
+    uint8   input_str[UART_RECVBUFFER];
+  #endif /* IRQ_LATENCY */
 
   // Clear strings
   memset(secret_code_str, 0, sizeof(secret_code_str));
-  memset(input_str, 0, sizeof(input_str));
+  memset(guess_str, 0, sizeof(guess_str));
   memset(hint_str, 0, sizeof(hint_str));
+  memset(candidates, 0xFF, sizeof(candidates));
 
   // Set the UART mode to MAIN
   uart_SetMode(UART_MAINMODE);
 
   // Announce that a new game is starting
-  uart_SendString((uint8*)CB_NEWGAME);
+  UART_SEND_CONST(CB_NEWGAME);
 
   // Wait for key1 press
+  CPU_TRACE_STATE("waiting for KEY1");
   pio_key_pressed(1); // clear it
-  uart_SendString((uint8*)CB_PRESSKEY1);
-  while (!pio_key_pressed(1));
+  UART_SEND_CONST(CB_PRESSKEY1);
+  while (!pio_key_pressed(1))
+  {
+    #ifdef IRQ_LATENCY
+      if (uart_RecvString(input_str) &&
+          0 == strcmp((char*)input_str, CB_LATENCY))
+      {
+        latency_report();
+      } /* if */
+    #endif /* IRQ_LATENCY */
+    defer_run();
+    CPU_IDLE();
+  } /* while */
 
   // Clear LEDs
   pio_leds_update(FALSE, FALSE);
@@ -144,41 +285,61 @@ void game_loop()
   secret_code = generate_secret_code();
   #ifdef CHEAT_MODE
     // If we're under development, simply output the secret number...
-    uart_SendString((uint8*)"Today's secret number is: ");
     to_colorstr(secret_code, (uint8*)secret_code_str);
-    uart_SendString((uint8*)secret_code_str);
-    uart_SendString((uint8*)"!\n");
+    reply[0] = (uart_frag_t)UART_CONST("Today's secret number is: ");
+    reply[1] = UART_FRAG(secret_code_str, CB_COLOR_LENGTH);
+    reply[2] = (uart_frag_t)UART_CONST("!\n");
+    uart_SendV(reply, 3);
   #endif /* CHEAT_MODE */
 
   // Start game by notifying user, switching to game input mode, and
   // starting the countdown timer.
-  uart_SendString((uint8*)CB_GAMESTART);
+  parts = 0;
+  reply[parts++] = (uart_frag_t)UART_CONST(CB_GAMESTART);
+  #ifdef BOOK_HINTS
+    to_colorstr(book_nodes[book_node].guess, book_str);
+    reply[parts++] = (uart_frag_t)UART_CONST(CB_BOOKHINT);
+    reply[parts++] = UART_FRAG(book_str, CB_COLOR_LENGTH);
+    reply[parts++] = _newline;
+  #endif /* BOOK_HINTS */
+  uart_SendV(reply, parts);
   uart_SetMode(UART_GAMEMODE);
+  display_guesses(0);
+  display_candidates(convert_to_bcd((uint16)candidates_left));
+  display_enable(DISPLAY_GUESSES_DIGITS | DISPLAY_CANDIDATES_DIGITS, TRUE);
   timer_countdown_start(CB_COUNTDOWN_TIME);
+  CPU_TRACE_STATE("playing");
 
   // Main gameplay loop
   while (!winner && !loser)
   {
     // Clear the input
-    memset(input_str, 0, sizeof(input_str));
+    guess_code = 0;
+    guess_length = 0;
 
     // Display the prompt
-    uart_SendString((uint8*)CB_PROMPT);
+    UART_SEND_CONST(CB_PROMPT);
 
     // Wait for something to happen...
     while(1)
     {
-      // check for incoming stuff from the UART
-      uart_RecvString(input_str);
+      // do whatever the ISRs left for us (echoing what's typed)
+      defer_run();
 
-      // strip down to 
+      // check for incoming stuff from the UART; the ISR has already
+      // packed it
+      uart_RecvCode(&guess_code, &guess_length);
 
       // check for key 2
       if (pio_key_pressed(2))
       {
-        uart_SendString((uint8*)CB_YOUGUESSED);
-        uart_SendString(input_str);
-        uart_SendString((uint8*)"\n");
+        guesses++;
+        display_guesses(convert_to_bcd((uint16)guesses));
+        to_colorstr(guess_code, guess_str);
+        reply[0] = (uart_frag_t)UART_CONST(CB_YOUGUESSED);
+        reply[1] = UART_FRAG(guess_str, guess_length);
+        reply[2] = _newline;
+        uart_SendV(reply, 3);
         break;
       } /* if key 2 pressed */
 
@@ -189,39 +350,74 @@ void game_loop()
         loser = TRUE;
         break;
       } /* if timer_expired */
+
+      CPU_IDLE();
     } /* while idle */
 
     if(!loser)
     {
-      winner = check_guess((uint8*)secret_code_str, (uint8*)input_str,
+      #ifdef GAME_ANALYSIS
+        // keep every complete guess for the report
+        if (analyzed < ANALYSIS_MAX_GUESSES &&
+            CB_COLOR_LENGTH == guess_length)
+        {
+          guess_codes[analyzed++] = guess_code;
+        } /* if */
+      #endif /* GAME_ANALYSIS */
+
+      CPU_TRACE_BEGIN("check_guess");
+      winner = check_guess(secret_code, guess_code, guess_length,
                            (uint8*)hint_str);
+      CPU_TRACE_END("check_guess");
+
+      // only a complete guess rules codes out
+      if (CB_COLOR_LENGTH == guess_length)
+      {
+        CPU_TRACE_BEGIN("filter_candidates");
+        candidates_left = filter_candidates(candidates, guess_code,
+                                            score_code(secret_code,
+                                                       guess_code));
+        CPU_TRACE_END("filter_candidates");
+        display_candidates(convert_to_bcd((uint16)candidates_left));
+      } /* if */
       if(!winner)
       {
-        // Demoralize the opponent
-        switch (lfsr_rand() % 4)
-        {
-          case 0:
-            uart_SendString((uint8*)CB_NOTRIGHT1);
-            break;
-          case 1:
-            uart_SendString((uint8*)CB_NOTRIGHT2);
-            break;
-          case 2:
-            uart_SendString((uint8*)CB_NOTRIGHT3);
-            break;
-          case 3:
-            uart_SendString((uint8*)CB_NOTRIGHT4);
-            break;
-          default:
-            // This shouldn't happen with mod 4......
-            uart_SendString((uint8*)"Bank error in your favor, collect $200.\n");
-            break;
-        } /* switch */
-
-        // Display a hint
-        uart_SendString((uint8*)CB_YOURHINT);
-        uart_SendString((uint8*)hint_str);
-        uart_SendString((uint8*)"\n");
+        // Demoralize the opponent, and display a hint
+        parts = 0;
+        reply[parts++] = _taunts[lfsr_rand_below(4)];
+        reply[parts++] = (uart_frag_t)UART_CONST(CB_YOURHINT);
+        reply[parts++] = UART_FRAG(hint_str, strlen((char*)hint_str));
+        reply[parts++] = _newline;
+
+        #ifdef BOOK_HINTS
+          // The book only knows where its own guesses lead
+          if (BOOK_NONE == book_node)
+          {
+            // already off the book
+          } /* if */
+          else if (CB_COLOR_LENGTH != guess_length ||
+                   guess_code != book_nodes[book_node].guess)
+          {
+            book_node = BOOK_NONE;
+            reply[parts++] = (uart_frag_t)UART_CONST(CB_OFFBOOK);
+          } /* else if off the book */
+          else
+          {
+            CPU_TRACE_BEGIN("book_next");
+            book_node = book_next(book_nodes, book_node,
+                                  score_code(secret_code,
+                                             book_nodes[book_node].guess));
+            CPU_TRACE_END("book_next");
+            if (BOOK_NONE != book_node)
+            {
+              to_colorstr(book_nodes[book_node].guess, book_str);
+              reply[parts++] = (uart_frag_t)UART_CONST(CB_BOOKHINT);
+              reply[parts++] = UART_FRAG(book_str, CB_COLOR_LENGTH);
+              reply[parts++] = _newline;
+            } /* if */
+          } /* else on the book */
+        #endif /* BOOK_HINTS */
+        uart_SendV(reply, parts);
 
       } /* if !winner */
     } /* if !loser */
@@ -231,19 +427,39 @@ void game_loop()
   pio_leds_update(loser, winner);
   if(loser)
   {
+    CPU_TRACE_STATE("lost");
     timer_countdown_stop();
-    uart_SendString((uint8*)CB_TIME_EXPIRED);
+    UART_SEND_CONST(CB_TIME_EXPIRED);
   } /* if loser */
   else if (winner)
   {
+    CPU_TRACE_STATE("won");
     timer_countdown_stop();
-    uart_SendString((uint8*)CB_WINNER);
+    UART_SEND_CONST(CB_WINNER);
   } /* if winner */
   else
   {
     // ??  We shouldn't be here.
-    uart_SendString((uint8*)"Error: you have neither won nor lost.");
+    #ifdef MSG_LOG
+      MSGLOG(MSG_NO_RESULT, guesses, 0);
+    #else
+      UART_SEND_CONST("Error: you have neither won nor lost.");
+    #endif /* MSG_LOG */
   } /* else */
+
+  #ifdef GAME_ANALYSIS
+    report_analysis(secret_code, guess_codes, analyzed);
+  #endif /* GAME_ANALYSIS */
+
+  #ifdef SESSION_RECORD
+    // Dump everything needed to replay the session so far
+    rec_dump();
+  #endif /* SESSION_RECORD */
+
+  #ifdef MSG_LOG
+    // ... and any diagnostics logged meanwhile
+    msglog_dump();
+  #endif /* MSG_LOG */
 } /* game_loop */
 
 //-------------------------------------------------------------------------
@@ -256,28 +472,46 @@ void game_loop()
 //-------------------------------------------------------------------------
 int main()
 {
+  // The instructions, in pieces
+  uart_frag_t text[3];
+
   // System initialization tasks
+  CPU_TRACE_STATE("init");
   //
+  // Session recorder (first, so that it sees the seed)
+  #ifdef SESSION_RECORD
+    rec_init();
+  #endif /* SESSION_RECORD */
   // Linear Feedback Shift Register PRNG
   // (Seed with the Qsys build timestamp)
   lfsr_rand_init((uint16)SYSID_QSYS_0_TIMESTAMP);
-  // Peripheral I/O initialization
-  pio_init();
+  // Display initialization
+  display_init();
+  // Game analysis tables
+  #ifdef GAME_ANALYSIS
+    analysis_init();
+  #endif /* GAME_ANALYSIS */
   // Timer initialization
   timer_init();
+  // Peripheral I/O initialization (after the timers, which debounce the
+  // keys)
+  pio_init();
   // UART initialization
   uart_init();
 
   // Set up a known initial state
   //
-  // Shut off the seven-segment displays and LEDs
-  pio_ssd_update(0, FALSE);
+  // Shut off the LEDs (display_init has blanked the displays)
   pio_leds_update(FALSE, FALSE);
   // Stop the timer, which shouldn't be running anyway
   timer_countdown_stop();
   // Send the greeting to the user
-  uart_SendString((uint8*)CB_WELCOME);
-  uart_SendString((uint8*)CB_INSTRUCTIONS);
+  UART_SEND_CONST(CB_WELCOME);
+  // (the instructions name the colors from the table the ISR uses)
+  text[0] = (uart_frag_t)UART_CONST(CB_INSTRUCTIONS);
+  text[1] = UART_FRAG(color_list, strlen((char*)color_list));
+  text[2] = (uart_frag_t)UART_CONST(CB_INSTRUCTIONS_END);
+  uart_SendV(text, 3);
 
   // Play the game.  Check for LFSR validity while doing so, to ensure that
   // we have a random initial state...
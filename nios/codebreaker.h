@@ -26,10 +26,68 @@
 //             the start of the game.  (Pretty much the ultimate cheat...)
 #define CHEAT_MODE
 
+// Session recording: if defined, every input the game depends on is
+//             logged, and the log is dumped over the UART at the end of
+//             each game so that it can be replayed on the host.  The log
+//             runs from boot, as the replay does, and its 2 KB buffer
+//             (REC_BUFFER_SIZE) holds only a few games; once it fills,
+//             every dump is TRUNCATED.  Define it to record a session,
+//             and reset the board first.  Host replay builds define it.
+//#define SESSION_RECORD
+
+// Message log: if defined, diagnostics are logged as numbered messages
+//             with raw arguments (see msglog.c) rather than sent as text,
+//             and the log is dumped at the end of each game for
+//             host/msglog_decode to render.  The ring (MSGLOG_SIZE
+//             entries of 16 bytes) takes 512 bytes of RAM, against the
+//             couple of hundred bytes of text it keeps off the chip; its
+//             code size on the board has not been measured, so it is off
+//             by default.
+//#define MSG_LOG
+
+// Book hints: if defined, the next guess of a precomputed strategy (see
+//             book.c) is suggested after every hint, for as long as the
+//             player keeps following it.  The table (book_table.c) is
+//             2196 bytes of on-chip memory at the default width; it is
+//             off by default until its cost on the board is measured.
+//#define BOOK_HINTS
+
+// Game analysis: if defined, each game ends with a report comparing the
+//             player's guesses with the best play (see analysis.c).  Its
+//             tables take about 3.1 KB of RAM, and it needs the opening
+//             book (2196 bytes) as well; it is off by default.  The
+//             report ends with how long the CPU took to work it out.
+//#define GAME_ANALYSIS
+
+// Repeated colors: if defined, the secret may use a color more than once,
+//             as in classic Mastermind.  The opening book has to be
+//             regenerated to match (see host/gen_book.c).
+//#define REPEAT_COLORS
+
+// Custom scoring: if defined, score_code is the score_ci custom
+//             instruction (see score_if.h and vhdl/score_ci.vhd) in
+//             firmware built for the board.  Host tools always score in
+//             software.  It is off until score_ci_0 has been synthesized
+//             into the board's system and the BSP regenerated from it.
+//#define SCORE_CUSTOM
+
+// Interrupt latency: if defined, the ISRs measure how late they run (see
+//             latency.c), and typing LAT before pressing KEY1 prints the
+//             histograms.  A one-second software timer runs as a probe.
+//#define IRQ_LATENCY
+
 // Magic numbers
 #define CB_COLOR_LENGTH 4       // Number of colors in the code
 #define CB_POSSIBLE_COLORS 6    // Number of colors available
+#define CB_COLOR_LETTERS "GBROYW"   // The colors' letters, color 0 first;
+                                    // rerun host/gen_colors after changing
 #define CB_COUNTDOWN_TIME 60    // How long the user gets to play
+#ifdef REPEAT_COLORS
+#define CB_CODES 1296           // Number of codes (6 * 6 * 6 * 6)
+#else
+#define CB_CODES 360            // Number of codes (6 * 5 * 4 * 3)
+#endif
+#define CB_CANDIDATE_WORDS ((CB_CODES + 31) / 32) // Words for a bit per code
 
 // Messages
 #define CB_WELCOME "\n" \
@@ -59,7 +117,9 @@
   "\n" \
   "   HOW TO DO IT:\n" \
   "     1. Enter a four-letter code at the GUESS> prompt, and hit Enter.\n" \
-  "         Valid letters are: G, B, R, O, Y, W\n" \
+  "         Valid letters are: "
+// (color_list, from color_table.c, goes here)
+#define CB_INSTRUCTIONS_END "\n" \
   "     2. Press KEY2 to try to open the door.\n" \
   "     3. If the door doesn't open, you'll get a hint:\n" \
   "         GUESS> ROYG\n" \
@@ -84,6 +144,10 @@
 #define CB_NOTRIGHT3 "Close only counts in horseshoes and hand grenades, but not here.  Guess again.\n"
 #define CB_NOTRIGHT4 "One thing is for sure: You did not guess the code.\n"
 #define CB_YOURHINT  "Your hint is: "
+#define CB_BOOKHINT  "The book says to try: "
+#define CB_ANALYSIS  "\nHow you played (par is how many guesses the best play needed):\n"
+#define CB_LATENCY   "LAT"      // Command that prints latency statistics
+#define CB_OFFBOOK   "You're off the book now.  You're on your own!\n"
 #define CB_TIME_EXPIRED "\n" \
         "--------------------------------------------------------------\n" \
         "                      YOU WERE TOO SLOW!\n" \
@@ -0,0 +1,69 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  color_table.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Color alphabet tables for the UART driver and utilities.c.
+//    GENERATED by host/gen_colors from CB_COLOR_LETTERS ("GBROYW"); do
+//    not edit.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_* defines
+#include "utilities.h"        // for CC_*
+
+#if (6 != CB_POSSIBLE_COLORS)
+#error "color_table.c is out of date; rerun host/gen_colors"
+#endif
+
+const uint8 color_letters[] = "GBROYW";
+
+const uint8 color_list[] = "G, B, R, O, Y, W";
+
+// CC_* class of each byte
+const uint8 color_class[256] =
+{
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x00
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x08
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x10
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x18
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // 0x20  !"#$%&'
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // 0x28 ()*+,-./
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // 0x30 01234567
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // 0x38 89:;<=>?
+  0x20, 0x20, 0x31, 0x20, 0x20, 0x20, 0x20, 0x30,   // 0x40 @ABCDEFG
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x33,   // 0x48 HIJKLMNO
+  0x20, 0x20, 0x32, 0x20, 0x20, 0x20, 0x20, 0x35,   // 0x50 PQRSTUVW
+  0x20, 0x34, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,   // 0x58 XYZ[\]^_
+  0x20, 0x60, 0x71, 0x60, 0x60, 0x60, 0x60, 0x70,   // 0x60 `abcdefg
+  0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x73,   // 0x68 hijklmno
+  0x60, 0x60, 0x72, 0x60, 0x60, 0x60, 0x60, 0x75,   // 0x70 pqrstuvw
+  0x60, 0x74, 0x60, 0x20, 0x20, 0x20, 0x20, 0x00,   // 0x78
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x80
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x88
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x90
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0x98
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xa0
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xa8
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xb0
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xb8
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xc0
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xc8
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xd0
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xd8
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xe0
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xe8
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xf0
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // 0xf8
+};
@@ -0,0 +1,119 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  defer.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Deferred work.  An ISR that has something slow to do (anything that
+//    can wait on the UART, say) posts a function and an argument here
+//    instead, and the main loop runs it from defer_run when it is next
+//    idle.  That keeps every ISR short and bounded.
+//
+//    The queue is a ring with one writer and one reader: ISRs post to
+//    the head and the main loop takes from the tail, and neither needs to
+//    lock the other out.  The HAL doesn't nest interrupts, so ISRs can't
+//    race each other for the head.  Work is only posted from interrupt
+//    context; the main loop can just do its own work.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "hw_access.h"        // for CPU_BARRIER
+#include "timer_if.h"         // for timer_timestamp
+#include "msglog.h"           // for MSGLOG
+#include "defer.h"
+
+// One queued piece of work
+typedef struct
+{
+  defer_func_t  func;
+  uint32        arg;
+  uint32        posted;       // timer_timestamp when it was posted
+} _defer_item_t;
+
+static _defer_item_t    _defer_queue[DEFER_QUEUE_SIZE];
+static volatile uint32  _defer_head;    // next slot posted to (ISRs)
+static volatile uint32  _defer_tail;    // next slot run (main loop)
+
+uint32 defer_posted;
+uint32 defer_dropped;
+uint32 defer_max_depth;
+uint32 defer_max_delay;
+
+//-------------------------------------------------------------------------
+// NAME:        defer_post
+//
+// DESCRIPTION: Queues work for the main loop.  Call only from an ISR.
+// ARGUMENTS:   defer_func_t func, function to call later
+//              uint32 arg, its argument
+// RETURNS:     uint32, TRUE if queued, FALSE if the queue was full and
+//              the work was dropped
+//-------------------------------------------------------------------------
+uint32 defer_post(defer_func_t func, uint32 arg)
+{
+  _defer_item_t* item;
+  uint32         depth = _defer_head - _defer_tail;
+
+  if (depth >= DEFER_QUEUE_SIZE)
+  {
+    defer_dropped++;
+    MSGLOG(MSG_DEFER_FULL, (uint32)(unsigned long)func, arg);
+    return FALSE;
+  } /* if full */
+
+  item         = &_defer_queue[_defer_head % DEFER_QUEUE_SIZE];
+  item->func   = func;
+  item->arg    = arg;
+  item->posted = timer_timestamp();
+  CPU_BARRIER();
+  _defer_head++;          // publish it only once it's filled in
+
+  defer_posted++;
+  if (depth + 1 > defer_max_depth)
+  {
+    defer_max_depth = depth + 1;
+  } /* if */
+  return TRUE;
+} /* defer_post */
+
+//-------------------------------------------------------------------------
+// NAME:        defer_run
+//
+// DESCRIPTION: Runs the queued work, oldest first, including anything
+//              posted while it runs.  Call from the main loop only.
+// ARGUMENTS:   None
+// RETURNS:     uint32, number of items run
+//-------------------------------------------------------------------------
+uint32 defer_run()
+{
+  _defer_item_t* item;
+  uint32         delay;
+  uint32         count = 0;
+
+  while (_defer_tail != _defer_head)
+  {
+    CPU_BARRIER();        // read the slot only after the head
+    item  = &_defer_queue[_defer_tail % DEFER_QUEUE_SIZE];
+    delay = timer_timestamp() - item->posted;
+    if (delay > defer_max_delay)
+    {
+      defer_max_delay = delay;
+    } /* if */
+
+    item->func(item->arg);
+    CPU_BARRIER();
+    _defer_tail++;        // only now may the slot be reused
+    count++;
+  } /* while */
+
+  return count;
+} /* defer_run */
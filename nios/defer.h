@@ -0,0 +1,41 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  defer.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for defer.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_DEFER__H
+#define __LAB_7_DEFER__H
+
+#include "nios_std_types.h"   // standard data types
+
+// Work items that can wait at once (a power of two)
+#define   DEFER_QUEUE_SIZE        64
+
+// Work to be done later, in the main loop
+typedef void (*defer_func_t)(uint32 arg);
+
+// Statistics
+extern uint32 defer_posted;       // items posted
+extern uint32 defer_dropped;      // ... and lost to a full queue
+extern uint32 defer_max_depth;    // most items waiting at once
+extern uint32 defer_max_delay;    // longest wait to be run, in cycles
+
+// Prototypes for public functions
+uint32 defer_post(defer_func_t func, uint32 arg);
+uint32 defer_run();
+
+#endif /* __LAB_7_DEFER__H */
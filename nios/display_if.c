@@ -0,0 +1,129 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  display_if.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    This file implements hardware abstraction functions for the
+//    eight-digit display controller in the Game System design of lab 7.
+//
+//    Each field of the display is written with a single byte or halfword
+//    store, which the controller applies to just those digits, so fields
+//    can be updated from ISRs and the main loop without any locking.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // BSP-provided definitions
+#include <sys/alt_irq.h>      // interrupt-related prototypes
+
+#include "hw_access.h"        // register access macros
+#include "display_if.h"       // defines and constants for hw interfacing
+
+// display controller register pointer
+volatile uint32* display = (uint32*)DISPLAY_0_BASE;
+
+// shadow of the enable byte, which is shared between fields
+uint32  _display_enabled;
+
+//-------------------------------------------------------------------------
+// NAME:        display_write
+//
+// DESCRIPTION: Replaces all eight digits in one bus write.
+// ARGUMENTS:   uint32 digits, HEXn shows bits 4n+3..4n
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void display_write(uint32 digits)
+{
+  REG_WRITE(display + DISPLAY_REG_DIGITS, digits);
+  return;
+} /* display_write */
+
+//-------------------------------------------------------------------------
+// NAME:        display_guesses, display_candidates
+//
+// DESCRIPTION: Update one field of the display.  Values are BCD (or any
+//              hex digits); no conversion is done here.
+// ARGUMENTS:   uint32 bcd, digits to show (2 and 4 digits)
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void display_guesses(uint32 bcd)
+{
+  REG_WRITE((volatile uint8*)display + DISPLAY_GUESSES, (uint8)bcd);
+  return;
+} /* display_guesses */
+
+void display_candidates(uint32 bcd)
+{
+  REG_WRITE((volatile uint16*)((volatile uint8*)display +
+                               DISPLAY_CANDIDATES), (uint16)bcd);
+  return;
+} /* display_candidates */
+
+//-------------------------------------------------------------------------
+// NAME:        display_enable
+//
+// DESCRIPTION: Lights or blanks a set of displays, leaving the rest as
+//              they are.  Safe to call from ISRs.
+// ARGUMENTS:   uint32 mask, displays to change (bit n = HEXn)
+//              uint32 enable, TRUE to light them, FALSE to blank them
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void display_enable(uint32 mask, uint32 enable)
+{
+  alt_irq_context irq_context;
+
+  irq_context = alt_irq_disable_all();
+  if (enable)
+  {
+    _display_enabled |= mask;
+  } /* if */
+  else
+  {
+    _display_enabled &= ~mask;
+  } /* else */
+  REG_WRITE((volatile uint8*)display + DISPLAY_CONTROL_ENABLE,
+            (uint8)_display_enabled);
+  alt_irq_enable_all(irq_context);
+
+  return;
+} /* display_enable */
+
+//-------------------------------------------------------------------------
+// NAME:        display_bank
+//
+// DESCRIPTION: Selects the special glyph bank (see seven_segment.vhd) on
+//              a set of displays.
+// ARGUMENTS:   uint32 mask, bit n set to use the special bank on HEXn
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void display_bank(uint32 mask)
+{
+  REG_WRITE((volatile uint8*)display + DISPLAY_CONTROL_BANK, (uint8)mask);
+  return;
+} /* display_bank */
+
+//-------------------------------------------------------------------------
+// NAME:        display_init
+//
+// DESCRIPTION: Blanks every display and clears the digits.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void display_init()
+{
+  _display_enabled = 0;
+  REG_WRITE(display + DISPLAY_REG_CONTROL, 0);
+  REG_WRITE(display + DISPLAY_REG_DIGITS, 0);
+
+  return;
+} /* display_init */
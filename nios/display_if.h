@@ -0,0 +1,49 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  display_if.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines various constants for display_if.c.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_DISPLAY_IF__H
+#define __LAB_7_DISPLAY_IF__H
+
+#include "nios_std_types.h"   // standard data types
+
+// Display controller register offsets (uint32)
+#define   DISPLAY_REG_DIGITS              0
+#define   DISPLAY_REG_CONTROL             1
+
+// Byte offsets of the control register's fields
+#define   DISPLAY_CONTROL_ENABLE          4
+#define   DISPLAY_CONTROL_BANK            5
+
+// What the game shows where: byte offset into the digits register, and
+// the mask of displays (HEX7..HEX0) each field occupies.  HEX1..HEX0
+// belong to the countdown peripheral (see timer_if.h).
+#define   DISPLAY_GUESSES                 1     // HEX3..HEX2, one byte
+#define   DISPLAY_CANDIDATES              2     // HEX7..HEX4, halfword
+#define   DISPLAY_GUESSES_DIGITS          0x0C
+#define   DISPLAY_CANDIDATES_DIGITS       0xF0
+
+// Prototypes for public functions
+void display_write(uint32 digits);
+void display_guesses(uint32 bcd);
+void display_candidates(uint32 bcd);
+void display_enable(uint32 mask, uint32 enable);
+void display_bank(uint32 mask);
+void display_init();
+
+#endif /* __LAB_7_DISPLAY_IF__H */
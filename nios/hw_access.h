@@ -0,0 +1,76 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  hw_access.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      Register access macros used by the drivers.  On the board these
+//      are plain volatile loads and stores.  When the firmware is built
+//      into a host tool with HOST_MODEL defined, every access goes to the
+//      host register model instead, tagged with the calling function.
+//
+//      CPU_IDLE marks the firmware's polling loops, so that the host
+//      model can skip ahead to the next hardware event rather than
+//      spinning in real time.
+//
+//      CPU_IRQ_AGE gives how long ago an interrupt line rose, in cycles.
+//      Only the host model can tell; on the board it is always
+//      CPU_IRQ_AGE_UNKNOWN.
+//
+//      CPU_BARRIER keeps the compiler from moving memory accesses across
+//      it.  A ring shared with an ISR fills a slot with plain stores and
+//      publishes it with a volatile index; volatile alone doesn't keep
+//      the slot's stores ahead of the index, so one goes between them.
+//
+//      CPU_TRACE_BEGIN/END bracket a span of firmware work and
+//      CPU_TRACE_STATE names the state the game has entered, for the
+//      host's timeline traces.  Names must be string literals.  On the
+//      board they compile to nothing.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_HW_ACCESS__H
+#define __LAB_7_HW_ACCESS__H
+
+// What CPU_IRQ_AGE gives when it can't tell
+#define CPU_IRQ_AGE_UNKNOWN   0xFFFFFFFF
+
+// Compiler barrier, the same on the board and the host
+#define CPU_BARRIER()         __asm__ volatile("" ::: "memory")
+
+#ifdef HOST_MODEL
+
+#include "regmodel.h"         // host register model
+
+#define REG_READ(ptr)         rm_read((unsigned long)(ptr), sizeof(*(ptr)), \
+                                      __func__)
+#define REG_WRITE(ptr, val)   rm_write((unsigned long)(ptr), sizeof(*(ptr)), \
+                                       (val), __func__)
+#define CPU_IDLE()            rm_idle(__func__)
+#define CPU_IRQ_AGE(irq)      rm_irq_age(irq)
+#define CPU_TRACE_BEGIN(name) rm_trace(RM_TRACE_BEGIN, name)
+#define CPU_TRACE_END(name)   rm_trace(RM_TRACE_END, name)
+#define CPU_TRACE_STATE(name) rm_trace(RM_TRACE_STATE, name)
+
+#else /* !HOST_MODEL */
+
+#define REG_READ(ptr)         (*(ptr))
+#define REG_WRITE(ptr, val)   (*(ptr) = (val))
+#define CPU_IDLE()
+#define CPU_IRQ_AGE(irq)      CPU_IRQ_AGE_UNKNOWN
+#define CPU_TRACE_BEGIN(name)
+#define CPU_TRACE_END(name)
+#define CPU_TRACE_STATE(name)
+
+#endif /* HOST_MODEL */
+
+#endif /* __LAB_7_HW_ACCESS__H */
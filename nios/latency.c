@@ -0,0 +1,273 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  latency.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Interrupt latency statistics, built with IRQ_LATENCY.  ISRs record
+//    how many cycles passed between their hardware event and their own
+//    entry, and latency_report prints a histogram for each source.
+//
+//    With IRQ_LATENCY, timer_init arms a one-second software timer that
+//    does nothing, as a probe: the one-second timer is set as a one-shot
+//    for its deadline, and the wheel ISR compares the timestamp on entry
+//    with the deadline it programmed.  The two timers don't share a
+//    phase, so the probe lands wherever the firmware happens to be.
+//
+//    The keys and the JTAG UART latch no time for their own events, so
+//    on the board the firmware raises their interrupts itself and notes
+//    when (latency_raise); the ISR measures from there on entry
+//    (latency_entry).  Each probe raises the UART's write interrupt, and
+//    the keys ISR holds each edge it takes and has it raised again from
+//    the main loop (see pio_if.c).  Those samples are the interrupt
+//    path: the time from the line rising to the ISR, including anything
+//    that held interrupts off meanwhile, but not how long a character or
+//    a key waited in the peripheral.  The countdown is started by the
+//    firmware and runs for a whole number of its ticks, so when it
+//    starts the firmware notes when it will expire (latency_due), and
+//    its ISR measures from there.  The host model knows when every line
+//    rose (CPU_IRQ_AGE) and measures every interrupt by that.
+//
+//    Without IRQ_LATENCY the whole file compiles away, and the ISRs'
+//    hooks with it.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include <sys/alt_irq.h>      // for alt_irq_disable_all
+#include "nios_std_types.h"   // standard data types
+#include "timer_if.h"         // for timer_timestamp
+#include "uart_if.h"          // for uart_SendString, uart_latency_probe
+#include "utilities.h"        // for put_string, put_number
+#include "latency.h"
+
+#ifdef IRQ_LATENCY
+
+// Latency of one interrupt source
+typedef struct
+{
+  uint32  count;
+  uint32  min;
+  uint32  max;
+  uint32  total_lo;           // sum of the latencies, in two words so
+  uint32  total_hi;           // that the ISRs only add
+  uint32  buckets[LATENCY_BUCKETS];
+} _latency_t;
+
+static _latency_t   _latency[LATENCY_SOURCES];
+
+// When the firmware last raised each source's interrupt itself, or when
+// it will rise, if that hasn't been taken yet
+static uint32       _latency_raised[LATENCY_SOURCES];
+static uint32       _latency_pending[LATENCY_SOURCES];
+
+static const char*  _latency_names[LATENCY_SOURCES] =
+{
+  "TIMER_GAME_1SEC_IRQ", "JTAG_UART_0_IRQ", "PIO_KEYS_IRQ",
+  "COUNTDOWN_0_IRQ"
+};
+
+//-------------------------------------------------------------------------
+// NAME:        latency_raise
+//
+// DESCRIPTION: Notes that the firmware is raising a source's interrupt
+//              now.  Call with interrupts off, just before raising it.
+// ARGUMENTS:   uint32 source, one of LATENCY_*
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void latency_raise(uint32 source)
+{
+  latency_due(source, timer_timestamp());
+} /* latency_raise */
+
+//-------------------------------------------------------------------------
+// NAME:        latency_due
+//
+// DESCRIPTION: Notes when a source's interrupt will rise, for one the
+//              firmware has set going and whose timing it knows.  Call
+//              with interrupts off, or before the interrupt can rise.
+// ARGUMENTS:   uint32 source, one of LATENCY_*
+//              uint32 when, timer_timestamp() when it will rise
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void latency_due(uint32 source, uint32 when)
+{
+  if (source < LATENCY_SOURCES)
+  {
+    _latency_raised[source]  = when;
+    _latency_pending[source] = TRUE;
+  } /* if */
+} /* latency_due */
+
+//-------------------------------------------------------------------------
+// NAME:        latency_entry
+//
+// DESCRIPTION: Measures an ISR's latency on entry (LATENCY_IRQ): from
+//              when its line rose, if the host model knows, or else from
+//              when the firmware raised it or said it would rise.  An
+//              interrupt that neither can tell about isn't counted.
+// ARGUMENTS:   uint32 source, one of LATENCY_*
+//              uint32 age, CPU_IRQ_AGE for the source's interrupt
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void latency_entry(uint32 source, uint32 age)
+{
+  if (source >= LATENCY_SOURCES)
+  {
+    return;
+  } /* if */
+
+  if (CPU_IRQ_AGE_UNKNOWN == age && _latency_pending[source])
+  {
+    age = timer_timestamp() - _latency_raised[source];
+  } /* if */
+  _latency_pending[source] = FALSE;
+  latency_record(source, age);
+} /* latency_entry */
+
+//-------------------------------------------------------------------------
+// NAME:        latency_record
+//
+// DESCRIPTION: Adds one measurement.  Called from ISRs, so it's short:
+//              at most LATENCY_BUCKETS steps to find the bucket.
+// ARGUMENTS:   uint32 source, one of LATENCY_*
+//              uint32 cycles, from the event to ISR entry; ignored if
+//                             CPU_IRQ_AGE_UNKNOWN
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void latency_record(uint32 source, uint32 cycles)
+{
+  _latency_t* stats;
+  uint32      bucket = 0;
+
+  if (source >= LATENCY_SOURCES || CPU_IRQ_AGE_UNKNOWN == cycles)
+  {
+    return;
+  } /* if */
+
+  stats = &_latency[source];
+  if (0 == stats->count || cycles < stats->min)
+  {
+    stats->min = cycles;
+  } /* if */
+  if (cycles > stats->max)
+  {
+    stats->max = cycles;
+  } /* if */
+  stats->count++;
+  stats->total_lo += cycles;
+  if (stats->total_lo < cycles)
+  {
+    stats->total_hi++;        // carry
+  } /* if */
+
+  while (bucket < LATENCY_BUCKETS - 1 && (cycles >> (bucket + 1)) != 0)
+  {
+    bucket++;
+  } /* while */
+  stats->buckets[bucket]++;
+} /* latency_record */
+
+//-------------------------------------------------------------------------
+// NAME:        latency_probe
+//
+// DESCRIPTION: The one-second probe's work, run from the main loop:
+//              raises the JTAG UART's interrupt, to be measured.
+// ARGUMENTS:   uint32 arg, unused
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void latency_probe(uint32 arg)
+{
+  uart_latency_probe();
+} /* latency_probe */
+
+//-------------------------------------------------------------------------
+// NAME:        latency_report
+//
+// DESCRIPTION: Prints, for each source that has been measured, the
+//              count, minimum, mean and maximum latency and the jitter
+//              (maximum less minimum), all in cycles, then the nonempty
+//              histogram buckets.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void latency_report()
+{
+  alt_irq_context irq_context;
+  _latency_t      stats;
+  uint8           line[80];
+  uint8*          end;
+  uint32          source;
+  uint32          bucket;
+  uint32          count;
+
+  uart_SendString((uint8*)"\nIRQ latency (cycles)  count      min     mean"
+                          "      max   jitter\n");
+  for (source = 0; source < LATENCY_SOURCES; source++)
+  {
+    // take a consistent copy; the ISRs keep adding to it
+    irq_context = alt_irq_disable_all();
+    stats = _latency[source];
+    alt_irq_enable_all(irq_context);
+    if (0 == stats.count)
+    {
+      continue;
+    } /* if */
+
+    end = put_string(line, _latency_names[source]);
+    while (end < line + 19)
+    {
+      *end++ = ' ';
+    } /* while */
+    end = put_number(end, stats.count, 10, ' ');
+    // The mean, by a 32-bit divide: scale the sum and the count down
+    // together until the sum fits in a word
+    count = stats.count;
+    while (0 != stats.total_hi)
+    {
+      stats.total_lo = (stats.total_lo >> 1) | (stats.total_hi << 31);
+      stats.total_hi >>= 1;
+      count >>= 1;
+    } /* while */
+    end = put_number(end, stats.min, 9, ' ');
+    end = put_number(end, stats.total_lo / ((0 == count) ? 1 : count), 9,
+                     ' ');
+    end = put_number(end, stats.max, 9, ' ');
+    end = put_number(end, stats.max - stats.min, 9, ' ');
+    end = put_string(end, "\n");
+    *end = NULL;
+    uart_SendString(line);
+
+    for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+    {
+      if (0 != stats.buckets[bucket])
+      {
+        end = put_string(line, "  ");
+        end = put_number(end, (0 == bucket) ? 0 : 1 << bucket, 9, ' ');
+        if (LATENCY_BUCKETS - 1 == bucket)
+        {
+          end = put_string(end, " and up     ");
+        } /* if */
+        else
+        {
+          end = put_string(end, " ..");
+          end = put_number(end, (2 << bucket) - 1, 9, ' ');
+        } /* else */
+        end = put_number(end, stats.buckets[bucket], 10, ' ');
+        end = put_string(end, "\n");
+        *end = NULL;
+        uart_SendString(line);
+      } /* if */
+    } /* for bucket */
+  } /* for source */
+} /* latency_report */
+
+#endif /* IRQ_LATENCY */
@@ -0,0 +1,53 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  latency.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for latency.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_LATENCY__H
+#define __LAB_7_LATENCY__H
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for IRQ_LATENCY
+#include "hw_access.h"        // for CPU_IRQ_AGE
+
+// Interrupt sources measured
+#define   LATENCY_TIMER_GAME      0     // TIMER_GAME_1SEC_IRQ, the wheel
+#define   LATENCY_UART            1     // JTAG_UART_0_IRQ
+#define   LATENCY_KEYS            2     // PIO_KEYS_IRQ
+#define   LATENCY_COUNTDOWN       3     // COUNTDOWN_0_IRQ
+#define   LATENCY_SOURCES         4
+
+// Histogram buckets: bucket n counts latencies of 2^n to 2^(n+1) - 1
+// cycles (bucket 0 also has 0), and the last counts everything longer
+#define   LATENCY_BUCKETS         24
+
+// Hook used by ISRs; compiles away unless latency is being measured
+#ifdef IRQ_LATENCY
+  #define LATENCY_IRQ(source, irq)  latency_entry((source), CPU_IRQ_AGE(irq))
+#else
+  #define LATENCY_IRQ(source, irq)
+#endif /* IRQ_LATENCY */
+
+// Prototypes for public functions
+void latency_raise(uint32 source);
+void latency_due(uint32 source, uint32 when);
+void latency_entry(uint32 source, uint32 age);
+void latency_record(uint32 source, uint32 cycles);
+void latency_probe(uint32 arg);
+void latency_report();
+
+#endif /* __LAB_7_LATENCY__H */
@@ -22,7 +22,9 @@
 #include "system.h"           // BSP-provided definitions
 #include <sys/alt_irq.h>      // interrupt-related prototypes
 
+#include "hw_access.h"        // register access macros
 #include "lfsr_if.h"          // defines and constants for hw interfacing
+#include "session_rec.h"      // session recorder
 #include "utilities.h"        // useful utilities
 
 // LFSR register pointer
@@ -38,9 +40,47 @@ volatile uint16* lfsr = (uint16*)LFSR_16_0_BASE;
 //-------------------------------------------------------------------------
 uint16 lfsr_rand()
 {
-  return *(lfsr + LFSR_REG_LFSR);
+  uint16 value;
+
+  value = REG_READ(lfsr + LFSR_REG_LFSR);
+  REC_EVENT(REC_LFSR, value);
+
+  return value;
 } /* lfsr_rand */
 
+//-------------------------------------------------------------------------
+// NAME:        lfsr_rand_below
+//
+// DESCRIPTION: Retrieves a uniform value below n from the LFSR's bounded
+//              register, which does the rejection sampling in hardware.
+//              The range is written every time, even when it hasn't
+//              changed, since that marks the bounded value stale: the
+//              value then read (again until it is not stale) is always
+//              a candidate taken after the last draw, never the same one
+//              twice.
+// ARGUMENTS:   uint16 n, the range, 1 to LFSR_RANGE_MAX (a larger one
+//              draws below LFSR_RANGE_MAX)
+// RETURNS:     uint16 random number, 0 to n-1 (0 if n is 0 or 1)
+//-------------------------------------------------------------------------
+uint16 lfsr_rand_below(uint16 n)
+{
+  uint16 value;
+
+  if (n < 2)
+  {
+    return 0;
+  } /* if nothing to draw */
+
+  REG_WRITE(lfsr + LFSR_REG_RANGE, n);
+  do
+  {
+    value = REG_READ(lfsr + LFSR_REG_BOUNDED);
+  } while (0 != (value & LFSR_REG_BOUNDED_STALE_MASK));
+  REC_EVENT(REC_LFSR, value);
+
+  return value;
+} /* lfsr_rand_below */
+
 //-------------------------------------------------------------------------
 // NAME:        lfsr_rand_valid
 //
@@ -53,7 +93,7 @@ uint32 lfsr_rand_valid()
 {
   uint32 seeded;
 
-  seeded = (uint32)*(lfsr + LFSR_REG_STATUS);
+  seeded = (uint32)REG_READ(lfsr + LFSR_REG_STATUS);
   seeded &= LFSR_REG_STATUS_SEEDED_MASK;
   return seeded;
 } /* lfsr_rand_valid */
@@ -67,10 +107,14 @@ uint32 lfsr_rand_valid()
 //-------------------------------------------------------------------------
 void lfsr_rand_init(uint16 seed)
 {
+  REC_EVENT(REC_SEED, seed);
+
   if (seed > 0)   // value must be > 0!!
   {
-    *(lfsr + LFSR_REG_SEED)     = seed;
-    *(lfsr + LFSR_REG_CONTROL) |= LFSR_REG_CONTROL_RESEED_MASK;
+    REG_WRITE(lfsr + LFSR_REG_SEED, seed);
+    REG_WRITE(lfsr + LFSR_REG_CONTROL,
+              REG_READ(lfsr + LFSR_REG_CONTROL) |
+              LFSR_REG_CONTROL_RESEED_MASK);
   } /* if */
 
   return;
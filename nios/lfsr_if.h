@@ -27,12 +27,21 @@
 #define   LFSR_REG_CONTROL                1
 #define   LFSR_REG_LFSR                   2
 #define   LFSR_REG_SEED                   3
+#define   LFSR_REG_RANGE                  4
+#define   LFSR_REG_BOUNDED                5
 #define   LFSR_REG_STATUS_SEEDED_MASK     0x1
 #define   LFSR_REG_STATUS_SEEDVALID_MASK  0x2
+#define   LFSR_REG_STATUS_FRESH_MASK      0x4
 #define   LFSR_REG_CONTROL_RESEED_MASK    0x1
+#define   LFSR_REG_BOUNDED_STALE_MASK     0x8000
+#define   LFSR_REG_BOUNDED_VALUE_MASK     0x7FFF
+
+// Largest range lfsr_rand_below takes
+#define   LFSR_RANGE_MAX                  0x8000
 
 // Prototypes for public functions
 uint16 lfsr_rand();
+uint16 lfsr_rand_below(uint16 n);
 uint32 lfsr_rand_valid();
 void lfsr_rand_init(uint16 seed);
 
@@ -0,0 +1,161 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  msglog.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Compact diagnostic log.  Rather than sending its complaints over the
+//    JTAG UART as text, sometimes from inside an ISR, the firmware logs a
+//    message number from msglog.h and up to two raw arguments, with a
+//    timestamp, in a small ring in RAM.  That costs a few stores, and
+//    the message text stays on the host.  The log is sent at the end of
+//    each game as lines of hex, bracketed by "LOG BEGIN" and "LOG END",
+//    and host/msglog_decode.c turns it back into text from a captured
+//    console session.
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // BSP-provided definitions
+#include <sys/alt_irq.h>      // interrupt-related prototypes
+
+#include "msglog.h"
+#include "timer_if.h"         // for timer_timestamp
+#include "uart_if.h"          // for sending the dump
+
+// Nothing here takes any memory unless logging is enabled
+#ifdef MSG_LOG
+
+// One logged message
+typedef struct
+{
+  uint32  time;               // timer_timestamp when it was logged
+  uint32  id;                 // one of msglog_id_t
+  uint32  arg[2];
+} _msglog_entry_t;
+
+static _msglog_entry_t  _msglog[MSGLOG_SIZE];
+static uint32           _msglog_count;    // messages ever logged
+static uint32           _msglog_sent;     // ... and already dumped
+
+//-------------------------------------------------------------------------
+// NAME:        msglog_put
+//
+// DESCRIPTION: Logs one message, overwriting the oldest if the log is
+//              full.  Safe to call from ISRs.
+// ARGUMENTS:   uint32 id, one of msglog_id_t
+//              uint32 a, uint32 b, its arguments
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void msglog_put(uint32 id, uint32 a, uint32 b)
+{
+  alt_irq_context  irq_context;
+  _msglog_entry_t* entry;
+
+  // Keep ISRs out while the entry is claimed and filled in
+  irq_context = alt_irq_disable_all();
+
+  entry         = &_msglog[_msglog_count % MSGLOG_SIZE];
+  entry->time   = timer_timestamp();
+  entry->id     = id;
+  entry->arg[0] = a;
+  entry->arg[1] = b;
+  _msglog_count++;
+
+  alt_irq_enable_all(irq_context);
+
+  return;
+} /* msglog_put */
+
+//-------------------------------------------------------------------------
+// NAME:        _msglog_hex
+//
+// DESCRIPTION: Writes a number as hex digits.
+// ARGUMENTS:   uint8* out, where the digits go
+//              uint32 value, uint32 digits, what to write
+// RETURNS:     uint8*, just past the digits
+//-------------------------------------------------------------------------
+static uint8* _msglog_hex(uint8* out, uint32 value, uint32 digits)
+{
+  static const uint8 hex[] = "0123456789ABCDEF";
+
+  while (digits-- > 0)
+  {
+    *out++ = hex[(value >> (digits * 4)) & 0xF];
+  } /* while */
+  return out;
+} /* _msglog_hex */
+
+//-------------------------------------------------------------------------
+// NAME:        msglog_dump
+//
+// DESCRIPTION: Sends the messages logged since the last dump, oldest
+//              first, one per line:
+//                  LOG <time> <id> <a> <b>
+//              in hex, after a "LOG BEGIN <lost>" line giving how many
+//              were overwritten before they could be sent.  Sends
+//              nothing if there's nothing new.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void msglog_dump()
+{
+  uint8            line[4 + 8 + 1 + 2 + 1 + 8 + 1 + 8 + 2];
+  uint8*           out;
+  _msglog_entry_t* entry;
+  uint32           count;
+  uint32           first;
+  uint32           i;
+
+  // Snapshot the count; messages logged during the dump wait for the
+  // next one.
+  count = _msglog_count;
+  if (count == _msglog_sent)
+  {
+    return;
+  } /* if */
+  first = _msglog_sent;
+  if (count - first > MSGLOG_SIZE)
+  {
+    first = count - MSGLOG_SIZE;
+  } /* if some were overwritten */
+
+  out = _msglog_hex(line, first - _msglog_sent, 8);
+  *out++ = '\n';
+  *out   = NULL;
+  uart_SendString((uint8*)"LOG BEGIN ");
+  uart_SendString(line);
+  for (i = first; i != count; i++)
+  {
+    entry = &_msglog[i % MSGLOG_SIZE];
+    line[0] = 'L';
+    line[1] = 'O';
+    line[2] = 'G';
+    line[3] = ' ';
+    out = _msglog_hex(line + 4, entry->time, 8);
+    *out++ = ' ';
+    out = _msglog_hex(out, entry->id, 2);
+    *out++ = ' ';
+    out = _msglog_hex(out, entry->arg[0], 8);
+    *out++ = ' ';
+    out = _msglog_hex(out, entry->arg[1], 8);
+    *out++ = '\n';
+    *out   = NULL;
+    uart_SendString(line);
+  } /* for i */
+  uart_SendString((uint8*)"LOG END\n");
+  _msglog_sent = count;
+
+  return;
+} /* msglog_dump */
+
+#endif /* MSG_LOG */
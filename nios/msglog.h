@@ -0,0 +1,65 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  msglog.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for msglog.c, and the
+//      dictionary of diagnostic messages it logs by number.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_MSGLOG__H
+#define __LAB_7_MSGLOG__H
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for MSG_LOG
+
+// Entries kept in the log; older ones are overwritten (a power of two)
+#define MSGLOG_SIZE       32
+
+// The message dictionary: X(id, format) for each message.  The firmware
+// only expands the ids, so none of the text is linked into on-chip
+// memory; host/msglog_decode.c expands the formats.  Each takes at most
+// two uint32 arguments, so use only %u, %x, %c and the like.  Add new
+// messages at the end, and rebuild the decoder along with the firmware.
+#define MSGLOG_MESSAGES(X)                                                \
+  X(MSG_UART_BUSY,                                                        \
+    "uart_recv_isr: can't process '%c' until previous line is picked up") \
+  X(MSG_UART_SPURIOUS,                                                    \
+    "uart_recv_isr: got interrupt but nothing to receive??")              \
+  X(MSG_DEFER_FULL,                                                       \
+    "defer_post: queue full; dropped %08x(%u)")                           \
+  X(MSG_REC_FULL,                                                         \
+    "rec_event: session log full; dropping from a type %u event on")      \
+  X(MSG_NO_RESULT,                                                        \
+    "game_loop: you have neither won nor lost, after %u guesses")
+
+#define MSGLOG_ID(id, format)   id,
+typedef enum
+{
+  MSGLOG_MESSAGES(MSGLOG_ID)
+  MSGLOG_COUNT
+} msglog_id_t;
+
+// Hook used by the drivers; compiles away unless logging is enabled
+#ifdef MSG_LOG
+  #define MSGLOG(id, a, b)      msglog_put((id), (a), (b))
+#else
+  #define MSGLOG(id, a, b)
+#endif /* MSG_LOG */
+
+// Prototypes for public functions
+void msglog_put(uint32 id, uint32 a, uint32 b);
+void msglog_dump();
+
+#endif /* __LAB_7_MSGLOG__H */
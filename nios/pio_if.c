@@ -22,72 +22,193 @@
 #include "system.h"           // BSP-provided definitions
 #include <sys/alt_irq.h>      // interrupt-related prototypes
 
+#include "hw_access.h"        // register access macros, CPU_BARRIER
 #include "pio_if.h"           // defines and constants for hw interfacing
+#include "session_rec.h"      // session recorder
+#include "latency.h"          // for LATENCY_IRQ, latency_raise
+#include "defer.h"            // for defer_post
+#include "timer_if.h"         // for timer_timestamp
 #include "utilities.h"        // useful utilities
 
-// variables for latching button state
-uint32  key1_pressed;
-uint32  key2_pressed;
+// presses not yet seen by pio_key_pressed, per key
+uint32  _key_presses[PIO_KEYS_COUNT];
+
+// key event ring, filled by the ISR and drained by pio_key_next
+pio_key_event_t   _key_queue[PIO_KEY_QUEUE_SIZE];
+volatile uint32   _key_head;          // next slot the ISR writes
+volatile uint32   _key_tail;          // next slot to be drained
+volatile uint32   _key_dropped;       // events lost to a full queue
+
+// debouncing: the accepted state of each key, when it last changed, and
+// the end of its debounce window, when the level is read again
+uint32  _key_down;                    // PIO_KEYS_* mask of keys down
+uint32  _key_changed[PIO_KEYS_COUNT];
+uint32  _key_debounce;
+timer_event_t     _key_settle[PIO_KEYS_COUNT];
+
+#ifdef IRQ_LATENCY
+  // TRUE while the ISR holds edges for _pio_keys_probe to raise again
+  uint32  _key_held;
+#endif /* IRQ_LATENCY */
 
 // pointers to our peripherals
 volatile uint32* pio_keys = (uint32*)PIO_KEYS_BASE;
-volatile uint32* pio_bcd  = (uint32*)PIO_COUNTDOWN_BASE;
 volatile uint32* pio_led  = (uint32*)PIO_LEDS_BASE;
 
+static void _pio_key_settle(uint32 key);
+
 //-------------------------------------------------------------------------
-// NAME:        _pio_keys_isr
+// NAME:        _pio_key_change
 //
-// DESCRIPTION: Interrupt service routine for our buttons
+// DESCRIPTION: Accepts a change of one key: records the new state,
+//              counts a press, queues the event, and starts the key's
+//              debounce window.  Called with interrupts off.
+// ARGUMENTS:   uint32 key, 0-based
+//              uint32 down, PIO_KEYS_* mask of the keys down now
+//              uint32 now, timer_timestamp() for the event
+// RETURNS:     void
 //-------------------------------------------------------------------------
-void _pio_keys_isr(void *context)
+static void _pio_key_change(uint32 key, uint32 down, uint32 now)
 {
-  // Test for button presses
-  if (0 != (*(pio_keys + PIO_REG_EDGECAPTURE) & PIO_KEYS_KEY1))
-  {
-    key1_pressed = TRUE;
-  } /* if key1 */
-  if (0 != (*(pio_keys + PIO_REG_EDGECAPTURE) & PIO_KEYS_KEY2))
+  uint32  mask = 1 << key;
+
+  _key_down ^= mask;
+  _key_changed[key] = now;
+  if (0 != (down & mask))
   {
-    key2_pressed = TRUE;
-  } /* if key2 */
+    _key_presses[key]++;
+  } /* if */
 
-  // Reset the register
-  *(pio_keys + PIO_REG_EDGECAPTURE) = (PIO_KEYS_KEY1 | PIO_KEYS_KEY2);
+  if (_key_head - _key_tail < PIO_KEY_QUEUE_SIZE)
+  {
+    _key_queue[_key_head % PIO_KEY_QUEUE_SIZE].key  = (uint8)(key + 1);
+    _key_queue[_key_head % PIO_KEY_QUEUE_SIZE].edge =
+      (0 != (down & mask)) ? PIO_KEY_EDGE_DOWN : PIO_KEY_EDGE_UP;
+    _key_queue[_key_head % PIO_KEY_QUEUE_SIZE].time = now;
+    CPU_BARRIER();          // fill the slot before publishing it
+    _key_head++;
+  } /* if room */
+  else
+  {
+    _key_dropped++;
+  } /* else */
 
-  return;
-} /* _pio_keys_isr */
+  // Edges inside the window are dropped as bounce, so look at the level
+  // again once it ends: the key may have settled the other way
+  if (0 != _key_debounce)
+  {
+    timer_event_start(&_key_settle[key], _key_debounce, 0,
+                      _pio_key_settle, key);
+  } /* if */
+} /* _pio_key_change */
 
 //-------------------------------------------------------------------------
-// NAME:        pio_ssd_update
+// NAME:        _pio_key_settle
 //
-// DESCRIPTION: Pushes new digits to the seven-segment display.
-//              Accepts "normal" input, does NOT need to be BCD
-//              already.
-// ARGUMENTS:   uint32 value, a number to push to the displays.
-//              uint32 enable, > 0 to drive the displays
+// DESCRIPTION: Runs (deferred) when a key's debounce window ends, and
+//              accepts the key's level if it differs from its state: the
+//              edge that got it there came too soon and was dropped.
+// ARGUMENTS:   uint32 key, 0-based
 // RETURNS:     void
 //-------------------------------------------------------------------------
-void pio_ssd_update(uint32 value, uint32 enable)
+static void _pio_key_settle(uint32 key)
 {
-  uint8 bcd_val = 0;
+  alt_irq_context irq_context;
+  uint32          down;
 
-  if (0 != enable)
+  irq_context = alt_irq_disable_all();
+  // The keys are active-low
+  down = ~REG_READ(pio_keys + PIO_REG_DATA) & (PIO_KEYS_KEY1 | PIO_KEYS_KEY2);
+  if ((down & (1 << key)) != (_key_down & (1 << key)))
   {
-    // convert value to BCD, then ensure bit 7 is high
-    bcd_val  = (uint8)convert_to_bcd((uint16)value);
-    bcd_val |= (1 << 7);
+    _pio_key_change(key, down, timer_timestamp());
   } /* if */
-  else
+  alt_irq_enable_all(irq_context);
+} /* _pio_key_settle */
+
+#ifdef IRQ_LATENCY
+//-------------------------------------------------------------------------
+// NAME:        _pio_keys_probe
+//
+// DESCRIPTION: Runs (deferred) after the ISR has held the edges it took:
+//              unmasks the keys, which raises the interrupt again at
+//              once, for latency_entry to measure.  The ISR then finds
+//              the keys where it left them, and just clears the edges.
+// ARGUMENTS:   uint32 arg, unused
+// RETURNS:     void
+//-------------------------------------------------------------------------
+static void _pio_keys_probe(uint32 arg)
+{
+  alt_irq_context irq_context;
+
+  irq_context = alt_irq_disable_all();
+  latency_raise(LATENCY_KEYS);
+  REG_WRITE(pio_keys + PIO_REG_IRQMASK, (PIO_KEYS_KEY1 | PIO_KEYS_KEY2));
+  alt_irq_enable_all(irq_context);
+} /* _pio_keys_probe */
+#endif /* IRQ_LATENCY */
+
+//-------------------------------------------------------------------------
+// NAME:        _pio_keys_isr
+//
+// DESCRIPTION: Interrupt service routine for our buttons.  The keys PIO
+//              captures both edges; each edge that survives debouncing
+//              is timestamped and queued, and an edge inside a key's
+//              debounce window is left for _pio_key_settle.  Only the
+//              edge bits that were read are cleared, so an edge arriving
+//              meanwhile raises the interrupt again rather than being
+//              lost.  With IRQ_LATENCY, the edges are instead held,
+//              with the keys masked, the first time they are seen (see
+//              _pio_keys_probe).
+//-------------------------------------------------------------------------
+void _pio_keys_isr(void *context)
+{
+  uint32  edges;
+  uint32  down;
+  uint32  now;
+  uint32  mask;
+  uint32  key;
+
+  LATENCY_IRQ(LATENCY_KEYS, PIO_KEYS_IRQ);
+  edges = REG_READ(pio_keys + PIO_REG_EDGECAPTURE) &
+          (PIO_KEYS_KEY1 | PIO_KEYS_KEY2);
+  #ifdef IRQ_LATENCY
+    if (!_key_held && 0 != edges && defer_post(_pio_keys_probe, 0))
+    {
+      REG_WRITE(pio_keys + PIO_REG_IRQMASK, 0);
+      _key_held = TRUE;
+    } /* if */
+    else
+    {
+      REG_WRITE(pio_keys + PIO_REG_EDGECAPTURE, edges);
+      _key_held = FALSE;
+    } /* else */
+  #else
+    REG_WRITE(pio_keys + PIO_REG_EDGECAPTURE, edges);
+  #endif /* IRQ_LATENCY */
+
+  // The keys are active-low
+  down  = ~REG_READ(pio_keys + PIO_REG_DATA) & (PIO_KEYS_KEY1 | PIO_KEYS_KEY2);
+  now   = timer_timestamp();
+  REC_EVENT(REC_KEY, edges | (down << 4));
+
+  for (key = 0; key < PIO_KEYS_COUNT; key++)
   {
-    // Ensure bit 7 is low
-    bcd_val  = 0x0;
-  } /* else */
+    mask = 1 << key;
+    if (0 == (edges & mask) || (down & mask) == (_key_down & mask))
+    {
+      continue;     // no edge, or it bounced back already
+    } /* if */
+    if (now - _key_changed[key] < _key_debounce)
+    {
+      continue;     // too soon after the last change: contact bounce
+    } /* if */
 
-  // Send the BCD value to the hex displays
-  *(pio_bcd + PIO_REG_DATA) = bcd_val;
+    _pio_key_change(key, down, now);
+  } /* for key */
 
   return;
-} /* pio_ssd_update */
+} /* _pio_keys_isr */
 
 //-------------------------------------------------------------------------
 // NAME:        pio_leds_update
@@ -105,7 +226,7 @@ void pio_leds_update(uint32 red, uint32 green)
   if (green)  tmpmask |= PIO_LEDS_GREEN_MASK;
 
   // Push new value to the LEDs
-  *(pio_led + PIO_REG_DATA) = tmpmask;
+  REG_WRITE(pio_led + PIO_REG_DATA, tmpmask);
 
   return;
 } /* pio_leds_update */
@@ -113,7 +234,7 @@ void pio_leds_update(uint32 red, uint32 green)
 //-------------------------------------------------------------------------
 // NAME:        pio_key_pressed
 // DESCRIPTION: Checks to see if a key has been pressed.  Resets on each
-//              read.
+//              read.  Independent of the event queue.
 // ARGUMENTS:   Key number to check (1 or 2)
 // RETURNS:     uint32, TRUE if the key has been pressed since the last
 //                      read; FALSE otherwise.  FALSE on invalid key.
@@ -122,42 +243,111 @@ uint32 pio_key_pressed(uint32 key)
 {
   uint32 result = FALSE;
 
-  switch(key)
+  if ((key >= 1) && (key <= PIO_KEYS_COUNT))
   {
-    case 1:
-      result = key1_pressed;
-      key1_pressed = FALSE;
-      break;
-    case 2:
-      result = key2_pressed;
-      key2_pressed = FALSE;
-      break;
-  } /* switch */
+    result = (0 != _key_presses[key - 1]);
+    _key_presses[key - 1] = 0;
+  } /* if */
 
   return result;
 } /* pio_key_pressed */
 
+//-------------------------------------------------------------------------
+// NAME:        pio_key_next
+// DESCRIPTION: Takes the oldest event off the key event queue.
+// ARGUMENTS:   pio_key_event_t* event, receives the event
+// RETURNS:     uint32, TRUE if there was an event; FALSE otherwise.
+//-------------------------------------------------------------------------
+uint32 pio_key_next(pio_key_event_t* event)
+{
+  if (_key_tail == _key_head)
+  {
+    return FALSE;
+  } /* if empty */
+
+  // Only the ISR moves the head and only we move the tail, so the slot
+  // can be copied out without masking the interrupt, as long as the
+  // compiler keeps the copy between the two.
+  CPU_BARRIER();
+  *event = _key_queue[_key_tail % PIO_KEY_QUEUE_SIZE];
+  CPU_BARRIER();
+  _key_tail++;
+
+  return TRUE;
+} /* pio_key_next */
+
+//-------------------------------------------------------------------------
+// NAME:        pio_key_pending
+// DESCRIPTION: Counts the events waiting in the key event queue.
+// ARGUMENTS:   None
+// RETURNS:     uint32, number of events
+//-------------------------------------------------------------------------
+uint32 pio_key_pending()
+{
+  return _key_head - _key_tail;
+} /* pio_key_pending */
+
+//-------------------------------------------------------------------------
+// NAME:        pio_key_dropped
+// DESCRIPTION: Counts the events lost because the queue was full.
+// ARGUMENTS:   None
+// RETURNS:     uint32, number of events
+//-------------------------------------------------------------------------
+uint32 pio_key_dropped()
+{
+  return _key_dropped;
+} /* pio_key_dropped */
+
+//-------------------------------------------------------------------------
+// NAME:        pio_key_debounce
+// DESCRIPTION: Sets how long a key must stay put after changing before
+//              another change is accepted.  0 disables debouncing.
+// ARGUMENTS:   uint32 cycles, debounce time in CPU cycles
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void pio_key_debounce(uint32 cycles)
+{
+  _key_debounce = cycles;
+  return;
+} /* pio_key_debounce */
+
 //-------------------------------------------------------------------------
 // NAME:        pio_init
 //
-// DESCRIPTION: Initialize status variables and set up the PIO ISR
+// DESCRIPTION: Initialize status variables and set up the PIO ISR.  Call
+//              after timer_init, since debouncing uses the timers.
 // ARGUMENTS:   None
 // RETURNS:     void
 //-------------------------------------------------------------------------
 void pio_init()
 {
-  // Reset our internal flags
-  key1_pressed = FALSE;
-  key2_pressed = FALSE;
+  uint32 key;
+
+  // Reset our internal state
+  for (key = 0; key < PIO_KEYS_COUNT; key++)
+  {
+    _key_presses[key] = 0;
+    _key_changed[key] = timer_timestamp() - PIO_KEY_DEBOUNCE_DEFAULT;
+    _key_settle[key].armed = FALSE;
+  } /* for key */
+  _key_head     = 0;
+  _key_tail     = 0;
+  _key_dropped  = 0;
+  #ifdef IRQ_LATENCY
+    _key_held   = FALSE;
+  #endif /* IRQ_LATENCY */
+  _key_debounce = PIO_KEY_DEBOUNCE_DEFAULT;
+  _key_down     = ~REG_READ(pio_keys + PIO_REG_DATA) &
+                  (PIO_KEYS_KEY1 | PIO_KEYS_KEY2);
 
   /* Clear the edge capture register with all-ones */
-  *(pio_keys + PIO_REG_EDGECAPTURE) = -1;
+  REG_WRITE(pio_keys + PIO_REG_EDGECAPTURE, -1);
 
   // Register and enable interrupts
   alt_ic_isr_register(PIO_KEYS_IRQ_INTERRUPT_CONTROLLER_ID,
                       PIO_KEYS_IRQ,
                       _pio_keys_isr, 0, 0);
-  *(pio_keys + PIO_REG_IRQMASK) = (PIO_KEYS_KEY1 | PIO_KEYS_KEY2);
+  REG_WRITE(pio_keys + PIO_REG_IRQMASK, (PIO_KEYS_KEY1 | PIO_KEYS_KEY2));
 
   return;
 } /* pio_init */
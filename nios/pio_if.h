@@ -37,10 +37,31 @@
 #define   PIO_KEYS_KEY1                   0x1
 #define   PIO_KEYS_KEY2                   0x2
 
+// Number of keys on the keys PIO
+#define   PIO_KEYS_COUNT                  2
+
+// Key event queue: size (a power of two), edge types, and the default
+// debounce time (5 ms at 50 MHz)
+#define   PIO_KEY_QUEUE_SIZE              16
+#define   PIO_KEY_EDGE_UP                 0
+#define   PIO_KEY_EDGE_DOWN               1
+#define   PIO_KEY_DEBOUNCE_DEFAULT        250000
+
+// One key event, as queued by the keys ISR
+typedef struct
+{
+  uint8   key;        // key number (1 or 2)
+  uint8   edge;       // PIO_KEY_EDGE_DOWN or PIO_KEY_EDGE_UP
+  uint32  time;       // timer_timestamp() when the edge was taken
+} pio_key_event_t;
+
 // Prototypes
-void pio_ssd_update(uint32 value, uint32 enable);
 void pio_leds_update(uint32 red, uint32 green);
 uint32 pio_key_pressed(uint32 key);
+uint32 pio_key_next(pio_key_event_t* event);
+uint32 pio_key_pending();
+uint32 pio_key_dropped();
+void pio_key_debounce(uint32 cycles);
 void pio_init();
 
 #endif /* __LAB_7_PIO_IF__H */
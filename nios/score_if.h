@@ -0,0 +1,49 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  score_if.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      Wrapper for the score_ci custom instruction (vhdl/score_ci.vhd),
+//      which scores a packed guess against a packed secret in one cycle,
+//      giving the same packed score as score_code.  With SCORE_CUSTOM
+//      defined in codebreaker.h, utilities.h makes score_code this
+//      instruction in firmware built for the Nios; host builds always
+//      get the software score_code.
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_SCORE_IF__H
+#define __LAB_7_SCORE_IF__H
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for SCORE_CUSTOM
+
+#if defined(SCORE_CUSTOM) && defined(__nios2__)
+
+#include "system.h"           // for ALT_CI_SCORE_CI_0_N
+
+#ifndef ALT_CI_SCORE_CI_0_N
+  #error "SCORE_CUSTOM needs score_ci_0 in the Qsys system; regenerate the BSP"
+#endif
+
+// Set when score_ci is the scorer
+#define SCORE_CI_PRESENT
+
+// score_ci(secret, guess): the packed score, as from score_code
+#define score_ci(secret, guess) \
+  ((uint32)__builtin_custom_inii(ALT_CI_SCORE_CI_0_N, \
+                                 (int)(secret), (int)(guess)))
+
+#endif /* SCORE_CUSTOM && __nios2__ */
+
+#endif /* __LAB_7_SCORE_IF__H */
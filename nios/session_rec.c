@@ -0,0 +1,177 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  session_rec.c
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//    Records everything that a game depends on from the outside world:
+//    the LFSR seed and the values read from it, each character received
+//    by the UART, each key edge, and the countdown reaching zero.  Events
+//    are timestamped and packed into a small in-memory log, which can be
+//    dumped over the UART as hex and replayed on the host (see
+//    host/replay.c).
+//
+//*************************************************************************
+//*************************************************************************
+
+#include "nios_std_types.h"   // standard data types
+#include "system.h"           // BSP-provided definitions
+#include <sys/alt_irq.h>      // interrupt-related prototypes
+
+#include "session_rec.h"
+#include "msglog.h"           // for MSGLOG
+#include "timer_if.h"         // for timer_timestamp
+#include "uart_if.h"          // for sending the dump
+
+// Nothing here takes any memory unless recording is enabled
+#ifdef SESSION_RECORD
+
+// the event log
+uint8   _rec_data[REC_BUFFER_SIZE];
+uint32  _rec_length;          // bytes used in _rec_data
+uint32  _rec_full;            // TRUE once an event didn't fit
+uint32  _rec_last;            // timestamp of the previous event
+
+//-------------------------------------------------------------------------
+// NAME:        rec_init
+//
+// DESCRIPTION: Empties the log and starts the clock.  Call before any
+//              other initialization, so the seed is captured.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rec_init()
+{
+  _rec_length = 0;
+  _rec_full   = FALSE;
+  _rec_last   = timer_timestamp();
+
+  return;
+} /* rec_init */
+
+//-------------------------------------------------------------------------
+// NAME:        rec_event
+//
+// DESCRIPTION: Appends one event to the log.  Safe to call from ISRs.
+//              Once the log fills up, further events are dropped and the
+//              dump is marked as truncated.
+// ARGUMENTS:   uint32 type, one of REC_*
+//              uint32 data, payload (truncated to the type's size)
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rec_event(uint32 type, uint32 data)
+{
+  static const uint8 payload_sizes[] = REC_PAYLOAD_SIZES;
+
+  alt_irq_context irq_context;
+  uint32  now;
+  uint32  delta;
+  uint32  delta_bytes;
+  uint32  i;
+
+  // Keep ISRs out while the log is being appended to
+  irq_context = alt_irq_disable_all();
+
+  now   = timer_timestamp();
+  delta = now - _rec_last;
+  for (delta_bytes = 0; delta_bytes < 4; delta_bytes++)
+  {
+    if (0 == (delta >> (delta_bytes * 8)))
+    {
+      break;
+    } /* if */
+  } /* for delta_bytes */
+
+  if (_rec_full ||
+      _rec_length + 1 + delta_bytes + payload_sizes[type] > REC_BUFFER_SIZE)
+  {
+    if (!_rec_full)
+    {
+      MSGLOG(MSG_REC_FULL, type, 0);
+    } /* if */
+    _rec_full = TRUE;
+  } /* if no room */
+  else
+  {
+    _rec_data[_rec_length++] = (uint8)((type << 4) | delta_bytes);
+    for (i = 0; i < delta_bytes; i++)
+    {
+      _rec_data[_rec_length++] = (uint8)(delta >> (i * 8));
+    } /* for i */
+    for (i = 0; i < payload_sizes[type]; i++)
+    {
+      _rec_data[_rec_length++] = (uint8)(data >> (i * 8));
+    } /* for i */
+    _rec_last = now;
+  } /* else */
+
+  alt_irq_enable_all(irq_context);
+
+  return;
+} /* rec_event */
+
+//-------------------------------------------------------------------------
+// NAME:        rec_log
+//
+// DESCRIPTION: Gives direct access to the log, for host tools.
+// ARGUMENTS:   uint32* length, receives the number of bytes used
+// RETURNS:     uint8*, the log
+//-------------------------------------------------------------------------
+uint8* rec_log(uint32* length)
+{
+  *length = _rec_length;
+  return _rec_data;
+} /* rec_log */
+
+//-------------------------------------------------------------------------
+// NAME:        rec_dump
+//
+// DESCRIPTION: Sends the log over the UART as lines of hex, bracketed by
+//              "REC BEGIN" and "REC END" lines that host/replay.c looks
+//              for in a captured console session.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void rec_dump()
+{
+  static const uint8 hex[] = "0123456789ABCDEF";
+
+  uint8   line[4 + 2*16 + 2];
+  uint32  length;
+  uint32  pos;
+  uint32  i;
+
+  // Snapshot the length; events recorded during the dump aren't sent.
+  length = _rec_length;
+
+  uart_SendString((uint8*)(_rec_full ? "REC BEGIN TRUNCATED\n"
+                                     : "REC BEGIN\n"));
+  for (pos = 0; pos < length; pos += 16)
+  {
+    line[0] = 'R';
+    line[1] = 'E';
+    line[2] = 'C';
+    line[3] = ' ';
+    for (i = 0; i < 16 && pos + i < length; i++)
+    {
+      line[4 + 2*i]     = hex[_rec_data[pos + i] >> 4];
+      line[4 + 2*i + 1] = hex[_rec_data[pos + i] & 0xF];
+    } /* for i */
+    line[4 + 2*i]     = '\n';
+    line[4 + 2*i + 1] = NULL;
+    uart_SendString(line);
+  } /* for pos */
+  uart_SendString((uint8*)"REC END\n");
+
+  return;
+} /* rec_dump */
+
+#endif /* SESSION_RECORD */
@@ -0,0 +1,54 @@
+//***************************  C Source Code  *****************************
+//*************************************************************************
+// vim: set ts=2 sw=2 tw=78 et :
+//
+//  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+//
+//       LAB NAME:  Lab 7: Game System
+//
+//      FILE NAME:  session_rec.h
+//
+//-------------------------------------------------------------------------
+//
+//  DESCRIPTION
+//
+//      This file defines constants/prototypes for session_rec.c
+//
+//*************************************************************************
+//*************************************************************************
+
+#ifndef __LAB_7_SESSION_REC__H
+#define __LAB_7_SESSION_REC__H
+
+#include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for SESSION_RECORD
+
+// Size of the in-memory event log, in bytes
+#define REC_BUFFER_SIZE   2048
+
+// Event types.  Each event is stored as a header byte (type in the high
+// nibble, number of timestamp-delta bytes in the low nibble), the delta
+// since the previous event in cycles (little-endian), then the payload.
+#define REC_SEED          0x1   // 2 bytes: LFSR seed
+#define REC_UART_RX       0x2   // 1 byte:  character received
+#define REC_KEY           0x3   // 1 byte:  edge bits, keys down << 4
+#define REC_TICK          0x4   // 0 bytes: countdown reached zero
+#define REC_LFSR          0x5   // 2 bytes: value read from the LFSR
+
+// Payload length of each event type, indexed by type
+#define REC_PAYLOAD_SIZES { 0, 2, 1, 1, 0, 2 }
+
+// Hook used by the drivers; compiles away unless recording is enabled
+#ifdef SESSION_RECORD
+  #define REC_EVENT(type, data)   rec_event((type), (data))
+#else
+  #define REC_EVENT(type, data)
+#endif /* SESSION_RECORD */
+
+// Prototypes for public functions
+void rec_init();
+void rec_event(uint32 type, uint32 data);
+uint8* rec_log(uint32* length);
+void rec_dump();
+
+#endif /* __LAB_7_SESSION_REC__H */
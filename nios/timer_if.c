@@ -15,99 +15,408 @@
 //    This file implements timer hardware abstraction functions for
 //    the Game System design of lab 7.
 //
+//    It also multiplexes any number of software timers (timer_event_t)
+//    onto the one-second timer, which the countdown no longer needs.
+//    Armed events sit in a hashed wheel: slot (deadline >> SHIFT) mod
+//    SLOTS, unsorted, so starting and cancelling one are a few pointer
+//    writes.  The timer isn't ticking: it is set as a one-shot for the
+//    earliest deadline, found by walking the busy slots from now's
+//    until one holds an event due before that slot's time is up.  Its
+//    ISR posts each due event's function to the deferred work queue,
+//    re-arms the periodic ones, and sets the timer again, or stops it
+//    if nothing is left.  So the timer interrupts only when something
+//    is due (or, for an event more than a turn of the wheel away, once
+//    a turn, or after the earliest event was cancelled).
+//
 //*************************************************************************
 //*************************************************************************
 
 #include "nios_std_types.h"   // standard data types
 #include "system.h"           // BSP-provided definitions
+#include <string.h>           // for memset
 #include <sys/alt_irq.h>      // interrupt-related prototypes
 
+#include "hw_access.h"        // register access macros
 #include "timer_if.h"         // defines and constants for hw interfacing
 #include "utilities.h"        // useful utilities
-#include "pio_if.h"           // PIO interface
+#include "session_rec.h"      // session recorder
+#include "latency.h"          // for latency_record, latency_due, ...
+#include "defer.h"            // for defer_post
 
 volatile  uint16* timer_reg = (uint16*)TIMER_GAME_1SEC_BASE;
-uint32    _time_remaining;    // stores our countdown
+
+// The wheel: each slot's events, a bit per slot that has any, and
+// where the last ISR left off
+static timer_event_t*   _wheel[TIMER_WHEEL_SLOTS];
+static uint32           _wheel_busy;
+static uint32           _wheel_cursor;  // timestamp of the last look
+static uint32           _wheel_armed;   // TRUE if the timer is running
+static uint32           _wheel_due;     // ... and the timestamp it ends
+
+uint32 timer_wakeups;
+uint32 timer_fired;
+
+#ifdef IRQ_LATENCY
+  // A wakeup every second, to measure latency by
+  static timer_event_t  _probe;
+#endif /* IRQ_LATENCY */
+
+#define   WHEEL_SLOT(when)  \
+  (((when) >> TIMER_WHEEL_SHIFT) & (TIMER_WHEEL_SLOTS - 1))
+#define   WHEEL_WIDTH       (1 << TIMER_WHEEL_SHIFT)
+
+// The game countdown runs in its own peripheral, which counts, drives
+// the countdown displays, and interrupts only when it reaches zero.
+volatile  uint32* countdown = (uint32*)COUNTDOWN_0_BASE;
+
+// The free-running LED toggle timer doubles as our timestamp source: its
+// snapshot gives the position within the current period, and its ISR
+// counts the periods.
+volatile  uint16* timer_ts_reg = (uint16*)TIMER_LED_TOGGLE_500MS_BASE;
+volatile  uint32  _ts_periods;  // number of timestamp timer periods
+
+//-------------------------------------------------------------------------
+// NAME:        _timer_ts_isr
+//
+// DESCRIPTION: Interrupt service routine for the timestamp timer
+//-------------------------------------------------------------------------
+void _timer_ts_isr(void *context)
+{
+  // Clear the TO bit to acknowledge the interrupt
+  REG_WRITE(timer_ts_reg + TIMER32_REG_STATUS, 0);
+  _ts_periods++;
+
+  return;
+} /* _timer_ts_isr */
 
 //-------------------------------------------------------------------------
-// NAME:        _timer_isr
+// NAME:        _wheel_link
 //
-// DESCRIPTION: Interrupt service routine for one-second tick counter
+// DESCRIPTION: Adds an event to the slot of its deadline.
 //-------------------------------------------------------------------------
-void _timer_isr(void *context)
+static void _wheel_link(timer_event_t* event)
 {
-  if (0 != (*(timer_reg + TIMER32_REG_STATUS) & TIMER32_REG_STATUS_TO_MASK))
+  uint32 slot = WHEEL_SLOT(event->deadline);
+
+  event->prev = NULL;
+  event->next = _wheel[slot];
+  if (NULL != event->next)
   {
-    // Decrement the timer, only if it's greater than zero, to avoid
-    // wrapping around
-    if (0 != _time_remaining)
+    event->next->prev = event;
+  } /* if */
+  _wheel[slot]  = event;
+  _wheel_busy  |= 1 << slot;
+  event->armed  = TRUE;
+} /* _wheel_link */
+
+//-------------------------------------------------------------------------
+// NAME:        _wheel_unlink
+//
+// DESCRIPTION: Takes an event out of its slot.
+//-------------------------------------------------------------------------
+static void _wheel_unlink(timer_event_t* event)
+{
+  uint32 slot = WHEEL_SLOT(event->deadline);
+
+  if (NULL != event->prev)
+  {
+    event->prev->next = event->next;
+  } /* if */
+  else
+  {
+    _wheel[slot] = event->next;
+  } /* else */
+  if (NULL != event->next)
+  {
+    event->next->prev = event->prev;
+  } /* if */
+  if (NULL == _wheel[slot])
+  {
+    _wheel_busy &= ~(1 << slot);
+  } /* if */
+  event->armed = FALSE;
+} /* _wheel_unlink */
+
+//-------------------------------------------------------------------------
+// NAME:        _wheel_program
+//
+// DESCRIPTION: Sets the one-second timer for the earliest deadline, or
+//              stops it if no event is armed.  The busy slots are walked
+//              from now's; the earliest deadline seen is the earliest of
+//              all once it falls within the slot just looked at, since
+//              every later slot's events are due later still (or a whole
+//              turn later, in this slot).  Call with interrupts off.
+//-------------------------------------------------------------------------
+static void _wheel_program(uint32 now)
+{
+  timer_event_t*  event;
+  uint32          rest;
+  uint32          left;
+  uint32          best  = TIMER_EVENT_MAX_DELAY;
+  uint32          found = FALSE;
+  uint32          slot  = WHEEL_SLOT(now);
+  uint32          ends  = WHEEL_WIDTH - (now & (WHEEL_WIDTH - 1));
+
+  // the busy bits, rotated so that now's slot is bit 0
+  rest = (_wheel_busy >> slot) |
+         ((slot != 0) ? (_wheel_busy << (TIMER_WHEEL_SLOTS - slot)) : 0);
+  while (0 != rest && !(found && best < ends))
+  {
+    if (0 != (rest & 1))
+    {
+      for (event = _wheel[slot]; NULL != event; event = event->next)
+      {
+        left = event->deadline - now;
+        if ((int32)left < 0)
+        {
+          left = 0;         // overdue; it will be taken at once
+        } /* if */
+        if (left < best)
+        {
+          best  = left;
+          found = TRUE;
+        } /* if */
+      } /* for event */
+    } /* if busy */
+    rest >>= 1;
+    slot   = (slot + 1) & (TIMER_WHEEL_SLOTS - 1);
+    ends  += WHEEL_WIDTH;
+  } /* while */
+
+  if (!found)
+  {
+    REG_WRITE(timer_reg + TIMER32_REG_CONTROL,
+              TIMER32_REG_CONTROL_STOP_MASK);
+    _wheel_armed = FALSE;
+    return;
+  } /* if idle */
+
+  // writing the period stops the counter and loads it; then one shot
+  if (best < TIMER_EVENT_MIN_DELAY)
+  {
+    best = TIMER_EVENT_MIN_DELAY;
+  } /* if */
+  REG_WRITE(timer_reg + TIMER32_REG_PERIOD_L, (uint16)(best - 1));
+  REG_WRITE(timer_reg + TIMER32_REG_PERIOD_H, (uint16)((best - 1) >> 16));
+  REG_WRITE(timer_reg + TIMER32_REG_STATUS, 0);
+  REG_WRITE(timer_reg + TIMER32_REG_CONTROL,
+            TIMER32_REG_CONTROL_ITO_MASK | TIMER32_REG_CONTROL_START_MASK);
+  _wheel_armed = TRUE;
+  _wheel_due   = now + best;
+} /* _wheel_program */
+
+//-------------------------------------------------------------------------
+// NAME:        _timer_wheel_isr
+//
+// DESCRIPTION: Interrupt service routine for the one-second timer: posts
+//              the events that are due, from the slots between the last
+//              look and now, and sets the timer for the next.
+//-------------------------------------------------------------------------
+void _timer_wheel_isr(void *context)
+{
+  timer_event_t*  event;
+  timer_event_t*  next;
+  timer_event_t*  again = NULL;   // periodic events to re-arm
+  uint32          now;
+  uint32          slots;
+  uint32          slot;
+
+  // Clear the TO bit to acknowledge the interrupt
+  REG_WRITE(timer_reg + TIMER32_REG_STATUS, 0);
+  now = timer_timestamp();
+  timer_wakeups++;
+  #ifdef IRQ_LATENCY
+    if (_wheel_armed && (int32)(now - _wheel_due) >= 0)
     {
-      _time_remaining--;
+      latency_record(LATENCY_TIMER_GAME, now - _wheel_due);
     } /* if */
-    else
+  #endif /* IRQ_LATENCY */
+
+  slots = (now >> TIMER_WHEEL_SHIFT) - (_wheel_cursor >> TIMER_WHEEL_SHIFT);
+  slots = (slots >= TIMER_WHEEL_SLOTS) ? TIMER_WHEEL_SLOTS : slots + 1;
+  for (slot = WHEEL_SLOT(_wheel_cursor); 0 != slots--;
+       slot = (slot + 1) & (TIMER_WHEEL_SLOTS - 1))
+  {
+    for (event = _wheel[slot]; NULL != event; event = next)
     {
-      // Stop the timer because we're at zero.
-      timer_countdown_stop();
-    } /* else */
+      next = event->next;
+      if ((int32)(event->deadline - now) > 0)
+      {
+        continue;           // a later turn of the wheel
+      } /* if */
 
-    // Send the current count to the SSD
-    pio_ssd_update(_time_remaining, TRUE);
+      _wheel_unlink(event);
+      timer_fired++;
+      if (NULL != event->func)
+      {
+        defer_post(event->func, event->arg);
+      } /* if */
+      if (0 != event->period)
+      {
+        // keep the phase, unless a whole period has been missed
+        event->deadline += event->period;
+        if ((int32)(event->deadline - now) <= 0)
+        {
+          event->deadline = now + event->period;
+        } /* if */
+        event->next = again;
+        again       = event;
+      } /* if periodic */
+    } /* for event */
+  } /* for slot */
 
-    // Clear the TO bit to acknowledge the interrupt
-    *(timer_reg + TIMER32_REG_STATUS) = 0;
+  for (event = again; NULL != event; event = next)
+  {
+    next = event->next;
+    _wheel_link(event);
+  } /* for event */
+  _wheel_cursor = now;
+  _wheel_program(now);
+
+  return;
+} /* _timer_wheel_isr */
+
+//-------------------------------------------------------------------------
+// NAME:        timer_event_start
+//
+// DESCRIPTION: Arms a software timer, or re-arms one already armed.  When
+//              it comes due, its function is posted to the deferred work
+//              queue (see defer.c) and so runs from the main loop.
+// ARGUMENTS:   timer_event_t* event, the timer (its contents are set here)
+//              uint32 delay, cycles from now until it is due (at most
+//                            TIMER_EVENT_MAX_DELAY)
+//              uint32 period, cycles between later runs, or 0 to run once
+//              defer_func_t func, uint32 arg, what to run (func may be
+//                                             NULL, for just a wakeup)
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void timer_event_start(timer_event_t* event, uint32 delay, uint32 period,
+                       defer_func_t func, uint32 arg)
+{
+  alt_irq_context irq_context;
+  uint32          now;
+
+  irq_context = alt_irq_disable_all();
+  now = timer_timestamp();
+  if (event->armed)
+  {
+    _wheel_unlink(event);
+  } /* if */
+  event->deadline = now + delay;
+  event->period   = period;
+  event->func     = func;
+  event->arg      = arg;
+  _wheel_link(event);
+
+  // only an earlier deadline moves the timer
+  if (!_wheel_armed || (int32)(event->deadline - _wheel_due) < 0)
+  {
+    _wheel_program(now);
+  } /* if */
+  alt_irq_enable_all(irq_context);
+
+  return;
+} /* timer_event_start */
+
+//-------------------------------------------------------------------------
+// NAME:        timer_event_cancel
+//
+// DESCRIPTION: Disarms a software timer.  Its function won't be posted
+//              again, though a run already posted still happens.  The
+//              timer isn't moved unless no event is left; if this was the
+//              earliest, the ISR just finds nothing due and moves on.
+// ARGUMENTS:   timer_event_t* event, the timer
+// RETURNS:     uint32, TRUE if it was armed
+//-------------------------------------------------------------------------
+uint32 timer_event_cancel(timer_event_t* event)
+{
+  alt_irq_context irq_context;
+  uint32          armed;
+
+  irq_context = alt_irq_disable_all();
+  armed = event->armed;
+  if (armed)
+  {
+    _wheel_unlink(event);
+    if (0 == _wheel_busy && _wheel_armed)
+    {
+      REG_WRITE(timer_reg + TIMER32_REG_CONTROL,
+                TIMER32_REG_CONTROL_STOP_MASK);
+      _wheel_armed = FALSE;
+    } /* if none left */
+  } /* if */
+  alt_irq_enable_all(irq_context);
+
+  return armed;
+} /* timer_event_cancel */
+
+//-------------------------------------------------------------------------
+// NAME:        _countdown_isr
+//
+// DESCRIPTION: Interrupt service routine for the countdown reaching zero.
+//              The peripheral has already stopped itself and keeps
+//              showing 00 until timer_countdown_stop.
+//-------------------------------------------------------------------------
+void _countdown_isr(void *context)
+{
+  LATENCY_IRQ(LATENCY_COUNTDOWN, COUNTDOWN_0_IRQ);
+
+  if (0 != (REG_READ(countdown + COUNTDOWN_REG_STATUS) &
+            COUNTDOWN_REG_STATUS_EXPIRED_MASK))
+  {
+    REC_EVENT(REC_TICK, 0);
+
+    // Clear the expired bit to acknowledge the interrupt
+    REG_WRITE(countdown + COUNTDOWN_REG_STATUS, 0);
   } /* if */
 
   return;
-} /* _timer_isr */
+} /* _countdown_isr */
 
 //-------------------------------------------------------------------------
 // NAME:        timer_countdown_start
 //
 // DESCRIPTION: Starts counting down at one-second intervals using the
-//              hardware timer
+//              countdown peripheral, and lights its displays.
 // ARGUMENTS:   uint32 start_count, initial value to count down from
+//                                  (at most COUNTDOWN_MAX)
 // RETURNS:     void
 //-------------------------------------------------------------------------
 void timer_countdown_start(uint32 start_count)
 {
-  uint16 reg_val;
-
-  // reset the count
-  _time_remaining = start_count;
-
-  // Send it to the SSD
-  pio_ssd_update(_time_remaining, TRUE);
-
-  // set up and start the timer: clear TO bit, reset to start value, then
-  // enable the interrupt, continuous run, and start the timer
-  *(timer_reg + TIMER32_REG_STATUS) = 0;
-  *(timer_reg + TIMER32_REG_PERIOD_L) = 1;
-  reg_val = *(timer_reg + TIMER32_REG_CONTROL);
-  reg_val |= (TIMER32_REG_CONTROL_ITO_MASK | TIMER32_REG_CONTROL_CONT_MASK |
-              TIMER32_REG_CONTROL_START_MASK);
-  *(timer_reg + TIMER32_REG_CONTROL) = reg_val;
+  if (start_count > COUNTDOWN_MAX)
+  {
+    start_count = COUNTDOWN_MAX;
+  } /* if */
+
+  // load the start value (which also stops it), clear any old expiry,
+  // then enable the interrupt and the displays, and start it
+  REG_WRITE(countdown + COUNTDOWN_REG_LOAD,
+            convert_to_bcd((uint16)start_count));
+  REG_WRITE(countdown + COUNTDOWN_REG_STATUS, 0);
+  #ifdef IRQ_LATENCY
+    // it expires start_count whole ticks after it starts, a second each
+    latency_due(LATENCY_COUNTDOWN,
+                timer_timestamp() + start_count * ALT_CPU_FREQ);
+  #endif /* IRQ_LATENCY */
+  REG_WRITE(countdown + COUNTDOWN_REG_CONTROL,
+            COUNTDOWN_REG_CONTROL_IE_MASK | COUNTDOWN_REG_CONTROL_SHOW_MASK |
+            COUNTDOWN_REG_CONTROL_START_MASK);
   return;
 } /* timer_countdown_start */
 
 //-------------------------------------------------------------------------
 // NAME:        timer_countdown_stop
 //
-// DESCRIPTION: Stops the timer and disables interrupts.
+// DESCRIPTION: Stops the countdown, disables its interrupt, and blanks
+//              its displays.
 // ARGUMENTS:   None
 // RETURNS:     void
 //-------------------------------------------------------------------------
 void timer_countdown_stop()
 {
-  uint16 reg_val;
-
-  // Stop the timer, then disable the interrupts
-  reg_val = *(timer_reg + TIMER32_REG_CONTROL);
-  reg_val |= TIMER32_REG_CONTROL_STOP_MASK;
-  reg_val &= ~(TIMER32_REG_CONTROL_ITO_MASK);
-  *(timer_reg + TIMER32_REG_CONTROL) = reg_val;
-
-  // Turn off SSDs
-  pio_ssd_update(0, FALSE);
+  REG_WRITE(countdown + COUNTDOWN_REG_CONTROL,
+            COUNTDOWN_REG_CONTROL_STOP_MASK);
 
   return;
 } /* timer_countdown_stop */
@@ -121,7 +430,8 @@ void timer_countdown_stop()
 //-------------------------------------------------------------------------
 uint32 timer_remaining()
 {
-  return _time_remaining;
+  return (REG_READ(countdown + COUNTDOWN_REG_REMAINING) >>
+          COUNTDOWN_REG_REMAINING_BIN_SHIFT) & 0xFF;
 } /* timer_remaining */
 
 //-------------------------------------------------------------------------
@@ -136,7 +446,7 @@ uint32 timer_expired()
 {
   uint32 result = TRUE;
 
-  if (_time_remaining > 0)
+  if (timer_remaining() > 0)
   {
     result = FALSE;
   } /* if */
@@ -144,6 +454,51 @@ uint32 timer_expired()
   return result;
 } /* timer_expired */
 
+//-------------------------------------------------------------------------
+// NAME:        timer_timestamp
+//
+// DESCRIPTION: Returns a free-running timestamp in system clock cycles,
+//              built from the timestamp timer's period count and a
+//              snapshot of its counter.  Wraps every 2^32 cycles (about
+//              86 seconds at 50 MHz), so only differences are meaningful.
+//              Safe to call from ISRs.
+// ARGUMENTS:   None
+// RETURNS:     uint32, cycles
+//-------------------------------------------------------------------------
+uint32 timer_timestamp()
+{
+  alt_irq_context irq_context;
+  uint32          periods;
+  uint32          snap;
+  uint32          status;
+
+  // Keep ISRs out from the latch to the last read: one that calls this
+  // in between would latch a new snapshot under us (and the period ISR
+  // would move the count).
+  irq_context = alt_irq_disable_all();
+
+  periods = _ts_periods;
+
+  // writing either snap register latches the counter
+  REG_WRITE(timer_ts_reg + TIMER32_REG_SNAP_L, 0);
+  snap    = REG_READ(timer_ts_reg + TIMER32_REG_SNAP_L);
+  snap   |= (uint32)REG_READ(timer_ts_reg + TIMER32_REG_SNAP_H) << 16;
+  status  = REG_READ(timer_ts_reg + TIMER32_REG_STATUS);
+
+  alt_irq_enable_all(irq_context);
+
+  // If the counter has wrapped but its interrupt hasn't been taken yet
+  // (interrupts are off, or we're in a higher-priority ISR), the period
+  // count is one behind.  A wrap is recent if the count is still high.
+  if (0 != (status & TIMER32_REG_STATUS_TO_MASK) &&
+      snap > (TIMER_TS_PERIOD / 2))
+  {
+    periods++;
+  } /* if */
+
+  return (periods * TIMER_TS_PERIOD) + (TIMER_TS_PERIOD - 1 - snap);
+} /* timer_timestamp */
+
 //-------------------------------------------------------------------------
 // NAME:        timer_init
 //
@@ -154,12 +509,38 @@ uint32 timer_expired()
 //-------------------------------------------------------------------------
 void timer_init()
 {
-  _time_remaining = 0;
-  *(timer_reg + TIMER32_REG_STATUS) = 0x0;
-  *(timer_reg + TIMER32_REG_CONTROL) = TIMER32_REG_CONTROL_STOP_MASK;
+  // Countdown: stopped, blank, and nothing pending
+  REG_WRITE(countdown + COUNTDOWN_REG_CONTROL,
+            COUNTDOWN_REG_CONTROL_STOP_MASK);
+  REG_WRITE(countdown + COUNTDOWN_REG_LOAD, 0);
+  REG_WRITE(countdown + COUNTDOWN_REG_STATUS, 0);
+  alt_ic_isr_register(COUNTDOWN_0_IRQ_INTERRUPT_CONTROLLER_ID,
+                      COUNTDOWN_0_IRQ, _countdown_isr, 0, 0);
+
+  // The timestamp timer always runs; just count its periods.
+  _ts_periods = 0;
+  REG_WRITE(timer_ts_reg + TIMER32_REG_STATUS, 0x0);
+  alt_ic_isr_register(TIMER_LED_TOGGLE_500MS_IRQ_INTERRUPT_CONTROLLER_ID,
+                      TIMER_LED_TOGGLE_500MS_IRQ, _timer_ts_isr, 0, 0);
+  REG_WRITE(timer_ts_reg + TIMER32_REG_CONTROL,
+            TIMER32_REG_CONTROL_ITO_MASK | TIMER32_REG_CONTROL_CONT_MASK);
 
+  // The one-second timer runs the software timers: stopped and quiet
+  // until one is armed
+  REG_WRITE(timer_reg + TIMER32_REG_CONTROL, TIMER32_REG_CONTROL_STOP_MASK);
+  REG_WRITE(timer_reg + TIMER32_REG_STATUS, 0x0);
+  memset(_wheel, 0, sizeof(_wheel));
+  _wheel_busy   = 0;
+  _wheel_armed  = FALSE;
+  _wheel_cursor = timer_timestamp();
+  timer_wakeups = 0;
+  timer_fired   = 0;
   alt_ic_isr_register(TIMER_GAME_1SEC_IRQ_INTERRUPT_CONTROLLER_ID,
-                      TIMER_GAME_1SEC_IRQ, _timer_isr, 0, 0);
+                      TIMER_GAME_1SEC_IRQ, _timer_wheel_isr, 0, 0);
+  #ifdef IRQ_LATENCY
+    _probe.armed = FALSE;
+    timer_event_start(&_probe, ALT_CPU_FREQ, ALT_CPU_FREQ, latency_probe, 0);
+  #endif /* IRQ_LATENCY */
 
   return;                      
 } /* timer_init */
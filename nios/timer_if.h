@@ -21,6 +21,7 @@
 #define __LAB_7_TIMER_IF__H
 
 #include "nios_std_types.h"   // standard data types
+#include "defer.h"            // for defer_func_t
 
 // 32-bit timer register offsets (uint16)
 #define   TIMER32_REG_STATUS              0
@@ -36,11 +37,61 @@
 #define   TIMER32_REG_CONTROL_START_MASK  0x4
 #define   TIMER32_REG_CONTROL_STOP_MASK   0x8
 
+// Countdown peripheral register offsets (uint32) and masks
+#define   COUNTDOWN_REG_STATUS                0
+#define   COUNTDOWN_REG_CONTROL               1
+#define   COUNTDOWN_REG_LOAD                  2
+#define   COUNTDOWN_REG_REMAINING             3
+#define   COUNTDOWN_REG_STATUS_EXPIRED_MASK   0x1
+#define   COUNTDOWN_REG_STATUS_RUNNING_MASK   0x2
+#define   COUNTDOWN_REG_CONTROL_IE_MASK       0x1
+#define   COUNTDOWN_REG_CONTROL_SHOW_MASK     0x2
+#define   COUNTDOWN_REG_CONTROL_START_MASK    0x4
+#define   COUNTDOWN_REG_CONTROL_STOP_MASK     0x8
+#define   COUNTDOWN_REG_REMAINING_BIN_SHIFT   8
+
+// Largest start value the countdown can show (two BCD digits)
+#define   COUNTDOWN_MAX                       99
+
+// Cycles per period of the timestamp timer
+#define   TIMER_TS_PERIOD         (TIMER_LED_TOGGLE_500MS_LOAD_VALUE + 1)
+
+// Software timers, on the one-second timer (see timer_event_start).
+// Events are hashed by deadline into a wheel of slots, each
+// 2^TIMER_WHEEL_SHIFT cycles (168 ms) wide, 5.4 s around.
+#define   TIMER_WHEEL_SLOTS       32    // a power of two, at most 32
+#define   TIMER_WHEEL_SHIFT       23
+
+// Shortest time the one-second timer is set for, and longest delay
+#define   TIMER_EVENT_MIN_DELAY   500
+#define   TIMER_EVENT_MAX_DELAY   0x7FFFFFFF
+
+// A software timer.  The caller owns it; the driver links it into the
+// wheel while it is armed.
+typedef struct timer_event
+{
+  struct timer_event* next;         // in its slot
+  struct timer_event* prev;
+  uint32              deadline;     // timer_timestamp
+  uint32              period;       // cycles; 0 for one-shot
+  defer_func_t        func;         // run deferred, or NULL for none
+  uint32              arg;
+  uint32              armed;
+} timer_event_t;
+
+// Statistics
+extern uint32 timer_wakeups;        // one-second timer interrupts
+extern uint32 timer_fired;          // events that came due
+
 // Prototypes
+void timer_event_start(timer_event_t* event, uint32 delay, uint32 period,
+                       defer_func_t func, uint32 arg);
+uint32 timer_event_cancel(timer_event_t* event);
 void timer_countdown_start(uint32 start_count);
 void timer_countdown_stop();
 uint32 timer_remaining();
 uint32 timer_expired();
+uint32 timer_timestamp();
 void timer_init();
 
 #endif /* __LAB_7_TIMER_IF__H */
@@ -23,8 +23,13 @@
 #include <string.h>                 // string handling
 #include "nios_std_types.h"         // for standard embedded types
 #include "system.h"                 // for Qsys defines
+#include "hw_access.h"              // register access macros
+#include "session_rec.h"            // session recorder
+#include "defer.h"                  // for defer_post
+#include "latency.h"                // for LATENCY_IRQ, latency_raise
+#include "msglog.h"                 // for MSGLOG
 #include "uart_if.h"                // uart_if headers
-#include "utilities.h"
+#include "utilities.h"                // for color_class, CC_*
 
 // pointers to registers
 volatile uint32* uartDataRegPtr = ((uint32*)JTAG_UART_0_BASE +
@@ -37,28 +42,78 @@ uint8  _recvstr_data[UART_RECVBUFFER];
 uint32 _recvstr_ready;      // TRUE when there's a string ready
 uint32 _recvstr_idx;        // used as index for _recvstr_data
 
+// The line being typed in UART_GAMEMODE as a packed code, built as the
+// colors arrive, and the last complete one
+uint32 _recvcode;
+uint32 _recvcode_line;      // packed code of the last line
+uint32 _recvcode_length;    // ... and how many colors it has
+
 // flag to set what characters we'll accept
 uint32 _uart_mode;
 
+// Complaints from the ISR, sent later by _uart_warn (or just logged; see
+// msglog.c)
+#ifndef MSG_LOG
+#define UART_WARN_BUSY      0
+#define UART_WARN_SPURIOUS  1
+static const char* _uart_warnings[] =
+{
+  "uart_recv_isr: can't process character until previous line is picked up\n",
+  "uart_recv_isr: got interrupt but nothing to receive??\n"
+};
+#endif /* !MSG_LOG */
+
+//-------------------------------------------------------------------------
+// NAME:        _uart_echo, _uart_warn
+//
+// DESCRIPTION: Work the receive ISR defers to the main loop, since both
+//              can wait on a full transmit FIFO: echoing a character, and
+//              sending one of _uart_warnings.
+//-------------------------------------------------------------------------
+static void _uart_echo(uint32 character)
+{
+  uart_SendByte((uint8)character);
+} /* _uart_echo */
+
+#ifndef MSG_LOG
+static void _uart_warn(uint32 which)
+{
+  uart_SendString((uint8*)_uart_warnings[which]);
+} /* _uart_warn */
+#endif /* !MSG_LOG */
+
 //-------------------------------------------------------------------------
 // NAME:        _uart_recv_isr
 //
 // DESCRIPTION: Interrupt service routine for servicing incoming data from
-//              the UART.
+//              the UART.  It never writes to the UART itself; echoes and
+//              complaints are deferred (see defer.c).  A write interrupt
+//              is only ever a latency probe (uart_latency_probe), and is
+//              just turned off again.
 //-------------------------------------------------------------------------
 void _uart_recv_isr(void *context)
 {
+  uint32  control;
   uint32  data;
   uint8   character;
+  uint8   class;
 
-  if (0 != (*uartCtrlRegPtr & JTAG_UART_RIRQ_PEND_MASK))
+  LATENCY_IRQ(LATENCY_UART, JTAG_UART_0_IRQ);
+  control = REG_READ(uartCtrlRegPtr);
+  if (0 != (control & JTAG_UART_WIRQ_PEND_MASK))
+  {
+    REG_WRITE(uartCtrlRegPtr, JTAG_UART_RIRQ_EN_MASK);
+  } /* if probe */
+  if (0 != (control & JTAG_UART_RIRQ_PEND_MASK))
   {
     // It's a valid interrupt: fetch the data register and test rvalid
-    data = *uartDataRegPtr;
+    data = REG_READ(uartDataRegPtr);
     if (0 != (data & JTAG_UART_RV_BIT_MASK))
     {
       character = (uint8)(data & 0xFF);
-      if ((character >= 'a') && (character <= 'z'))
+      REC_EVENT(REC_UART_RX, character);
+      class = color_class[character];
+      if (0 != (class & CC_LOWER))
       {
         // convert lower-case characters to upper case
         character -= 0x20;
@@ -67,20 +122,28 @@ void _uart_recv_isr(void *context)
       if (_recvstr_ready)
       {
         // Can't do much until this is cleared...
-        uart_SendString((uint8*)"uart_recv_isr: can't process character until previous line is picked up\n");
+        #ifdef MSG_LOG
+          MSGLOG(MSG_UART_BUSY, character, 0);
+        #else
+          defer_post(_uart_warn, UART_WARN_BUSY);
+        #endif /* MSG_LOG */
       } /* if */
       else if (('\b' == character) && (_recvstr_idx > 0))
       {
         // backspace: echo it, and decrement our index
-        uart_SendByte(character);
-        _recvstr_data[_recvstr_idx--] = NULL;
+        defer_post(_uart_echo, character);
+        _recvstr_data[--_recvstr_idx] = NULL;
+        _recvcode &= ~(0xF << (_recvstr_idx * 4));
       } /* if */
       else if ('\n' == character)
       {
         // newline character: send stuff out
         _recvstr_data[_recvstr_idx] = NULL;
+        _recvcode_line   = _recvcode;
+        _recvcode_length = _recvstr_idx;
         _recvstr_ready = TRUE;
         _recvstr_idx = 0;
+        _recvcode = 0;
       } /* else if */
       else if (_recvstr_idx+1 < UART_RECVBUFFER)
       {
@@ -88,35 +151,34 @@ void _uart_recv_isr(void *context)
         if (UART_MAINMODE == _uart_mode)
         {
           // Main mode: allow normal characters plus backspace and newline
-          if ((character >= 0x20) && (character <= 0x7E))
+          if (0 != (class & CC_PRINT))
           {
-            uart_SendByte(character);
+            defer_post(_uart_echo, character);
             _recvstr_data[_recvstr_idx++] = character;
           } /* if */
         } /* if */
         else if (UART_GAMEMODE == _uart_mode)
         {
-          // Game mode: only accept colors
-          switch (character)
+          // Game mode: only accept colors, and pack them as they come
+          if (0 != (class & CC_COLOR))
           {
-            case 'G':
-            case 'B':
-            case 'R':
-            case 'O':
-            case 'Y':
-            case 'W':
-              uart_SendByte(character);
-              _recvstr_data[_recvstr_idx++] = character;
-              break;
-          } /* switch */
+            defer_post(_uart_echo, character);
+            _recvcode |= (uint32)(class & CC_COLOR_MASK) <<
+                         (_recvstr_idx * 4);
+            _recvstr_data[_recvstr_idx++] = character;
+          } /* if */
         } /* else if */
       } /* else if */
     } /* if */
   } /* if */
-  else
+  else if (0 == (control & JTAG_UART_WIRQ_PEND_MASK))
   {
     // probable error condition
-    uart_SendString((uint8*)"uart_recv_isr: got interrupt but nothing to receive??\n");
+    #ifdef MSG_LOG
+      MSGLOG(MSG_UART_SPURIOUS, 0, 0);
+    #else
+      defer_post(_uart_warn, UART_WARN_SPURIOUS);
+    #endif /* MSG_LOG */
   } /* else */
 
   return;
@@ -132,39 +194,76 @@ void _uart_recv_isr(void *context)
 //-------------------------------------------------------------------------
 void uart_SendByte(uint8 byte)
 {
-  while (0 == (*uartCtrlRegPtr & JTAG_UART_WSPACE_MASK))
+  while (0 == (REG_READ(uartCtrlRegPtr) & JTAG_UART_WSPACE_MASK))
   {
     // available write space is zero.
     // spin until the FIFO has room.
   } /* while */
 
   // store our byte to the FIFO
-  *uartDataRegPtr = (uint32)byte;
+  REG_WRITE(uartDataRegPtr, (uint32)byte);
 } /* uart_SendByte */
 
 //-------------------------------------------------------------------------
 // NAME:        uart_SendString
 //
 // DESCRIPTION: Sends a NULL-terminated string to the UART.  This will
-//              block if uart_SendByte blocks.
+//              block if uart_SendV blocks.
 // ARGUMENTS:   uint8* msg, a pointer to a null-terminated string
 // RETURNS:     void
 //-------------------------------------------------------------------------
 void uart_SendString(uint8 *msg)
 {
-  uint8 byte;
+  uart_frag_t frag;
 
-  while (TRUE)
+  frag.data   = msg;
+  frag.length = strlen((char*)msg);
+  uart_SendV(&frag, 1);
+} /* uart_SendString */
+
+//-------------------------------------------------------------------------
+// NAME:        uart_SendV
+//
+// DESCRIPTION: Sends several fragments to the UART as one message.  The
+//              write space is read once and then filled without checking
+//              again, so a message costs one data register write per byte
+//              plus one control register read per FIFO's worth (or per
+//              wait, when the FIFO is full).  Nothing else writes to the
+//              FIFO meanwhile: the receive ISR defers its echo to the
+//              main loop.  Blocks until the last byte is in the FIFO.
+// ARGUMENTS:   const uart_frag_t* frags, the fragments, in order
+//              uint32 count, number of fragments
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void uart_SendV(const uart_frag_t* frags, uint32 count)
+{
+  uint32 space;
+  uint32 sent = 0;      /* bytes of the current fragment already sent */
+
+  // skip empty fragments; after this, each one is left as soon as its
+  // last byte is written
+  while ((count > 0) && (sent == frags->length))
+  {
+    frags++;
+    count--;
+  } /* while */
+
+  while (count > 0)
   {
-    byte = *msg;          // fetch next character from the string
-    if (NULL == byte)
+    space = (REG_READ(uartCtrlRegPtr) & JTAG_UART_WSPACE_MASK) >> 16;
+    while ((space > 0) && (count > 0))
     {
-      break;              // we're at the end of the string
-    } /* if end */
-    uart_SendByte(byte);  // send to the UART
-    msg += 1;             // re-point at the next character
+      REG_WRITE(uartDataRegPtr, (uint32)frags->data[sent++]);
+      space--;
+      while ((count > 0) && (sent == frags->length))
+      {
+        frags++;
+        count--;
+        sent = 0;
+      } /* while */
+    } /* while room */
   } /* while */
-} /* uart_SendString */
+} /* uart_SendV */
 
 //-------------------------------------------------------------------------
 // NAME:        uart_RecvString
@@ -193,7 +292,7 @@ uint32 uart_RecvString(uint8 str[])
   // Check to see if we have something to return.  If so, update the ptr
   if (_recvstr_ready)
   {
-    strcpy(str, _recvstr_data);
+    strcpy((char*)str, (char*)_recvstr_data);
     _recvstr_ready = FALSE;
     result = TRUE;
   } /* if */
@@ -209,6 +308,33 @@ uint32 uart_RecvString(uint8 str[])
   return result;
 } /* uart_RecvString */
 
+//-------------------------------------------------------------------------
+// NAME:        uart_RecvCode
+//
+// DESCRIPTION: Returns the last line typed in UART_GAMEMODE, if a new one
+//              is available, as the packed code the ISR built while it
+//              was typed (see to_colorstr for the format).  A line may
+//              be shorter than CB_COLOR_LENGTH; its missing slots are 0.
+// ARGUMENTS:   uint32* code, receives the packed code
+//              uint32* length, receives the number of colors in it
+// RETURNS:     uint32, TRUE if a line was delivered, FALSE otherwise
+//-------------------------------------------------------------------------
+uint32 uart_RecvCode(uint32* code, uint32* length)
+{
+  uint32 result = FALSE;
+
+  // The ISR won't touch the line until _recvstr_ready is cleared
+  if (_recvstr_ready)
+  {
+    *code   = _recvcode_line;
+    *length = _recvcode_length;
+    _recvstr_ready = FALSE;
+    result = TRUE;
+  } /* if */
+
+  return result;
+} /* uart_RecvCode */
+
 //-------------------------------------------------------------------------
 // NAME:        uart_SetMode
 //
@@ -224,6 +350,37 @@ void uart_SetMode(uint32 mode)
   return;
 } /* uart_SetMode */
 
+#ifdef IRQ_LATENCY
+//-------------------------------------------------------------------------
+// NAME:        uart_latency_probe
+//
+// DESCRIPTION: Raises the UART's interrupt for the latency statistics
+//              (see latency.c), by enabling the write interrupt while the
+//              write FIFO is empty enough for it to be pending at once.
+//              The ISR turns it off again.  Does nothing while the FIFO
+//              is fuller than that.
+// ARGUMENTS:   None
+// RETURNS:     void
+//-------------------------------------------------------------------------
+void uart_latency_probe()
+{
+  alt_irq_context irq_context;
+  uint32          space;
+
+  irq_context = alt_irq_disable_all();
+  space = REG_READ(uartCtrlRegPtr) >> JTAG_UART_WSPACE_SHIFT;
+  if (space >= JTAG_UART_WFIFO_DEPTH - JTAG_UART_WIRQ_THRESHOLD)
+  {
+    latency_raise(LATENCY_UART);
+    REG_WRITE(uartCtrlRegPtr,
+              JTAG_UART_RIRQ_EN_MASK | JTAG_UART_WIRQ_EN_MASK);
+  } /* if */
+  alt_irq_enable_all(irq_context);
+
+  return;
+} /* uart_latency_probe */
+#endif /* IRQ_LATENCY */
+
 //-------------------------------------------------------------------------
 // NAME:        uart_init
 //
@@ -236,7 +393,6 @@ void uart_init()
 {
   uint8* test_msg_0 = (uint8*)INIT_MESSAGE_0;
   uint8* test_msg_1 = (uint8*)INIT_MESSAGE_1;
-  uint8 byte;
 
   // Send first welcome message
   uart_SendString(test_msg_0);
@@ -246,9 +402,10 @@ void uart_init()
   memset(_recvstr_data, 0, sizeof(_recvstr_data));
   _recvstr_ready = FALSE;
   _recvstr_idx = 0;
+  _recvcode = 0;
 
   // read the data reg, to clear it
-  byte = *uartDataRegPtr;
+  (void)REG_READ(uartDataRegPtr);
 
   // register our ISR.
   alt_ic_isr_register(JTAG_UART_0_IRQ_INTERRUPT_CONTROLLER_ID,
@@ -256,7 +413,7 @@ void uart_init()
                       _uart_recv_isr, 0, 0);
 
   // enable UART read interrupt, disable write interrupt
-  *uartCtrlRegPtr = JTAG_UART_RIRQ_EN_MASK;
+  REG_WRITE(uartCtrlRegPtr, JTAG_UART_RIRQ_EN_MASK);
 
   // Send second welcome message
   uart_SendString(test_msg_1);
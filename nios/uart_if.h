@@ -30,7 +30,15 @@
 #define JTAG_UART_RV_BIT_MASK       0x00008000
 #define JTAG_UART_DATA_MASK         0x000000FF
 #define JTAG_UART_RIRQ_EN_MASK      0x00000001
+#define JTAG_UART_WIRQ_EN_MASK      0x00000002
 #define JTAG_UART_RIRQ_PEND_MASK    0x00000100
+#define JTAG_UART_WIRQ_PEND_MASK    0x00000200
+#define JTAG_UART_WSPACE_SHIFT      16
+
+// Write FIFO depth and write interrupt threshold (writeBufferDepth and
+// writeIRQThreshold in nios_system.qsys)
+#define JTAG_UART_WFIFO_DEPTH       64
+#define JTAG_UART_WIRQ_THRESHOLD    8
 
 // Constants
 #define INIT_MESSAGE_0  "Game System JTAG UART driver is active.\n"
@@ -41,11 +49,35 @@
 #define UART_MAINMODE   0x1
 #define UART_GAMEMODE   0x2
 
+// One piece of a message for uart_SendV
+typedef struct
+{
+  const uint8*  data;
+  uint32        length;
+} uart_frag_t;
+
+// Fragment for a string literal or CB_* message, measured at compile time
+#define UART_CONST(str)       { (const uint8*)(str), sizeof(str) - 1 }
+
+// Fragment for run-time data
+#define UART_FRAG(ptr, len)   ((uart_frag_t){ (const uint8*)(ptr), (len) })
+
+// Sends a string literal or CB_* message without scanning it
+#define UART_SEND_CONST(str)                                    \
+  do                                                            \
+  {                                                             \
+    static const uart_frag_t _uart_const = UART_CONST(str);     \
+    uart_SendV(&_uart_const, 1);                                \
+  } while (0)
+
 // Prototypes for public functions
 void uart_SendByte(uint8 byte);
 void uart_SendString(uint8 *msg);
+void uart_SendV(const uart_frag_t* frags, uint32 count);
 uint32 uart_RecvString(uint8 *str);
+uint32 uart_RecvCode(uint32* code, uint32* length);
 void uart_SetMode(uint32 mode);
+void uart_latency_probe();
 void uart_init();
 
 #endif /* __LAB_7_UART_IF__H */
@@ -23,42 +23,6 @@
 #include "lfsr_if.h"          // for random number generation
 #include "utilities.h"
 
-//-------------------------------------------------------------------------
-// NAME:        _is_in
-//
-// DESCRIPTION: Used by secret code generation to detect if a given
-//              4-bit segment is already present in the code.
-// ARGUMENTS:   uint32 guess        (truncated to lower 4 bits)
-//              uint32* secret_code (scanned in 4-bit chunks)
-// RETURNS:     0 if guess is not found in secret_code,
-//              > 0 if it is (with 4-bit-aligned index of match)
-//-------------------------------------------------------------------------
-uint32 _is_in(uint32 guess, uint32* secret_code)
-{
-  uint32 result = 0;    /* end result */
-
-  uint32 i;
-  uint32 code_part;
-
-  // Remove extraneous bits from the guess
-  guess &= 0xF;
-
-  for (i = 0; i < CB_COLOR_LENGTH; i++)
-  {
-    // Isolate a four-bit slot of the secret code.
-    code_part = (*secret_code >> i*4);
-    code_part &= 0xF;
-    // Test for a match.
-    if (guess == code_part)
-    {
-      result = i+1;
-      break;
-    } /* if */
-  } /* for i */
-
-  return result;
-} /* _is_in */
-
 //*************************************************************************
 // convert_to_bcd
 //*************************************************************************
@@ -101,34 +65,8 @@ uint32 convert_to_bcd(uint16 number)
 //-------------------------------------------------------------------------
 uint8 to_color(uint8 number)
 {
-  uint8 color;
-
-  switch (number)
-  {
-    case 0:
-      color = 'G';  // Green
-      break;
-    case 1:
-      color = 'B';  // Blue
-      break;
-    case 2:
-      color = 'R';  // Red
-      break;
-    case 3:
-      color = 'O';  // Octarine
-      break;
-    case 4:
-      color = 'Y';  // Yellow
-      break;
-    case 5:
-      color = 'W';  // White
-      break;
-    default:
-      color = 'X';  // invalid
-      break;
-  } /* switch */
-
-  return color;
+  // color_letters is CB_COLOR_LETTERS (see color_table.c)
+  return (number < CB_POSSIBLE_COLORS) ? color_letters[number] : 'X';
 } /* to_color */
 
 //-------------------------------------------------------------------------
@@ -160,45 +98,229 @@ void to_colorstr(uint32 number, uint8* color_string)
   return;
 } /* to_colorstr */
 
+//-------------------------------------------------------------------------
+// NAME:        from_colorstr
+//
+// DESCRIPTION: Converts a string of color letters (either case) back to
+//              a code in the format of to_colorstr.
+// ARGUMENTS:   uint8* color_string, the letters (null-terminated)
+//              uint32* number, receives the code
+// RETURNS:     uint32, TRUE if the string was exactly CB_COLOR_LENGTH
+//              valid letters, FALSE otherwise
+//-------------------------------------------------------------------------
+uint32 from_colorstr(uint8* color_string, uint32* number)
+{
+  uint32 code = 0;
+  uint8  class;
+  uint8  i;
+
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    class = color_class[color_string[i]];
+    if (0 == (class & CC_COLOR))
+    {
+      return FALSE;       // not a color (or the string ended early)
+    } /* if */
+    code |= (uint32)(class & CC_COLOR_MASK) << (i*4);
+  } /* for i */
+
+  if (NULL != color_string[CB_COLOR_LENGTH])
+  {
+    return FALSE;         // too long
+  } /* if */
+
+  *number = code;
+  return TRUE;
+} /* from_colorstr */
+
+//-------------------------------------------------------------------------
+// NAME:        code_from_index
+//
+// DESCRIPTION: Numbers the codes: gives the index-th of the CB_CODES codes
+//              the game can use.  Each slot takes one digit of the index,
+//              lowest first; without REPEAT_COLORS the digit picks among
+//              the colors the earlier slots haven't used, so every index
+//              below CB_CODES gives a different valid code.  The digits
+//              are taken off the top by subtraction (at most 14 times)
+//              rather than by dividing.
+// ARGUMENTS:   uint32 index, 0 to CB_CODES-1
+// RETURNS:     uint32 packed code, in the format of generate_secret_code
+//-------------------------------------------------------------------------
+uint32 code_from_index(uint32 index)
+{
+  uint32 weight[CB_COLOR_LENGTH];   /* place value of each slot's digit */
+  uint32 digit[CB_COLOR_LENGTH];
+  uint32 code  = 0;
+  uint32 used  = 0;     /* colors taken by earlier slots */
+  uint32 skip;
+  uint32 color;
+  uint32 i;
+
+  weight[0] = 1;
+  for (i = 1; i < CB_COLOR_LENGTH; i++)
+  {
+#ifdef REPEAT_COLORS
+    weight[i] = weight[i-1] * CB_POSSIBLE_COLORS;
+#else
+    weight[i] = weight[i-1] * (CB_POSSIBLE_COLORS - i + 1);
+#endif
+  } /* for i */
+
+  for (i = CB_COLOR_LENGTH; i-- > 0; )
+  {
+    for (digit[i] = 0; index >= weight[i]; digit[i]++)
+    {
+      index -= weight[i];
+    } /* for digit */
+  } /* for i */
+
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
+  {
+    // the skip-th color not used yet
+    skip = digit[i];
+    for (color = 0; ; color++)
+    {
+      if (0 == (used & (1 << color)))
+      {
+        if (0 == skip)
+        {
+          break;
+        } /* if */
+        skip--;
+      } /* if free */
+    } /* for color */
+
+    code |= color << (i*4);
+#ifndef REPEAT_COLORS
+    used |= 1 << color;
+#endif
+  } /* for i */
+
+  return code;
+} /* code_from_index */
+
 //-------------------------------------------------------------------------
 // NAME:        generate_secret_code
 //
-// DESCRIPTION: Generates a secret code, with each four-bit chunk being
-//              unique within the code.  Limits the possible four-bit chunk
-//              values to CB_POSSIBLE_COLORS (default 6) and generates
-//              CB_COLOR_LENGTH chunks (default 4).
+// DESCRIPTION: Generates a secret code: one of the CB_CODES codes (see
+//              code_from_index), each equally likely.  The LFSR's bounded
+//              register does the rejection sampling, so no divide is
+//              needed.  One draw over every code, rather than one per
+//              slot, keeps the slots from sharing the LFSR's bits.
 // ARGUMENTS:   None
 // RETURNS:     uint32 secret code, as described above
 //-------------------------------------------------------------------------
 uint32 generate_secret_code()
 {
-  uint32 secret_code    = 0;      /* end result */
+  return code_from_index(lfsr_rand_below(CB_CODES));
+} /* generate_secret_code */
 
-  uint32 random_number;
-  uint32 shifted_num    = 0;
-  uint32 digit          = 0;
-  uint32 loop_count     = 0;
-  uint32 got_it         = FALSE;
+#ifndef SCORE_CI_PRESENT
+//-------------------------------------------------------------------------
+// NAME:        _histogram
+//
+// DESCRIPTION: Counts the colors in a packed code, one four-bit count per
+//              color: the count of color c is in bits 4c+3..4c.
+// ARGUMENTS:   uint32 code, the packed code
+// RETURNS:     uint32 packed histogram
+//-------------------------------------------------------------------------
+uint32 _histogram(uint32 code)
+{
+  uint32 hist = 0;
+  uint32 i;
 
-  // Pick a random number, and convert it into base 6.  Keep doing this until
-  // we find a number we haven't already picked.
-  for (loop_count = 0; loop_count < CB_COLOR_LENGTH; loop_count++)
+  for (i = 0; i < CB_COLOR_LENGTH; i++)
   {
-    got_it = FALSE;
-    while (!got_it)
-    {
-      random_number = (uint32)lfsr_rand();
-      shifted_num   = random_number / CB_POSSIBLE_COLORS;
-      digit         = random_number - (shifted_num * CB_POSSIBLE_COLORS);
+    hist += 1 << ((code & 0x7) * 4);
+    code >>= 4;
+  } /* for i */
 
-      if (0 == _is_in(digit, &secret_code))
-      {
-        // we haven't used this digit before
-        got_it = TRUE;
-      } /* if */
-    } /* while !got_it */
-    secret_code  |= (digit << (loop_count*4));
-  } /* for loop_count */
-
-  return secret_code;
-} /* generate_secret_code */
+  return hist;
+} /* _histogram */
+
+//-------------------------------------------------------------------------
+// NAME:        score_code
+//
+// DESCRIPTION: Scores a packed guess against a packed secret code, both in
+//              the 4-bit-per-color format used by generate_secret_code.
+//              The counts are what check_guess emits as a hint string: P
+//              for each position where the colors agree, and C for each
+//              other guess peg whose color is left over in the secret.
+//
+//              P counts the zero four-bit slots of secret XOR guess.  Every
+//              color agrees min(secret count, guess count) times in all,
+//              so P + C is the sum of those minimums, taken all colors at
+//              once on the two histograms: each count has a spare top bit,
+//              which survives subtracting the guess's count exactly when
+//              the secret's is no smaller.  Not built when score_ci
+//              takes its place (see score_if.h).
+// ARGUMENTS:   uint32 secret, the packed secret code
+//              uint32 guess, the packed guess
+// RETURNS:     uint32 packed score; use SCORE_P and SCORE_C to unpack
+//-------------------------------------------------------------------------
+uint32 score_code(uint32 secret, uint32 guess)
+{
+  uint32 exact;               /* P count */
+  uint32 matches;             /* P + C count */
+
+  uint32 diff;
+  uint32 secret_hist;
+  uint32 guess_hist;
+  uint32 keep;
+
+  // Fold each four-bit slot of the difference down into its low bit;
+  // a slot is zero (a match) when that bit is clear.
+  diff   = secret ^ guess;
+  diff  |= diff >> 1;
+  diff  |= diff >> 2;
+  diff   = ~diff & CODE_SLOT_LSBS;
+  exact  = (diff * 0x11111111) >> 28;     // sum the per-slot match bits
+
+  // Per-color minimum: keep the guess's count where the secret's is at
+  // least as big (spare bit still set), the secret's elsewhere.
+  secret_hist = _histogram(secret);
+  guess_hist  = _histogram(guess);
+  keep        = (((secret_hist | HIST_SPARE) - guess_hist) & HIST_SPARE) >> 3;
+  keep       *= 0xF;
+  matches     = (guess_hist & keep) | (secret_hist & ~keep);
+  matches     = (matches * 0x11111111) >> 28;
+
+  return SCORE(exact, matches - exact);
+} /* score_code */
+#endif /* !SCORE_CI_PRESENT */
+
+//-------------------------------------------------------------------------
+// NAME:        put_string, put_number
+//
+// DESCRIPTION: Formatting helpers: a string, or a number right-aligned
+//              in a field (zero-padded if pad is '0').  Neither writes a
+//              terminator.
+// ARGUMENTS:   uint8* line, where to write
+//              const char* str, string to copy
+//              uint32 value, number to write; only its low width digits
+//                            fit
+//              uint32 width, field width
+//              uint8 pad, fill for the leading digits
+// RETURNS:     uint8*, just past what was written
+//-------------------------------------------------------------------------
+uint8* put_string(uint8* line, const char* str)
+{
+  while (NULL != *str)
+  {
+    *line++ = (uint8)*str++;
+  } /* while */
+  return line;
+} /* put_string */
+
+uint8* put_number(uint8* line, uint32 value, uint32 width, uint8 pad)
+{
+  uint32 i;
+
+  for (i = width; i > 0; i--)
+  {
+    line[i - 1] = (0 == value && i < width) ? pad
+                                            : (uint8)('0' + value % 10);
+    value /= 10;
+  } /* for i */
+  return line + width;
+} /* put_number */
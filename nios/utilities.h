@@ -21,11 +21,47 @@
 #define __LAB_7_UTILITIES__H
 
 #include "nios_std_types.h"   // standard data types
+#include "codebreaker.h"      // for CB_COLOR_LENGTH
+#include "score_if.h"         // for score_ci
+
+// Packed codes: one color per four-bit slot, CB_COLOR_LENGTH slots
+#define CODE_MASK       (0xFFFFFFFF >> (32 - (CB_COLOR_LENGTH * 4)))
+#define CODE_SLOT_LSBS  (0x11111111 & CODE_MASK)
+#define CODE_SLOT(code, i)  (((code) >> ((i) * 4)) & 0xF)
+
+// Color histograms (see score_code): the top bit of each color's count
+#define HIST_SPARE      (0x88888888 >> (32 - (CB_POSSIBLE_COLORS * 4)))
+
+// Character classes, from color_class in color_table.c (made by
+// host/gen_colors from CB_COLOR_LETTERS)
+#define CC_COLOR_MASK   0x0F    // the color number, for CC_COLOR
+#define CC_COLOR        0x10    // a color letter, in either case
+#define CC_PRINT        0x20    // printable (space to tilde)
+#define CC_LOWER        0x40    // lower-case letter; less 0x20 is upper
+
+// Packed scores, as returned by score_code
+#define SCORE(p, c)     (((p) << 8) | (c))
+#define SCORE_P(score)  (((score) >> 8) & 0xFF)
+#define SCORE_C(score)  ((score) & 0xFF)
+
+// Generated tables (color_table.c)
+extern const uint8 color_class[256];
+extern const uint8 color_letters[];     // CB_COLOR_LETTERS
+extern const uint8 color_list[];        // the letters, comma-separated
 
 // prototypes for public functions
 uint32 convert_to_bcd(uint16 number);
 uint8 to_color(uint8 number);
 void to_colorstr(uint32 number, uint8* color_string);
+uint32 from_colorstr(uint8* color_string, uint32* number);
+uint32 code_from_index(uint32 index);
 uint32 generate_secret_code();
+#ifdef SCORE_CI_PRESENT
+  #define score_code(secret, guess)   score_ci(secret, guess)
+#else
+uint32 score_code(uint32 secret, uint32 guess);
+#endif /* SCORE_CI_PRESENT */
+uint8* put_string(uint8* line, const char* str);
+uint8* put_number(uint8* line, uint32 value, uint32 width, uint8 pad);
 
 #endif /* __LAB_7_UTILITIES__H */
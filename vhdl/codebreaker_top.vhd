@@ -53,7 +53,9 @@ architecture structure of codebreaker_top is
       pio_keys_export         : in  std_logic_vector(1 downto 0);
       --
       led_toggle_pulse_export : out std_logic;
-      pio_countdown_export    : out std_logic_vector(7 downto 0);
+      countdown_display_bcd   : out std_logic_vector(7 downto 0);
+      countdown_display_show  : out std_logic;
+      display_hex_export      : out std_logic_vector(55 downto 0);
       pio_leds_export         : out std_logic_vector(1 downto 0)
     );
   end component nios_system;
@@ -61,7 +63,9 @@ architecture structure of codebreaker_top is
   signal  led_toggle_pulse    : std_logic;
   signal  led_gate            : std_logic := '0';
   signal  leds                : std_logic_vector(1 downto 0);
+  signal  hex                 : std_logic_vector(55 downto 0);
   signal  countdown           : std_logic_vector(7 downto 0);
+  signal  countdown_show      : std_logic;
 begin
 
   NiosII : nios_system
@@ -71,7 +75,9 @@ begin
       pio_keys_export             => key(2 downto 1),
       --
       led_toggle_pulse_export     => led_toggle_pulse,
-      pio_countdown_export        => countdown,
+      countdown_display_bcd       => countdown,
+      countdown_display_show      => countdown_show,
+      display_hex_export          => hex,
       pio_leds_export             => leds
     );
 
@@ -95,27 +101,27 @@ begin
   ledg <= (others => '1') when (leds(1) = '1' and led_gate = '1') -- WINNER
                           else (others => '0');
 
-  -- force unused 7-seg displays off
-  hex7 <= (others => '1');
-  hex6 <= (others => '1');
-  hex5 <= (others => '1');
-  hex4 <= (others => '1');
-  hex3 <= (others => '1');
-  hex2 <= (others => '1');
+  -- seven-segment displays, decoded by the display controller
+  hex7 <= hex(55 downto 49);
+  hex6 <= hex(48 downto 42);
+  hex5 <= hex(41 downto 35);
+  hex4 <= hex(34 downto 28);
+  hex3 <= hex(27 downto 21);
+  hex2 <= hex(20 downto 14);
 
+  -- ...except for the countdown, which drives HEX1..HEX0 itself
   ssd_tens: entity work.seven_segment port map (
-    digit => "0" & countdown(6 downto 4),
-    enable => countdown(7),
+    digit => countdown(7 downto 4),
+    enable => countdown_show,
     bank => '0',
     sevenseg => hex1
   );
 
   ssd_ones: entity work.seven_segment port map (
     digit => countdown(3 downto 0),
-    enable => countdown(7),
+    enable => countdown_show,
     bank => '0',
     sevenseg => hex0
   );
 
-
 end structure;
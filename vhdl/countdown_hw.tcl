@@ -0,0 +1,130 @@
+# Qsys component description for countdown_peripheral.vhd,
+# written by hand in the form Component Editor 12.0 produces.
+
+# 
+# countdown "BCD Countdown Timer" v1.0
+# 
+# 
+
+# 
+# request TCL package from ACDS 12.0
+# 
+package require -exact qsys 12.0
+
+
+# 
+# module countdown
+# 
+set_module_property NAME countdown
+set_module_property VERSION 1.0
+set_module_property INTERNAL false
+set_module_property OPAQUE_ADDRESS_MAP true
+set_module_property GROUP Peripherals
+set_module_property DISPLAY_NAME "BCD Countdown Timer"
+set_module_property INSTANTIATE_IN_SYSTEM_MODULE true
+set_module_property EDITABLE true
+set_module_property ANALYZE_HDL AUTO
+set_module_property REPORT_TO_TALKBACK false
+set_module_property ALLOW_GREYBOX_GENERATION false
+
+
+# 
+# file sets
+# 
+add_fileset QUARTUS_SYNTH QUARTUS_SYNTH "" ""
+set_fileset_property QUARTUS_SYNTH TOP_LEVEL countdown_peripheral
+set_fileset_property QUARTUS_SYNTH ENABLE_RELATIVE_INCLUDE_PATHS false
+add_fileset_file countdown_peripheral.vhd VHDL PATH countdown_peripheral.vhd
+
+
+# 
+# parameters
+# 
+add_parameter TICK_CLOCKS INTEGER 50000000 "Clock cycles per count"
+set_parameter_property TICK_CLOCKS DEFAULT_VALUE 50000000
+set_parameter_property TICK_CLOCKS DISPLAY_NAME TICK_CLOCKS
+set_parameter_property TICK_CLOCKS TYPE INTEGER
+set_parameter_property TICK_CLOCKS UNITS None
+set_parameter_property TICK_CLOCKS ALLOWED_RANGES 1:2147483647
+set_parameter_property TICK_CLOCKS DESCRIPTION "Clock cycles per count"
+set_parameter_property TICK_CLOCKS HDL_PARAMETER true
+
+
+# 
+# display items
+# 
+
+
+# 
+# connection point clock
+# 
+add_interface clock clock end
+set_interface_property clock clockRate 0
+set_interface_property clock ENABLED true
+
+add_interface_port clock clk clk Input 1
+
+
+# 
+# connection point reset
+# 
+add_interface reset reset end
+set_interface_property reset associatedClock clock
+set_interface_property reset synchronousEdges DEASSERT
+set_interface_property reset ENABLED true
+
+add_interface_port reset reset_n reset_n Input 1
+
+
+# 
+# connection point avalon_slave_0
+# 
+add_interface avalon_slave_0 avalon end
+set_interface_property avalon_slave_0 addressUnits WORDS
+set_interface_property avalon_slave_0 associatedClock clock
+set_interface_property avalon_slave_0 associatedReset reset
+set_interface_property avalon_slave_0 bitsPerSymbol 8
+set_interface_property avalon_slave_0 burstOnBurstBoundariesOnly false
+set_interface_property avalon_slave_0 burstcountUnits WORDS
+set_interface_property avalon_slave_0 explicitAddressSpan 0
+set_interface_property avalon_slave_0 holdTime 0
+set_interface_property avalon_slave_0 linewrapBursts false
+set_interface_property avalon_slave_0 maximumPendingReadTransactions 0
+set_interface_property avalon_slave_0 readLatency 0
+set_interface_property avalon_slave_0 readWaitTime 1
+set_interface_property avalon_slave_0 setupTime 0
+set_interface_property avalon_slave_0 timingUnits Cycles
+set_interface_property avalon_slave_0 writeWaitTime 0
+set_interface_property avalon_slave_0 ENABLED true
+
+add_interface_port avalon_slave_0 we_n write_n Input 1
+add_interface_port avalon_slave_0 be_n byteenable_n Input 4
+add_interface_port avalon_slave_0 a address Input 2
+add_interface_port avalon_slave_0 din writedata Input 32
+add_interface_port avalon_slave_0 dout readdata Output 32
+set_interface_assignment avalon_slave_0 embeddedsw.configuration.isFlash 0
+set_interface_assignment avalon_slave_0 embeddedsw.configuration.isMemoryDevice 0
+set_interface_assignment avalon_slave_0 embeddedsw.configuration.isNonVolatileStorage 0
+set_interface_assignment avalon_slave_0 embeddedsw.configuration.isPrintableDevice 0
+
+
+# 
+# connection point irq
+# 
+add_interface irq interrupt end
+set_interface_property irq associatedAddressablePoint avalon_slave_0
+set_interface_property irq associatedClock clock
+set_interface_property irq associatedReset reset
+set_interface_property irq ENABLED true
+
+add_interface_port irq irq irq Output 1
+
+
+# 
+# connection point display
+# 
+add_interface display conduit end
+set_interface_property display ENABLED true
+
+add_interface_port display bcd bcd Output 8
+add_interface_port display show show Output 1
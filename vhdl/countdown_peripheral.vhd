@@ -0,0 +1,243 @@
+--**************************  VHDL Source Code ****************************
+--*************************************************************************
+-- vim: set ts=2 sw=2 tw=78 et :
+--
+--  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+--
+--       LAB NAME:  Lab 7: Game System
+--
+--      FILE NAME:  countdown_peripheral.vhd
+--
+---------------------------------------------------------------------------
+--
+--  DESCRIPTION
+--
+--    This design implements the game's countdown in hardware.  Firmware
+--    loads a two-digit BCD start value and starts it; from then on the
+--    peripheral counts down once a second on its own, drives the two
+--    countdown displays directly, and raises its interrupt once, when it
+--    reaches zero.  The counter is kept in BCD for the displays and in
+--    binary for the firmware.
+--
+--    Addresses of this component:
+--      0   status    RW  bit 0:  1 once the count has reached zero;
+--                                any write clears it
+--                        bit 1:  1 while counting
+--      1   control   RW  bit 0:  1 to interrupt on reaching zero
+--                        bit 1:  1 to light the countdown displays
+--                         W  bit 2:  1 to start counting
+--                            bit 3:  1 to stop counting
+--      2   load      RW  bits 7..0:  BCD start value; writing it stops
+--                                    the count and reloads it
+--      3   remaining R   bits 7..0:  count remaining, BCD
+--                        bits 15..8: count remaining, binary
+--
+--    The bcd output carries the count remaining, and show is control
+--    bit 1, for a pair of seven_segment decoders.
+--
+---------------------------------------------------------------------------
+--
+--  REVISION HISTORY
+--
+--  ______________________________________________________________________
+-- |  DATE    | USER | Ver |  Description                                 |
+-- |==========+======+=====+==============================================
+-- |          |      |     |
+-- | 10/19/26 | RST  | 1.0 | Created
+-- |          |      |     |
+-- |----------|------|-----|----------------------------------------------
+--
+--*************************************************************************
+--*************************************************************************
+
+library IEEE;
+use IEEE.std_logic_1164.ALL;
+use IEEE.std_logic_unsigned.ALL;
+
+entity countdown_peripheral is
+  generic (
+    -- clock cycles per count (one second at 50 MHz)
+    TICK_CLOCKS : integer := 50000000
+  );
+  port (
+    -- inputs
+    clk     : in  std_logic;
+    reset_n : in  std_logic;
+    we_n    : in  std_logic;
+    be_n    : in  std_logic_vector(3 downto 0);
+    a       : in  std_logic_vector(1 downto 0);
+    din     : in  std_logic_vector(31 downto 0);
+    -- outputs
+    dout    : out std_logic_vector(31 downto 0);
+    irq     : out std_logic;
+    bcd     : out std_logic_vector(7 downto 0);
+    show    : out std_logic
+  );
+end entity countdown_peripheral;
+
+architecture rtl of countdown_peripheral is
+  -- constants
+  constant  STAT_ADDR   : std_logic_vector(1 downto 0) := "00";
+  constant  CTRL_ADDR   : std_logic_vector(1 downto 0) := "01";
+  constant  LOAD_ADDR   : std_logic_vector(1 downto 0) := "10";
+  constant  REM_ADDR    : std_logic_vector(1 downto 0) := "11";
+
+  constant  WRITE       : std_logic := '0';
+  constant  RESET       : std_logic := '0';
+  constant  BYTE_EN     : std_logic := '0';
+
+  constant  ZEROS_4     : std_logic_vector(3 downto 0) := "0000";
+  constant  ZEROS_8     : std_logic_vector(7 downto 0) := "00000000";
+  constant  NINE        : std_logic_vector(3 downto 0) := "1001";
+
+  -- internal signals
+  signal    write_stat  : std_logic;
+  signal    write_ctrl  : std_logic;
+  signal    write_load  : std_logic;
+  signal    tick        : std_logic;
+
+  -- registers
+  signal    reg_load    : std_logic_vector(7 downto 0);
+  signal    reg_bcd     : std_logic_vector(7 downto 0);
+  signal    reg_bin     : std_logic_vector(7 downto 0);
+  signal    reg_ie      : std_logic;
+  signal    reg_show    : std_logic;
+  signal    prescale    : integer range 0 to TICK_CLOCKS - 1;
+
+  -- control and status flags
+  signal    running     : std_logic;
+  signal    expired     : std_logic;
+
+begin
+  -- combinational logic: decode bus writes (everything lives in byte 0)
+  write_stat  <= '1' when (a = STAT_ADDR and we_n = WRITE and
+                           be_n(0) = BYTE_EN) else '0';
+  write_ctrl  <= '1' when (a = CTRL_ADDR and we_n = WRITE and
+                           be_n(0) = BYTE_EN) else '0';
+  write_load  <= '1' when (a = LOAD_ADDR and we_n = WRITE and
+                           be_n(0) = BYTE_EN) else '0';
+
+  tick        <= '1' when (running = '1' and prescale = TICK_CLOCKS - 1)
+                     else '0';
+
+  irq         <= expired and reg_ie;
+  bcd         <= reg_bcd;
+  show        <= reg_show;
+
+  -- process: ctrl_register_p
+  --  handle writes to the control and load registers
+  --  control inputs: write_ctrl, write_load
+  --  bus input:      din
+  --  registers:      reg_ie, reg_show, reg_load
+  ctrl_register_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      reg_ie      <= '0';
+      reg_show    <= '0';
+      reg_load    <= (others => '0');
+    elsif (rising_edge(clk)) then
+      if (write_ctrl = '1') then
+        reg_ie    <= din(0);
+        reg_show  <= din(1);
+      end if;
+      if (write_load = '1') then
+        reg_load  <= din(7 downto 0);
+      end if;
+    end if;
+  end process ctrl_register_p;
+
+  -- process: prescale_p
+  --  divides the clock down to one tick per count while running
+  --  control inputs: running, write_ctrl, write_load
+  --  register:       prescale
+  prescale_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      prescale    <= 0;
+    elsif (rising_edge(clk)) then
+      if (running = '0' or write_load = '1') then
+        prescale  <= 0;
+      elsif (prescale = TICK_CLOCKS - 1) then
+        prescale  <= 0;
+      else
+        prescale  <= prescale + 1;
+      end if;
+    end if;
+  end process prescale_p;
+
+  -- process: counter_p
+  --  implements the BCD and binary down-counters and the run/expired
+  --  state
+  --  control inputs: write_stat, write_ctrl, write_load, tick
+  --  status outputs: running, expired
+  --  registers:      reg_bcd, reg_bin
+  counter_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      reg_bcd     <= (others => '0');
+      reg_bin     <= (others => '0');
+      running     <= '0';
+      expired     <= '0';
+    elsif (rising_edge(clk)) then
+      if (write_stat = '1') then
+        expired   <= '0';
+      end if;
+
+      if (write_load = '1') then
+        -- stop and reload; the binary count is tens * 10 + ones
+        running   <= '0';
+        reg_bcd   <= din(7 downto 0);
+        reg_bin   <= ("0" & din(7 downto 4) & "000") +
+                     ("000" & din(7 downto 4) & "0") +
+                     ("0000" & din(3 downto 0));
+      elsif (write_ctrl = '1' and din(3) = '1') then
+        running   <= '0';
+      elsif (write_ctrl = '1' and din(2) = '1') then
+        -- starting at zero expires at once
+        if (reg_bcd = ZEROS_8) then
+          expired <= '1';
+        else
+          running <= '1';
+        end if;
+      elsif (tick = '1') then
+        -- count down in BCD: a zero ones digit borrows from the tens
+        if (reg_bcd(3 downto 0) = ZEROS_4) then
+          reg_bcd <= (reg_bcd(7 downto 4) - 1) & NINE;
+        else
+          reg_bcd <= reg_bcd - 1;
+        end if;
+        reg_bin   <= reg_bin - 1;
+
+        if (reg_bin = 1) then
+          running <= '0';
+          expired <= '1';
+        end if;
+      end if;
+    end if;
+  end process counter_p;
+
+  -- process: register_read_p
+  --  selects requested register values to the dout bus
+  --  control input:  a
+  --  bus output:     dout
+  register_read_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      dout  <= (others => '0');
+    elsif (rising_edge(clk)) then
+      dout  <= (others => '0');
+      case a is
+        when  STAT_ADDR =>
+          dout(0)           <=  expired;
+          dout(1)           <=  running;
+        when  CTRL_ADDR =>
+          dout(0)           <=  reg_ie;
+          dout(1)           <=  reg_show;
+        when  LOAD_ADDR =>
+          dout(7 downto 0)  <=  reg_load;
+        when  others =>
+          dout(15 downto 0) <=  reg_bin & reg_bcd;
+      end case;
+    end if;
+  end process register_read_p;
+end architecture rtl;
@@ -0,0 +1,276 @@
+--**************************  VHDL Source Code ****************************
+--*************************************************************************
+-- vim: set ts=2 sw=2 tw=78 et :
+--
+--  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+--
+--       LAB NAME:  Lab 7: Game System
+--
+--      FILE NAME:  countdown_peripheral_tb.vhd
+--
+---------------------------------------------------------------------------
+--
+--  DESCRIPTION
+--
+--    Self-checking testbench for countdown_peripheral.vhd, run with a
+--    tick of a few clocks instead of a second.  It covers loading,
+--    starting, the BCD borrow from the tens digit, stopping, expiry and
+--    its interrupt, and a status clear on the same clock as the tick
+--    that expires the count.  Each mismatch is reported, and the
+--    simulation ends in a failure if there were any.
+--
+--    The bus is driven from falling edge to falling edge, so the
+--    peripheral sees each access on the rising edge in between.
+--
+--    Running it with GHDL:
+--      ghdl -a --ieee=synopsys -fexplicit countdown_peripheral.vhd
+--      ghdl -a --ieee=synopsys -fexplicit countdown_peripheral_tb.vhd
+--      ghdl -e --ieee=synopsys -fexplicit countdown_peripheral_tb
+--      ghdl -r --ieee=synopsys -fexplicit countdown_peripheral_tb
+--
+---------------------------------------------------------------------------
+--
+--  REVISION HISTORY
+--
+--  ______________________________________________________________________
+-- |  DATE    | USER | Ver |  Description                                 |
+-- |==========+======+=====+==============================================
+-- |          |      |     |
+-- | 10/19/26 | RST  | 1.0 | Created
+-- |          |      |     |
+-- |----------|------|-----|----------------------------------------------
+--
+--*************************************************************************
+--*************************************************************************
+
+library IEEE;
+use IEEE.std_logic_1164.ALL;
+use IEEE.std_logic_unsigned.ALL;
+
+entity countdown_peripheral_tb is
+end entity countdown_peripheral_tb;
+
+architecture sim of countdown_peripheral_tb is
+  -- constants
+  constant  CLK_PERIOD  : time := 20 ns;
+  constant  TICKS       : integer := 8;       -- clocks per count
+
+  constant  STAT_ADDR   : std_logic_vector(1 downto 0) := "00";
+  constant  CTRL_ADDR   : std_logic_vector(1 downto 0) := "01";
+  constant  LOAD_ADDR   : std_logic_vector(1 downto 0) := "10";
+  constant  REM_ADDR    : std_logic_vector(1 downto 0) := "11";
+
+  -- control writes: interrupt enabled and displays lit, and with that,
+  -- start or stop
+  constant  CTRL_ON     : std_logic_vector(31 downto 0) := x"00000003";
+  constant  CTRL_START  : std_logic_vector(31 downto 0) := x"00000007";
+  constant  CTRL_STOP   : std_logic_vector(31 downto 0) := x"0000000B";
+  constant  CTRL_NO_IRQ : std_logic_vector(31 downto 0) := x"00000002";
+
+  -- peripheral under test
+  signal    clk         : std_logic := '0';
+  signal    reset_n     : std_logic := '0';
+  signal    we_n        : std_logic := '1';
+  signal    be_n        : std_logic_vector(3 downto 0) := "1111";
+  signal    a           : std_logic_vector(1 downto 0) := STAT_ADDR;
+  signal    din         : std_logic_vector(31 downto 0) := (others => '0');
+  signal    dout        : std_logic_vector(31 downto 0);
+  signal    irq         : std_logic;
+  signal    bcd         : std_logic_vector(7 downto 0);
+  signal    show        : std_logic;
+
+  signal    done        : boolean := false;
+
+begin
+  dut : entity work.countdown_peripheral
+    generic map (
+      TICK_CLOCKS => TICKS
+    )
+    port map (
+      clk     => clk,
+      reset_n => reset_n,
+      we_n    => we_n,
+      be_n    => be_n,
+      a       => a,
+      din     => din,
+      dout    => dout,
+      irq     => irq,
+      bcd     => bcd,
+      show    => show
+    );
+
+  -- free-running clock until the test is done
+  clk <= not clk after CLK_PERIOD / 2 when not done else '0';
+
+  -- process: test_p
+  --  runs the checks
+  test_p : process is
+    variable  errors  : integer := 0;
+    variable  start   : time;
+
+    -- one write, seen on the next rising edge
+    procedure bus_write(addr  : std_logic_vector(1 downto 0);
+                        value : std_logic_vector(31 downto 0)) is
+    begin
+      a     <= addr;
+      din   <= value;
+      we_n  <= '0';
+      be_n  <= "0000";
+      wait until falling_edge(clk);
+      we_n  <= '1';
+      be_n  <= "1111";
+    end procedure bus_write;
+
+    -- one read; dout is registered on the rising edge in between
+    procedure bus_read(addr  : std_logic_vector(1 downto 0);
+                       value : out std_logic_vector(31 downto 0)) is
+    begin
+      a     <= addr;
+      wait until falling_edge(clk);
+      value := dout;
+    end procedure bus_read;
+
+    procedure idle(clocks : integer) is
+    begin
+      for i in 1 to clocks loop
+        wait until falling_edge(clk);
+      end loop;
+    end procedure idle;
+
+    procedure check(what : string; got, want : std_logic_vector) is
+    begin
+      if (got /= want) then
+        report what & ": got " & integer'image(conv_integer(got)) &
+               ", expected " & integer'image(conv_integer(want))
+          severity error;
+        errors := errors + 1;
+      end if;
+    end procedure check;
+
+    procedure check_bit(what : string; got, want : std_logic) is
+    begin
+      if (got /= want) then
+        report what & ": got " & std_logic'image(got) &
+               ", expected " & std_logic'image(want)
+          severity error;
+        errors := errors + 1;
+      end if;
+    end procedure check_bit;
+
+    -- reads a register and checks it
+    procedure expect(what : string; addr : std_logic_vector(1 downto 0);
+                     want : std_logic_vector(31 downto 0)) is
+      variable  value : std_logic_vector(31 downto 0);
+    begin
+      bus_read(addr, value);
+      check(what, value, want);
+    end procedure expect;
+
+  begin
+    -- hold reset for a few clocks, and come out of it on a falling edge
+    idle(3);
+    reset_n <= '1';
+    idle(1);
+
+    expect("status after reset", STAT_ADDR, x"00000000");
+    expect("remaining after reset", REM_ADDR, x"00000000");
+    check_bit("irq after reset", irq, '0');
+    check_bit("show after reset", show, '0');
+
+    -- load: the start value reads back, and the count remaining is the
+    -- same in BCD and in binary
+    bus_write(LOAD_ADDR, x"00000099");
+    expect("load 99", LOAD_ADDR, x"00000099");
+    expect("remaining after load 99", REM_ADDR, x"00006399");
+    bus_write(LOAD_ADDR, x"00000021");
+    expect("remaining after load 21", REM_ADDR, x"00001521");
+    check("bcd after load 21", bcd, x"21");
+    expect("status after load", STAT_ADDR, x"00000000");
+
+    bus_write(CTRL_ADDR, CTRL_ON);
+    expect("control", CTRL_ADDR, x"00000003");
+    check_bit("show when lit", show, '1');
+
+    -- start, and count 21, 20, 19: one count every TICKS clocks, the
+    -- second borrowing from the tens digit
+    bus_write(CTRL_ADDR, CTRL_START);
+    expect("status while counting", STAT_ADDR, x"00000002");
+    wait until bcd = x"20" for 2 * TICKS * CLK_PERIOD;
+    check("first count", bcd, x"20");
+    start := now;
+    wait until bcd = x"19" for 2 * TICKS * CLK_PERIOD;
+    check("borrow from the tens", bcd, x"19");
+    if (now - start /= TICKS * CLK_PERIOD) then
+      report "count period was " & time'image(now - start) severity error;
+      errors := errors + 1;
+    end if;
+    wait until falling_edge(clk);
+    expect("remaining after borrow", REM_ADDR, x"00001319");
+
+    -- stop: the count holds, and starting again picks it up
+    bus_write(CTRL_ADDR, CTRL_STOP);
+    expect("status after stop", STAT_ADDR, x"00000000");
+    idle(3 * TICKS);
+    check("bcd while stopped", bcd, x"19");
+    bus_write(CTRL_ADDR, CTRL_START);
+    wait until bcd = x"18" for 2 * TICKS * CLK_PERIOD;
+    check("count after restart", bcd, x"18");
+    wait until falling_edge(clk);
+
+    -- loading while counting stops the count
+    bus_write(LOAD_ADDR, x"00000002");
+    expect("status after load while counting", STAT_ADDR, x"00000000");
+    check("bcd after load while counting", bcd, x"02");
+
+    -- expiry: the count stops at zero and raises the interrupt, which
+    -- stays up, unless disabled, until the status is written
+    bus_write(CTRL_ADDR, CTRL_START);
+    wait until irq = '1' for 3 * TICKS * CLK_PERIOD;
+    check_bit("irq on expiry", irq, '1');
+    check("bcd on expiry", bcd, x"00");
+    wait until falling_edge(clk);
+    expect("status on expiry", STAT_ADDR, x"00000001");
+    expect("remaining on expiry", REM_ADDR, x"00000000");
+    idle(2 * TICKS);
+    check("bcd after expiry", bcd, x"00");
+    check_bit("irq held", irq, '1');
+    bus_write(CTRL_ADDR, CTRL_NO_IRQ);
+    check_bit("irq disabled", irq, '0');
+    expect("status with irq disabled", STAT_ADDR, x"00000001");
+    bus_write(CTRL_ADDR, CTRL_ON);
+    check_bit("irq enabled again", irq, '1');
+    bus_write(STAT_ADDR, x"00000000");
+    check_bit("irq after clear", irq, '0');
+    expect("status after clear", STAT_ADDR, x"00000000");
+
+    -- starting at zero expires at once
+    bus_write(CTRL_ADDR, CTRL_START);
+    check_bit("irq starting at zero", irq, '1');
+    expect("status starting at zero", STAT_ADDR, x"00000001");
+    bus_write(STAT_ADDR, x"00000000");
+
+    -- a status clear on the clock of the tick that expires the count
+    -- must not lose the expiry; that tick comes TICKS clocks after the
+    -- start, and the bcd checks show the clear landed on it
+    bus_write(LOAD_ADDR, x"00000001");
+    bus_write(CTRL_ADDR, CTRL_START);
+    idle(TICKS - 1);
+    check("bcd before the racing clear", bcd, x"01");
+    bus_write(STAT_ADDR, x"00000000");
+    check("bcd after the racing clear", bcd, x"00");
+    check_bit("irq after the racing clear", irq, '1');
+    expect("status after the racing clear", STAT_ADDR, x"00000001");
+    bus_write(STAT_ADDR, x"00000000");
+    check_bit("irq after a second clear", irq, '0');
+
+    if (errors = 0) then
+      report "countdown_peripheral: all checks passed" severity note;
+    end if;
+    assert (errors = 0)
+      report "countdown_peripheral: " & integer'image(errors) &
+             " checks failed"
+      severity failure;
+    done <= true;
+    wait;
+  end process test_p;
+end architecture sim;
@@ -0,0 +1,148 @@
+--**************************  VHDL Source Code ****************************
+--*************************************************************************
+-- vim: set ts=2 sw=2 tw=78 et :
+--
+--  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+--
+--       LAB NAME:  Lab 7: Game System
+--
+--      FILE NAME:  display_controller.vhd
+--
+---------------------------------------------------------------------------
+--
+--  DESCRIPTION
+--
+--    This design drives all eight seven-segment displays (HEX7..HEX0)
+--    from two memory-mapped registers, using one seven_segment decoder
+--    per digit.  A single 32-bit write updates every digit at once; byte
+--    and halfword writes update two or four digits without touching the
+--    others, so no read-modify-write is ever needed.
+--
+--    Addresses of this component:
+--      0   digits    RW  bits 4n+3..4n: hex digit shown on HEXn
+--      1   control   RW  bits  7..0:    1 to light HEXn (bit n)
+--                        bits 15..8:    1 to use the special bank on
+--                                       HEXn (bit 8+n); see
+--                                       seven_segment.vhd
+--
+--    The hex output carries the seven active-low segments of HEXn in
+--    bits 7n+6..7n.
+--
+---------------------------------------------------------------------------
+--
+--  REVISION HISTORY
+--
+--  ______________________________________________________________________
+-- |  DATE    | USER | Ver |  Description                                 |
+-- |==========+======+=====+==============================================
+-- |          |      |     |
+-- | 10/19/26 | RST  | 1.0 | Created
+-- |          |      |     |
+-- |----------|------|-----|----------------------------------------------
+--
+--*************************************************************************
+--*************************************************************************
+
+library IEEE;
+use IEEE.std_logic_1164.ALL;
+use IEEE.std_logic_unsigned.ALL;
+
+library work;
+
+entity display_controller is
+  port (
+    -- inputs
+    clk     : in  std_logic;
+    reset_n : in  std_logic;
+    we_n    : in  std_logic;
+    be_n    : in  std_logic_vector(3 downto 0);
+    a       : in  std_logic;
+    din     : in  std_logic_vector(31 downto 0);
+    -- outputs
+    dout    : out std_logic_vector(31 downto 0);
+    hex     : out std_logic_vector(55 downto 0)
+  );
+end entity display_controller;
+
+architecture rtl of display_controller is
+  -- constants
+  constant  DIGITS_ADDR : std_logic := '0';
+  constant  CTRL_ADDR   : std_logic := '1';
+
+  constant  WRITE       : std_logic := '0';
+  constant  RESET       : std_logic := '0';
+  constant  BYTE_EN     : std_logic := '0';
+
+  -- registers
+  signal    reg_digits  : std_logic_vector(31 downto 0);
+  signal    reg_enable  : std_logic_vector(7 downto 0);
+  signal    reg_bank    : std_logic_vector(7 downto 0);
+
+begin
+  -- process: digits_register_p
+  --  handle writes to the digits register, one byte lane at a time
+  --  control inputs: a, we_n, be_n
+  --  bus input:      din
+  --  register:       reg_digits
+  digits_register_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      reg_digits  <= (others => '0');
+    elsif (rising_edge(clk)) then
+      for lane in 0 to 3 loop
+        if (a = DIGITS_ADDR and we_n = WRITE and be_n(lane) = BYTE_EN) then
+          reg_digits(8*lane + 7 downto 8*lane) <= din(8*lane + 7 downto 8*lane);
+        end if;
+      end loop;
+    end if;
+  end process digits_register_p;
+
+  -- process: ctrl_register_p
+  --  handle writes to the control register; the upper half is unused
+  --  control inputs: a, we_n, be_n
+  --  bus input:      din
+  --  registers:      reg_enable, reg_bank
+  ctrl_register_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      -- Reset with every display blank
+      reg_enable  <= (others => '0');
+      reg_bank    <= (others => '0');
+    elsif (rising_edge(clk)) then
+      if (a = CTRL_ADDR and we_n = WRITE and be_n(0) = BYTE_EN) then
+        reg_enable  <= din(7 downto 0);
+      end if;
+      if (a = CTRL_ADDR and we_n = WRITE and be_n(1) = BYTE_EN) then
+        reg_bank    <= din(15 downto 8);
+      end if;
+    end if;
+  end process ctrl_register_p;
+
+  -- process: register_read_p
+  --  selects requested register values to the dout bus
+  --  control input:  a
+  --  bus output:     dout
+  register_read_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      dout  <= (others => '0');
+    elsif (rising_edge(clk)) then
+      case a is
+        when  DIGITS_ADDR =>
+          dout  <=  reg_digits;
+        when  others =>
+          dout  <=  x"0000" & reg_bank & reg_enable;
+      end case;
+    end if;
+  end process register_read_p;
+
+  -- one glyph decoder per display
+  decoders : for n in 0 to 7 generate
+    ssd : entity work.seven_segment port map (
+      digit     => reg_digits(4*n + 3 downto 4*n),
+      enable    => reg_enable(n),
+      bank      => reg_bank(n),
+      sevenseg  => hex(7*n + 6 downto 7*n)
+    );
+  end generate decoders;
+end architecture rtl;
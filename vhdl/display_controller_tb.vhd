@@ -0,0 +1,257 @@
+--**************************  VHDL Source Code ****************************
+--*************************************************************************
+-- vim: set ts=2 sw=2 tw=78 et :
+--
+--  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+--
+--       LAB NAME:  Lab 7: Game System
+--
+--      FILE NAME:  display_controller_tb.vhd
+--
+---------------------------------------------------------------------------
+--
+--  DESCRIPTION
+--
+--    Self-checking testbench for display_controller.vhd and the
+--    seven_segment decoders under it.  It makes a series of word,
+--    halfword and byte writes to both registers, keeps its own copy of
+--    what they should hold, and after each write checks both registers'
+--    readback and all eight displays' segments: blank where the enable
+--    bit is clear, and otherwise the glyph for the digit in the bank
+--    selected.  Each mismatch is reported, and the simulation ends in a
+--    failure if there were any.
+--
+--    Running it with GHDL:
+--      ghdl -a --ieee=synopsys -fexplicit seven_segment.vhd
+--      ghdl -a --ieee=synopsys -fexplicit display_controller.vhd
+--      ghdl -a --ieee=synopsys -fexplicit display_controller_tb.vhd
+--      ghdl -e --ieee=synopsys -fexplicit display_controller_tb
+--      ghdl -r --ieee=synopsys -fexplicit display_controller_tb
+--
+---------------------------------------------------------------------------
+--
+--  REVISION HISTORY
+--
+--  ______________________________________________________________________
+-- |  DATE    | USER | Ver |  Description                                 |
+-- |==========+======+=====+==============================================
+-- |          |      |     |
+-- | 10/19/26 | RST  | 1.0 | Created
+-- |          |      |     |
+-- |----------|------|-----|----------------------------------------------
+--
+--*************************************************************************
+--*************************************************************************
+
+library IEEE;
+use IEEE.std_logic_1164.ALL;
+use IEEE.std_logic_unsigned.ALL;
+
+entity display_controller_tb is
+end entity display_controller_tb;
+
+architecture sim of display_controller_tb is
+  -- constants
+  constant  CLK_PERIOD  : time := 20 ns;
+
+  constant  DIGITS_ADDR : std_logic := '0';
+  constant  CTRL_ADDR   : std_logic := '1';
+
+  -- active-low segments, gfedcba, as seven_segment.vhd draws them
+  type glyph_table_t is array (0 to 15) of std_logic_vector(6 downto 0);
+  constant  GLYPHS      : glyph_table_t := (
+    "1000000", "1111001", "0100100", "0110000",     -- 0 1 2 3
+    "0011001", "0010010", "0000010", "1111000",     -- 4 5 6 7
+    "0000000", "0011000", "0001000", "0000011",     -- 8 9 A b
+    "1000110", "0100001", "0000110", "0001110"      -- C d E F
+  );
+  constant  GLYPH_OFF   : std_logic_vector(6 downto 0) := "1111111";
+  constant  GLYPH_o     : std_logic_vector(6 downto 0) := "0100011";
+  constant  GLYPH_L     : std_logic_vector(6 downto 0) := "1000111";
+  constant  GLYPH_c     : std_logic_vector(6 downto 0) := "0100111";
+
+  -- the writes made, in order
+  type write_t is record
+    a       : std_logic;
+    be_n    : std_logic_vector(3 downto 0);
+    data    : std_logic_vector(31 downto 0);
+  end record write_t;
+  type write_list_t is array (natural range <>) of write_t;
+  constant  WRITES      : write_list_t := (
+    (CTRL_ADDR,   "0000", x"000000FF"),   -- all lit, hex bank
+    (DIGITS_ADDR, "0000", x"76543210"),
+    (DIGITS_ADDR, "0000", x"FEDCBA98"),
+    (DIGITS_ADDR, "1101", x"12345678"),   -- byte 1: HEX3..HEX2
+    (DIGITS_ADDR, "0011", x"0C700000"),   -- upper half: HEX7..HEX4
+    (DIGITS_ADDR, "1110", x"000000C7"),   -- byte 0: HEX1..HEX0
+    (CTRL_ADDR,   "1101", x"0000FF00"),   -- special bank everywhere
+    (CTRL_ADDR,   "1110", x"000000A5"),   -- every other display lit
+    (CTRL_ADDR,   "0011", x"FFFF0000"),   -- unused half: no change
+    (CTRL_ADDR,   "0000", x"000055FF"),   -- all lit, banks alternate
+    (DIGITS_ADDR, "0000", x"C7C70707"),
+    (DIGITS_ADDR, "1011", x"00000000"),   -- byte 2: HEX5..HEX4
+    (CTRL_ADDR,   "1110", x"00000000"),   -- all blank
+    (DIGITS_ADDR, "0000", x"89ABCDEF")    -- while blank
+  );
+
+  -- display controller under test
+  signal    clk         : std_logic := '0';
+  signal    reset_n     : std_logic := '0';
+  signal    we_n        : std_logic := '1';
+  signal    be_n        : std_logic_vector(3 downto 0) := "1111";
+  signal    a           : std_logic := DIGITS_ADDR;
+  signal    din         : std_logic_vector(31 downto 0) := (others => '0');
+  signal    dout        : std_logic_vector(31 downto 0);
+  signal    hex         : std_logic_vector(55 downto 0);
+
+  signal    done        : boolean := false;
+
+  -- function: glyph
+  --  the segments seven_segment should show for a digit in a bank
+  function glyph(digit : std_logic_vector(3 downto 0); bank : std_logic)
+    return std_logic_vector is
+  begin
+    if (bank = '1') then
+      case digit is
+        when x"0"   => return GLYPH_o;
+        when x"7"   => return GLYPH_L;
+        when x"C"   => return GLYPH_c;
+        when others => null;
+      end case;
+    end if;
+    return GLYPHS(conv_integer(digit));
+  end function glyph;
+
+  -- function: hex_image
+  --  a vector as hex digits, for reports
+  function hex_image(value : std_logic_vector) return string is
+    constant  HEX_DIGITS  : string(1 to 16) := "0123456789ABCDEF";
+    constant  COUNT       : integer := (value'length + 3) / 4;
+    variable  v           : std_logic_vector(4*COUNT - 1 downto 0);
+    variable  image       : string(1 to COUNT);
+  begin
+    v := (others => '0');
+    v(value'length - 1 downto 0) := value;
+    for i in 1 to COUNT loop
+      image(i) := HEX_DIGITS(
+                    conv_integer(v(4*(COUNT - i) + 3 downto 4*(COUNT - i)))
+                    + 1);
+    end loop;
+    return image;
+  end function hex_image;
+
+begin
+  dut : entity work.display_controller
+    port map (
+      clk     => clk,
+      reset_n => reset_n,
+      we_n    => we_n,
+      be_n    => be_n,
+      a       => a,
+      din     => din,
+      dout    => dout,
+      hex     => hex
+    );
+
+  -- free-running clock until the test is done
+  clk <= not clk after CLK_PERIOD / 2 when not done else '0';
+
+  -- process: test_p
+  --  makes the writes and checks the results against the expected
+  --  register contents, from falling edge to falling edge
+  test_p : process is
+    variable  errors  : integer := 0;
+    variable  digits  : std_logic_vector(31 downto 0) := (others => '0');
+    variable  enable  : std_logic_vector(7 downto 0) := (others => '0');
+    variable  bank    : std_logic_vector(7 downto 0) := (others => '0');
+    variable  value   : std_logic_vector(31 downto 0);
+    variable  want    : std_logic_vector(6 downto 0);
+
+    procedure check(what : string; got, expected : std_logic_vector) is
+    begin
+      if (got /= expected) then
+        report what & ": got " & hex_image(got) &
+               ", expected " & hex_image(expected)
+          severity error;
+        errors := errors + 1;
+      end if;
+    end procedure check;
+
+    -- one read; dout is registered on the rising edge in between
+    procedure bus_read(addr  : std_logic;
+                       value : out std_logic_vector(31 downto 0)) is
+    begin
+      a     <= addr;
+      wait until falling_edge(clk);
+      value := dout;
+    end procedure bus_read;
+
+    -- checks the readback and every display against the expected
+    -- register contents
+    procedure check_all(step : integer) is
+    begin
+      bus_read(DIGITS_ADDR, value);
+      check("step " & integer'image(step) & " digits", value, digits);
+      bus_read(CTRL_ADDR, value);
+      check("step " & integer'image(step) & " control", value,
+            x"0000" & bank & enable);
+      for n in 0 to 7 loop
+        if (enable(n) = '1') then
+          want := glyph(digits(4*n + 3 downto 4*n), bank(n));
+        else
+          want := GLYPH_OFF;
+        end if;
+        check("step " & integer'image(step) & " HEX" & integer'image(n),
+              hex(7*n + 6 downto 7*n), want);
+      end loop;
+    end procedure check_all;
+
+  begin
+    -- hold reset for a few clocks, and come out of it on a falling edge
+    for i in 1 to 3 loop
+      wait until falling_edge(clk);
+    end loop;
+    reset_n <= '1';
+    wait until falling_edge(clk);
+
+    -- reset: everything zero, and every display blank
+    check_all(0);
+
+    for i in WRITES'range loop
+      a     <= WRITES(i).a;
+      be_n  <= WRITES(i).be_n;
+      din   <= WRITES(i).data;
+      we_n  <= '0';
+      wait until falling_edge(clk);
+      we_n  <= '1';
+      be_n  <= "1111";
+
+      -- what the write should have changed: each enabled byte lane of
+      -- the digits, or the low two of the control register
+      for lane in 0 to 3 loop
+        if (WRITES(i).be_n(lane) = '0') then
+          if (WRITES(i).a = DIGITS_ADDR) then
+            digits(8*lane + 7 downto 8*lane) :=
+              WRITES(i).data(8*lane + 7 downto 8*lane);
+          elsif (lane = 0) then
+            enable := WRITES(i).data(7 downto 0);
+          elsif (lane = 1) then
+            bank   := WRITES(i).data(15 downto 8);
+          end if;
+        end if;
+      end loop;
+
+      check_all(i + 1);
+    end loop;
+
+    if (errors = 0) then
+      report "display_controller: all checks passed" severity note;
+    end if;
+    assert (errors = 0)
+      report "display_controller: " & integer'image(errors) &
+             " checks failed"
+      severity failure;
+    done <= true;
+    wait;
+  end process test_p;
+end architecture sim;
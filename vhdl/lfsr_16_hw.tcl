@@ -94,7 +94,7 @@ set_interface_property avalon_slave_0 ENABLED true
 
 add_interface_port avalon_slave_0 we_n write_n Input 1
 add_interface_port avalon_slave_0 be_n byteenable_n Input 2
-add_interface_port avalon_slave_0 a address Input 2
+add_interface_port avalon_slave_0 a address Input 3
 add_interface_port avalon_slave_0 din writedata Input 16
 add_interface_port avalon_slave_0 dout readdata Output 16
 set_interface_assignment avalon_slave_0 embeddedsw.configuration.isFlash 0
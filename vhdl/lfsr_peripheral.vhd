@@ -18,13 +18,32 @@
 --    About LFSRs:
 --      https://en.wikipedia.org/wiki/Linear_feedback_shift_register
 --
+--    It also draws bounded values, so that software never has to reduce
+--    a raw value with a divide.  Every 16th clock, the LFSR value less
+--    one is masked to the bits needed to hold RANGE-1, and kept in the
+--    bounded register if it is below RANGE; otherwise it is thrown away.
+--    Candidates are 16 clocks apart so that each one is made of bits
+--    the last one never saw: one clock later, a rejected candidate's
+--    bits have only shifted over by one, and retrying on it favors some
+--    values over others.  65535 is odd, so every state is still a
+--    candidate once over 16 periods, and every value below RANGE turns
+--    up equally often (if RANGE is a power of two, RANGE-1 once less in
+--    65536/RANGE).  At least half the candidates are kept, so the
+--    register is refreshed every 32 clocks on average.  Writing RANGE
+--    marks the register stale until the first candidate under the new
+--    range is kept.
+--
 --    Addresses of this component:
 --      0   status    R   bit 0:  1 if LFSR is seeded, 0 if not
 --                        bit 1:  1 if seed value is nonzero, 0 if zero
+--                        bit 2:  1 if bounded holds a value below range
 --      1   control    W  bit 0:  1 to reseed LFSR from seed register
 --                                (note: status bit 1 MUST be 1 first)
 --      2   lfsr      R   current 16-bit LFSR value
 --      3   seed      RW  seed value for LFSR
+--      4   range     RW  bound for bounded values, 1 to 0x8000
+--      5   bounded   R   bits 14-0:  a value below range
+--                        bit 15:     1 if stale (range written since)
 --
 ---------------------------------------------------------------------------
 --
@@ -36,6 +55,9 @@
 -- |          |      |     |
 -- | 04/21/13 | RST  | 1.0 | Created
 -- |          |      |     |
+-- | 10/19/26 | RST  | 1.1 | Added range and bounded registers; address
+-- |          |      |     | is now three bits
+-- |          |      |     |
 -- |----------|------|-----|----------------------------------------------
 --
 --*************************************************************************
@@ -54,7 +76,7 @@ entity lfsr_peripheral is
     reset_n : in  std_logic;
     we_n    : in  std_logic;
     be_n    : in  std_logic_vector(1 downto 0);
-    a       : in  std_logic_vector(1 downto 0);
+    a       : in  std_logic_vector(2 downto 0);
     din     : in  std_logic_vector(15 downto 0);
     -- outputs
     dout    : out std_logic_vector(15 downto 0)
@@ -62,11 +84,27 @@ entity lfsr_peripheral is
 end entity lfsr_peripheral;
 
 architecture rtl of lfsr_peripheral is
+  -- function: smear_right
+  --  sets every bit below the highest set bit, giving the smallest
+  --  all-ones mask that covers the value
+  function smear_right(value : std_logic_vector(15 downto 0))
+    return std_logic_vector is
+    variable  mask  : std_logic_vector(15 downto 0);
+  begin
+    mask := value;
+    for i in 14 downto 0 loop
+      mask(i) := mask(i) or mask(i + 1);
+    end loop;
+    return mask;
+  end function smear_right;
+
   -- constants
-  constant  STAT_ADDR   : std_logic_vector(1 downto 0) := "00";
-  constant  CTRL_ADDR   : std_logic_vector(1 downto 0) := "01";
-  constant  LFSR_ADDR   : std_logic_vector(1 downto 0) := "10";
-  constant  SEED_ADDR   : std_logic_vector(1 downto 0) := "11";
+  constant  STAT_ADDR   : std_logic_vector(2 downto 0) := "000";
+  constant  CTRL_ADDR   : std_logic_vector(2 downto 0) := "001";
+  constant  LFSR_ADDR   : std_logic_vector(2 downto 0) := "010";
+  constant  SEED_ADDR   : std_logic_vector(2 downto 0) := "011";
+  constant  RANGE_ADDR  : std_logic_vector(2 downto 0) := "100";
+  constant  BOUND_ADDR  : std_logic_vector(2 downto 0) := "101";
 
   constant  READ        : std_logic := '1';
   constant  WRITE       : std_logic := '0';
@@ -82,7 +120,12 @@ architecture rtl of lfsr_peripheral is
   constant  NOTNOW      : std_logic := '0';
   constant  DOITNOW     : std_logic := '1';
 
+  constant  STALE       : std_logic := '0';
+  constant  FRESH       : std_logic := '1';
+
   constant  ZEROS_8     : std_logic_vector := "00000000";
+  constant  BOUND_BITS  : std_logic_vector(15 downto 0) := x"7FFF";
+  constant  SAMPLE_NOW  : std_logic_vector(3 downto 0) := "0000";
 
   -- internal signals
   signal    din_h       : std_logic_vector(7 downto 0);
@@ -97,10 +140,22 @@ architecture rtl of lfsr_peripheral is
   signal    reg_lfsr    : std_logic_vector(15 downto 0);
   signal    reg_stat    : std_logic_vector(15 downto 0);
 
+  signal    reg_range_h : std_logic_vector(7 downto 0);
+  signal    reg_range_l : std_logic_vector(7 downto 0);
+  signal    reg_bounded : std_logic_vector(14 downto 0);
+
+  -- bounded value candidates
+  signal    range_value : std_logic_vector(15 downto 0);
+  signal    range_mask  : std_logic_vector(15 downto 0);
+  signal    candidate   : std_logic_vector(15 downto 0);
+  signal    sample_count: std_logic_vector(3 downto 0);
+
   -- control and status flags
   signal    is_seeded   : std_logic := UNSEEDED;
   signal    seed_valid  : std_logic := INVALID;
   signal    ctrl_doseed : std_logic := NOTNOW;
+  signal    is_fresh    : std_logic := STALE;
+  signal    range_write : std_logic;
 
 begin
   -- combinational logic: break down long signals into shorter ones, and
@@ -114,6 +169,13 @@ begin
   seed_valid  <=  INVALID when (reg_seed_h = ZEROS_8 and reg_seed_l = ZEROS_8)
                           else VALID;
 
+  -- bounded candidates: the LFSR value less one (so that 0 can come up
+  -- and 0xFFFF can't), masked to the bits of RANGE-1
+  range_value <= reg_range_h & reg_range_l;
+  range_write <= '1' when (a = RANGE_ADDR and we_n = WRITE) else '0';
+  range_mask  <= smear_right(range_value - 1) and BOUND_BITS;
+  candidate   <= (reg_lfsr - 1) and range_mask;
+
   -- process: seed_register_p
   --  handle writes to the seed register
   --  control inputs: a, we_n, be_n_h
@@ -135,6 +197,50 @@ begin
     end if;
   end process seed_register_p;
 
+  -- process: range_register_p
+  --  handle writes to the range register
+  --  control inputs: a, we_n, be_n_h, be_n_l
+  --  bus output:     din
+  --  registers:      reg_range_h, reg_range_l
+  range_register_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      -- Reset range to zero, which draws nothing
+      reg_range_h   <= (others => '0');
+      reg_range_l   <= (others => '0');
+    elsif (rising_edge(clk)) then
+      if (range_write = '1' and be_n_h = BYTE_EN) then
+        reg_range_h <= din_h;
+      end if;
+      if (range_write = '1' and be_n_l = BYTE_EN) then
+        reg_range_l <= din_l;
+      end if;
+    end if;
+  end process range_register_p;
+
+  -- process: bounded_register_p
+  --  keeps the latest candidate below the range, of one per 16 clocks
+  --  control inputs: range_write, candidate, range_value
+  --  status output:  is_fresh
+  --  registers:      reg_bounded, sample_count
+  bounded_register_p : process(clk, reset_n) is
+  begin
+    if (reset_n = RESET) then
+      reg_bounded   <= (others => '0');
+      is_fresh      <= STALE;
+      sample_count  <= (others => '0');
+    elsif (rising_edge(clk)) then
+      sample_count  <= sample_count + 1;
+      if (range_write = '1') then
+        -- the range changes on this edge; older values may be above it
+        is_fresh    <= STALE;
+      elsif (sample_count = SAMPLE_NOW and candidate < range_value) then
+        reg_bounded <= candidate(14 downto 0);
+        is_fresh    <= FRESH;
+      end if;
+    end if;
+  end process bounded_register_p;
+
   -- process: lfsr_register_p
   --  implements the linear feedback shift register
   --  control input:  ctrl_doseed
@@ -202,6 +308,7 @@ begin
       reg_stat <= (others => '0');
       reg_stat(0) <= is_seeded;
       reg_stat(1) <= seed_valid;
+      reg_stat(2) <= is_fresh;
     end if;
   end process stat_register_p;
 
@@ -221,6 +328,10 @@ begin
           dout  <=  reg_lfsr;
         when  SEED_ADDR =>
           dout  <=  reg_seed_h & reg_seed_l;
+        when  RANGE_ADDR =>
+          dout  <=  range_value;
+        when  BOUND_ADDR =>
+          dout  <=  (not is_fresh) & reg_bounded;
         when  others =>
           dout  <=  (others => '0');
       end case;
@@ -0,0 +1,192 @@
+--**************************  VHDL Source Code ****************************
+--*************************************************************************
+-- vim: set ts=2 sw=2 tw=78 et :
+--
+--  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+--
+--       LAB NAME:  Lab 7: Game System
+--
+--      FILE NAME:  lfsr_peripheral_tb.vhd
+--
+---------------------------------------------------------------------------
+--
+--  DESCRIPTION
+--
+--    Self-checking testbench for the range and bounded registers of
+--    lfsr_peripheral.vhd, against the software model the firmware and
+--    host tools rely on (lfsr_model_bounded_at in host/lfsr_model.c).
+--    The bus accesses and the expected values come from a vector file
+--    that host/hdl_vectors.c writes from the model: a series of ranges,
+--    each written to RANGE (address 4) and then read back through
+--    BOUNDED (address 5) on every clock for a full LFSR period.  Each
+--    line is
+--        w <edge> <range>    write RANGE on rising edge <edge>
+--        r <edge> <value>    read BOUNDED on rising edge <edge>
+--    with edges counted from the first one out of reset, as 1.  <value>
+--    is the bounded value the read returns, or -1 if it must read stale
+--    (bit 15 set; the other bits are then not checked).  Each mismatch
+--    is reported, up to a limit, and the simulation ends in a failure if
+--    there were any.
+--
+--    Running it with GHDL, after writing the vectors from host/ with
+--    "hdl_vectors -l ../vhdl/lfsr_vectors.txt":
+--      ghdl -a --ieee=synopsys -fexplicit lfsr_peripheral.vhd
+--      ghdl -a --ieee=synopsys -fexplicit lfsr_peripheral_tb.vhd
+--      ghdl -e --ieee=synopsys -fexplicit lfsr_peripheral_tb
+--      ghdl -r --ieee=synopsys -fexplicit lfsr_peripheral_tb
+--    (-gVECTOR_FILE=path reads the vectors from elsewhere.)
+--
+---------------------------------------------------------------------------
+--
+--  REVISION HISTORY
+--
+--  ______________________________________________________________________
+-- |  DATE    | USER | Ver |  Description                                 |
+-- |==========+======+=====+==============================================
+-- |          |      |     |
+-- | 10/19/26 | RST  | 1.0 | Created
+-- |          |      |     |
+-- |----------|------|-----|----------------------------------------------
+--
+--*************************************************************************
+--*************************************************************************
+
+library IEEE;
+use IEEE.std_logic_1164.ALL;
+use IEEE.std_logic_arith.ALL;
+use IEEE.std_logic_unsigned.ALL;
+
+library STD;
+use STD.textio.ALL;
+
+entity lfsr_peripheral_tb is
+  generic (
+    VECTOR_FILE : string := "lfsr_vectors.txt"
+  );
+end entity lfsr_peripheral_tb;
+
+architecture sim of lfsr_peripheral_tb is
+  -- constants
+  constant  CLK_PERIOD  : time := 20 ns;
+  constant  MAX_REPORTS : integer := 20;      -- mismatches reported
+
+  constant  RANGE_ADDR  : std_logic_vector(2 downto 0) := "100";
+  constant  BOUND_ADDR  : std_logic_vector(2 downto 0) := "101";
+
+  -- peripheral under test
+  signal    clk         : std_logic := '0';
+  signal    reset_n     : std_logic := '0';
+  signal    we_n        : std_logic := '1';
+  signal    be_n        : std_logic_vector(1 downto 0) := "11";
+  signal    a           : std_logic_vector(2 downto 0) := BOUND_ADDR;
+  signal    din         : std_logic_vector(15 downto 0) := (others => '0');
+  signal    dout        : std_logic_vector(15 downto 0);
+
+  signal    edges       : integer := 0;     -- rising edges out of reset
+  signal    done        : boolean := false;
+
+begin
+  dut : entity work.lfsr_peripheral
+    port map (
+      clk     => clk,
+      reset_n => reset_n,
+      we_n    => we_n,
+      be_n    => be_n,
+      a       => a,
+      din     => din,
+      dout    => dout
+    );
+
+  -- free-running clock until the test is done
+  clk <= not clk after CLK_PERIOD / 2 when not done else '0';
+
+  -- process: edge_count_p
+  --  counts rising edges out of reset, the vector file's clock
+  edge_count_p : process(clk) is
+  begin
+    if (rising_edge(clk)) then
+      if (reset_n = '1') then
+        edges <= edges + 1;
+      end if;
+    end if;
+  end process edge_count_p;
+
+  -- process: test_p
+  --  plays the vector file, setting up each access on the falling edge
+  --  before the rising edge it is for, and checking reads on the
+  --  falling edge after it
+  test_p : process is
+    file      vectors   : text open read_mode is VECTOR_FILE;
+    variable  l         : line;
+    variable  kind      : character;
+    variable  edge      : integer;
+    variable  value     : integer;
+    variable  reads     : integer := 0;
+    variable  errors    : integer := 0;
+
+    procedure mismatch(what : string) is
+    begin
+      errors := errors + 1;
+      if (errors <= MAX_REPORTS) then
+        report "edge " & integer'image(edge) & ": " & what
+          severity error;
+      end if;
+    end procedure mismatch;
+
+  begin
+    -- hold reset for a few clocks, and come out of it on a falling edge
+    for i in 1 to 3 loop
+      wait until falling_edge(clk);
+    end loop;
+    reset_n <= '1';
+
+    while not endfile(vectors) loop
+      readline(vectors, l);
+      read(l, kind);
+      read(l, edge);
+      read(l, value);
+
+      assert (edges < edge)
+        report "vector for edge " & integer'image(edge) & " is out of order"
+        severity failure;
+      while (edges < edge - 1) loop
+        wait until falling_edge(clk);
+      end loop;
+
+      if (kind = 'w') then
+        a     <= RANGE_ADDR;
+        din   <= conv_std_logic_vector(value, 16);
+        we_n  <= '0';
+        be_n  <= "00";
+        wait until falling_edge(clk);
+        a     <= BOUND_ADDR;
+        we_n  <= '1';
+        be_n  <= "11";
+      else
+        a     <= BOUND_ADDR;
+        wait until falling_edge(clk);
+        reads := reads + 1;
+        if (value < 0) then
+          if (dout(15) /= '1') then
+            mismatch("expected stale, read " &
+                     integer'image(conv_integer(dout)));
+          end if;
+        elsif (dout(15) /= '0') then
+          mismatch("expected " & integer'image(value) & ", read stale");
+        elsif (conv_integer(dout(14 downto 0)) /= value) then
+          mismatch("expected " & integer'image(value) & ", read " &
+                   integer'image(conv_integer(dout(14 downto 0))));
+        end if;
+      end if;
+    end loop;
+
+    report "lfsr_peripheral: " & integer'image(reads) & " reads, " &
+           integer'image(errors) & " mismatches"
+      severity note;
+    assert (errors = 0 and reads > 0)
+      report "lfsr_peripheral: bounded register does not match the model"
+      severity failure;
+    done <= true;
+    wait;
+  end process test_p;
+end architecture sim;
@@ -0,0 +1,114 @@
+--**************************  VHDL Source Code ****************************
+--*************************************************************************
+-- vim: set ts=2 sw=2 tw=78 et :
+--
+--  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+--
+--       LAB NAME:  Lab 7: Game System
+--
+--      FILE NAME:  score_ci.vhd
+--
+---------------------------------------------------------------------------
+--
+--  DESCRIPTION
+--
+--    This design implements a combinational Nios II custom instruction
+--    that scores a packed guess against a packed secret code, as
+--    score_code does in software (see nios/utilities.c).
+--
+--    Operands and result:
+--      dataa     secret, one color per four-bit slot, slot 0 lowest
+--      datab     guess, packed the same way
+--      result    bits 15..8:  P, slots where the colors agree
+--                bits 7..0:   C, other guess colors left over in the
+--                             secret
+--
+--    P counts the equal slots.  P + C is the sum over the colors of the
+--    smaller of the two codes' counts of that color, counted on the low
+--    three bits of each slot as _histogram does.  PEGS and COLORS must
+--    match CB_COLOR_LENGTH and CB_POSSIBLE_COLORS in codebreaker.h.
+--
+--    Being combinational, it takes one cycle; score_code in software
+--    takes on the order of a hundred on the Small core.
+--
+---------------------------------------------------------------------------
+--
+--  REVISION HISTORY
+--
+--  ______________________________________________________________________
+-- |  DATE    | USER | Ver |  Description                                 |
+-- |==========+======+=====+==============================================
+-- |          |      |     |
+-- | 10/19/26 | RST  | 1.0 | Created
+-- |          |      |     |
+-- |----------|------|-----|----------------------------------------------
+--
+--*************************************************************************
+--*************************************************************************
+
+library IEEE;
+use IEEE.std_logic_1164.ALL;
+use IEEE.std_logic_unsigned.ALL;
+
+entity score_ci is
+  generic (
+    PEGS    : integer := 4;       -- CB_COLOR_LENGTH
+    COLORS  : integer := 6        -- CB_POSSIBLE_COLORS
+  );
+  port (
+    -- inputs
+    dataa   : in  std_logic_vector(31 downto 0);
+    datab   : in  std_logic_vector(31 downto 0);
+    -- outputs
+    result  : out std_logic_vector(31 downto 0)
+  );
+end entity score_ci;
+
+architecture rtl of score_ci is
+  -- constants
+  constant  ZEROS_8     : std_logic_vector(7 downto 0) := "00000000";
+  constant  ZEROS_16    : std_logic_vector(15 downto 0) := x"0000";
+
+begin
+  -- process: score_p
+  --  score the guess against the secret
+  --  inputs:   dataa, datab
+  --  output:   result
+  score_p : process(dataa, datab) is
+    variable  exact     : std_logic_vector(7 downto 0);
+    variable  matches   : std_logic_vector(7 downto 0);
+    variable  count_a   : std_logic_vector(7 downto 0);
+    variable  count_b   : std_logic_vector(7 downto 0);
+  begin
+    -- P: equal slots
+    exact := ZEROS_8;
+    for i in 0 to PEGS - 1 loop
+      if (dataa(4*i + 3 downto 4*i) = datab(4*i + 3 downto 4*i)) then
+        exact := exact + 1;
+      end if;
+    end loop;
+
+    -- P + C: per color, the smaller of the two counts
+    matches := ZEROS_8;
+    for c in 0 to COLORS - 1 loop
+      count_a := ZEROS_8;
+      count_b := ZEROS_8;
+      for i in 0 to PEGS - 1 loop
+        if (conv_integer(dataa(4*i + 2 downto 4*i)) = c) then
+          count_a := count_a + 1;
+        end if;
+        if (conv_integer(datab(4*i + 2 downto 4*i)) = c) then
+          count_b := count_b + 1;
+        end if;
+      end loop;
+      if (count_a < count_b) then
+        matches := matches + count_a;
+      else
+        matches := matches + count_b;
+      end if;
+    end loop;
+
+    result <= ZEROS_16 & exact & (matches - exact);
+  end process score_p;
+
+end architecture rtl;
@@ -0,0 +1,74 @@
+# Qsys component description for score_ci.vhd, written by hand in the
+# form Component Editor 12.0 produces.
+
+# 
+# score_ci "Codebreaker Score" v1.0
+# 
+# 
+
+# 
+# request TCL package from ACDS 12.0
+# 
+package require -exact qsys 12.0
+
+
+# 
+# module score_ci
+# 
+set_module_property NAME score_ci
+set_module_property VERSION 1.0
+set_module_property INTERNAL false
+set_module_property OPAQUE_ADDRESS_MAP true
+set_module_property GROUP "Custom Instruction Modules"
+set_module_property DISPLAY_NAME "Codebreaker Score"
+set_module_property INSTANTIATE_IN_SYSTEM_MODULE true
+set_module_property EDITABLE true
+set_module_property ANALYZE_HDL AUTO
+set_module_property REPORT_TO_TALKBACK false
+set_module_property ALLOW_GREYBOX_GENERATION false
+
+
+# 
+# file sets
+# 
+add_fileset QUARTUS_SYNTH QUARTUS_SYNTH "" ""
+set_fileset_property QUARTUS_SYNTH TOP_LEVEL score_ci
+set_fileset_property QUARTUS_SYNTH ENABLE_RELATIVE_INCLUDE_PATHS false
+add_fileset_file score_ci.vhd VHDL PATH score_ci.vhd
+
+
+# 
+# parameters
+# 
+add_parameter PEGS INTEGER 4
+set_parameter_property PEGS DEFAULT_VALUE 4
+set_parameter_property PEGS DISPLAY_NAME PEGS
+set_parameter_property PEGS TYPE INTEGER
+set_parameter_property PEGS UNITS None
+set_parameter_property PEGS ALLOWED_RANGES 1:8
+set_parameter_property PEGS HDL_PARAMETER true
+add_parameter COLORS INTEGER 6
+set_parameter_property COLORS DEFAULT_VALUE 6
+set_parameter_property COLORS DISPLAY_NAME COLORS
+set_parameter_property COLORS TYPE INTEGER
+set_parameter_property COLORS UNITS None
+set_parameter_property COLORS ALLOWED_RANGES 1:8
+set_parameter_property COLORS HDL_PARAMETER true
+
+
+# 
+# display items
+# 
+
+
+# 
+# connection point nios_custom_instruction_slave
+# 
+add_interface nios_custom_instruction_slave nios_custom_instruction end
+set_interface_property nios_custom_instruction_slave clockCycle 0
+set_interface_property nios_custom_instruction_slave operands 2
+set_interface_property nios_custom_instruction_slave ENABLED true
+
+add_interface_port nios_custom_instruction_slave dataa dataa Input 32
+add_interface_port nios_custom_instruction_slave datab datab Input 32
+add_interface_port nios_custom_instruction_slave result result Output 32
@@ -0,0 +1,122 @@
+--**************************  VHDL Source Code ****************************
+--*************************************************************************
+-- vim: set ts=2 sw=2 tw=78 et :
+--
+--  DESIGNER NAME:  Ryan S. Tucker <rst7983@rit.edu>
+--
+--       LAB NAME:  Lab 7: Game System
+--
+--      FILE NAME:  score_ci_tb.vhd
+--
+---------------------------------------------------------------------------
+--
+--  DESCRIPTION
+--
+--    Exhaustive testbench for score_ci.vhd: every pair of packed codes
+--    (1296 x 1296 with the default six colors and four pegs, repeated
+--    colors included) is applied, and the result is compared with
+--    score_code's score (nios/utilities.c).  The pairs and scores come
+--    from a vector file that host/hdl_vectors.c writes by calling
+--    score_code, one pair per line:
+--        <secret> <guess> <score>
+--    Each mismatch is reported, up to a limit, and the simulation ends
+--    in a failure if there were any.
+--
+--    Running it with GHDL, after writing the vectors from host/ with
+--    "hdl_vectors -s ../vhdl/score_vectors.txt":
+--      ghdl -a --ieee=synopsys -fexplicit score_ci.vhd
+--      ghdl -a --ieee=synopsys -fexplicit score_ci_tb.vhd
+--      ghdl -e --ieee=synopsys -fexplicit score_ci_tb
+--      ghdl -r --ieee=synopsys -fexplicit score_ci_tb
+--    (-gVECTOR_FILE=path reads the vectors from elsewhere.)
+--
+---------------------------------------------------------------------------
+--
+--  REVISION HISTORY
+--
+--  ______________________________________________________________________
+-- |  DATE    | USER | Ver |  Description                                 |
+-- |==========+======+=====+==============================================
+-- |          |      |     |
+-- | 10/19/26 | RST  | 1.0 | Created
+-- |          |      |     |
+-- |----------|------|-----|----------------------------------------------
+--
+--*************************************************************************
+--*************************************************************************
+
+library IEEE;
+use IEEE.std_logic_1164.ALL;
+use IEEE.std_logic_arith.ALL;
+use IEEE.std_logic_unsigned.ALL;
+
+library STD;
+use STD.textio.ALL;
+
+entity score_ci_tb is
+  generic (
+    VECTOR_FILE : string := "score_vectors.txt"
+  );
+end entity score_ci_tb;
+
+architecture sim of score_ci_tb is
+  -- constants
+  constant  SETTLE      : time := 10 ns;      -- per pair
+  constant  MAX_REPORTS : integer := 20;      -- mismatches reported
+
+  -- custom instruction under test
+  signal    dataa       : std_logic_vector(31 downto 0) := (others => '0');
+  signal    datab       : std_logic_vector(31 downto 0) := (others => '0');
+  signal    result      : std_logic_vector(31 downto 0);
+
+begin
+  dut : entity work.score_ci
+    port map (
+      dataa   => dataa,
+      datab   => datab,
+      result  => result
+    );
+
+  -- process: test_p
+  --  applies each pair in the vector file and checks the score
+  test_p : process is
+    file      vectors   : text open read_mode is VECTOR_FILE;
+    variable  l         : line;
+    variable  secret    : integer;
+    variable  guess     : integer;
+    variable  score     : integer;
+    variable  pairs     : integer := 0;
+    variable  errors    : integer := 0;
+  begin
+    while not endfile(vectors) loop
+      readline(vectors, l);
+      read(l, secret);
+      read(l, guess);
+      read(l, score);
+
+      dataa <= conv_std_logic_vector(secret, 32);
+      datab <= conv_std_logic_vector(guess, 32);
+      wait for SETTLE;
+
+      pairs := pairs + 1;
+      if (conv_integer(result) /= score) then
+        errors := errors + 1;
+        if (errors <= MAX_REPORTS) then
+          report "secret " & integer'image(secret) & ", guess " &
+                 integer'image(guess) & ": score " &
+                 integer'image(conv_integer(result)) & ", expected " &
+                 integer'image(score)
+            severity error;
+        end if;
+      end if;
+    end loop;
+
+    report "score_ci: " & integer'image(pairs) & " pairs, " &
+           integer'image(errors) & " mismatches"
+      severity note;
+    assert (errors = 0 and pairs > 0)
+      report "score_ci: scores do not match score_code"
+      severity failure;
+    wait;
+  end process test_p;
+end architecture sim;